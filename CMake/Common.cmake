@@ -86,3 +86,8 @@ OPTION(USE_DOUBLE_PRECISION "Use double precision"	ON)
 if (USE_DOUBLE_PRECISION)
 	add_definitions( -DUSE_DOUBLE)	
 endif (USE_DOUBLE_PRECISION)
+
+OPTION(USE_ALLOCATION_COUNTER "Count the heap allocations of each simulation step" OFF)
+if (USE_ALLOCATION_COUNTER)
+	add_definitions( -DPBD_COUNT_ALLOCATIONS)
+endif (USE_ALLOCATION_COUNTER)
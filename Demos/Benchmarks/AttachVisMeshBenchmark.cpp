@@ -0,0 +1,119 @@
+#include "Common/Common.h"
+#include "BenchmarkCommon.h"
+#include "Simulation/TetModel.h"
+#include "Simulation/ParticleData.h"
+#include "Utils/FileSystem.h"
+#include "Utils/Logger.h"
+#include "Utils/TetGenLoader.h"
+#include "Utils/Timing.h"
+#include <random>
+#include <string>
+
+// Benchmark of TetModel::attachVisMesh. The armadillo tet model is loaded and a
+// visualization mesh is generated by sampling random points close to its surface.
+// The points are attached to the surface by the search with an AABB tree and (optionally)
+// by testing all surface triangles. The attachments of both are compared.
+//
+// Usage: AttachVisMeshBenchmark [numVisVertices] [bruteForce (0/1)] [nodeFile eleFile]
+
+using namespace PBD;
+using namespace std;
+using namespace Utilities;
+
+int runBenchmark(int argc, char **argv)
+{
+	unsigned int numVisVertices = 100000;
+	if (argc > 1)
+		numVisVertices = std::max(1, atoi(argv[1]));
+	bool bruteForce = true;
+	if (argc > 2)
+		bruteForce = atoi(argv[2]) != 0;
+	const std::string modelPath = FileSystem::normalizePath(FileSystem::getProgramPath() + "/resources/models");
+	std::string nodeFile = modelPath + "/armadillo_4k.node";
+	std::string eleFile = modelPath + "/armadillo_4k.ele";
+	if (argc > 4)
+	{
+		nodeFile = argv[3];
+		eleFile = argv[4];
+	}
+
+	std::vector<Vector3r> vertices;
+	std::vector<unsigned int> tets;
+	TetGenLoader::loadTetgenModel(nodeFile, eleFile, vertices, tets);
+	if (vertices.size() == 0)
+	{
+		LOG_ERR << "Cannot load " << nodeFile;
+		return 1;
+	}
+
+	ParticleData pd;
+	for (unsigned int i = 0; i < vertices.size(); i++)
+		pd.addVertex(vertices[i]);
+	TetModel tm;
+	tm.initMesh(static_cast<unsigned int>(vertices.size()), static_cast<unsigned int>(tets.size() / 4), 0, tets.data());
+	tm.updateMeshNormals(pd);
+
+	// visualization vertices close to the surface
+	const TetModel::SurfaceMesh &surfaceMesh = tm.getSurfaceMesh();
+	const unsigned int *faces = surfaceMesh.getFaces().data();
+	const unsigned int nFaces = surfaceMesh.numFaces();
+	const Vector3r *normals = surfaceMesh.getVertexNormals().data();
+	AlignedBox3r box;
+	for (unsigned int i = 0; i < vertices.size(); i++)
+		box.extend(vertices[i]);
+	const Real maxOffset = static_cast<Real>(0.005) * box.diagonal().norm();
+
+	std::mt19937 gen(numVisVertices);
+	std::uniform_int_distribution<unsigned int> face(0, nFaces - 1);
+	std::uniform_real_distribution<Real> uniform(0.0, 1.0);
+	std::uniform_real_distribution<Real> offset(-maxOffset, maxOffset);
+	VertexData &visVertices = tm.getVisVertices();
+	for (unsigned int i = 0; i < numVisVertices; i++)
+	{
+		const unsigned int f = face(gen);
+		const Real r1 = sqrt(uniform(gen));
+		const Real r2 = uniform(gen);
+		const Real b[3] = { static_cast<Real>(1.0) - r1, r1 * (static_cast<Real>(1.0) - r2), r1 * r2 };
+		Vector3r x, n;
+		x.setZero();
+		n.setZero();
+		for (unsigned int j = 0; j < 3; j++)
+		{
+			x += b[j] * pd.getPosition0(faces[3 * f + j]);
+			n += b[j] * normals[faces[3 * f + j]];
+		}
+		visVertices.addVertex(x + offset(gen) * n.normalized());
+	}
+
+	START_TIMING("attachVisMesh (AABB tree)");
+	tm.attachVisMesh(pd);
+	const double timeBVH = STOP_TIMING;
+	const std::vector<TetModel::Attachment> attachments = tm.getAttachments();
+
+	LOG_INFO << "Tets: " << tets.size() / 4 << ", surface triangles: " << nFaces << ", visualization vertices: " << numVisVertices;
+	if (!bruteForce)
+	{
+		LOG_INFO << "attachVisMesh (AABB tree): " << timeBVH << " ms";
+		return 0;
+	}
+
+	START_TIMING("attachVisMesh (all triangles)");
+	tm.attachVisMesh(pd, false);
+	const double timeBruteForce = STOP_TIMING;
+	const std::vector<TetModel::Attachment> &reference = tm.getAttachments();
+
+	size_t numDifferent = 0;
+	for (size_t i = 0; i < attachments.size(); i++)
+	{
+		const TetModel::Attachment &a = attachments[i];
+		const TetModel::Attachment &r = reference[i];
+		if ((a.m_triIndex != r.m_triIndex) || (a.m_dist != r.m_dist) ||
+			(a.m_bary[0] != r.m_bary[0]) || (a.m_bary[1] != r.m_bary[1]) || (a.m_bary[2] != r.m_bary[2]))
+			numDifferent++;
+	}
+
+	LOG_INFO << "attachVisMesh (all triangles): " << timeBruteForce << " ms, attachVisMesh (AABB tree): " << timeBVH << " ms, speedup: " << timeBruteForce / timeBVH;
+	LOG_INFO << "Attachments: " << ((numDifferent == 0) ? "equal" : "DIFFERENT") << " (" << numDifferent << " different)";
+
+	return (numDifferent == 0) ? 0 : 1;
+}
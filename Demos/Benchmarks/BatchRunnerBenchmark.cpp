@@ -0,0 +1,109 @@
+#include "Common/Common.h"
+#include "BenchmarkCommon.h"
+#include "Simulation/BatchRunner.h"
+#include "Simulation/Simulation.h"
+#include "Simulation/SimulationModel.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing.h"
+#include <string>
+#include <vector>
+
+// Benchmark of the batch runner. Many independent cloth simulations with different
+// stiffness values (e.g. of a parameter study) are performed one after another and
+// in parallel by the batch runner. The results of both runs must be identical.
+//
+// Usage: BatchRunnerBenchmark [numSimulations] [numSteps] [resolution] [numThreads]
+
+using namespace PBD;
+using namespace std;
+using namespace Utilities;
+
+Simulation *createSimulation(const unsigned int index, const int resolution)
+{
+	Simulation *sim = new Simulation();
+	sim->init();
+	SimulationModel *model = new SimulationModel();
+	model->init();
+	sim->setModel(model);
+
+	model->addRegularTriangleModel(resolution, resolution);
+	const Real stiffness = static_cast<Real>(1.0) / static_cast<Real>(index + 1);
+	model->addClothConstraints(model->getTriangleModels()[0], 2, stiffness, 1.0, 1.0, 1.0,
+		static_cast<Real>(0.3), static_cast<Real>(0.3), false, false);
+	model->addBendingConstraints(model->getTriangleModels()[0], 2, static_cast<Real>(0.01));
+
+	// fix two corners
+	ParticleData &pd = model->getParticles();
+	pd.setMass(0, 0.0);
+	pd.setMass(resolution - 1, 0.0);
+	return sim;
+}
+
+void deleteSimulations(std::vector<Simulation*> &simulations)
+{
+	for (size_t i = 0; i < simulations.size(); i++)
+	{
+		SimulationModel *model = simulations[i]->getModel();
+		delete simulations[i];
+		delete model;
+	}
+	simulations.clear();
+}
+
+int runBenchmark(int argc, char **argv)
+{
+	unsigned int numSimulations = 32;
+	unsigned int numSteps = 100;
+	int resolution = 30;
+	unsigned int numThreads = 0;
+	if (argc > 1)
+		numSimulations = std::max(1, atoi(argv[1]));
+	if (argc > 2)
+		numSteps = std::max(1, atoi(argv[2]));
+	if (argc > 3)
+		resolution = std::max(2, atoi(argv[3]));
+	if (argc > 4)
+		numThreads = std::max(0, atoi(argv[4]));
+
+	std::vector<Simulation*> simulations(numSimulations);
+	for (unsigned int i = 0; i < numSimulations; i++)
+		simulations[i] = createSimulation(i, resolution);
+
+	START_TIMING("sequential");
+	for (unsigned int i = 0; i < numSimulations; i++)
+	{
+		simulations[i]->makeCurrent();
+		for (unsigned int s = 0; s < numSteps; s++)
+			simulations[i]->getTimeStep()->step(*simulations[i]->getModel());
+	}
+	const double timeSequential = STOP_TIMING;
+
+	std::vector<std::vector<Vector3r>> reference(numSimulations);
+	for (unsigned int i = 0; i < numSimulations; i++)
+		reference[i] = simulations[i]->getModel()->getParticles().getVertices();
+	deleteSimulations(simulations);
+
+	simulations.resize(numSimulations);
+	for (unsigned int i = 0; i < numSimulations; i++)
+		simulations[i] = createSimulation(i, resolution);
+
+	BatchRunner runner(numThreads);
+	START_TIMING("batch");
+	runner.step(simulations, numSteps);
+	const double timeBatch = STOP_TIMING;
+
+	Real maxDiff = 0.0;
+	for (unsigned int i = 0; i < numSimulations; i++)
+	{
+		const std::vector<Vector3r> &x = simulations[i]->getModel()->getParticles().getVertices();
+		for (size_t j = 0; j < x.size(); j++)
+			maxDiff = std::max(maxDiff, (x[j] - reference[i][j]).norm());
+	}
+	deleteSimulations(simulations);
+
+	LOG_INFO << "Simulations: " << numSimulations << ", steps: " << numSteps << ", particles per simulation: " << resolution * resolution;
+	LOG_INFO << "sequential: " << timeSequential << " ms";
+	LOG_INFO << "batch (" << runner.getNumThreads() << " threads): " << timeBatch << " ms (speedup " << timeSequential / timeBatch << "), max. difference: " << maxDiff;
+
+	return (maxDiff == 0.0) ? 0 : 1;
+}
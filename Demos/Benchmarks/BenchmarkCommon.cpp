@@ -0,0 +1,16 @@
+#include "Common/Common.h"
+#include "BenchmarkCommon.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing.h"
+
+// Logging, timing and main function which are shared by all benchmarks.
+
+INIT_LOGGING
+INIT_TIMING
+std::ofstream Utilities::graphingData;
+
+int main(int argc, char **argv)
+{
+	Utilities::logger.addSink(std::unique_ptr<Utilities::ConsoleSink>(new Utilities::ConsoleSink(Utilities::LogLevel::INFO)));
+	return runBenchmark(argc, argv);
+}
@@ -0,0 +1,9 @@
+#ifndef __BenchmarkCommon_h__
+#define __BenchmarkCommon_h__
+
+/** Entry point of a benchmark. It is called by the main function of BenchmarkCommon.cpp
+ * after the logging is initialized. The return value is the exit code of the benchmark.
+ */
+int runBenchmark(int argc, char **argv);
+
+#endif
@@ -0,0 +1,119 @@
+#include "Common/Common.h"
+#include "BenchmarkCommon.h"
+#include "Simulation/BroadPhase.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing.h"
+#include <random>
+#include <string>
+
+// Benchmark of the broad phase methods. A pile of n rigid bodies is generated
+// and moved slightly in each frame to mimic a settling pile. The brute force
+// method is used as reference for the pairs found by sweep and prune.
+//
+// Usage: BroadPhaseBenchmark [numFrames] [n1 n2 ...]
+
+using namespace PBD;
+using namespace std;
+using namespace Utilities;
+
+const Real bodySize = static_cast<Real>(1.0);
+const Real tolerance = static_cast<Real>(0.01);
+
+void createPile(const unsigned int numBodies, std::mt19937 &gen, std::vector<Vector3r> &positions)
+{
+	// square base, the height of the pile is about the half of the base width
+	const unsigned int width = static_cast<unsigned int>(ceil(pow(2.0 * numBodies, 1.0 / 3.0)));
+	std::uniform_real_distribution<Real> jitter(static_cast<Real>(-0.1), static_cast<Real>(0.1));
+	positions.resize(numBodies);
+	for (unsigned int i = 0; i < numBodies; i++)
+	{
+		const unsigned int layer = i / (width*width);
+		const unsigned int j = i % (width*width);
+		positions[i] = Vector3r(
+			static_cast<Real>(j % width) * static_cast<Real>(1.05) + jitter(gen),
+			static_cast<Real>(layer) * static_cast<Real>(1.02) + jitter(gen),
+			static_cast<Real>(j / width) * static_cast<Real>(1.05) + jitter(gen));
+	}
+}
+
+void updateAABBs(const std::vector<Vector3r> &positions, std::vector<AABB> &aabbs)
+{
+	const Real h = static_cast<Real>(0.5) * bodySize + tolerance;
+	aabbs.resize(positions.size());
+	for (size_t i = 0; i < positions.size(); i++)
+	{
+		aabbs[i].m_p[0] = positions[i] - Vector3r(h, h, h);
+		aabbs[i].m_p[1] = positions[i] + Vector3r(h, h, h);
+	}
+}
+
+void runBenchmark(const unsigned int numBodies, const unsigned int numFrames)
+{
+	std::mt19937 gen(numBodies);
+	std::uniform_real_distribution<Real> motion(static_cast<Real>(-0.01), static_cast<Real>(0.01));
+	std::vector<Vector3r> positions;
+	std::vector<AABB> aabbs;
+	createPile(numBodies, gen, positions);
+
+	BruteForceBroadPhase bruteForce;
+	SweepAndPruneBroadPhase sap;
+	BroadPhase::PairVector pairs, refPairs;
+
+	// The brute force method is too slow for large piles, so it is only run in the first 
+	// and in the last frame to verify the initial pairs and the incremental updates.
+	double timeBruteForce = 0.0;
+	double timeSAP = 0.0;
+	double timeFirstSAP = 0.0;
+	size_t numPairs = 0;
+	bool equal = true;
+	for (unsigned int frame = 0; frame < numFrames; frame++)
+	{
+		for (size_t i = 0; i < positions.size(); i++)
+			positions[i] += Vector3r(motion(gen), static_cast<Real>(-0.5) * fabs(motion(gen)), motion(gen));
+		updateAABBs(positions, aabbs);
+
+		START_TIMING("SAP");
+		sap.computePairs(aabbs, pairs);
+		const double t = STOP_TIMING;
+		if (frame == 0)
+			timeFirstSAP = t;
+		else
+			timeSAP += t;
+		numPairs = pairs.size();
+
+		if ((frame == 0) || (frame == numFrames - 1))
+		{
+			START_TIMING("brute force");
+			bruteForce.computePairs(aabbs, refPairs);
+			const double tbf = STOP_TIMING;
+			if (frame == 0)
+				timeBruteForce = tbf;
+			equal = equal && (refPairs == pairs);
+		}
+	}
+
+	LOG_INFO << "Bodies: " << numBodies << ", pairs: " << numPairs
+		<< ", brute force: " << timeBruteForce << " ms"
+		<< ", SAP (initial sort): " << timeFirstSAP << " ms"
+		<< ", SAP (coherent): " << ((numFrames > 1) ? timeSAP / (numFrames - 1) : 0.0) << " ms"
+		<< ", results " << (equal ? "equal" : "DIFFERENT");
+}
+
+int runBenchmark(int argc, char **argv)
+{
+	unsigned int numFrames = 100;
+	std::vector<unsigned int> sizes = { 1000, 5000, 10000, 20000, 50000 };
+	if (argc > 1)
+		numFrames = std::max(1, atoi(argv[1]));
+	if (argc > 2)
+	{
+		sizes.clear();
+		for (int i = 2; i < argc; i++)
+			sizes.push_back(static_cast<unsigned int>(atoi(argv[i])));
+	}
+
+	for (size_t i = 0; i < sizes.size(); i++)
+		runBenchmark(sizes[i], numFrames);
+
+	return 0;
+}
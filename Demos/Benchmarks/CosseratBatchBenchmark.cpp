@@ -0,0 +1,244 @@
+#include "Common/Common.h"
+#include "BenchmarkCommon.h"
+#include "PositionBasedDynamics/PositionBasedElasticRods.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+// Benchmark of the batch variants of the Cosserat rod constraint solvers. Independent
+// stretch-shear and bend-twist constraints are generated from randomly deformed rod
+// segments. Half of the constraints have anisotropic stiffness coefficients, a part of
+// the particles and quaternions is static. The corrections of the batch solvers are
+// compared with the ones of the solvers for single constraints relative to the largest
+// correction.
+//
+// Usage: CosseratBatchBenchmark [numConstraints] [repetitions]
+
+using namespace PBD;
+using namespace std;
+using namespace Utilities;
+
+typedef PositionBasedCosseratRods CR;
+
+/** Relative difference of vectors with n coefficients which are stored consecutively. */
+Real relativeDifference(const std::vector<Real> &corr, const std::vector<Real> &reference, const int n)
+{
+	Real maxDiff = 0.0;
+	Real maxCorr = 0.0;
+	for (size_t i = 0; i < corr.size(); i += n)
+	{
+		Real diff2 = 0.0;
+		Real corr2 = 0.0;
+		for (int k = 0; k < n; k++)
+		{
+			diff2 += (corr[i + k] - reference[i + k]) * (corr[i + k] - reference[i + k]);
+			corr2 += reference[i + k] * reference[i + k];
+		}
+		maxDiff = std::max(maxDiff, sqrt(diff2));
+		maxCorr = std::max(maxCorr, sqrt(corr2));
+	}
+	return (maxCorr > 0.0) ? maxDiff / maxCorr : maxDiff;
+}
+
+Quaternionr randomRotation(std::mt19937 &gen)
+{
+	std::normal_distribution<Real> normal(0.0, 1.0);
+	Quaternionr q(normal(gen), normal(gen), normal(gen), normal(gen));
+	q.normalize();
+	return q;
+}
+
+/** Rotation q perturbed by a small random rotation */
+Quaternionr perturbRotation(const Quaternionr &q, const Real angle, std::mt19937 &gen)
+{
+	std::uniform_real_distribution<Real> position(-1.0, 1.0);
+	const Vector3r axis = Vector3r(position(gen), position(gen), position(gen)).normalized();
+	return (q * Quaternionr(AngleAxisr(angle * position(gen), axis))).normalized();
+}
+
+int runBenchmark(int argc, char **argv)
+{
+	const int batchSize = CR::BatchSize;
+	int numConstraints = 200000;
+	if (argc > 1)
+		numConstraints = std::max(batchSize, atoi(argv[1]));
+	int repetitions = 5;
+	if (argc > 2)
+		repetitions = std::max(1, atoi(argv[2]));
+	// full batches
+	numConstraints -= numConstraints % batchSize;
+
+	// a rod segment per constraint: two particles, the quaternion of the segment and
+	// the quaternion of the next segment
+	std::mt19937 gen(numConstraints);
+	std::uniform_real_distribution<Real> position(-1.0, 1.0);
+	std::uniform_real_distribution<Real> uniform(0.0, 1.0);
+	std::vector<Vector3r> p0(numConstraints), p1(numConstraints);
+	std::vector<Quaternionr> q0(numConstraints), q1(numConstraints), restDarboux(numConstraints);
+	std::vector<Real> invMass0(numConstraints), invMass1(numConstraints), invMassq0(numConstraints), invMassq1(numConstraints);
+	std::vector<Real> restLength(numConstraints);
+	std::vector<Vector3r> stretchKs(numConstraints), bendKs(numConstraints);
+	for (int c = 0; c < numConstraints; c++)
+	{
+		restLength[c] = static_cast<Real>(0.05) + static_cast<Real>(0.1) * uniform(gen);
+		const Quaternionr rest0 = randomRotation(gen);
+		const Quaternionr rest1 = perturbRotation(rest0, static_cast<Real>(0.5), gen);
+		restDarboux[c] = rest0.conjugate() * rest1;
+
+		// deformed segment
+		q0[c] = perturbRotation(rest0, static_cast<Real>(0.2), gen);
+		q1[c] = perturbRotation(rest1, static_cast<Real>(0.2), gen);
+		p0[c] = Vector3r(position(gen), position(gen), position(gen));
+		const Vector3r d3 = rest0 * Vector3r(0, 0, 1);
+		p1[c] = p0[c] + restLength[c] * ((static_cast<Real>(1.0) + static_cast<Real>(0.2) * position(gen)) * d3 +
+			static_cast<Real>(0.1) * Vector3r(position(gen), position(gen), position(gen)));
+
+		invMass0[c] = (uniform(gen) < 0.1) ? static_cast<Real>(0.0) : static_cast<Real>(1.0) + uniform(gen);
+		invMass1[c] = (uniform(gen) < 0.1) ? static_cast<Real>(0.0) : static_cast<Real>(1.0) + uniform(gen);
+		invMassq0[c] = (uniform(gen) < 0.1) ? static_cast<Real>(0.0) : static_cast<Real>(1.0) + uniform(gen);
+		invMassq1[c] = (uniform(gen) < 0.1) ? static_cast<Real>(0.0) : static_cast<Real>(1.0) + uniform(gen);
+
+		// isometric and anisotropic stiffness coefficients
+		if (c % 2 == 0)
+		{
+			stretchKs[c] = Vector3r::Constant(uniform(gen));
+			bendKs[c] = Vector3r::Constant(uniform(gen));
+		}
+		else
+		{
+			stretchKs[c] = Vector3r(uniform(gen), uniform(gen), uniform(gen));
+			bendKs[c] = Vector3r(uniform(gen), uniform(gen), uniform(gen));
+		}
+	}
+
+	LOG_INFO << "Cosserat rod constraints: " << numConstraints;
+
+	int result = 0;
+
+	// stretch-shear constraints: corrections of p0, p1 (3 coefficients each) and q0 (4 coefficients)
+	{
+		std::vector<Real> reference(10 * numConstraints);
+		std::vector<Real> corr(10 * numConstraints);
+
+		double time = 0.0;
+		for (int r = 0; r < repetitions; r++)
+		{
+			START_TIMING("single");
+			for (int c = 0; c < numConstraints; c++)
+			{
+				Vector3r corr0, corr1;
+				Quaternionr corrq0;
+				CR::solve_StretchShearConstraint(p0[c], invMass0[c], p1[c], invMass1[c], q0[c], invMassq0[c],
+					stretchKs[c], restLength[c], corr0, corr1, corrq0);
+				Vector3r::Map(&reference[10 * c]) = corr0;
+				Vector3r::Map(&reference[10 * c + 3]) = corr1;
+				Vector4r::Map(&reference[10 * c + 6]) = corrq0.coeffs();
+			}
+			time += STOP_TIMING;
+		}
+		const double timeSingle = time / repetitions;
+		LOG_INFO << "Stretch-shear single constraints: " << timeSingle << " ms";
+
+		time = 0.0;
+		for (int r = 0; r < repetitions; r++)
+		{
+			START_TIMING("batches");
+			for (int b = 0; b < numConstraints / batchSize; b++)
+			{
+				CR::Vector3Batch p0b, p1b, stretchKsb;
+				CR::QuaternionBatch q0b;
+				CR::RealBatch invMass0b, invMass1b, invMassq0b, restLengthb;
+				for (int j = 0; j < batchSize; j++)
+				{
+					const int c = b * batchSize + j;
+					p0b.row(j) = p0[c].transpose();
+					p1b.row(j) = p1[c].transpose();
+					q0b.row(j) = q0[c].coeffs().transpose();
+					stretchKsb.row(j) = stretchKs[c].transpose();
+					invMass0b[j] = invMass0[c];
+					invMass1b[j] = invMass1[c];
+					invMassq0b[j] = invMassq0[c];
+					restLengthb[j] = restLength[c];
+				}
+				CR::Vector3Batch corr0b, corr1b;
+				CR::QuaternionBatch corrq0b;
+				CR::solve_StretchShearConstraintBatch(p0b, invMass0b, p1b, invMass1b, q0b, invMassq0b,
+					stretchKsb, restLengthb, corr0b, corr1b, corrq0b);
+				for (int j = 0; j < batchSize; j++)
+				{
+					const int c = b * batchSize + j;
+					Vector3r::Map(&corr[10 * c]) = corr0b.row(j).transpose().matrix();
+					Vector3r::Map(&corr[10 * c + 3]) = corr1b.row(j).transpose().matrix();
+					Vector4r::Map(&corr[10 * c + 6]) = corrq0b.row(j).transpose().matrix();
+				}
+			}
+			time += STOP_TIMING;
+		}
+		const Real diff = relativeDifference(corr, reference, 10);
+		LOG_INFO << "Stretch-shear batches: " << time / repetitions << " ms (speedup " << timeSingle / (time / repetitions) << "), max. relative difference: " << diff;
+		if (diff > 1.0e-4)
+			result = 1;
+	}
+
+	// bend-twist constraints: corrections of q0 and q1 (4 coefficients each)
+	{
+		std::vector<Real> reference(8 * numConstraints);
+		std::vector<Real> corr(8 * numConstraints);
+
+		double time = 0.0;
+		for (int r = 0; r < repetitions; r++)
+		{
+			START_TIMING("single");
+			for (int c = 0; c < numConstraints; c++)
+			{
+				Quaternionr corrq0, corrq1;
+				CR::solve_BendTwistConstraint(q0[c], invMassq0[c], q1[c], invMassq1[c], bendKs[c], restDarboux[c], corrq0, corrq1);
+				Vector4r::Map(&reference[8 * c]) = corrq0.coeffs();
+				Vector4r::Map(&reference[8 * c + 4]) = corrq1.coeffs();
+			}
+			time += STOP_TIMING;
+		}
+		const double timeSingle = time / repetitions;
+		LOG_INFO << "Bend-twist single constraints: " << timeSingle << " ms";
+
+		time = 0.0;
+		for (int r = 0; r < repetitions; r++)
+		{
+			START_TIMING("batches");
+			for (int b = 0; b < numConstraints / batchSize; b++)
+			{
+				CR::QuaternionBatch q0b, q1b, restDarbouxb;
+				CR::Vector3Batch bendKsb;
+				CR::RealBatch invMassq0b, invMassq1b;
+				for (int j = 0; j < batchSize; j++)
+				{
+					const int c = b * batchSize + j;
+					q0b.row(j) = q0[c].coeffs().transpose();
+					q1b.row(j) = q1[c].coeffs().transpose();
+					restDarbouxb.row(j) = restDarboux[c].coeffs().transpose();
+					bendKsb.row(j) = bendKs[c].transpose();
+					invMassq0b[j] = invMassq0[c];
+					invMassq1b[j] = invMassq1[c];
+				}
+				CR::QuaternionBatch corrq0b, corrq1b;
+				CR::solve_BendTwistConstraintBatch(q0b, invMassq0b, q1b, invMassq1b, bendKsb, restDarbouxb, corrq0b, corrq1b);
+				for (int j = 0; j < batchSize; j++)
+				{
+					const int c = b * batchSize + j;
+					Vector4r::Map(&corr[8 * c]) = corrq0b.row(j).transpose().matrix();
+					Vector4r::Map(&corr[8 * c + 4]) = corrq1b.row(j).transpose().matrix();
+				}
+			}
+			time += STOP_TIMING;
+		}
+		const Real diff = relativeDifference(corr, reference, 8);
+		LOG_INFO << "Bend-twist batches: " << time / repetitions << " ms (speedup " << timeSingle / (time / repetitions) << "), max. relative difference: " << diff;
+		if (diff > 1.0e-4)
+			result = 1;
+	}
+
+	return result;
+}
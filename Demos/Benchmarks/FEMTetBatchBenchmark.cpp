@@ -0,0 +1,193 @@
+#include "Common/Common.h"
+#include "BenchmarkCommon.h"
+#include "PositionBasedDynamics/PositionBasedDynamics.h"
+#include "PositionBasedDynamics/XPBD.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+// Benchmark of the batch variants of the FEM tet constraint solvers. Independent tets
+// with a regular rest shape are deformed randomly, a part of them is inverted. The
+// corrections are determined by the solvers for single constraints and by the batch
+// solvers with the rest data in SoA layout. The corrections are compared with the ones
+// of the solvers for single constraints relative to the largest correction.
+//
+// Usage: FEMTetBatchBenchmark [numConstraints] [repetitions] [invertedFraction]
+
+using namespace PBD;
+using namespace std;
+using namespace Utilities;
+
+typedef PositionBasedDynamics FEM;
+
+const Real youngsModulus = 1.0;
+const Real poissonRatio = static_cast<Real>(0.3);
+const Real dt = static_cast<Real>(0.005);
+
+Real relativeDifference(const std::vector<Vector3r> &corr, const std::vector<Vector3r> &reference)
+{
+	Real maxDiff = 0.0;
+	Real maxCorr = 0.0;
+	for (size_t i = 0; i < corr.size(); i++)
+	{
+		maxDiff = std::max(maxDiff, (corr[i] - reference[i]).norm());
+		maxCorr = std::max(maxCorr, reference[i].norm());
+	}
+	return (maxCorr > 0.0) ? maxDiff / maxCorr : maxDiff;
+}
+
+void solveBatches(const bool xpbd, const int numConstraints, const std::vector<Vector3r> &x, const std::vector<Real> &invMass,
+	const std::vector<Real> &restData, const std::vector<Real> &handleInversion, std::vector<Vector3r> &corr)
+{
+	const int batchSize = FEM::BatchSize;
+	for (int b = 0; b < numConstraints / batchSize; b++)
+	{
+		FEM::Vector3Batch xb[4];
+		FEM::RealBatch invMassb[4], handleInversionb;
+		for (int j = 0; j < batchSize; j++)
+		{
+			const int c = b * batchSize + j;
+			for (int i = 0; i < 4; i++)
+			{
+				xb[i].row(j) = x[4 * c + i].transpose();
+				invMassb[i][j] = invMass[4 * c + i];
+			}
+			handleInversionb[j] = handleInversion[c];
+		}
+
+		// rest data of the batch in SoA layout
+		const FEM::Matrix3Batch invRestMatb = Eigen::Map<const FEM::Matrix3Batch>(&restData[10 * b * batchSize]);
+		const FEM::RealBatch restVolumeb = Eigen::Map<const FEM::RealBatch>(&restData[(10 * b + 9) * batchSize]);
+
+		FEM::Vector3Batch corrb[4];
+		if (xpbd)
+			XPBD::solve_FEMTetraConstraintBatch(xb[0], invMassb[0], xb[1], invMassb[1], xb[2], invMassb[2], xb[3], invMassb[3],
+				restVolumeb, invRestMatb, FEM::RealBatch::Constant(youngsModulus), FEM::RealBatch::Constant(poissonRatio),
+				handleInversionb, dt, FEM::RealBatch::Zero(), corrb[0], corrb[1], corrb[2], corrb[3]);
+		else
+			FEM::solve_FEMTetraConstraintBatch(xb[0], invMassb[0], xb[1], invMassb[1], xb[2], invMassb[2], xb[3], invMassb[3],
+				restVolumeb, invRestMatb, FEM::RealBatch::Constant(youngsModulus), FEM::RealBatch::Constant(poissonRatio),
+				handleInversionb, corrb[0], corrb[1], corrb[2], corrb[3]);
+
+		for (int j = 0; j < batchSize; j++)
+		{
+			const int c = b * batchSize + j;
+			for (int i = 0; i < 4; i++)
+				corr[4 * c + i] = corrb[i].row(j).transpose().matrix();
+		}
+	}
+}
+
+int runBenchmark(int argc, char **argv)
+{
+	const int batchSize = FEM::BatchSize;
+	int numConstraints = 200000;
+	if (argc > 1)
+		numConstraints = std::max(batchSize, atoi(argv[1]));
+	int repetitions = 5;
+	if (argc > 2)
+		repetitions = std::max(1, atoi(argv[2]));
+	Real invertedFraction = static_cast<Real>(0.1);
+	if (argc > 3)
+		invertedFraction = static_cast<Real>(atof(argv[3]));
+	// full batches
+	numConstraints -= numConstraints % batchSize;
+
+	// four particles per constraint, some particles are static
+	std::mt19937 gen(numConstraints);
+	std::uniform_real_distribution<Real> position(-1.0, 1.0);
+	std::uniform_real_distribution<Real> uniform(0.0, 1.0);
+	std::vector<Vector3r> x(4 * numConstraints);
+	std::vector<Real> invMass(4 * numConstraints);
+	std::vector<Real> restVolume(numConstraints);
+	std::vector<Matrix3r> invRestMat(numConstraints);
+	std::vector<Real> handleInversion(numConstraints);
+	int numInverted = 0;
+	for (int c = 0; c < numConstraints; c++)
+	{
+		// regular rest shape with a random deformation
+		Vector3r x0[4] = { Vector3r(0, 0, 0), Vector3r(1, 0, 0), Vector3r(0, 1, 0), Vector3r(0, 0, 1) };
+		Matrix3r F;
+		for (int i = 0; i < 9; i++)
+			F.data()[i] = static_cast<Real>(0.3) * position(gen);
+		F += Matrix3r::Identity();
+		for (int i = 0; i < 4; i++)
+		{
+			x[4 * c + i] = F * x0[i] + static_cast<Real>(0.1) * Vector3r(position(gen), position(gen), position(gen));
+			invMass[4 * c + i] = (uniform(gen) < 0.1) ? static_cast<Real>(0.0) : static_cast<Real>(1.0) + uniform(gen);
+		}
+		// the inverted tets have their fourth particle on the other side
+		if (uniform(gen) < invertedFraction)
+			x[4 * c + 3][2] = -x[4 * c + 3][2];
+		FEM::init_FEMTetraConstraint(x0[0], x0[1], x0[2], x0[3], restVolume[c], invRestMat[c]);
+
+		// as in FEMTetConstraint::computePositionCorrections()
+		const Vector3r &x1 = x[4 * c];
+		const Real currentVolume = -static_cast<Real>(1.0 / 6.0) * (x[4 * c + 3] - x1).dot((x[4 * c + 2] - x1).cross(x[4 * c + 1] - x1));
+		handleInversion[c] = (currentVolume / restVolume[c] < 0.2) ? static_cast<Real>(1.0) : static_cast<Real>(0.0);
+		if (currentVolume < 0.0)
+			numInverted++;
+	}
+
+	// precomputed rest data in SoA layout, a block per batch as in SimulationModel::FEMTetBatchData
+	std::vector<Real> restData(10 * numConstraints);
+	for (int c = 0; c < numConstraints; c++)
+	{
+		Real *block = &restData[10 * (c - c % batchSize)];
+		for (int k = 0; k < 9; k++)
+			block[k * batchSize + c % batchSize] = invRestMat[c].data()[k];
+		block[9 * batchSize + c % batchSize] = restVolume[c];
+	}
+
+	LOG_INFO << "FEM tet constraints: " << numConstraints << ", inverted: " << numInverted;
+
+	int result = 0;
+	const std::string names[2] = { "PBD", "XPBD" };
+	for (int method = 0; method < 2; method++)
+	{
+		const bool xpbd = (method == 1);
+		std::vector<Vector3r> reference(4 * numConstraints);
+		std::vector<Vector3r> corr(4 * numConstraints);
+
+		double time = 0.0;
+		for (int r = 0; r < repetitions; r++)
+		{
+			START_TIMING("single");
+			for (int c = 0; c < numConstraints; c++)
+			{
+				Real multiplier = 0.0;
+				const Vector3r *xc = &x[4 * c];
+				const Real *invMassc = &invMass[4 * c];
+				Vector3r *corrc = &reference[4 * c];
+				if (xpbd)
+					XPBD::solve_FEMTetraConstraint(xc[0], invMassc[0], xc[1], invMassc[1], xc[2], invMassc[2], xc[3], invMassc[3],
+						restVolume[c], invRestMat[c], youngsModulus, poissonRatio, handleInversion[c] != 0.0, dt, multiplier,
+						corrc[0], corrc[1], corrc[2], corrc[3]);
+				else
+					FEM::solve_FEMTetraConstraint(xc[0], invMassc[0], xc[1], invMassc[1], xc[2], invMassc[2], xc[3], invMassc[3],
+						restVolume[c], invRestMat[c], youngsModulus, poissonRatio, handleInversion[c] != 0.0,
+						corrc[0], corrc[1], corrc[2], corrc[3]);
+			}
+			time += STOP_TIMING;
+		}
+		const double timeSingle = time / repetitions;
+		LOG_INFO << names[method] << " single constraints: " << timeSingle << " ms";
+
+		time = 0.0;
+		for (int r = 0; r < repetitions; r++)
+		{
+			START_TIMING("batches");
+			solveBatches(xpbd, numConstraints, x, invMass, restData, handleInversion, corr);
+			time += STOP_TIMING;
+		}
+		const Real diff = relativeDifference(corr, reference);
+		LOG_INFO << names[method] << " batches: " << time / repetitions << " ms (speedup " << timeSingle / (time / repetitions) << "), max. relative difference: " << diff;
+		if (diff > 1.0e-3)
+			result = 1;
+	}
+
+	return result;
+}
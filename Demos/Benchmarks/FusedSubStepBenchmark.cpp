@@ -0,0 +1,80 @@
+#include "Common/Common.h"
+#include "BenchmarkCommon.h"
+#include "Simulation/Simulation.h"
+#include "Simulation/SimulationModel.h"
+#include "Simulation/TimeStepController.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing.h"
+#include <string>
+#include <vector>
+
+// Benchmark of the fused sub steps. A cloth with XPBD distance and bending constraints
+// is simulated with many sub steps and one iteration (small step XPBD). The sub steps
+// are performed one after another and fused in one parallel region. The results of
+// both runs must be identical.
+//
+// Usage: FusedSubStepBenchmark [numSteps] [subSteps] [resolution]
+
+using namespace PBD;
+using namespace std;
+using namespace Utilities;
+
+double runScene(const bool fused, const unsigned int numSteps, const unsigned int subSteps, const int resolution, std::vector<Vector3r> &x)
+{
+	SimulationModel model;
+	model.init();
+	Simulation sim;
+	sim.init();
+	sim.setModel(&model);
+	sim.makeCurrent();
+
+	model.addRegularTriangleModel(resolution, resolution);
+	// XPBD distance constraints and isometric bending
+	model.addClothConstraints(model.getTriangleModels()[0], 4, 1.0, 1.0, 1.0, 1.0,
+		static_cast<Real>(0.3), static_cast<Real>(0.3), false, false);
+	model.addBendingConstraints(model.getTriangleModels()[0], 3, static_cast<Real>(0.01));
+	ParticleData &pd = model.getParticles();
+	pd.setMass(0, 0.0);
+	pd.setMass(resolution - 1, 0.0);
+
+	TimeStepController *tsc = static_cast<TimeStepController*>(sim.getTimeStep());
+	tsc->setValue<unsigned int>(TimeStepController::NUM_SUB_STEPS, subSteps);
+	tsc->setValue<unsigned int>(TimeStepController::MAX_ITERATIONS, 1);
+	tsc->setValue<bool>(TimeStepController::FUSED_SUB_STEPS, fused);
+
+	START_TIMING("steps");
+	for (unsigned int s = 0; s < numSteps; s++)
+		tsc->step(model);
+	const double time = STOP_TIMING;
+
+	x = pd.getVertices();
+	return time;
+}
+
+int runBenchmark(int argc, char **argv)
+{
+	unsigned int numSteps = 100;
+	unsigned int subSteps = 20;
+	int resolution = 50;
+	if (argc > 1)
+		numSteps = std::max(1, atoi(argv[1]));
+	if (argc > 2)
+		subSteps = std::max(1, atoi(argv[2]));
+	if (argc > 3)
+		resolution = std::max(2, atoi(argv[3]));
+
+	std::vector<Vector3r> reference;
+	std::vector<Vector3r> x;
+	const double timeSequential = runScene(false, numSteps, subSteps, resolution, reference);
+	const double timeFused = runScene(true, numSteps, subSteps, resolution, x);
+
+	Real maxDiff = 0.0;
+	for (size_t i = 0; i < x.size(); i++)
+		maxDiff = std::max(maxDiff, (x[i] - reference[i]).norm());
+
+	LOG_INFO << "Steps: " << numSteps << ", sub steps: " << subSteps << ", particles: " << resolution * resolution;
+	LOG_INFO << "sub steps: " << timeSequential / numSteps << " ms per step";
+	LOG_INFO << "fused sub steps: " << timeFused / numSteps << " ms per step (speedup " << timeSequential / timeFused << "), max. difference: " << maxDiff;
+
+	return (maxDiff == 0.0) ? 0 : 1;
+}
@@ -0,0 +1,223 @@
+#include "Common/Common.h"
+#include "BenchmarkCommon.h"
+#include "PositionBasedDynamics/PositionBasedDynamics.h"
+#include "PositionBasedDynamics/PositionBasedGenericConstraints.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+// Benchmark of the generic constraint solvers. Independent distance constraints with
+// random particle positions are solved by the hand-written distance constraint, the
+// generic solver with callbacks (known gradient and finite differences) and the generic
+// solver with inlined function objects (known gradient, automatic differentiation and
+// batches). The corrections are compared with the ones of the hand-written solver.
+//
+// Usage: GenericConstraintsBenchmark [numConstraints] [repetitions]
+
+using namespace PBD;
+using namespace std;
+using namespace Utilities;
+
+typedef PositionBasedGenericConstraints GC;
+
+void distanceConstraintFct(
+	const unsigned int numberOfParticles,
+	const Real invMass[],
+	const Vector3r x[],
+	void *userData,
+	Eigen::Matrix<Real, 1, 1> &constraintValue)
+{
+	const Real restLength = *(Real*)userData;
+	constraintValue(0, 0) = (x[1] - x[0]).norm() - restLength;
+}
+
+void distanceGradientFct(
+	const unsigned int i,
+	const unsigned int numberOfParticles,
+	const Real invMass[],
+	const Vector3r x[],
+	void *userData,
+	Eigen::Matrix<Real, 1, 3> &jacobian)
+{
+	jacobian = (x[i] - x[1 - i]).normalized().transpose();
+}
+
+struct DistanceConstraintFct
+{
+	Real m_restLength;
+
+	void operator()(const Vector3r x[], Eigen::Matrix<Real, 1, 1> &constraintValue) const
+	{
+		constraintValue(0, 0) = (x[1] - x[0]).norm() - m_restLength;
+	}
+};
+
+struct DistanceGradientFct
+{
+	void operator()(const unsigned int i, const Vector3r x[], Eigen::Matrix<Real, 1, 3> &jacobian) const
+	{
+		jacobian = (x[i] - x[1 - i]).normalized().transpose();
+	}
+};
+
+/** Distance constraint for the automatic differentiation */
+struct DistanceConstraintFctAD
+{
+	Real m_restLength;
+
+	template<typename Scalar>
+	void operator()(const Eigen::Matrix<Scalar, 3, 1> x[], Eigen::Matrix<Scalar, 1, 1> &constraintValue) const
+	{
+		constraintValue(0, 0) = (x[1] - x[0]).norm() - m_restLength;
+	}
+};
+
+Real maxDifference(const std::vector<Vector3r> &corr, const std::vector<Vector3r> &reference)
+{
+	Real maxDiff = 0.0;
+	for (size_t i = 0; i < corr.size(); i++)
+		maxDiff = std::max(maxDiff, (corr[i] - reference[i]).norm());
+	return maxDiff;
+}
+
+int runBenchmark(int argc, char **argv)
+{
+	const int batchSize = GC::BatchSize;
+	int numConstraints = 1000000;
+	if (argc > 1)
+		numConstraints = std::max(batchSize, atoi(argv[1]));
+	int repetitions = 5;
+	if (argc > 2)
+		repetitions = std::max(1, atoi(argv[2]));
+	// full batches
+	numConstraints -= numConstraints % batchSize;
+
+	// two particles per constraint, some particles are static
+	std::mt19937 gen(numConstraints);
+	std::uniform_real_distribution<Real> position(-1.0, 1.0);
+	std::uniform_real_distribution<Real> uniform(0.0, 1.0);
+	std::vector<Vector3r> x(2 * numConstraints);
+	std::vector<Real> invMass(2 * numConstraints);
+	std::vector<Real> restLength(numConstraints);
+	for (int c = 0; c < numConstraints; c++)
+	{
+		for (int i = 0; i < 2; i++)
+		{
+			x[2 * c + i] = Vector3r(position(gen), position(gen), position(gen));
+			invMass[2 * c + i] = (uniform(gen) < 0.1) ? static_cast<Real>(0.0) : static_cast<Real>(1.0) + uniform(gen);
+		}
+		restLength[c] = uniform(gen);
+	}
+
+	// the corrections of constraints between static particles stay zero
+	std::vector<Vector3r> reference(2 * numConstraints, Vector3r::Zero());
+	std::vector<Vector3r> corr(2 * numConstraints);
+
+	double time = 0.0;
+	for (int r = 0; r < repetitions; r++)
+	{
+		START_TIMING("hand-written");
+		for (int c = 0; c < numConstraints; c++)
+			PositionBasedDynamics::solve_DistanceConstraint(x[2 * c], invMass[2 * c], x[2 * c + 1], invMass[2 * c + 1],
+				restLength[c], 1.0, reference[2 * c], reference[2 * c + 1]);
+		time += STOP_TIMING;
+	}
+	LOG_INFO << "Distance constraints: " << numConstraints;
+	LOG_INFO << "hand-written: " << time / repetitions << " ms";
+	const double timeHandWritten = time / repetitions;
+
+	std::fill(corr.begin(), corr.end(), Vector3r::Zero());
+	time = 0.0;
+	for (int r = 0; r < repetitions; r++)
+	{
+		START_TIMING("callbacks");
+		for (int c = 0; c < numConstraints; c++)
+			GC::solve_GenericConstraint<2, 1>(&invMass[2 * c], &x[2 * c], &restLength[c], distanceConstraintFct, distanceGradientFct, &corr[2 * c]);
+		time += STOP_TIMING;
+	}
+	LOG_INFO << "callbacks: " << time / repetitions << " ms (" << time / repetitions / timeHandWritten << "x), max. difference: " << maxDifference(corr, reference);
+
+	std::fill(corr.begin(), corr.end(), Vector3r::Zero());
+	time = 0.0;
+	for (int r = 0; r < repetitions; r++)
+	{
+		START_TIMING("callbacks (finite differences)");
+		for (int c = 0; c < numConstraints; c++)
+			GC::solve_GenericConstraint<2, 1>(&invMass[2 * c], &x[2 * c], &restLength[c], distanceConstraintFct, &corr[2 * c]);
+		time += STOP_TIMING;
+	}
+	LOG_INFO << "callbacks (finite differences): " << time / repetitions << " ms (" << time / repetitions / timeHandWritten << "x), max. difference: " << maxDifference(corr, reference);
+
+	std::fill(corr.begin(), corr.end(), Vector3r::Zero());
+	time = 0.0;
+	for (int r = 0; r < repetitions; r++)
+	{
+		START_TIMING("function objects");
+		for (int c = 0; c < numConstraints; c++)
+		{
+			DistanceConstraintFct constraintFct;
+			constraintFct.m_restLength = restLength[c];
+			GC::solve_GenericConstraint_Functor<2, 1>(&invMass[2 * c], &x[2 * c], constraintFct, DistanceGradientFct(), &corr[2 * c]);
+		}
+		time += STOP_TIMING;
+	}
+	LOG_INFO << "function objects: " << time / repetitions << " ms (" << time / repetitions / timeHandWritten << "x), max. difference: " << maxDifference(corr, reference);
+
+	std::fill(corr.begin(), corr.end(), Vector3r::Zero());
+	time = 0.0;
+	for (int r = 0; r < repetitions; r++)
+	{
+		START_TIMING("function objects (automatic differentiation)");
+		for (int c = 0; c < numConstraints; c++)
+		{
+			DistanceConstraintFctAD constraintFct;
+			constraintFct.m_restLength = restLength[c];
+			GC::solve_GenericConstraint_Functor<2, 1>(&invMass[2 * c], &x[2 * c], constraintFct, &corr[2 * c]);
+		}
+		time += STOP_TIMING;
+	}
+	LOG_INFO << "function objects (automatic differentiation): " << time / repetitions << " ms (" << time / repetitions / timeHandWritten << "x), max. difference: " << maxDifference(corr, reference);
+
+	std::fill(corr.begin(), corr.end(), Vector3r::Zero());
+	time = 0.0;
+	for (int r = 0; r < repetitions; r++)
+	{
+		START_TIMING("function objects (batches)");
+		for (int b = 0; b < numConstraints / batchSize; b++)
+		{
+			GC::Vector3Batch xb[2];
+			GC::RealBatch invMassb[2];
+			DistanceConstraintFct constraintFct[GC::BatchSize];
+			DistanceGradientFct gradientFct[GC::BatchSize];
+			for (int j = 0; j < batchSize; j++)
+			{
+				const int c = b * batchSize + j;
+				for (int i = 0; i < 2; i++)
+				{
+					xb[i].row(j) = x[2 * c + i].transpose();
+					invMassb[i][j] = invMass[2 * c + i];
+				}
+				constraintFct[j].m_restLength = restLength[c];
+			}
+
+			GC::Vector3Batch corrb[2];
+			GC::RealBatch valid;
+			GC::solve_GenericConstraintBatch<2, 1>(invMassb, xb, constraintFct, gradientFct, corrb, valid);
+
+			for (int j = 0; j < batchSize; j++)
+			{
+				const int c = b * batchSize + j;
+				for (int i = 0; i < 2; i++)
+					corr[2 * c + i] = corrb[i].row(j).transpose().matrix();
+			}
+		}
+		time += STOP_TIMING;
+	}
+	const Real maxDiffBatch = maxDifference(corr, reference);
+	LOG_INFO << "function objects (batches): " << time / repetitions << " ms (" << time / repetitions / timeHandWritten << "x), max. difference: " << maxDiffBatch;
+
+	return (maxDiffBatch < 1.0e-4) ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+#include "Common/Common.h"
+#include "BenchmarkCommon.h"
+#include "Simulation/Simulation.h"
+#include "Simulation/SimulationModel.h"
+#include "Simulation/TimeStepController.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing.h"
+#include <string>
+
+// Benchmark of the Jacobi solver. A bar with FEM tet constraints which is fixed at one
+// end bends under gravity. The tet constraints need many constraint groups, so the
+// colored Gauss-Seidel solver has one synchronization per group and iteration while
+// the Jacobi solver has only one per iteration. The Jacobi solver converges slower,
+// so it is also run with more iterations. The displacement of the free end of the bar
+// shows the stiffness which is reached by the solvers.
+//
+// Usage: JacobiSolverBenchmark [numSteps] [iterations] [jacobiIterationFactor] [relaxation]
+
+using namespace PBD;
+using namespace std;
+using namespace Utilities;
+
+const int width = 30;
+const int height = 5;
+const int depth = 5;
+
+void runScene(const int solverMethod, const std::string &methodName, const unsigned int numSteps,
+	const unsigned int iterations, const Real relaxation)
+{
+	SimulationModel model;
+	model.init();
+	Simulation sim;
+	sim.init();
+	sim.setModel(&model);
+	sim.makeCurrent();
+
+	model.addRegularTetModel(width, height, depth, Vector3r(5, 0, 0), Matrix3r::Identity(), Vector3r(10.0, 1.5, 1.5));
+	// FEM based PBD
+	model.addSolidConstraints(model.getTetModels()[0], 2, 1.0, static_cast<Real>(0.3), 1.0, false, false);
+	ParticleData &pd = model.getParticles();
+	for (int j = 0; j < height; j++)
+	{
+		for (int k = 0; k < depth; k++)
+			pd.setMass(j*depth + k, 0.0);
+	}
+	model.setValue<int>(SimulationModel::SOLVER_METHOD, solverMethod);
+	model.setValue<Real>(SimulationModel::JACOBI_RELAXATION, relaxation);
+
+	TimeStepController *tsc = static_cast<TimeStepController*>(sim.getTimeStep());
+	tsc->setValue<unsigned int>(TimeStepController::MAX_ITERATIONS, iterations);
+
+	START_TIMING("steps");
+	for (unsigned int s = 0; s < numSteps; s++)
+		tsc->step(model);
+	const double time = STOP_TIMING;
+
+	// average displacement of the particles at the free end
+	Real displacement = 0.0;
+	const unsigned int numEndParticles = height * depth;
+	for (unsigned int i = pd.size() - numEndParticles; i < pd.size(); i++)
+		displacement += (pd.getPosition(i) - pd.getPosition0(i)).norm();
+	displacement /= static_cast<Real>(numEndParticles);
+
+	LOG_INFO << methodName << " (" << iterations << " iterations): " << time / numSteps << " ms per step, displacement of the free end: " << displacement;
+}
+
+int runBenchmark(int argc, char **argv)
+{
+	unsigned int numSteps = 100;
+	unsigned int iterations = 5;
+	unsigned int jacobiIterationFactor = 4;
+	Real relaxation = static_cast<Real>(1.5);
+	if (argc > 1)
+		numSteps = std::max(1, atoi(argv[1]));
+	if (argc > 2)
+		iterations = std::max(1, atoi(argv[2]));
+	if (argc > 3)
+		jacobiIterationFactor = std::max(1, atoi(argv[3]));
+	if (argc > 4)
+		relaxation = static_cast<Real>(atof(argv[4]));
+
+	{
+		SimulationModel model;
+		model.init();
+		model.addRegularTetModel(width, height, depth, Vector3r(5, 0, 0), Matrix3r::Identity(), Vector3r(10.0, 1.5, 1.5));
+		model.addSolidConstraints(model.getTetModels()[0], 2, 1.0, static_cast<Real>(0.3), 1.0, false, false);
+		model.initConstraintGroups();
+		LOG_INFO << "Steps: " << numSteps << ", particles: " << model.getParticles().size() << ", constraints: " << model.getConstraints().size()
+			<< ", constraint groups: " << model.getConstraintGroups().size() << ", relaxation: " << relaxation;
+	}
+
+	runScene(0, "Gauss-Seidel", numSteps, iterations, relaxation);
+	runScene(1, "Jacobi", numSteps, iterations, relaxation);
+	runScene(1, "Jacobi", numSteps, jacobiIterationFactor * iterations, relaxation);
+
+	return 0;
+}
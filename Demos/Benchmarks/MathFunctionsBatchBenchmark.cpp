@@ -0,0 +1,349 @@
+#include "Common/Common.h"
+#include "BenchmarkCommon.h"
+#include "PositionBasedDynamics/MathFunctions.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+// Benchmark of the batch variants of the 3x3 matrix decompositions in MathFunctions.
+// The eigen decomposition, the SVD, the polar decomposition and the rotation extraction
+// are determined for random matrices by the scalar functions and by the batch functions.
+// The accuracy of the batch functions is checked by the reconstruction errors and by
+// the differences to the scalar functions. The rotation extraction is performed for a
+// sequence of rotating matrices with and without a warm start by the rotations of the
+// last frame.
+//
+// Usage: MathFunctionsBatchBenchmark [numMatrices] [repetitions] [numFrames]
+
+using namespace PBD;
+using namespace std;
+using namespace Utilities;
+
+typedef MathFunctions MF;
+
+const Real tolerance = static_cast<Real>(1.0e-3);
+const unsigned int maxIter = 20;
+
+void gatherBatch(const std::vector<Matrix3r> &A, const int b, MF::Matrix3Batch &Ab)
+{
+	for (int j = 0; j < MF::BatchSize; j++)
+		for (int k = 0; k < 9; k++)
+			Ab(j, k) = A[b * MF::BatchSize + j].data()[k];
+}
+
+void scatterBatch(const MF::Matrix3Batch &Ab, const int b, std::vector<Matrix3r> &A)
+{
+	for (int j = 0; j < MF::BatchSize; j++)
+		for (int k = 0; k < 9; k++)
+			A[b * MF::BatchSize + j].data()[k] = Ab(j, k);
+}
+
+void scatterBatch(const MF::Vector3Batch &vb, const int b, std::vector<Vector3r> &v)
+{
+	for (int j = 0; j < MF::BatchSize; j++)
+		v[b * MF::BatchSize + j] = vb.row(j).transpose().matrix();
+}
+
+Real maxDifference(const std::vector<Matrix3r> &A, const std::vector<Matrix3r> &B)
+{
+	Real maxDiff = 0.0;
+	for (size_t i = 0; i < A.size(); i++)
+		maxDiff = std::max(maxDiff, (A[i] - B[i]).norm());
+	return maxDiff;
+}
+
+Real maxOrthogonalityError(const std::vector<Matrix3r> &R)
+{
+	Real maxError = 0.0;
+	for (size_t i = 0; i < R.size(); i++)
+		maxError = std::max(maxError, (R[i].transpose() * R[i] - Matrix3r::Identity()).norm());
+	return maxError;
+}
+
+/** Maximum error of A = U diag(sigma) V^T relative to the norm of A */
+Real maxReconstructionError(const std::vector<Matrix3r> &A, const std::vector<Matrix3r> &U, const std::vector<Vector3r> &sigma, const std::vector<Matrix3r> &VT)
+{
+	Real maxError = 0.0;
+	for (size_t i = 0; i < A.size(); i++)
+		maxError = std::max(maxError, (U[i] * sigma[i].asDiagonal() * VT[i] - A[i]).norm() / A[i].norm());
+	return maxError;
+}
+
+bool benchmarkEigenDecomposition(const std::vector<Matrix3r> &M, const int repetitions)
+{
+	const int numMatrices = (int)M.size();
+	std::vector<Matrix3r> A(numMatrices);
+	for (int i = 0; i < numMatrices; i++)
+		A[i] = M[i] + M[i].transpose();
+
+	std::vector<Matrix3r> V(numMatrices), VT(numMatrices), Vb(numMatrices), VbT(numMatrices);
+	std::vector<Vector3r> lambda(numMatrices), lambdab(numMatrices);
+
+	double timeSingle = 0.0;
+	double timeBatch = 0.0;
+	for (int r = 0; r < repetitions; r++)
+	{
+		START_TIMING("single");
+		for (int i = 0; i < numMatrices; i++)
+			MF::eigenDecomposition(A[i], V[i], lambda[i]);
+		timeSingle += STOP_TIMING;
+
+		START_TIMING("batches");
+		for (int b = 0; b < numMatrices / MF::BatchSize; b++)
+		{
+			MF::Matrix3Batch Ab, eigenVecs;
+			MF::Vector3Batch eigenVals;
+			gatherBatch(A, b, Ab);
+			MF::eigenDecompositionBatch(Ab, eigenVecs, eigenVals);
+			scatterBatch(eigenVecs, b, Vb);
+			scatterBatch(eigenVals, b, lambdab);
+		}
+		timeBatch += STOP_TIMING;
+	}
+	for (int i = 0; i < numMatrices; i++)
+	{
+		VT[i] = V[i].transpose();
+		VbT[i] = Vb[i].transpose();
+	}
+
+	// eigenvalues in increasing order relative to the norm of the matrix
+	Real maxDiff = 0.0;
+	for (int i = 0; i < numMatrices; i++)
+	{
+		Vector3r l = lambda[i];
+		Vector3r lb = lambdab[i];
+		std::sort(l.data(), l.data() + 3);
+		std::sort(lb.data(), lb.data() + 3);
+		maxDiff = std::max(maxDiff, (l - lb).norm() / A[i].norm());
+	}
+	const Real error = maxReconstructionError(A, V, lambda, VT);
+	const Real errorBatch = maxReconstructionError(A, Vb, lambdab, VbT);
+
+	LOG_INFO << "eigenDecomposition: " << timeSingle / repetitions << " ms, batches: " << timeBatch / repetitions << " ms (speedup " << timeSingle / timeBatch << ")";
+	LOG_INFO << "  reconstruction error: " << error << ", batches: " << errorBatch << ", max. relative difference of the eigenvalues: " << maxDiff;
+	return (errorBatch < tolerance) && (maxDiff < tolerance);
+}
+
+bool benchmarkSVD(const std::vector<Matrix3r> &F, const int repetitions)
+{
+	const int numMatrices = (int)F.size();
+	std::vector<Matrix3r> U(numMatrices), VT(numMatrices), Ub(numMatrices), Vb(numMatrices), VbT(numMatrices);
+	std::vector<Vector3r> sigma(numMatrices), sigmab(numMatrices);
+
+	double timeSingle = 0.0;
+	double timeBatch = 0.0;
+	for (int r = 0; r < repetitions; r++)
+	{
+		START_TIMING("single");
+		for (int i = 0; i < numMatrices; i++)
+			MF::svdWithInversionHandling(F[i], sigma[i], U[i], VT[i]);
+		timeSingle += STOP_TIMING;
+
+		START_TIMING("batches");
+		for (int b = 0; b < numMatrices / MF::BatchSize; b++)
+		{
+			MF::Matrix3Batch Fb, Ubatch, Vbatch;
+			MF::Vector3Batch sigmaBatch;
+			gatherBatch(F, b, Fb);
+			MF::svdWithInversionHandlingBatch(Fb, sigmaBatch, Ubatch, Vbatch);
+			scatterBatch(Ubatch, b, Ub);
+			scatterBatch(Vbatch, b, Vb);
+			scatterBatch(sigmaBatch, b, sigmab);
+		}
+		timeBatch += STOP_TIMING;
+	}
+	for (int i = 0; i < numMatrices; i++)
+		VbT[i] = Vb[i].transpose();
+
+	const Real error = maxReconstructionError(F, U, sigma, VT);
+	const Real errorBatch = maxReconstructionError(F, Ub, sigmab, VbT);
+	const Real orthogonalityError = std::max(maxOrthogonalityError(Ub), maxOrthogonalityError(Vb));
+
+	LOG_INFO << "svdWithInversionHandling: " << timeSingle / repetitions << " ms, batches: " << timeBatch / repetitions << " ms (speedup " << timeSingle / timeBatch << ")";
+	LOG_INFO << "  reconstruction error: " << error << ", batches: " << errorBatch << ", orthogonality error of the batches: " << orthogonalityError;
+	return (errorBatch < tolerance) && (orthogonalityError < tolerance);
+}
+
+bool benchmarkPolarDecomposition(const std::vector<Matrix3r> &F, const int repetitions)
+{
+	const int numMatrices = (int)F.size();
+	std::vector<Matrix3r> R(numMatrices), RStable(numMatrices), Rb(numMatrices);
+
+	double timeSingle = 0.0;
+	double timeStable = 0.0;
+	double timeBatch = 0.0;
+	for (int r = 0; r < repetitions; r++)
+	{
+		START_TIMING("single");
+		for (int i = 0; i < numMatrices; i++)
+		{
+			Matrix3r U, D;
+			MF::polarDecomposition(F[i], R[i], U, D);
+		}
+		timeSingle += STOP_TIMING;
+
+		START_TIMING("stable");
+		for (int i = 0; i < numMatrices; i++)
+			MF::polarDecompositionStable(F[i], static_cast<Real>(1.0e-6), RStable[i]);
+		timeStable += STOP_TIMING;
+
+		START_TIMING("batches");
+		for (int b = 0; b < numMatrices / MF::BatchSize; b++)
+		{
+			MF::Matrix3Batch Fb, Rbatch;
+			gatherBatch(F, b, Fb);
+			MF::polarDecompositionStableBatch(Fb, Rbatch);
+			scatterBatch(Rbatch, b, Rb);
+		}
+		timeBatch += STOP_TIMING;
+	}
+
+	const Real diff = maxDifference(Rb, R);
+	const Real diffStable = maxDifference(Rb, RStable);
+	const Real orthogonalityError = maxOrthogonalityError(Rb);
+
+	LOG_INFO << "polarDecomposition: " << timeSingle / repetitions << " ms, polarDecompositionStable: " << timeStable / repetitions
+		<< " ms, batches: " << timeBatch / repetitions << " ms (speedup " << timeSingle / timeBatch << ", " << timeStable / timeBatch << ")";
+	LOG_INFO << "  max. difference of the rotations: " << diff << ", to the stable variant: " << diffStable << ", orthogonality error of the batches: " << orthogonalityError;
+	return (diffStable < tolerance) && (orthogonalityError < tolerance);
+}
+
+bool benchmarkExtractRotation(const std::vector<std::vector<Matrix3r> > &frames, const std::vector<Matrix3r> &RPolar, const int repetitions)
+{
+	const int numMatrices = (int)frames[0].size();
+	const int numFrames = (int)frames.size();
+	bool result = true;
+	for (int warmStart = 0; warmStart < 2; warmStart++)
+	{
+		std::vector<Quaternionr> q(numMatrices), qb(numMatrices);
+
+		double timeSingle = 0.0;
+		double timeBatch = 0.0;
+		for (int r = 0; r < repetitions; r++)
+		{
+			for (int i = 0; i < numMatrices; i++)
+				q[i].setIdentity();
+			START_TIMING("single");
+			for (int f = 0; f < numFrames; f++)
+			{
+				for (int i = 0; i < numMatrices; i++)
+				{
+					if (!warmStart)
+						q[i].setIdentity();
+					MF::extractRotation(frames[f][i], q[i], maxIter);
+				}
+			}
+			timeSingle += STOP_TIMING;
+
+			for (int i = 0; i < numMatrices; i++)
+				qb[i].setIdentity();
+			START_TIMING("batches");
+			for (int f = 0; f < numFrames; f++)
+			{
+				for (int b = 0; b < numMatrices / MF::BatchSize; b++)
+				{
+					MF::Matrix3Batch Ab;
+					MF::QuaternionBatch qBatch;
+					gatherBatch(frames[f], b, Ab);
+					for (int j = 0; j < MF::BatchSize; j++)
+					{
+						Quaternionr &qi = qb[b * MF::BatchSize + j];
+						if (!warmStart)
+							qi.setIdentity();
+						qBatch.row(j) = qi.coeffs().transpose();
+					}
+					MF::extractRotationBatch(Ab, qBatch, maxIter);
+					for (int j = 0; j < MF::BatchSize; j++)
+						qb[b * MF::BatchSize + j].coeffs() = qBatch.row(j).transpose().matrix();
+				}
+			}
+			timeBatch += STOP_TIMING;
+		}
+
+		// rotations of the last frame
+		std::vector<Matrix3r> R(numMatrices), Rb(numMatrices);
+		for (int i = 0; i < numMatrices; i++)
+		{
+			R[i] = q[i].matrix();
+			Rb[i] = qb[i].matrix();
+		}
+		const Real diff = maxDifference(Rb, R);
+		const Real diffPolar = maxDifference(R, RPolar);
+		const Real diffPolarBatch = maxDifference(Rb, RPolar);
+
+		const std::string name = warmStart ? "warm start" : "cold start";
+		LOG_INFO << "extractRotation, " << name << ": " << timeSingle / repetitions << " ms, batches: " << timeBatch / repetitions << " ms (speedup " << timeSingle / timeBatch << ")";
+		LOG_INFO << "  max. difference to the polar decomposition: " << diffPolar << ", batches: " << diffPolarBatch << ", max. difference of the rotations: " << diff;
+		// The batches must be as accurate as the scalar function. Without a warm start large
+		// rotations do not converge within maxIter iterations, so only the warm start is checked.
+		if (warmStart)
+			result = result && (diffPolarBatch < diffPolar + tolerance);
+	}
+	return result;
+}
+
+int runBenchmark(int argc, char **argv)
+{
+	const int batchSize = MF::BatchSize;
+	int numMatrices = 100000;
+	if (argc > 1)
+		numMatrices = std::max(batchSize, atoi(argv[1]));
+	int repetitions = 5;
+	if (argc > 2)
+		repetitions = std::max(1, atoi(argv[2]));
+	int numFrames = 10;
+	if (argc > 3)
+		numFrames = std::max(1, atoi(argv[3]));
+	// full batches
+	numMatrices -= numMatrices % batchSize;
+
+	std::mt19937 gen(numMatrices);
+	std::uniform_real_distribution<Real> uniform(-1.0, 1.0);
+
+	// random matrices and deformation gradients, a tenth of them is inverted
+	std::vector<Matrix3r> M(numMatrices), F(numMatrices), FPositive(numMatrices);
+	for (int i = 0; i < numMatrices; i++)
+	{
+		for (int k = 0; k < 9; k++)
+		{
+			M[i].data()[k] = uniform(gen);
+			F[i].data()[k] = static_cast<Real>(0.5) * uniform(gen);
+		}
+		F[i] += Matrix3r::Identity();
+		if (F[i].determinant() < 0.0)
+			F[i].col(2) = -F[i].col(2);
+		FPositive[i] = F[i];
+		if (i % 10 == 0)
+			F[i].col(2) = -F[i].col(2);
+	}
+
+	// rotating matrices with a constant stretch, the rotations of the last frame are
+	// determined by the polar decomposition
+	std::vector<std::vector<Matrix3r> > frames(numFrames, std::vector<Matrix3r>(numMatrices));
+	std::vector<Matrix3r> RPolar(numMatrices);
+	for (int i = 0; i < numMatrices; i++)
+	{
+		const Vector3r axis = Vector3r(uniform(gen), uniform(gen), uniform(gen)).normalized();
+		const Real angle = static_cast<Real>(M_PI) * uniform(gen);
+		Matrix3r S;
+		for (int k = 0; k < 9; k++)
+			S.data()[k] = static_cast<Real>(0.1) * uniform(gen);
+		S = Matrix3r::Identity() + S + S.transpose();
+		for (int f = 0; f < numFrames; f++)
+			frames[f][i] = AngleAxisr(angle + static_cast<Real>(0.05) * f, axis).toRotationMatrix() * S;
+		MF::polarDecompositionStable(frames[numFrames - 1][i], static_cast<Real>(1.0e-6), RPolar[i]);
+	}
+
+	LOG_INFO << "Matrices: " << numMatrices << ", repetitions: " << repetitions << ", frames: " << numFrames;
+
+	bool result = true;
+	result = benchmarkEigenDecomposition(M, repetitions) && result;
+	result = benchmarkSVD(F, repetitions) && result;
+	result = benchmarkPolarDecomposition(FPositive, repetitions) && result;
+	result = benchmarkExtractRotation(frames, RPolar, repetitions) && result;
+
+	return result ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+#include "Common/Common.h"
+#include "BenchmarkCommon.h"
+#include "Simulation/CubicSDFCollisionDetection.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing.h"
+#include <random>
+#include <string>
+
+// Benchmark of the distance field queries of CubicSDFCollisionObject. The signed
+// distance field of a torus is sampled on a cubic grid. Clusters of points close
+// to the surface (similar to the vertices in the leaves of a BVH) are tested with
+// the double precision collisionTest() and with the single precision
+// collisionTestBatch(). The results of both are compared. Finally, a narrow band
+// of the field is saved, memory mapped and compared with the dense field.
+//
+// Usage: SDFQueryBenchmark [resolution] [numClusters] [bandWidth]
+
+using namespace PBD;
+using namespace std;
+using namespace Utilities;
+
+const unsigned int clusterSize = 10;
+
+double torusDistance(const Eigen::Vector3d &x)
+{
+	const Eigen::Vector2d q(Eigen::Vector2d(x[0], x[2]).norm() - 1.0, x[1]);
+	return q.norm() - 0.3;
+}
+
+int runBenchmark(int argc, char **argv)
+{
+	unsigned int resolution = 50;
+	unsigned int numClusters = 100000;
+	if (argc > 1)
+		resolution = std::max(4, atoi(argv[1]));
+	if (argc > 2)
+		numClusters = std::max(1, atoi(argv[2]));
+	float bandWidth = 0.1f;
+	if (argc > 3)
+		bandWidth = static_cast<float>(atof(argv[3]));
+
+	const Eigen::AlignedBox3d domain(Eigen::Vector3d(-1.5, -0.5, -1.5), Eigen::Vector3d(1.5, 0.5, 1.5));
+	CubicSDFCollisionDetection::GridPtr sdf = std::make_shared<CubicSDFCollisionDetection::Grid>(domain,
+		std::array<unsigned int, 3>({ resolution, std::max(4u, resolution / 3), resolution }));
+	START_TIMING("generate SDF");
+	sdf->addFunction(torusDistance);
+	const double timeGenerate = STOP_TIMING;
+
+	CubicSDFCollisionDetection cd;
+	const Vector3r vertex(0.0, 0.0, 0.0);
+	START_TIMING("single precision copy");
+	cd.addCubicSDFCollisionObject(0, CollisionDetection::CollisionObject::RigidBodyCollisionObjectType, &vertex, 1, sdf, Vector3r(1.0, 1.0, 1.0), true, false, true);
+	const double timeCopy = STOP_TIMING;
+	CubicSDFCollisionDetection::CubicSDFCollisionObject *co = (CubicSDFCollisionDetection::CubicSDFCollisionObject*)cd.getCollisionObjects()[0];
+
+	// clusters of points close to the surface
+	std::mt19937 gen(resolution);
+	std::uniform_real_distribution<Real> angle(0.0, static_cast<Real>(2.0 * M_PI));
+	std::uniform_real_distribution<Real> offset(static_cast<Real>(-0.02), static_cast<Real>(0.02));
+	std::vector<Vector3r> points(numClusters * clusterSize);
+	for (unsigned int c = 0; c < numClusters; c++)
+	{
+		const Real phi = angle(gen);
+		const Real theta = angle(gen);
+		const Vector3r center((static_cast<Real>(1.0) + static_cast<Real>(0.3) * cos(theta)) * cos(phi), static_cast<Real>(0.3) * sin(theta),
+			(static_cast<Real>(1.0) + static_cast<Real>(0.3) * cos(theta)) * sin(phi));
+		for (unsigned int i = 0; i < clusterSize; i++)
+			points[c * clusterSize + i] = center + Vector3r(offset(gen), offset(gen), offset(gen));
+	}
+
+	const Real tolerance = static_cast<Real>(0.01);
+	std::vector<unsigned char> contact(points.size(), 0);
+	std::vector<Real> refDist(points.size());
+	std::vector<Vector3r> refNormal(points.size());
+	size_t numContacts = 0;
+	START_TIMING("collisionTest");
+	for (size_t i = 0; i < points.size(); i++)
+	{
+		Vector3r cp;
+		if (co->collisionTest(points[i], tolerance, cp, refNormal[i], refDist[i]))
+		{
+			contact[i] = 1;
+			numContacts++;
+		}
+	}
+	const double timeSingle = STOP_TIMING;
+
+	std::vector<Real> dist(points.size());
+	std::vector<Vector3r> normal(points.size());
+	std::vector<unsigned int> contactIndices(points.size());
+	std::vector<Vector3r> cp(points.size());
+	size_t numBatchContacts = 0;
+	START_TIMING("collisionTestBatch");
+	for (size_t c = 0; c < numClusters; c++)
+	{
+		const size_t begin = c * clusterSize;
+		const unsigned int n = co->collisionTestBatch(clusterSize, &points[begin], tolerance, &contactIndices[numBatchContacts],
+			&cp[numBatchContacts], &normal[numBatchContacts], &dist[numBatchContacts]);
+		for (unsigned int i = 0; i < n; i++)
+			contactIndices[numBatchContacts + i] += static_cast<unsigned int>(begin);
+		numBatchContacts += n;
+	}
+	const double timeBatch = STOP_TIMING;
+
+	// compare the results (contacts exactly at the tolerance may differ due to the precision)
+	Real maxDistError = 0.0;
+	Real maxNormalError = 0.0;
+	size_t numMatches = 0;
+	for (size_t i = 0; i < numBatchContacts; i++)
+	{
+		const unsigned int index = contactIndices[i];
+		if (!contact[index])
+			continue;
+		numMatches++;
+		maxDistError = std::max(maxDistError, fabs(dist[i] - refDist[index]));
+		maxNormalError = std::max(maxNormalError, (normal[i] - refNormal[index]).norm());
+	}
+
+	LOG_INFO << "Resolution: " << resolution << ", cells: " << co->m_floatSDF->numCells() << ", points: " << points.size()
+		<< ", contacts: " << numContacts << " / " << numBatchContacts << " (" << numMatches << " equal)";
+	LOG_INFO << "Generation of the SDF: " << timeGenerate << " ms, single precision copy: " << timeCopy << " ms";
+	LOG_INFO << "collisionTest: " << timeSingle << " ms, collisionTestBatch: " << timeBatch << " ms, speedup: " << timeSingle / timeBatch;
+	LOG_INFO << "Max. distance error: " << maxDistError << ", max. normal error: " << maxNormalError;
+
+	// narrow band field which is converted from the grid file and loaded by a memory mapping
+	const std::string gridFileName = "SDFQueryBenchmark_torus.cdf";
+	const std::string sparseFileName = "SDFQueryBenchmark_torus.csdf";
+	sdf->save(gridFileName);
+	if (!FloatCubicSDF::convert(gridFileName, sparseFileName, bandWidth))
+	{
+		LOG_ERR << "Cannot write " << sparseFileName;
+		return 1;
+	}
+	START_TIMING("load sparse SDF");
+	FloatCubicSDFPtr mappedSDF = std::make_shared<FloatCubicSDF>();
+	const bool loaded = mappedSDF->load(sparseFileName);
+	const double timeLoad = STOP_TIMING;
+	if (!loaded)
+	{
+		LOG_ERR << "Cannot load " << sparseFileName;
+		return 1;
+	}
+	cd.addCubicSDFCollisionObject(0, CollisionDetection::CollisionObject::RigidBodyCollisionObjectType, &vertex, 1, mappedSDF, Vector3r(1.0, 1.0, 1.0));
+	CubicSDFCollisionDetection::CubicSDFCollisionObject *sparseCo = (CubicSDFCollisionDetection::CubicSDFCollisionObject*)cd.getCollisionObjects()[1];
+
+	// all points are in the band, so the contacts must be identical to the dense field
+	size_t numSparseContacts = 0;
+	size_t numDifferent = 0;
+	for (size_t c = 0; c < numClusters; c++)
+	{
+		const size_t begin = c * clusterSize;
+		Vector3r sparseCp[clusterSize], sparseNormal[clusterSize];
+		Real sparseDist[clusterSize];
+		unsigned int sparseIndices[clusterSize];
+		const unsigned int n = sparseCo->collisionTestBatch(clusterSize, &points[begin], tolerance, sparseIndices, sparseCp, sparseNormal, sparseDist);
+		for (unsigned int i = 0; i < n; i++)
+		{
+			const unsigned int index = static_cast<unsigned int>(begin) + sparseIndices[i];
+			if ((numSparseContacts + i >= numBatchContacts) || (contactIndices[numSparseContacts + i] != index) || (dist[numSparseContacts + i] != sparseDist[i]))
+				numDifferent++;
+		}
+		numSparseContacts += n;
+	}
+	LOG_INFO << "Band width: " << bandWidth << ", cells: " << mappedSDF->numCells() << " (dense: " << co->m_floatSDF->numCells() << ")"
+		<< ", load: " << timeLoad << " ms, contacts: " << numSparseContacts << ", " << ((numDifferent == 0) ? "equal" : "DIFFERENT");
+
+	// a point on the center line of the torus is outside of the band but must still generate a contact
+	const Vector3r deepPoint(1.0, 0.0, 0.0);
+	Vector3r deepCp, deepNormal;
+	Real deepDist;
+	const bool deepContact = sparseCo->collisionTest(deepPoint, tolerance, deepCp, deepNormal, deepDist);
+	LOG_INFO << "Deep penetration: " << (deepContact ? "contact" : "NO CONTACT") << ", distance: " << (deepContact ? deepDist : static_cast<Real>(0.0));
+
+	return deepContact ? 0 : 1;
+}
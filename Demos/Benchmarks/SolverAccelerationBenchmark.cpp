@@ -0,0 +1,134 @@
+#include "Common/Common.h"
+#include "BenchmarkCommon.h"
+#include "Simulation/Simulation.h"
+#include "Simulation/SimulationModel.h"
+#include "Simulation/TimeStepController.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Benchmark of the acceleration of the position solver. A cloth with distance constraints 
+// and a bar with distance and volume constraints are stretched by 10% and released. They 
+// are simulated with plain Gauss-Seidel iterations, over-relaxation and the Chebyshev method. 
+// The solver stops when the residual is reduced by the given tolerance, so the average 
+// number of iterations per sub step shows the convergence. The residual history of the 
+// first sub step of the last step is printed for tuning.
+//
+// Usage: SolverAccelerationBenchmark [numSteps] [maxIterations] [residualTolerance] [omega] [rho]
+
+using namespace PBD;
+using namespace std;
+using namespace Utilities;
+
+const Real stretch = static_cast<Real>(1.1);
+
+void buildCloth(SimulationModel &model)
+{
+	const int res = 30;
+	model.addRegularTriangleModel(res, res, Vector3r::Zero(), Matrix3r::Identity(), Vector2r(5.0, 5.0));
+	// distance constraints
+	model.addClothConstraints(model.getTriangleModels()[0], 1, 1.0, 1.0, 1.0, 1.0,
+		static_cast<Real>(0.3), static_cast<Real>(0.3), false, false);
+	ParticleData &pd = model.getParticles();
+	for (unsigned int i = 0; i < pd.size(); i++)
+		pd.getPosition(i) *= stretch;
+	pd.setMass(0, 0.0);
+}
+
+void buildBar(SimulationModel &model)
+{
+	const int width = 30;
+	const int height = 5;
+	const int depth = 5;
+	model.addRegularTetModel(width, height, depth, Vector3r(5, 0, 0), Matrix3r::Identity(), Vector3r(10.0, 1.5, 1.5));
+	// distance and volume constraints
+	model.addSolidConstraints(model.getTetModels()[0], 1, 1.0, static_cast<Real>(0.3), 1.0, false, false);
+	ParticleData &pd = model.getParticles();
+	for (unsigned int i = 0; i < pd.size(); i++)
+		pd.getPosition(i) *= stretch;
+	for (int j = 0; j < height; j++)
+	{
+		for (int k = 0; k < depth; k++)
+			pd.setMass(j*depth + k, 0.0);
+	}
+}
+
+void runScene(const std::string &sceneName, void (*buildScene)(SimulationModel&), const int method, const std::string &methodName,
+	const unsigned int numSteps, const unsigned int maxIterations, const Real tolerance, const Real omega, const Real rho)
+{
+	SimulationModel model;
+	model.init();
+	Simulation sim;
+	sim.init();
+	sim.setModel(&model);
+	sim.makeCurrent();
+	buildScene(model);
+
+	TimeStepController *tsc = static_cast<TimeStepController*>(sim.getTimeStep());
+	tsc->setValue<unsigned int>(TimeStepController::MAX_ITERATIONS, maxIterations);
+	tsc->setValue<int>(TimeStepController::SOLVER_ACCELERATION, method);
+	tsc->setValue<Real>(TimeStepController::RELAXATION_OMEGA, omega);
+	tsc->setValue<Real>(TimeStepController::CHEBYSHEV_RHO, rho);
+	tsc->setValue<Real>(TimeStepController::RESIDUAL_TOLERANCE, tolerance);
+	const unsigned int subSteps = tsc->getValue<unsigned int>(TimeStepController::NUM_SUB_STEPS);
+
+	size_t iterations = 0;
+	double time = 0.0;
+	for (unsigned int s = 0; s < numSteps; s++)
+	{
+		START_TIMING("step");
+		tsc->step(model);
+		time += STOP_TIMING;
+		iterations += tsc->getResidualHistory().size();
+	}
+
+	// residuals of the first sub step of the last step relative to the first iteration
+	const std::vector<Real> &history = tsc->getResidualHistory();
+	std::ostringstream ss;
+	Real reduction = 0.0;
+	for (size_t i = 0; (i < history.size()) && (i < maxIterations); i++)
+	{
+		reduction = (history[0] > 0.0) ? history[i] / history[0] : static_cast<Real>(0.0);
+		if (i < 10)
+			ss << reduction << " ";
+		// end of the first sub step
+		if ((tolerance > 0.0) && (reduction <= tolerance))
+			break;
+	}
+
+	LOG_INFO << sceneName << ", " << methodName << ": " << static_cast<double>(iterations) / (numSteps * subSteps) << " iterations per sub step, "
+		<< time / numSteps << " ms per step, residual reduction of the last step: " << reduction;
+	LOG_INFO << "  residual history: " << ss.str();
+}
+
+int runBenchmark(int argc, char **argv)
+{
+	unsigned int numSteps = 1;
+	unsigned int maxIterations = 500;
+	Real tolerance = static_cast<Real>(0.02);
+	Real omega = static_cast<Real>(1.5);
+	Real rho = static_cast<Real>(0.9);
+	if (argc > 1)
+		numSteps = std::max(1, atoi(argv[1]));
+	if (argc > 2)
+		maxIterations = std::max(1, atoi(argv[2]));
+	if (argc > 3)
+		tolerance = static_cast<Real>(atof(argv[3]));
+	if (argc > 4)
+		omega = static_cast<Real>(atof(argv[4]));
+	if (argc > 5)
+		rho = static_cast<Real>(atof(argv[5]));
+
+	LOG_INFO << "Steps: " << numSteps << ", max. iterations: " << maxIterations << ", residual tolerance: " << tolerance
+		<< ", omega: " << omega << ", rho: " << rho;
+
+	const std::string methodNames[3] = { "Gauss-Seidel", "SOR", "Chebyshev" };
+	for (int method = 0; method < 3; method++)
+		runScene("cloth", buildCloth, method, methodNames[method], numSteps, maxIterations, tolerance, omega, rho);
+	for (int method = 0; method < 3; method++)
+		runScene("bar", buildBar, method, methodNames[method], numSteps, maxIterations, tolerance, omega, rho);
+
+	return 0;
+}
@@ -94,7 +94,7 @@ void FluidModel::initModel(const unsigned int nFluidParticles, Vector3r* fluidPa
 	resizeFluidParticles(nFluidParticles);
 
 	// init kernel
-	CubicKernel::setRadius(m_supportRadius);
+	m_kernel.setRadius(m_supportRadius);
 
 	// copy fluid positions
 	#pragma omp parallel default(shared)
@@ -139,11 +139,11 @@ void FluidModel::initModel(const unsigned int nFluidParticles, Vector3r* fluidPa
 		#pragma omp for schedule(static)  
 		for (int i = 0; i < (int) nBoundaryParticles; i++)
 		{
-			Real delta = CubicKernel::W_zero();
+			Real delta = m_kernel.W_zero();
 			for (unsigned int j = 0; j < numNeighbors[i]; j++)
 			{
 				const unsigned int neighborIndex = neighbors[i][j];
-				delta += CubicKernel::W(m_boundaryX[i] - m_boundaryX[neighborIndex]);
+				delta += m_kernel.W(m_boundaryX[i] - m_boundaryX[neighborIndex]);
 			}
 			const Real volume = static_cast<Real>(1.0) / delta;
 			m_boundaryPsi[i] = m_density0 * volume;
@@ -4,6 +4,7 @@
 #include "Simulation/ParticleData.h"
 #include <vector>
 #include "Simulation/NeighborhoodSearchSpatialHashing.h"
+#include "PositionBasedDynamics/SPHKernels.h"
 
 namespace PBD 
 {	
@@ -18,6 +19,7 @@ namespace PBD
 			Real m_density0;
 			Real m_particleRadius;
 			Real m_supportRadius;
+			CubicKernel m_kernel;
 			ParticleData m_particles;
 			std::vector<Vector3r> m_boundaryX;
 			std::vector<Real> m_boundaryPsi;
@@ -43,6 +45,7 @@ namespace PBD
 			const unsigned int numBoundaryParticles() const { return (unsigned int)m_boundaryX.size(); }
 			Real getDensity0() const { return m_density0; }
 			Real getSupportRadius() const { return m_supportRadius; }
+			const CubicKernel &getKernel() const { return m_kernel; }
 			Real getParticleRadius() const { return m_particleRadius; }
 			void setParticleRadius(Real val) { m_particleRadius = val; m_supportRadius = static_cast<Real>(4.0)*m_particleRadius; }
 			NeighborhoodSearchSpatialHashing* getNeighborhoodSearch() { return m_neighborhoodSearch; }
@@ -98,7 +98,7 @@ void FluidModel::initModel(const unsigned int nFluidParticles, Vector3r* fluidPa
 	resizeFluidParticles(nFluidParticles);
 
 	// init kernel
-	CubicKernel::setRadius(m_supportRadius);
+	m_kernel.setRadius(m_supportRadius);
 
 	// copy fluid positions
 	#pragma omp parallel default(shared)
@@ -142,11 +142,11 @@ void FluidModel::initModel(const unsigned int nFluidParticles, Vector3r* fluidPa
 		for (int i = 0; i < (int)nBoundaryParticles; i++)
 		{
 			const unsigned int sortIdx = neighborhoodSearchSH.partIdx(i);
-			Real delta = CubicKernel::W_zero();
+			Real delta = m_kernel.W_zero();
 			for (unsigned int j = 0; j < neighborhoodSearchSH.n_neighbors(sortIdx); j++)
 			{
 				const unsigned int neighborIndex = neighborhoodSearchSH.neighbor(sortIdx, j); //neighborhoodSearchSH.sortIdxBoundry(neighborhoodSearchSH.neighborBoundry(sortIdx, j)); neighborhoodSearchSH.neighborBoundry(sortIdx, j) neighborhoodSearchSH.invNeighborBoundry(sortIdx, j)
-				delta += CubicKernel::W(m_boundaryX[i] - m_boundaryX[neighborIndex]);
+				delta += m_kernel.W(m_boundaryX[i] - m_boundaryX[neighborIndex]);
 			}
 			const Real volume = static_cast<Real>(1.0) / delta;
 			m_boundaryPsi[i] = m_density0 * volume;
@@ -169,11 +169,11 @@ void FluidModel::initModel(const unsigned int nFluidParticles, Vector3r* fluidPa
 		for (int i = 0; i < (int)nBoundaryParticles; i++)
 		{
 			const unsigned int sortIdx = i;//neighborhoodSearchSH.sortIdxBoundry(i);
-			Real delta = CubicKernel::W_zero();
+			Real delta = m_kernel.W_zero();
 			for (unsigned int j = 0; j < neighborhoodSearchSH.n_neighborsBoundry(sortIdx); j++)
 			{
 				const unsigned int neighborIndex = neighborhoodSearchSH.neighborBoundry(sortIdx, j); //neighborhoodSearchSH.sortIdxBoundry(neighborhoodSearchSH.neighborBoundry(sortIdx, j)); neighborhoodSearchSH.neighborBoundry(sortIdx, j) neighborhoodSearchSH.invNeighborBoundry(sortIdx, j)
-				delta += CubicKernel::W(m_boundaryX[i] - m_boundaryX[neighborIndex]);
+				delta += m_kernel.W(m_boundaryX[i] - m_boundaryX[neighborIndex]);
 			}
 			const Real volume = static_cast<Real>(1.0) / delta;
 			m_boundaryPsi[i] = m_density0 * volume;
@@ -198,11 +198,11 @@ void FluidModel::initModel(const unsigned int nFluidParticles, Vector3r* fluidPa
 		#pragma omp for schedule(static)  
 		for (int i = 0; i < (int)nBoundaryParticles; i++)
 		{
-			Real delta = CubicKernel::W_zero();
+			Real delta = m_kernel.W_zero();
 			for (unsigned int j = 0; j < numNeighbors[i]; j++)
 			{
 				const unsigned int neighborIndex = neighbors[i][j];
-				delta += CubicKernel::W(m_boundaryX[i] - m_boundaryX[neighborIndex]);
+				delta += m_kernel.W(m_boundaryX[i] - m_boundaryX[neighborIndex]);
 			}
 			const Real volume = static_cast<Real>(1.0) / delta;
 			m_boundaryPsi[i] = m_density0 * volume;
@@ -208,7 +208,7 @@ void TimeStepFluidModel::computeXSPHViscosity(FluidModel &model)
 					const Vector3r& xj = pd.getPosition(neighborIndex);
 					const Vector3r& vj = pd.getVelocity(neighborIndex);
 					const Real density_j = model.getDensity(neighborIndex);
-					vi -= viscosity * (pd.getMass(neighborIndex) / density_j) * (vi - vj) * CubicKernel::W(xi - xj);
+					vi -= viscosity * (pd.getMass(neighborIndex) / density_j) * (vi - vj) * model.getKernel().W(xi - xj);
 				}
 			}
 		}
@@ -268,14 +268,14 @@ void TimeStepFluidModel::constraintProjection(FluidModel &model)
 				const Real density0 = model.getDensity0();
 
 				// Compute current density for particle i
-				density = mass[i] * CubicKernel::W_zero();
+				density = mass[i] * model.getKernel().W_zero();
 				for (unsigned int j = 0; j < model.getNeighborhoodSearch()->n_neighbors(sortIdx); j++)
 				{
 					//const unsigned int neighborIndex = model.getNeighborhoodSearch()->invNeighbor(sortIdx, j);
 					const unsigned int neighborIndex = model.getNeighborhoodSearch()->neighbor(sortIdx, j);
 					if (neighborIndex < nParticles)		// Test if fluid particle
 					{
-						density += mass[neighborIndex] * CubicKernel::W(x[i] - x[neighborIndex]);
+						density += mass[neighborIndex] * model.getKernel().W(x[i] - x[neighborIndex]);
 						
 						if (sign == -1) frag++;
 						sign = 1;
@@ -284,7 +284,7 @@ void TimeStepFluidModel::constraintProjection(FluidModel &model)
 					else
 					{
 						// Boundary: Akinci2012
-						density += boundaryPsi[neighborIndex - nParticles] * CubicKernel::W(x[i] - boundaryX[neighborIndex - nParticles]);
+						density += boundaryPsi[neighborIndex - nParticles] * model.getKernel().W(x[i] - boundaryX[neighborIndex - nParticles]);
 						
 						if (sign == 1) frag++;
 						sign = -1;
@@ -325,14 +325,14 @@ void TimeStepFluidModel::constraintProjection(FluidModel &model)
 						const unsigned int neighborIndex = model.getNeighborhoodSearch()->neighbor(sortIdx, j);
 						if (neighborIndex < nParticles)		// Test if fluid particle
 						{
-							const Vector3r gradC_j = -mass[neighborIndex] / density0 * CubicKernel::gradW(x[i] - x[neighborIndex]);
+							const Vector3r gradC_j = -mass[neighborIndex] / density0 * model.getKernel().gradW(x[i] - x[neighborIndex]);
 							sum_grad_C2 += gradC_j.squaredNorm();
 							gradC_i -= gradC_j;
 						}
 						else
 						{
 							// Boundary: Akinci2012
-							const Vector3r gradC_j = -boundaryPsi[neighborIndex - nParticles] / density0 * CubicKernel::gradW(x[i] - boundaryX[neighborIndex - nParticles]);
+							const Vector3r gradC_j = -boundaryPsi[neighborIndex - nParticles] / density0 * model.getKernel().gradW(x[i] - boundaryX[neighborIndex - nParticles]);
 							sum_grad_C2 += gradC_j.squaredNorm();
 							gradC_i -= gradC_j;
 						}
@@ -347,9 +347,9 @@ void TimeStepFluidModel::constraintProjection(FluidModel &model)
 					lambda = 0.0;
 #else
 				PositionBasedFluids::computePBFDensity(i, nParticles, &pd.getPosition(0), &pd.getMass(0), &model.getBoundaryX(0), 
-					&model.getBoundaryPsi(0), numNeighbors[i], neighbors[i], model.getDensity0(), true, density_err, model.getDensity(i), sumFrag);
+					&model.getBoundaryPsi(0), numNeighbors[i], neighbors[i], model.getKernel(), model.getDensity0(), true, density_err, model.getDensity(i), sumFrag);
 				PositionBasedFluids::computePBFLagrangeMultiplier(i, nParticles, &pd.getPosition(0), &pd.getMass(0), &model.getBoundaryX(0), 
-					&model.getBoundaryPsi(0), model.getDensity(i), numNeighbors[i], neighbors[i], model.getDensity0(), true, model.getLambda(i));
+					&model.getBoundaryPsi(0), model.getDensity(i), numNeighbors[i], neighbors[i], model.getKernel(), model.getDensity0(), true, model.getLambda(i));
 #endif
 
 				
@@ -397,13 +397,13 @@ void TimeStepFluidModel::constraintProjection(FluidModel &model)
 					const unsigned int neighborIndex = model.getNeighborhoodSearch()->neighbor(sortIdx, j);
 					if (neighborIndex < nParticles)		// Test if fluid particle
 					{
-						const Vector3r gradC_j = -mass[neighborIndex] / density0 * CubicKernel::gradW(x[i] - x[neighborIndex]);
+						const Vector3r gradC_j = -mass[neighborIndex] / density0 * model.getKernel().gradW(x[i] - x[neighborIndex]);
 						corr -= (lambda[i] + lambda[neighborIndex]) * gradC_j;
 					}
 					else
 					{
 						// Boundary: Akinci2012
-						const Vector3r gradC_j = -boundaryPsi[neighborIndex - nParticles] / density0 * CubicKernel::gradW(x[i] - boundaryX[neighborIndex - nParticles]);
+						const Vector3r gradC_j = -boundaryPsi[neighborIndex - nParticles] / density0 * model.getKernel().gradW(x[i] - boundaryX[neighborIndex - nParticles]);
 						corr -= (lambda[i]) * gradC_j;
 					}
 				}
@@ -412,7 +412,7 @@ void TimeStepFluidModel::constraintProjection(FluidModel &model)
 
 #else
 				PositionBasedFluids::solveDensityConstraint(i, nParticles, &pd.getPosition(0), &pd.getMass(0), &model.getBoundaryX(0), &model.getBoundaryPsi(0), 
-					numNeighbors[i], neighbors[i], model.getDensity0(), true, &model.getLambda(0), corr);
+					numNeighbors[i], neighbors[i], model.getKernel(), model.getDensity0(), true, &model.getLambda(0), corr);
 #endif
 				model.getDeltaX(i) = corr;
 				
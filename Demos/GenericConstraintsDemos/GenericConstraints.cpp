@@ -17,32 +17,6 @@ int GenericSliderJoint::TYPE_ID = IDFactory::getId();
 // GenericDistanceConstraint
 //////////////////////////////////////////////////////////////////////////
 
-void GenericDistanceConstraint::constraintFct(
-	const unsigned int numberOfParticles,
-	const Real mass[],
-	const Vector3r x[],
-	void *userData,
-	Eigen::Matrix<Real, 1, 1> &constraintValue)
-{
-	Real restLength = *(Real*)userData;
-	Eigen::Matrix<Real, 1, 1> C;
-	C(0, 0) = (x[1] - x[0]).norm() - restLength;
-	constraintValue = C;
-}
-
-void GenericDistanceConstraint::gradientFct(
-	const unsigned int i,
-	const unsigned int numberOfParticles,
-	const Real mass[],
-	const Vector3r x[],
-	void *userData,
-	Eigen::Matrix<Real, 1, 3> &jacobian)
-{
-	Vector3r n = x[i] - x[1 - i];
-	n.normalize();
-	jacobian = n.transpose();
-}
-
 bool GenericDistanceConstraint::initConstraint(SimulationModel &model, const unsigned int particle1, const unsigned int particle2, const Real stiffness)
 {
 	m_stiffness = stiffness;
@@ -73,12 +47,12 @@ bool GenericDistanceConstraint::solvePositionConstraint(SimulationModel &model,
 	const Real invMass[2] = { invMass1, invMass2 };
 	const Vector3r x[2] = { x1, x2 };
 
+	ConstraintFct constraintFct;
+	constraintFct.m_restLength = m_restLength;
+
 	Vector3r corr[2];
-	const bool res = PositionBasedGenericConstraints::solve_GenericConstraint<2, 1>(
-		invMass, x, &m_restLength,
-		GenericDistanceConstraint::constraintFct,
-		GenericDistanceConstraint::gradientFct,
-		corr);
+	const bool res = PositionBasedGenericConstraints::solve_GenericConstraint_Functor<2, 1>(
+		invMass, x, constraintFct, GradientFct(), corr);
 
 	if (res)
 	{
@@ -96,16 +70,17 @@ bool GenericDistanceConstraint::solvePositionConstraint(SimulationModel &model,
 // GenericIsometricBendingConstraint
 //////////////////////////////////////////////////////////////////////////
 
+template<typename Scalar>
 void GenericIsometricBendingConstraint::constraintFct(
 	const unsigned int numberOfParticles,
 	const Real invMass[],
-	const Vector3r x[],
+	const Eigen::Matrix<Scalar, 3, 1> x[],
 	void *userData,
-	Eigen::Matrix<Real, 1, 1> &constraintValue)
+	Eigen::Matrix<Scalar, 1, 1> &constraintValue)
 {
 	Matrix4r *Q = (Matrix4r*)userData;
 
-	Real energy = 0.0;
+	Scalar energy = static_cast<Real>(0.0);
 	for (unsigned char k = 0; k < 4; k++)
 	for (unsigned char j = 0; j < 4; j++)
 		energy += (*Q)(j, k)*(x[k].dot(x[j]));
@@ -185,10 +160,9 @@ bool GenericIsometricBendingConstraint::solvePositionConstraint(SimulationModel
 
 	Vector3r corr[4];
 
-	const bool res = PositionBasedGenericConstraints::solve_GenericConstraint<4, 1>(
+	const bool res = PositionBasedGenericConstraints::solve_GenericConstraint_AD<4, 1>(
 		invMass, x, &m_Q,
-		GenericIsometricBendingConstraint::constraintFct,
-		//GenericIsometricBendingConstraint::gradientFct,
+		GenericIsometricBendingConstraint::constraintFct<PositionBasedGenericConstraints::ParticleDual<4> >,
 		corr);
 
 	if (res)
@@ -210,16 +184,11 @@ bool GenericIsometricBendingConstraint::solvePositionConstraint(SimulationModel
 //////////////////////////////////////////////////////////////////////////
 
 void GenericHingeJoint::constraintFct(
-	const unsigned int numberOfRigidBodies,
-	const Real mass[],
+	const Eigen::Matrix<Real, 3, 12> &jointInfo,
 	const Vector3r x[],
-	const Matrix3r inertiaInverseW[],
 	const Quaternionr q[],
-	void *userData,
 	Eigen::Matrix<Real, 5, 1> &constraintValue)
 {
-	Eigen::Matrix<Real, 3, 12> &jointInfo = *(Eigen::Matrix<Real, 3, 12>*)userData;
-	
 	const Vector3r &c0 = jointInfo.col(6);
 	const Vector3r &c1 = jointInfo.col(7);
 	const Vector3r &axis1 = jointInfo.col(11);
@@ -233,16 +202,11 @@ void GenericHingeJoint::constraintFct(
 
 void GenericHingeJoint::gradientFct(
 	const unsigned int i,
-	const unsigned int numberOfRigidBodies,
-	const Real mass[],
+	const Eigen::Matrix<Real, 3, 12> &jointInfo,
 	const Vector3r x[],
-	const Matrix3r inertiaInverseW[],
 	const Quaternionr q[],
-	void *userData,
 	Eigen::Matrix<Real, 5, 6> &jacobian)
 {
-	Eigen::Matrix<Real, 3, 12> &jointInfo = *(Eigen::Matrix<Real, 3, 12>*)userData;
-
 	const Vector3r &c0 = jointInfo.col(6);
 	const Vector3r &c1 = jointInfo.col(7);
 	const Vector3r &axis1 = jointInfo.col(11);
@@ -405,10 +369,11 @@ bool GenericHingeJoint::solvePositionConstraint(SimulationModel &model, const un
 
 	Vector3r corrX[2];
 	Quaternionr corrQ[2];
-	const bool res = PositionBasedGenericConstraints::solve_GenericConstraint<2, 5>(
-		invMass, x, inertiaInverseW, q, &m_jointInfo, 
-		GenericHingeJoint::constraintFct,
-		GenericHingeJoint::gradientFct,
+	const Eigen::Matrix<Real, 3, 12> &jointInfo = m_jointInfo;
+	const bool res = PositionBasedGenericConstraints::solve_GenericConstraint_Functor<2, 5>(
+		invMass, x, inertiaInverseW, q,
+		[&](const Vector3r xi[], const Quaternionr qi[], Eigen::Matrix<Real, 5, 1> &C) { constraintFct(jointInfo, xi, qi, C); },
+		[&](const unsigned int i, const Vector3r xi[], const Quaternionr qi[], Eigen::Matrix<Real, 5, 6> &jacobian) { gradientFct(i, jointInfo, xi, qi, jacobian); },
 		corrX, corrQ);
 
 	if (res)
@@ -436,19 +401,21 @@ bool GenericHingeJoint::solvePositionConstraint(SimulationModel &model, const un
 // GenericBallJoint
 //////////////////////////////////////////////////////////////////////////
 
+template<typename Scalar>
 void GenericBallJoint::constraintFct(
 	const unsigned int numberOfRigidBodies,
 	const Real mass[],
-	const Vector3r x[],
+	const Eigen::Matrix<Scalar, 3, 1> x[],
 	const Matrix3r inertiaInverseW[],
-	const Quaternionr q[],
+	const Eigen::Quaternion<Scalar> q[],
 	void *userData,
-	Eigen::Matrix<Real, 3, 1> &constraintValue)
+	Eigen::Matrix<Scalar, 3, 1> &constraintValue)
 {
+	typedef Eigen::Matrix<Scalar, 3, 1> Vector3s;
 	Eigen::Matrix<Real, 3, 2> &jointInfo = *(Eigen::Matrix<Real, 3, 2>*)userData;
 
-	const Vector3r c0 = q[0].matrix() * jointInfo.col(0) + x[0];
-	const Vector3r c1 = q[1].matrix() * jointInfo.col(1) + x[1];
+	const Vector3s c0 = q[0].matrix() * jointInfo.col(0) + x[0];
+	const Vector3s c1 = q[1].matrix() * jointInfo.col(1) + x[1];
 
 	constraintValue = c0 - c1;
 }
@@ -503,9 +470,9 @@ bool GenericBallJoint::solvePositionConstraint(SimulationModel &model, const uns
 
 	Vector3r corrX[2];
 	Quaternionr corrQ[2];
-	const bool res = PositionBasedGenericConstraints::solve_GenericConstraint<2, 3>(
+	const bool res = PositionBasedGenericConstraints::solve_GenericConstraint_AD<2, 3>(
 		invMass, x, inertiaInverseW, q, &m_jointInfo,
-		GenericBallJoint::constraintFct,
+		GenericBallJoint::constraintFct<PositionBasedGenericConstraints::RigidBodyDual<2> >,
 		corrX, corrQ);
 
 	if (res)
@@ -532,32 +499,35 @@ bool GenericBallJoint::solvePositionConstraint(SimulationModel &model, const uns
 // GenericSliderJoint
 //////////////////////////////////////////////////////////////////////////
 
+template<typename Scalar>
 void GenericSliderJoint::constraintFct(
 	const unsigned int numberOfRigidBodies,
 	const Real mass[],
-	const Vector3r x[],
+	const Eigen::Matrix<Scalar, 3, 1> x[],
 	const Matrix3r inertiaInverseW[],
-	const Quaternionr q[],
+	const Eigen::Quaternion<Scalar> q[],
 	void *userData,
-	Eigen::Matrix<Real, 5, 1> &constraintValue)
+	Eigen::Matrix<Scalar, 5, 1> &constraintValue)
 {
+	typedef Eigen::Matrix<Scalar, 3, 1> Vector3s;
+	typedef Eigen::Matrix<Scalar, 3, 3> Matrix3s;
 	Eigen::Matrix<Real, 3, 7> &jointInfo = *(Eigen::Matrix<Real, 3, 7>*)userData;
 
-	const Vector3r c0 = q[0].matrix() * jointInfo.col(0) + x[0];
-	const Vector3r c1 = q[1].matrix() * jointInfo.col(1) + x[1];
-	const Vector3r axis0 = q[0].matrix() * jointInfo.col(2);
-	const Vector3r axis1 = q[1].matrix() * jointInfo.col(5);
-	const Vector3r u = axis0.cross(axis1);
-	const Vector3r t1 = q[0].matrix() * jointInfo.col(3);
-	const Vector3r t2 = q[0].matrix() * jointInfo.col(4);
-	const Vector3r t3 = q[1].matrix() * jointInfo.col(6);
+	const Matrix3s rot0 = q[0].matrix();
+	const Matrix3s rot1 = q[1].matrix();
+	const Vector3s c0 = rot0 * jointInfo.col(0) + x[0];
+	const Vector3s c1 = rot1 * jointInfo.col(1) + x[1];
+	const Vector3s axis1 = rot1 * jointInfo.col(5);
+	const Vector3s t1 = rot0 * jointInfo.col(3);
+	const Vector3s t2 = rot0 * jointInfo.col(4);
+	const Vector3s t3 = rot1 * jointInfo.col(6);
 
 	// projection 	
-	Eigen::Matrix<Real, 2, 3> P;
+	Eigen::Matrix<Scalar, 2, 3> P;
 	P.row(0) = t1.transpose();
 	P.row(1) = t2.transpose();
 
-	constraintValue.block<2, 1>(0, 0) = P * (c0 - c1);
+	constraintValue.template block<2, 1>(0, 0) = P * (c0 - c1);
 	constraintValue(2, 0) = t1.dot(axis1);
 	constraintValue(3, 0) = t2.dot(axis1);
 	constraintValue(4, 0) = t2.dot(t3);
@@ -644,9 +614,9 @@ bool GenericSliderJoint::solvePositionConstraint(SimulationModel &model, const u
 
 	Vector3r corrX[2];
 	Quaternionr corrQ[2];
-	const bool res = PositionBasedGenericConstraints::solve_GenericConstraint<2, 5>(
+	const bool res = PositionBasedGenericConstraints::solve_GenericConstraint_AD<2, 5>(
 		invMass, x, inertiaInverseW, q, &m_jointInfo,
-		GenericSliderJoint::constraintFct,
+		GenericSliderJoint::constraintFct<PositionBasedGenericConstraints::RigidBodyDual<2> >,
 		corrX, corrQ);
 
 	if (res)
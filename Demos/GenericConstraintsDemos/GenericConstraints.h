@@ -15,20 +15,24 @@ namespace PBD
 		Real m_restLength;
 		Real m_stiffness;
 
-		static void constraintFct(
-			const unsigned int numberOfParticles,
-			const Real invMass[],
-			const Vector3r x[],
-			void *userData,
-			Eigen::Matrix<Real, 1, 1> &constraintValue);
-
-		static void gradientFct(
-			const unsigned int i,
-			const unsigned int numberOfParticles,
-			const Real invMass[],
-			const Vector3r x[],
-			void *userData,
-			Eigen::Matrix<Real, 1, 3> &jacobian);
+		/** Constraint function object, the functions are inlined by the solver. */
+		struct ConstraintFct
+		{
+			Real m_restLength;
+
+			void operator()(const Vector3r x[], Eigen::Matrix<Real, 1, 1> &constraintValue) const
+			{
+				constraintValue(0, 0) = (x[1] - x[0]).norm() - m_restLength;
+			}
+		};
+
+		struct GradientFct
+		{
+			void operator()(const unsigned int i, const Vector3r x[], Eigen::Matrix<Real, 1, 3> &jacobian) const
+			{
+				jacobian = (x[i] - x[1 - i]).normalized().transpose();
+			}
+		};
 
 		GenericDistanceConstraint() : Constraint(2) {}
 		virtual int &getTypeId() const { return TYPE_ID; }
@@ -44,12 +48,14 @@ namespace PBD
 		Matrix4r m_Q;
 		Real m_stiffness;
 
+		/** The gradient is determined by automatic differentiation. */
+		template<typename Scalar>
 		static void constraintFct(
 			const unsigned int numberOfParticles,
 			const Real invMass[],
-			const Vector3r x[],
+			const Eigen::Matrix<Scalar, 3, 1> x[],
 			void *userData,
-			Eigen::Matrix<Real, 1, 1> &constraintValue);
+			Eigen::Matrix<Scalar, 1, 1> &constraintValue);
 
 		GenericIsometricBendingConstraint() : Constraint(4) {}
 		virtual int &getTypeId() const { return TYPE_ID; }
@@ -65,23 +71,18 @@ namespace PBD
 		static int TYPE_ID;
 		Eigen::Matrix<Real, 3, 12> m_jointInfo;
 
+		/** The constraint and gradient functions are called by lambdas which are inlined by the solver. */
 		static void constraintFct(
-			const unsigned int numberOfRigidBodies,
-			const Real invMass[],					// inverse mass is zero if body is static
+			const Eigen::Matrix<Real, 3, 12> &jointInfo,
 			const Vector3r x[],						// positions of bodies
-			const Matrix3r inertiaInverseW[],		// inverse inertia tensor (world space) of bodies
 			const Quaternionr q[],
-			void *userData,
 			Eigen::Matrix<Real, 5, 1> &constraintValue);
 
 		static void gradientFct(
 			const unsigned int i,
-			const unsigned int numberOfRigidBodies,
-			const Real invMass[],
+			const Eigen::Matrix<Real, 3, 12> &jointInfo,
 			const Vector3r x[],
-			const Matrix3r inertiaInverseW[],
 			const Quaternionr q[],
-			void *userData,
 			Eigen::Matrix<Real, 5, 6> &jacobian);
 
 		GenericHingeJoint() : Constraint(2) {}
@@ -98,14 +99,16 @@ namespace PBD
 		static int TYPE_ID;
 		Eigen::Matrix<Real, 3, 2> m_jointInfo;
 
+		/** The gradient is determined by automatic differentiation. */
+		template<typename Scalar>
 		static void constraintFct(
 			const unsigned int numberOfRigidBodies,
 			const Real invMass[],					// inverse mass is zero if body is static
-			const Vector3r x[],						// positions of bodies
+			const Eigen::Matrix<Scalar, 3, 1> x[],	// positions of bodies
 			const Matrix3r inertiaInverseW[],		// inverse inertia tensor (world space) of bodies
-			const Quaternionr q[],
+			const Eigen::Quaternion<Scalar> q[],
 			void *userData,
-			Eigen::Matrix<Real, 3, 1> &constraintValue);
+			Eigen::Matrix<Scalar, 3, 1> &constraintValue);
 
 		GenericBallJoint() : Constraint(2) {}
 		virtual int &getTypeId() const { return TYPE_ID; }
@@ -120,14 +123,16 @@ namespace PBD
 		static int TYPE_ID;
 		Eigen::Matrix<Real, 3, 7> m_jointInfo;
 
+		/** The gradient is determined by automatic differentiation. */
+		template<typename Scalar>
 		static void constraintFct(
 			const unsigned int numberOfRigidBodies,
 			const Real invMass[],					// inverse mass is zero if body is static
-			const Vector3r x[],						// positions of bodies
+			const Eigen::Matrix<Scalar, 3, 1> x[],	// positions of bodies
 			const Matrix3r inertiaInverseW[],		// inverse inertia tensor (world space) of bodies
-			const Quaternionr q[],
+			const Eigen::Quaternion<Scalar> q[],
 			void *userData,
-			Eigen::Matrix<Real, 5, 1> &constraintValue);
+			Eigen::Matrix<Scalar, 5, 1> &constraintValue);
 
 		GenericSliderJoint() : Constraint(2) {}
 		virtual int &getTypeId() const { return TYPE_ID; }
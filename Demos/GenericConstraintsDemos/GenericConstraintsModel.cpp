@@ -31,7 +31,7 @@ void GenericConstraintsModel::initParameters()
 
 bool GenericConstraintsModel::addGenericDistanceConstraint(const unsigned int particle1, const unsigned int particle2, const Real stiffness)
 {
-	GenericDistanceConstraint *c = new GenericDistanceConstraint();
+	GenericDistanceConstraint *c = m_constraintArena.create<GenericDistanceConstraint>();
 	const bool res = c->initConstraint(*this, particle1, particle2, stiffness);
 	if (res)
 		m_constraints.push_back(c);
@@ -41,7 +41,7 @@ bool GenericConstraintsModel::addGenericDistanceConstraint(const unsigned int pa
 bool GenericConstraintsModel::addGenericIsometricBendingConstraint(const unsigned int particle1, const unsigned int particle2,
 				const unsigned int particle3, const unsigned int particle4, const Real stiffness)
 {
-	GenericIsometricBendingConstraint *c = new GenericIsometricBendingConstraint();
+	GenericIsometricBendingConstraint *c = m_constraintArena.create<GenericIsometricBendingConstraint>();
 	const bool res = c->initConstraint(*this, particle1, particle2, particle3, particle4, stiffness);
 	if (res)
 		m_constraints.push_back(c);
@@ -50,7 +50,7 @@ bool GenericConstraintsModel::addGenericIsometricBendingConstraint(const unsigne
 
 bool GenericConstraintsModel::addGenericHingeJoint(const unsigned int rbIndex1, const unsigned int rbIndex2, const Vector3r &pos, const Vector3r &axis)
 {
-	GenericHingeJoint *c = new GenericHingeJoint();
+	GenericHingeJoint *c = m_constraintArena.create<GenericHingeJoint>();
 	const bool res = c->initConstraint(*this, rbIndex1, rbIndex2, pos, axis);
 	if (res)
 		m_constraints.push_back(c);
@@ -59,7 +59,7 @@ bool GenericConstraintsModel::addGenericHingeJoint(const unsigned int rbIndex1,
 
 bool GenericConstraintsModel::addGenericSliderJoint(const unsigned int rbIndex1, const unsigned int rbIndex2, const Vector3r &pos, const Vector3r &axis)
 {
-	GenericSliderJoint *c = new GenericSliderJoint();
+	GenericSliderJoint *c = m_constraintArena.create<GenericSliderJoint>();
 	const bool res = c->initConstraint(*this, rbIndex1, rbIndex2, pos, axis);
 	if (res)
 		m_constraints.push_back(c);
@@ -68,7 +68,7 @@ bool GenericConstraintsModel::addGenericSliderJoint(const unsigned int rbIndex1,
 
 bool GenericConstraintsModel::addGenericBallJoint(const unsigned int rbIndex1, const unsigned int rbIndex2, const Vector3r &pos)
 {
-	GenericBallJoint *c = new GenericBallJoint();
+	GenericBallJoint *c = m_constraintArena.create<GenericBallJoint>();
 	const bool res = c->initConstraint(*this, rbIndex1, rbIndex2, pos);
 	if (res)
 		m_constraints.push_back(c);
@@ -53,7 +53,7 @@ ParticleData & PositionBasedElasticRodsModel::getGhostParticles()
 
 bool PositionBasedElasticRodsModel::addPerpendiculaBisectorConstraint(const unsigned int p0, const unsigned int p1, const unsigned int p2)
 {
-	PerpendiculaBisectorConstraint *c = new PerpendiculaBisectorConstraint();
+	PerpendiculaBisectorConstraint *c = m_constraintArena.create<PerpendiculaBisectorConstraint>();
 	const bool res = c->initConstraint(*this, p0, p1, p2);
 	if (res)
 		m_constraints.push_back(c);
@@ -62,7 +62,7 @@ bool PositionBasedElasticRodsModel::addPerpendiculaBisectorConstraint(const unsi
 
 bool PositionBasedElasticRodsModel::addGhostPointEdgeDistanceConstraint(const unsigned int pA, const unsigned int pB, const unsigned int pG)
 {
-	GhostPointEdgeDistanceConstraint *c = new GhostPointEdgeDistanceConstraint();
+	GhostPointEdgeDistanceConstraint *c = m_constraintArena.create<GhostPointEdgeDistanceConstraint>();
 	const bool res = c->initConstraint(*this, pA, pB, pG);
 	if (res)
 		m_constraints.push_back(c);
@@ -72,7 +72,7 @@ bool PositionBasedElasticRodsModel::addGhostPointEdgeDistanceConstraint(const un
 bool PositionBasedElasticRodsModel::addDarbouxVectorConstraint(const unsigned int pA, const unsigned int pB,
 	const unsigned int pC, const unsigned int pD, const unsigned int pE)
 {
-	DarbouxVectorConstraint *c = new DarbouxVectorConstraint();
+	DarbouxVectorConstraint *c = m_constraintArena.create<DarbouxVectorConstraint>();
 	const bool res = c->initConstraint(*this, pA, pB, pC, pD, pE);
 	if (res)
 		m_constraints.push_back(c);
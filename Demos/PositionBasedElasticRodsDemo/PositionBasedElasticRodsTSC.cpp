@@ -20,8 +20,9 @@ PositionBasedElasticRodsTSC::~PositionBasedElasticRodsTSC()
 
 void PositionBasedElasticRodsTSC::step(SimulationModel &model)
 {
- 	TimeManager *tm = TimeManager::getCurrent ();
+ 	TimeManager *tm = model.getTimeManager();
 	const Real hOld = tm->getTimeStepSize();
+	m_residualHistory.clear();
 	PositionBasedElasticRodsModel &ermodel = (PositionBasedElasticRodsModel&)model;
  
 	//////////////////////////////////////////////////////////////////////////
@@ -147,7 +148,7 @@ void PositionBasedElasticRodsTSC::clearAccelerations(SimulationModel &model)
 
 	PositionBasedElasticRodsModel &ermodel = (PositionBasedElasticRodsModel&)model;
 	SimulationModel::RigidBodyVector &rb = model.getRigidBodies();
-	Simulation *sim = Simulation::getCurrent();
+	Simulation *sim = model.getSimulation();
 	const Vector3r grav(sim->getVecValue<Real>(Simulation::GRAVITATION));
  	for (size_t i=0; i < rb.size(); i++)
  	{
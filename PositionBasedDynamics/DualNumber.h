@@ -0,0 +1,149 @@
+#ifndef DUALNUMBER_H
+#define DUALNUMBER_H
+
+#include "Common/Common.h"
+#include <cmath>
+
+// ------------------------------------------------------------------------------------
+namespace PBD
+{
+	/** Dual number for forward mode automatic differentiation. It stores a value
+	* and its derivatives with respect to N variables. A function which is written
+	* as template of the scalar type computes its value and its exact gradient
+	* in a single evaluation if it is called with dual numbers.
+	*/
+	template<typename Scalar, int N>
+	class DualNumber
+	{
+	public:
+		typedef Eigen::Matrix<Scalar, N, 1, Eigen::DontAlign> DerivativeType;
+
+		Scalar m_value;
+		DerivativeType m_derivatives;
+
+		DualNumber() : m_value(0) { m_derivatives.setZero(); }
+		/** Constant */
+		DualNumber(const Scalar value) : m_value(value) { m_derivatives.setZero(); }
+		/** Variable with index i, i.e. the derivative with respect to the i-th variable is one. */
+		DualNumber(const Scalar value, const int i) : m_value(value) { m_derivatives.setZero(); m_derivatives[i] = static_cast<Scalar>(1.0); }
+		DualNumber(const Scalar value, const DerivativeType &derivatives) : m_value(value), m_derivatives(derivatives) {}
+
+		const Scalar &value() const { return m_value; }
+		const DerivativeType &derivatives() const { return m_derivatives; }
+
+		DualNumber operator-() const { return DualNumber(-m_value, -m_derivatives); }
+		DualNumber operator+() const { return *this; }
+
+		DualNumber &operator+=(const DualNumber &b) { m_value += b.m_value; m_derivatives += b.m_derivatives; return *this; }
+		DualNumber &operator-=(const DualNumber &b) { m_value -= b.m_value; m_derivatives -= b.m_derivatives; return *this; }
+		DualNumber &operator*=(const DualNumber &b) { *this = *this * b; return *this; }
+		DualNumber &operator/=(const DualNumber &b) { *this = *this / b; return *this; }
+		DualNumber &operator+=(const Scalar b) { m_value += b; return *this; }
+		DualNumber &operator-=(const Scalar b) { m_value -= b; return *this; }
+		DualNumber &operator*=(const Scalar b) { m_value *= b; m_derivatives *= b; return *this; }
+		DualNumber &operator/=(const Scalar b) { m_value /= b; m_derivatives /= b; return *this; }
+
+		friend DualNumber operator+(const DualNumber &a, const DualNumber &b) { return DualNumber(a.m_value + b.m_value, a.m_derivatives + b.m_derivatives); }
+		friend DualNumber operator+(const DualNumber &a, const Scalar b) { return DualNumber(a.m_value + b, a.m_derivatives); }
+		friend DualNumber operator+(const Scalar a, const DualNumber &b) { return DualNumber(a + b.m_value, b.m_derivatives); }
+		friend DualNumber operator-(const DualNumber &a, const DualNumber &b) { return DualNumber(a.m_value - b.m_value, a.m_derivatives - b.m_derivatives); }
+		friend DualNumber operator-(const DualNumber &a, const Scalar b) { return DualNumber(a.m_value - b, a.m_derivatives); }
+		friend DualNumber operator-(const Scalar a, const DualNumber &b) { return DualNumber(a - b.m_value, -b.m_derivatives); }
+		friend DualNumber operator*(const DualNumber &a, const DualNumber &b) { return DualNumber(a.m_value * b.m_value, b.m_value * a.m_derivatives + a.m_value * b.m_derivatives); }
+		friend DualNumber operator*(const DualNumber &a, const Scalar b) { return DualNumber(a.m_value * b, b * a.m_derivatives); }
+		friend DualNumber operator*(const Scalar a, const DualNumber &b) { return DualNumber(a * b.m_value, a * b.m_derivatives); }
+		friend DualNumber operator/(const DualNumber &a, const DualNumber &b)
+		{
+			const Scalar invB = static_cast<Scalar>(1.0) / b.m_value;
+			return DualNumber(a.m_value * invB, (a.m_derivatives - (a.m_value * invB) * b.m_derivatives) * invB);
+		}
+		friend DualNumber operator/(const DualNumber &a, const Scalar b) { return DualNumber(a.m_value / b, a.m_derivatives / b); }
+		friend DualNumber operator/(const Scalar a, const DualNumber &b)
+		{
+			const Scalar invB = static_cast<Scalar>(1.0) / b.m_value;
+			return DualNumber(a * invB, (-a * invB * invB) * b.m_derivatives);
+		}
+
+		// comparisons only consider the value
+		friend bool operator<(const DualNumber &a, const DualNumber &b) { return a.m_value < b.m_value; }
+		friend bool operator<=(const DualNumber &a, const DualNumber &b) { return a.m_value <= b.m_value; }
+		friend bool operator>(const DualNumber &a, const DualNumber &b) { return a.m_value > b.m_value; }
+		friend bool operator>=(const DualNumber &a, const DualNumber &b) { return a.m_value >= b.m_value; }
+		friend bool operator==(const DualNumber &a, const DualNumber &b) { return a.m_value == b.m_value; }
+		friend bool operator!=(const DualNumber &a, const DualNumber &b) { return a.m_value != b.m_value; }
+
+		// elementary functions, the derivatives follow from the chain rule
+		friend DualNumber sqrt(const DualNumber &a)
+		{
+			const Scalar s = std::sqrt(a.m_value);
+			const Scalar d = (s > static_cast<Scalar>(0.0)) ? static_cast<Scalar>(0.5) / s : static_cast<Scalar>(0.0);
+			return DualNumber(s, d * a.m_derivatives);
+		}
+		friend DualNumber abs(const DualNumber &a) { return (a.m_value < static_cast<Scalar>(0.0)) ? -a : a; }
+		friend DualNumber fabs(const DualNumber &a) { return abs(a); }
+		friend DualNumber abs2(const DualNumber &a) { return a * a; }
+		friend DualNumber sin(const DualNumber &a) { return DualNumber(std::sin(a.m_value), std::cos(a.m_value) * a.m_derivatives); }
+		friend DualNumber cos(const DualNumber &a) { return DualNumber(std::cos(a.m_value), -std::sin(a.m_value) * a.m_derivatives); }
+		friend DualNumber tan(const DualNumber &a)
+		{
+			const Scalar t = std::tan(a.m_value);
+			return DualNumber(t, (static_cast<Scalar>(1.0) + t * t) * a.m_derivatives);
+		}
+		friend DualNumber asin(const DualNumber &a) { return DualNumber(std::asin(a.m_value), (static_cast<Scalar>(1.0) / std::sqrt(static_cast<Scalar>(1.0) - a.m_value * a.m_value)) * a.m_derivatives); }
+		friend DualNumber acos(const DualNumber &a) { return DualNumber(std::acos(a.m_value), (-static_cast<Scalar>(1.0) / std::sqrt(static_cast<Scalar>(1.0) - a.m_value * a.m_value)) * a.m_derivatives); }
+		friend DualNumber atan(const DualNumber &a) { return DualNumber(std::atan(a.m_value), (static_cast<Scalar>(1.0) / (static_cast<Scalar>(1.0) + a.m_value * a.m_value)) * a.m_derivatives); }
+		friend DualNumber atan2(const DualNumber &y, const DualNumber &x)
+		{
+			const Scalar invR2 = static_cast<Scalar>(1.0) / (x.m_value * x.m_value + y.m_value * y.m_value);
+			return DualNumber(std::atan2(y.m_value, x.m_value), (x.m_value * invR2) * y.m_derivatives - (y.m_value * invR2) * x.m_derivatives);
+		}
+		friend DualNumber exp(const DualNumber &a)
+		{
+			const Scalar e = std::exp(a.m_value);
+			return DualNumber(e, e * a.m_derivatives);
+		}
+		friend DualNumber log(const DualNumber &a) { return DualNumber(std::log(a.m_value), (static_cast<Scalar>(1.0) / a.m_value) * a.m_derivatives); }
+		friend DualNumber pow(const DualNumber &a, const Scalar b)
+		{
+			const Scalar p = std::pow(a.m_value, b - static_cast<Scalar>(1.0));
+			return DualNumber(p * a.m_value, (b * p) * a.m_derivatives);
+		}
+	};
+}
+
+namespace Eigen
+{
+	/** Dual numbers can be used as scalar type of Eigen matrices. */
+	template<typename Scalar, int N>
+	struct NumTraits<PBD::DualNumber<Scalar, N> > : NumTraits<Scalar>
+	{
+		typedef PBD::DualNumber<Scalar, N> Real;
+		typedef PBD::DualNumber<Scalar, N> NonInteger;
+		typedef PBD::DualNumber<Scalar, N> Nested;
+		typedef Scalar Literal;
+		enum
+		{
+			IsComplex = 0,
+			IsInteger = 0,
+			IsSigned = 1,
+			RequireInitialization = 1,
+			ReadCost = 1,
+			AddCost = 3,
+			MulCost = 3
+		};
+	};
+
+	template<typename Scalar, int N, typename BinaryOp>
+	struct ScalarBinaryOpTraits<PBD::DualNumber<Scalar, N>, Scalar, BinaryOp>
+	{
+		typedef PBD::DualNumber<Scalar, N> ReturnType;
+	};
+
+	template<typename Scalar, int N, typename BinaryOp>
+	struct ScalarBinaryOpTraits<Scalar, PBD::DualNumber<Scalar, N>, BinaryOp>
+	{
+		typedef PBD::DualNumber<Scalar, N> ReturnType;
+	};
+}
+
+#endif
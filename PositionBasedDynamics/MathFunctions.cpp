@@ -1,5 +1,7 @@
 #include "MathFunctions.h"
 #include <cfloat>
+#include <algorithm>
+#include <limits>
 
 using namespace PBD;
 
@@ -417,4 +419,273 @@ void MathFunctions::extractRotation(const Matrix3r &A, Quaternionr &q,	const uns
 		q = Quaternionr(AngleAxisr(w, (1.0 / w) * omega)) *	q;
 		q.normalize();
 	}
-}
\ No newline at end of file
+}
+
+// ----------------------------------------------------------------------------------------------
+/** Conjugation S = Q^T S Q of the symmetric matrices S with the Jacobi rotation Q in the
+ * (p, q) plane which sets the entry (p, q) to zero. The rotation is accumulated in V = V Q.
+ */
+template<int p, int q>
+static inline void jacobiConjugationBatch(MathFunctions::RealBatch S[3][3], MathFunctions::RealBatch V[3][3])
+{
+	typedef MathFunctions::RealBatch RealBatch;
+
+	// The rotation angle theta is determined by tan(2 theta) = 2 S(p,q) / (S(p,p) - S(q,q))
+	// with |theta| <= pi/4. Eigen does not vectorize comparisons and select(), so the
+	// cases are handled by masks.
+	const RealBatch d = S[p][p] - S[q][q];
+	const RealBatch h = static_cast<Real>(2.0) * S[p][q];
+	RealBatch mask, sign;
+	for (int j = 0; j < MathFunctions::BatchSize; j++)
+	{
+		mask[j] = (h[j] != 0.0) ? static_cast<Real>(1.0) : static_cast<Real>(0.0);
+		sign[j] = (d[j] < 0.0) ? static_cast<Real>(-1.0) : static_cast<Real>(1.0);
+	}
+	const RealBatch invR = mask * (d * d + h * h).max(REAL_MIN).rsqrt();
+	const RealBatch cos2 = d.abs() * invR + (static_cast<Real>(1.0) - mask);
+	const RealBatch sin2 = sign * h * invR;
+	const RealBatch c = (static_cast<Real>(0.5) * (static_cast<Real>(1.0) + cos2)).sqrt();
+	const RealBatch s = static_cast<Real>(0.5) * sin2 / c;
+
+	// S = S Q, V = V Q
+	for (int k = 0; k < 3; k++)
+	{
+		RealBatch tmp = c * S[k][p] + s * S[k][q];
+		S[k][q] = c * S[k][q] - s * S[k][p];
+		S[k][p] = tmp;
+
+		tmp = c * V[k][p] + s * V[k][q];
+		V[k][q] = c * V[k][q] - s * V[k][p];
+		V[k][p] = tmp;
+	}
+	// S = Q^T S
+	for (int k = 0; k < 3; k++)
+	{
+		const RealBatch tmp = c * S[p][k] + s * S[q][k];
+		S[q][k] = c * S[q][k] - s * S[p][k];
+		S[p][k] = tmp;
+	}
+}
+
+// ----------------------------------------------------------------------------------------------
+/** Diagonalize the symmetric matrices S by a fixed number of cyclic Jacobi sweeps.
+ * The rotations are accumulated in V.
+ */
+static inline void jacobiSweepsBatch(MathFunctions::RealBatch S[3][3], MathFunctions::RealBatch V[3][3])
+{
+	const int numSweeps = 4;
+	for (int sweep = 0; sweep < numSweeps; sweep++)
+	{
+		jacobiConjugationBatch<0, 1>(S, V);
+		jacobiConjugationBatch<1, 2>(S, V);
+		jacobiConjugationBatch<0, 2>(S, V);
+	}
+}
+
+// ----------------------------------------------------------------------------------------------
+/** Swap the columns i and j of B and V if column i has a smaller norm. One column is
+ * negated, so that V remains a rotation.
+ */
+template<int i, int j>
+static inline void sortColumnsBatch(MathFunctions::RealBatch B[3][3], MathFunctions::RealBatch V[3][3], MathFunctions::RealBatch rho[3])
+{
+	typedef MathFunctions::RealBatch RealBatch;
+	RealBatch swap;
+	for (int l = 0; l < MathFunctions::BatchSize; l++)
+		swap[l] = (rho[i][l] < rho[j][l]) ? static_cast<Real>(1.0) : static_cast<Real>(0.0);
+	const RealBatch keep = static_cast<Real>(1.0) - swap;
+
+	for (int k = 0; k < 3; k++)
+	{
+		RealBatch tmp = keep * B[k][i] + swap * B[k][j];
+		B[k][j] = keep * B[k][j] - swap * B[k][i];
+		B[k][i] = tmp;
+
+		tmp = keep * V[k][i] + swap * V[k][j];
+		V[k][j] = keep * V[k][j] - swap * V[k][i];
+		V[k][i] = tmp;
+	}
+	const RealBatch tmp = keep * rho[i] + swap * rho[j];
+	rho[j] = keep * rho[j] + swap * rho[i];
+	rho[i] = tmp;
+}
+
+// ----------------------------------------------------------------------------------------------
+/** Givens rotation G of the rows p and q of B which sets the entry (q, p) to zero.
+ * The rotation is accumulated in U = U G^T.
+ */
+template<int p, int q>
+static inline void qrGivensBatch(MathFunctions::RealBatch B[3][3], MathFunctions::RealBatch U[3][3])
+{
+	typedef MathFunctions::RealBatch RealBatch;
+	const RealBatch &a1 = B[p][p];
+	const RealBatch &a2 = B[q][p];
+	const RealBatch r = (a1 * a1 + a2 * a2).sqrt();
+	RealBatch mask;
+	for (int j = 0; j < MathFunctions::BatchSize; j++)
+		mask[j] = (r[j] > REAL_MIN) ? static_cast<Real>(1.0) : static_cast<Real>(0.0);
+	const RealBatch invR = mask / r.max(REAL_MIN);
+	const RealBatch c = a1 * invR + (static_cast<Real>(1.0) - mask);
+	const RealBatch s = a2 * invR;
+
+	for (int k = 0; k < 3; k++)
+	{
+		RealBatch tmp = c * B[p][k] + s * B[q][k];
+		B[q][k] = c * B[q][k] - s * B[p][k];
+		B[p][k] = tmp;
+
+		tmp = c * U[k][p] + s * U[k][q];
+		U[k][q] = c * U[k][q] - s * U[k][p];
+		U[k][p] = tmp;
+	}
+}
+
+// ----------------------------------------------------------------------------------------------
+void MathFunctions::svdWithInversionHandlingBatch(const Matrix3Batch &A, Vector3Batch &sigma, Matrix3Batch &U, Matrix3Batch &V)
+{
+	RealBatch a[3][3];
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 3; j++)
+			a[i][j] = A.col(i + 3 * j);
+
+	// Symmetric eigen decomposition of A^T A by Jacobi sweeps
+	RealBatch S[3][3], v[3][3];
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			S[i][j] = a[0][i] * a[0][j] + a[1][i] * a[1][j] + a[2][i] * a[2][j];
+			v[i][j].setConstant((i == j) ? static_cast<Real>(1.0) : static_cast<Real>(0.0));
+		}
+	}
+	jacobiSweepsBatch(S, v);
+
+	// B = A V, sort the columns by decreasing norm
+	RealBatch B[3][3], rho[3];
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 3; j++)
+			B[i][j] = a[i][0] * v[0][j] + a[i][1] * v[1][j] + a[i][2] * v[2][j];
+	for (int j = 0; j < 3; j++)
+		rho[j] = B[0][j] * B[0][j] + B[1][j] * B[1][j] + B[2][j] * B[2][j];
+	sortColumnsBatch<0, 1>(B, v, rho);
+	sortColumnsBatch<0, 2>(B, v, rho);
+	sortColumnsBatch<1, 2>(B, v, rho);
+
+	// QR decomposition B = U R, where R is diagonal since the columns of B are orthogonal
+	RealBatch u[3][3];
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 3; j++)
+			u[i][j].setConstant((i == j) ? static_cast<Real>(1.0) : static_cast<Real>(0.0));
+	qrGivensBatch<0, 1>(B, u);
+	qrGivensBatch<0, 2>(B, u);
+	qrGivensBatch<1, 2>(B, u);
+
+	for (int i = 0; i < 3; i++)
+	{
+		sigma.col(i) = B[i][i];
+		for (int j = 0; j < 3; j++)
+		{
+			U.col(i + 3 * j) = u[i][j];
+			V.col(i + 3 * j) = v[i][j];
+		}
+	}
+}
+
+// ----------------------------------------------------------------------------------------------
+void MathFunctions::eigenDecompositionBatch(const Matrix3Batch &A, Matrix3Batch &eigenVecs, Vector3Batch &eigenVals)
+{
+	// only for symmetric matrices!
+	RealBatch S[3][3], v[3][3];
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			S[i][j] = A.col(i + 3 * j);
+			v[i][j].setConstant((i == j) ? static_cast<Real>(1.0) : static_cast<Real>(0.0));
+		}
+	}
+	jacobiSweepsBatch(S, v);
+
+	for (int i = 0; i < 3; i++)
+	{
+		eigenVals.col(i) = S[i][i];
+		for (int j = 0; j < 3; j++)
+			eigenVecs.col(i + 3 * j) = v[i][j];
+	}
+}
+
+// ----------------------------------------------------------------------------------------------
+void MathFunctions::polarDecompositionBatch(const Matrix3Batch &A, Matrix3Batch &R, Matrix3Batch &U, Vector3Batch &D)
+{
+	// A = U D V^T = (U D U^T) (U V^T)
+	Matrix3Batch V;
+	svdWithInversionHandlingBatch(A, D, U, V);
+
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 3; j++)
+			R.col(i + 3 * j) = U.col(i) * V.col(j) + U.col(i + 3) * V.col(j + 3) + U.col(i + 6) * V.col(j + 6);
+}
+
+// ----------------------------------------------------------------------------------------------
+void MathFunctions::polarDecompositionStableBatch(const Matrix3Batch &M, Matrix3Batch &R)
+{
+	Matrix3Batch U;
+	Vector3Batch D;
+	polarDecompositionBatch(M, R, U, D);
+}
+
+// ----------------------------------------------------------------------------------------------
+void MathFunctions::extractRotationBatch(const Matrix3Batch &A, QuaternionBatch &q, const unsigned int maxIter)
+{
+	const Real one = static_cast<Real>(1.0);
+	const Real two = static_cast<Real>(2.0);
+	// The threshold of extractRotation() is not reached in single precision
+	const Real minAngle = std::max(static_cast<Real>(1.0e-9), static_cast<Real>(10.0) * std::numeric_limits<Real>::epsilon());
+	for (unsigned int iter = 0; iter < maxIter; iter++)
+	{
+		// rotation matrices of the quaternions
+		const RealBatch x = q.col(0), y = q.col(1), z = q.col(2), w = q.col(3);
+		RealBatch R[3][3];
+		R[0][0] = one - two * (y * y + z * z);
+		R[0][1] = two * (x * y - z * w);
+		R[0][2] = two * (x * z + y * w);
+		R[1][0] = two * (x * y + z * w);
+		R[1][1] = one - two * (x * x + z * z);
+		R[1][2] = two * (y * z - x * w);
+		R[2][0] = two * (x * z - y * w);
+		R[2][1] = two * (y * z + x * w);
+		R[2][2] = one - two * (x * x + y * y);
+
+		// omega = sum_i r_i x a_i / |sum_i r_i . a_i|
+		Vector3Batch omega = Vector3Batch::Zero();
+		RealBatch dot = RealBatch::Zero();
+		for (int i = 0; i < 3; i++)
+		{
+			const RealBatch a0 = A.col(3 * i), a1 = A.col(1 + 3 * i), a2 = A.col(2 + 3 * i);
+			omega.col(0) += R[1][i] * a2 - R[2][i] * a1;
+			omega.col(1) += R[2][i] * a0 - R[0][i] * a2;
+			omega.col(2) += R[0][i] * a1 - R[1][i] * a0;
+			dot += R[0][i] * a0 + R[1][i] * a1 + R[2][i] * a2;
+		}
+		const RealBatch invDot = one / (dot.abs() + static_cast<Real>(1.0e-9));
+		for (int i = 0; i < 3; i++)
+			omega.col(i) *= invDot;
+		const RealBatch angle = (omega.col(0).square() + omega.col(1).square() + omega.col(2).square()).sqrt();
+		if ((angle < minAngle).all())
+			break;
+
+		// q = dq * q with the rotation dq about omega by the angle |omega|,
+		// the factor is zero for lanes with a vanishing angle
+		const RealBatch factor = (static_cast<Real>(0.5) * angle).sin() / angle.max(REAL_MIN);
+		const RealBatch dw = (static_cast<Real>(0.5) * angle).cos();
+		const RealBatch dx = factor * omega.col(0), dy = factor * omega.col(1), dz = factor * omega.col(2);
+		q.col(0) = dw * x + dx * w + dy * z - dz * y;
+		q.col(1) = dw * y + dy * w + dz * x - dx * z;
+		q.col(2) = dw * z + dz * w + dx * y - dy * x;
+		q.col(3) = dw * w - dx * x - dy * y - dz * z;
+
+		const RealBatch invNorm = (q.col(0).square() + q.col(1).square() + q.col(2).square() + q.col(3).square()).rsqrt();
+		for (int i = 0; i < 4; i++)
+			q.col(i) *= invNorm;
+	}
+}
@@ -50,6 +50,93 @@ namespace PBD
 		 * ACM SIGGRAPH Motion in Games, 2016
 		 */
 		static void extractRotation(const Matrix3r &A, Quaternionr &q, const unsigned int maxIter);
+
+		/** Number of matrices which are processed by the batch variants of the functions. */
+		static const int BatchSize = 8;
+		/** One value per matrix of a batch */
+		typedef Eigen::Array<Real, BatchSize, 1> RealBatch;
+		/** Vectors of a batch. Column i contains the i-th component of all vectors. */
+		typedef Eigen::Array<Real, BatchSize, 3> Vector3Batch;
+		/** 3x3 matrices of a batch. Column i + 3*j contains the entry (i, j) of all matrices
+		* (column-major as Matrix3r), so that the arithmetic is performed in SIMD lanes
+		* across the matrices.
+		*/
+		typedef Eigen::Array<Real, BatchSize, 9> Matrix3Batch;
+		/** Quaternions of a batch. The columns contain the coefficients in the order of
+		* Quaternionr::coeffs() (x, y, z, w).
+		*/
+		typedef Eigen::Array<Real, BatchSize, 4> QuaternionBatch;
+
+		/** Batch variant of eigenDecomposition() for BatchSize symmetric matrices. A fixed number
+		* of cyclic Jacobi sweeps is performed instead of the search for the largest off-diagonal
+		* element, so there are no branches. The eigenvalues are not sorted.
+		*
+		* @param  A			symmetric input matrices
+		* @param  eigenVecs	rotations whose columns are the eigenvectors
+		* @param  eigenVals	eigenvalues
+		*/
+		static void eigenDecompositionBatch(const Matrix3Batch &A,
+			Matrix3Batch &eigenVecs,
+			Vector3Batch &eigenVals);
+
+		/** Batch variant of polarDecomposition() which determines A = (U D U^T) R by
+		* svdWithInversionHandlingBatch(). R is always a rotation. For inverted matrices
+		* (det(A) < 0) the last entry of D is negative and R is the closest rotation, while
+		* the scalar function returns a reflection.
+		*
+		* @param  A		input matrices
+		* @param  R		rotations
+		* @param  U		rotations whose columns are the eigenvectors of A A^T
+		* @param  D		square roots of the eigenvalues of A A^T, see above for inversions
+		*/
+		static void polarDecompositionBatch(const Matrix3Batch &A,
+			Matrix3Batch &R,
+			Matrix3Batch &U,
+			Vector3Batch &D);
+
+		/** Batch variant of polarDecompositionStable() which only determines the rotations.
+		* The SVD handles degenerated matrices without branches, so no tolerance is required.
+		* Inverted matrices are handled as in polarDecompositionBatch().
+		*
+		* @param  M		input matrices
+		* @param  R		rotations
+		*/
+		static void polarDecompositionStableBatch(const Matrix3Batch &M,
+			Matrix3Batch &R);
+
+		/** Batch variant of svdWithInversionHandling() which determines the singular value
+		* decompositions A = U diag(sigma) V^T of BatchSize matrices at once without branches.
+		* A fixed number of Jacobi sweeps diagonalizes A^T A, the columns of A V are sorted by
+		* their norms and a QR decomposition by Givens rotations yields U and sigma. U and V are
+		* rotations and the singular values are sorted in decreasing order. The last one is
+		* negative if the matrix is inverted (det(A) < 0). \n\n
+		* The method follows the technical report below, but uses exact Jacobi rotations instead
+		* of the approximate ones since they need fewer sweeps for single precision: \n
+		* Aleka McAdams, Andrew Selle, Rasmus Tamstorf, Joseph Teran and Eftychios Sifakis,
+		* "Computing the Singular Value Decomposition of 3x3 matrices with minimal branching
+		* and elementary floating point operations", University of Wisconsin-Madison, 2011
+		*
+		* @param  A		input matrices
+		* @param  sigma	singular values
+		* @param  U		left rotations
+		* @param  V		right rotations (not transposed)
+		*/
+		static void svdWithInversionHandlingBatch(const Matrix3Batch &A,
+			Vector3Batch &sigma,
+			Matrix3Batch &U,
+			Matrix3Batch &V);
+
+		/** Batch variant of extractRotation(). The quaternions q are used as initial guesses
+		* and contain the results afterwards. The rotations of the last time step are good
+		* initial guesses (warm start), then one or two iterations are sufficient in most
+		* cases. The iteration stops when the rotations of all matrices have converged. In
+		* single precision the threshold for the convergence is 10 * epsilon instead of 1e-9.
+		*
+		* @param  A			input matrices
+		* @param  q			initial guesses and resulting rotations
+		* @param  maxIter	maximum number of iterations
+		*/
+		static void extractRotationBatch(const Matrix3Batch &A, QuaternionBatch &q, const unsigned int maxIter);
 	};
 }
 
@@ -1168,6 +1168,163 @@ bool PositionBasedDynamics::solve_FEMTetraConstraint(
 	return true;
 }
 
+// ----------------------------------------------------------------------------------------------
+void PositionBasedDynamics::computeGradCGreenBatch(const RealBatch &restVolume, const Matrix3Batch &invRestMat, const Matrix3Batch &sigma, Vector3Batch J[4])
+{
+	// H = sigma * invRestMat^T * restVolume, J[j] is column j of H
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+			J[j].col(i) = restVolume * (sigma.col(i) * invRestMat.col(j) + sigma.col(i + 3) * invRestMat.col(j + 3) + sigma.col(i + 6) * invRestMat.col(j + 6));
+	}
+	J[3] = -J[0] - J[1] - J[2];
+}
+
+// ----------------------------------------------------------------------------------------------
+void PositionBasedDynamics::computeGreenStrainAndPiolaStressBatch(
+	const Vector3Batch &x1, const Vector3Batch &x2, const Vector3Batch &x3, const Vector3Batch &x4,
+	const Matrix3Batch &invRestMat,
+	const RealBatch &restVolume,
+	const RealBatch &mu, const RealBatch &lambda,
+	const RealBatch &inversion,
+	Matrix3Batch &sigma, RealBatch &energy)
+{
+	// Determine \partial x/\partial m_i, entry (i, j) is in column i + 3*j
+	const Vector3Batch p14 = x1 - x4;
+	const Vector3Batch p24 = x2 - x4;
+	const Vector3Batch p34 = x3 - x4;
+	Matrix3Batch F;
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+			F.col(i + 3 * j) = p14.col(i) * invRestMat.col(3 * j) + p24.col(i) * invRestMat.col(1 + 3 * j) + p34.col(i) * invRestMat.col(2 + 3 * j);
+	}
+
+	// epsilon = 1/2 F^T F - I
+	Matrix3Batch epsilon;
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+			epsilon.col(i + 3 * j) = static_cast<Real>(0.5) * (F.col(3 * i) * F.col(3 * j) + F.col(1 + 3 * i) * F.col(1 + 3 * j) + F.col(2 + 3 * i) * F.col(2 + 3 * j));
+		epsilon.col(4 * i) -= static_cast<Real>(0.5);
+	}
+
+	// P(F) = F(2 mu E + lambda tr(E)I) => E = green strain
+	const RealBatch trace = epsilon.col(0) + epsilon.col(4) + epsilon.col(8);
+	Matrix3Batch S;
+	for (int k = 0; k < 9; k++)
+		S.col(k) = static_cast<Real>(2.0) * mu * epsilon.col(k);
+	for (int i = 0; i < 3; i++)
+		S.col(4 * i) += lambda * trace;
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+			sigma.col(i + 3 * j) = F.col(i) * S.col(3 * j) + F.col(i + 3) * S.col(1 + 3 * j) + F.col(i + 6) * S.col(2 + 3 * j);
+	}
+
+	const RealBatch psi = epsilon.square().rowwise().sum();
+	energy = restVolume * (mu * psi + static_cast<Real>(0.5) * lambda * trace * trace);
+
+	// Inverted tetrahedra: the stress is determined for the clamped singular values of F.
+	// The decomposition is only computed if it is required by a tetrahedron of the batch.
+	bool hasInversion = false;
+	for (int j = 0; j < BatchSize; j++)
+		hasInversion = hasInversion || (inversion[j] != 0.0);
+	if (!hasInversion)
+		return;
+
+	Vector3Batch hatF;
+	Matrix3Batch U, V;
+	MathFunctions::svdWithInversionHandlingBatch(F, hatF, U, V);
+
+	// Clamp small singular values
+	const Real minXVal = static_cast<Real>(0.577);
+	hatF = hatF.max(minXVal);
+
+	// epsilon for hatF
+	const Vector3Batch epsilonHatF = static_cast<Real>(0.5) * (hatF.square() - static_cast<Real>(1.0));
+	const RealBatch traceHatF = epsilonHatF.rowwise().sum();
+	Vector3Batch sigmaVec;
+	for (int k = 0; k < 3; k++)
+		sigmaVec.col(k) = hatF.col(k) * (static_cast<Real>(2.0) * mu * epsilonHatF.col(k) + lambda * traceHatF);
+
+	// sigma = U diag(sigmaVec) V^T, the norm of epsilon is invariant under the rotations
+	const RealBatch keep = static_cast<Real>(1.0) - inversion;
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			const RealBatch sigmaInv = U.col(i) * sigmaVec.col(0) * V.col(j) + U.col(i + 3) * sigmaVec.col(1) * V.col(j + 3) + U.col(i + 6) * sigmaVec.col(2) * V.col(j + 6);
+			sigma.col(i + 3 * j) = keep * sigma.col(i + 3 * j) + inversion * sigmaInv;
+		}
+	}
+	const RealBatch psiHatF = epsilonHatF.square().rowwise().sum();
+	energy = keep * energy + inversion * restVolume * (mu * psiHatF + static_cast<Real>(0.5) * lambda * traceHatF * traceHatF);
+}
+
+// ----------------------------------------------------------------------------------------------
+void PositionBasedDynamics::solve_FEMTetraConstraintBatch(
+	const Vector3Batch &p0, const RealBatch &invMass0,
+	const Vector3Batch &p1, const RealBatch &invMass1,
+	const Vector3Batch &p2, const RealBatch &invMass2,
+	const Vector3Batch &p3, const RealBatch &invMass3,
+	const RealBatch &restVolume,
+	const Matrix3Batch &invRestMat,
+	const RealBatch &youngsModulus,
+	const RealBatch &poissonRatio,
+	const RealBatch &handleInversion,
+	Vector3Batch &corr0, Vector3Batch &corr1, Vector3Batch &corr2, Vector3Batch &corr3)
+{
+	// only the sign of the volume is required
+	const Vector3Batch a = p1 - p0;
+	const Vector3Batch b = p2 - p0;
+	const Vector3Batch c = p3 - p0;
+	const RealBatch volume = (a.col(1) * b.col(2) - a.col(2) * b.col(1)) * c.col(0) +
+		(a.col(2) * b.col(0) - a.col(0) * b.col(2)) * c.col(1) +
+		(a.col(0) * b.col(1) - a.col(1) * b.col(0)) * c.col(2);
+
+	// Constraints with a non-positive Young's modulus or an invalid Poisson ratio have no
+	// corrections. Their Young's modulus is set to zero and the Poisson ratio is replaced,
+	// so that no invalid values arise in the SIMD lanes.
+	RealBatch valid, nu, inversion;
+	for (int j = 0; j < BatchSize; j++)
+	{
+		valid[j] = ((youngsModulus[j] > 0.0) && (poissonRatio[j] >= 0.0) && (poissonRatio[j] <= 0.49)) ? static_cast<Real>(1.0) : static_cast<Real>(0.0);
+		nu[j] = (valid[j] != 0.0) ? poissonRatio[j] : static_cast<Real>(0.0);
+		inversion[j] = ((handleInversion[j] != 0.0) && !(volume[j] > 0.0)) ? static_cast<Real>(1.0) : static_cast<Real>(0.0);
+	}
+	const RealBatch E = valid * youngsModulus;
+	const RealBatch mu = E / static_cast<Real>(2.0) / (static_cast<Real>(1.0) + nu);
+	const RealBatch lambda = E * nu / (static_cast<Real>(1.0) + nu) / (static_cast<Real>(1.0) - static_cast<Real>(2.0) * nu);
+
+	Matrix3Batch sigma;
+	RealBatch C;
+	Vector3Batch gradC[4];
+	computeGreenStrainAndPiolaStressBatch(p0, p1, p2, p3, invRestMat, restVolume, mu, lambda, inversion, sigma, C);
+	computeGradCGreenBatch(restVolume, invRestMat, sigma, gradC);
+
+	const RealBatch sum_normGradC =
+		invMass0 * gradC[0].square().rowwise().sum() +
+		invMass1 * gradC[1].square().rowwise().sum() +
+		invMass2 * gradC[2].square().rowwise().sum() +
+		invMass3 * gradC[3].square().rowwise().sum();
+
+	RealBatch solved;
+	for (int j = 0; j < BatchSize; j++)
+		solved[j] = (sum_normGradC[j] < eps) ? static_cast<Real>(0.0) : static_cast<Real>(1.0);
+
+	// compute scaling factor
+	const RealBatch s = solved * C / sum_normGradC.max(eps);
+
+	for (int i = 0; i < 3; i++)
+	{
+		corr0.col(i) = -s * invMass0 * gradC[0].col(i);
+		corr1.col(i) = -s * invMass1 * gradC[1].col(i);
+		corr2.col(i) = -s * invMass2 * gradC[2].col(i);
+		corr3.col(i) = -s * invMass3 * gradC[3].col(i);
+	}
+}
+
 // ----------------------------------------------------------------------------------------------
 bool PositionBasedDynamics::init_ParticleTetContactConstraint(
 	const Real invMass0,							// inverse mass is zero if particle is static
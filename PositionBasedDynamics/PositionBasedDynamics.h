@@ -2,6 +2,7 @@
 #define POSITION_BASED_DYNAMICS_H
 
 #include "Common/Common.h"
+#include "MathFunctions.h"
 
 // ------------------------------------------------------------------------------------
 namespace PBD
@@ -387,6 +388,37 @@ namespace PBD
 			const Real mu, const Real lambda,
 			Matrix3r &epsilon, Matrix3r &sigma, Real &energy);
 
+		/** Number of constraints which are processed by the batch variants of the solvers. */
+		static const int BatchSize = MathFunctions::BatchSize;
+		/** One value per constraint of a batch */
+		typedef MathFunctions::RealBatch RealBatch;
+		/** Vectors of a batch of constraints. Column i contains the i-th component of all vectors,
+		* so that the arithmetic is performed in SIMD lanes across the constraints.
+		*/
+		typedef MathFunctions::Vector3Batch Vector3Batch;
+		/** 3x3 matrices of a batch of constraints, see MathFunctions::Matrix3Batch */
+		typedef MathFunctions::Matrix3Batch Matrix3Batch;
+
+		/** Batch variant of computeGradCGreen(). */
+		static void computeGradCGreenBatch(
+			const RealBatch &restVolume,
+			const Matrix3Batch &invRestMat,
+			const Matrix3Batch &sigma,
+			Vector3Batch J[4]);
+
+		/** Batch variant of computeGreenStrainAndPiolaStress() and computeGreenStrainAndPiolaStressInversion()
+		* which determines the stress and the energy of BatchSize tetrahedra at once. The inversion
+		* handling is used for the tetrahedra with inversion = 1. Its singular value decomposition
+		* is only computed if the batch contains such a tetrahedron. The strain is not returned.
+		*/
+		static void computeGreenStrainAndPiolaStressBatch(
+			const Vector3Batch &x1, const Vector3Batch &x2, const Vector3Batch &x3, const Vector3Batch &x4,
+			const Matrix3Batch &invRestMat,
+			const RealBatch &restVolume,
+			const RealBatch &mu, const RealBatch &lambda,
+			const RealBatch &inversion,
+			Matrix3Batch &sigma, RealBatch &energy);
+
 
 	public:
 		/** Implementation of the finite element method described in \n\n
@@ -457,6 +489,23 @@ namespace PBD
 			const bool  handleInversion,
 			Vector3r &corr0, Vector3r &corr1, Vector3r &corr2, Vector3r &corr3);
 
+		/** Batch variant of solve_FEMTetraConstraint() which determines the corrections of
+		* BatchSize independent constraints at once. The parameters are the same as for the
+		* single constraint, where row j of each batch belongs to the j-th constraint and
+		* handleInversion is 1 or 0. The corrections of the constraints which cannot be
+		* solved (e.g. with an invalid Poisson ratio) are zero.
+		*/
+		static void solve_FEMTetraConstraintBatch(
+			const Vector3Batch &p0, const RealBatch &invMass0,
+			const Vector3Batch &p1, const RealBatch &invMass1,
+			const Vector3Batch &p2, const RealBatch &invMass2,
+			const Vector3Batch &p3, const RealBatch &invMass3,
+			const RealBatch &restVolume,
+			const Matrix3Batch &invRestMat,
+			const RealBatch &youngsModulus,
+			const RealBatch &poissonRatio,
+			const RealBatch &handleInversion,
+			Vector3Batch &corr0, Vector3Batch &corr1, Vector3Batch &corr2, Vector3Batch &corr3);
 
 		/** Initialize contact between a particle and a tetrahedron and return
 		* info which is required by the solver step.
@@ -2,6 +2,7 @@
 #include "PositionBasedDynamics/MathFunctions.h"
 
 #include "Utils/Logger.h"
+#include <algorithm>
 
 #define _USE_MATH_DEFINES
 #include "math.h"
@@ -78,6 +79,126 @@ bool PositionBasedCosseratRods::solve_BendTwistConstraint(
 	return true;
 }
 
+// ----------------------------------------------------------------------------------------------
+/** Quaternion product a * b of two batches of quaternions (coefficients x, y, z, w). */
+static inline void quaternionProductBatch(
+	const PositionBasedCosseratRods::QuaternionBatch& a,
+	const PositionBasedCosseratRods::QuaternionBatch& b,
+	PositionBasedCosseratRods::QuaternionBatch& result)
+{
+	result.col(0) = a.col(3) * b.col(0) + a.col(0) * b.col(3) + a.col(1) * b.col(2) - a.col(2) * b.col(1);
+	result.col(1) = a.col(3) * b.col(1) + a.col(1) * b.col(3) + a.col(2) * b.col(0) - a.col(0) * b.col(2);
+	result.col(2) = a.col(3) * b.col(2) + a.col(2) * b.col(3) + a.col(0) * b.col(1) - a.col(1) * b.col(0);
+	result.col(3) = a.col(3) * b.col(3) - a.col(0) * b.col(0) - a.col(1) * b.col(1) - a.col(2) * b.col(2);
+}
+
+// ----------------------------------------------------------------------------------------------
+void PositionBasedCosseratRods::solve_StretchShearConstraintBatch(
+	const Vector3Batch& p0, const RealBatch& invMass0,
+	const Vector3Batch& p1, const RealBatch& invMass1,
+	const QuaternionBatch& q0, const RealBatch& invMassq0,
+	const Vector3Batch& stretchingAndShearingKs,
+	const RealBatch& restLength,
+	Vector3Batch& corr0, Vector3Batch& corr1, QuaternionBatch& corrq0)
+{
+	const RealBatch qx = q0.col(0);
+	const RealBatch qy = q0.col(1);
+	const RealBatch qz = q0.col(2);
+	const RealBatch qw = q0.col(3);
+
+	Vector3Batch d3;	//third director d3 = q0 * e_3 * q0_conjugate
+	d3.col(0) = static_cast<Real>(2.0) * (qx * qz + qw * qy);
+	d3.col(1) = static_cast<Real>(2.0) * (qy * qz - qw * qx);
+	d3.col(2) = qw * qw - qx * qx - qy * qy + qz * qz;
+
+	const RealBatch invRestLength = restLength.inverse();
+	const RealBatch invDenominator = ((invMass1 + invMass0) * invRestLength + invMassq0 * static_cast<Real>(4.0) * restLength + eps).inverse();
+	Vector3Batch gamma;
+	for (int i = 0; i < 3; i++)
+		gamma.col(i) = ((p1.col(i) - p0.col(i)) * invRestLength - d3.col(i)) * invDenominator;
+
+	// Different stretching and shearing Ks: transform diag(Ks[0], Ks[1], Ks[2]) into world space using
+	// Ks_w = R(q0) * diag(Ks[0], Ks[1], Ks[2]) * R^T(q0). The rotation is computed for all constraints
+	// and the result is selected per constraint.
+	const RealBatch tx = static_cast<Real>(2.0) * qx;
+	const RealBatch ty = static_cast<Real>(2.0) * qy;
+	const RealBatch tz = static_cast<Real>(2.0) * qz;
+	const RealBatch txx = tx * qx, txy = ty * qx, txz = tz * qx;
+	const RealBatch tyy = ty * qy, tyz = tz * qy, tzz = tz * qz;
+	const RealBatch twx = tx * qw, twy = ty * qw, twz = tz * qw;
+	const RealBatch R00 = static_cast<Real>(1.0) - (tyy + tzz), R01 = txy - twz, R02 = txz + twy;
+	const RealBatch R10 = txy + twz, R11 = static_cast<Real>(1.0) - (txx + tzz), R12 = tyz - twx;
+	const RealBatch R20 = txz - twy, R21 = tyz + twx, R22 = static_cast<Real>(1.0) - (txx + tyy);
+
+	const RealBatch l0 = (R00 * gamma.col(0) + R10 * gamma.col(1) + R20 * gamma.col(2)) * stretchingAndShearingKs.col(0);
+	const RealBatch l1 = (R01 * gamma.col(0) + R11 * gamma.col(1) + R21 * gamma.col(2)) * stretchingAndShearingKs.col(1);
+	const RealBatch l2 = (R02 * gamma.col(0) + R12 * gamma.col(1) + R22 * gamma.col(2)) * stretchingAndShearingKs.col(2);
+
+	// Selection of the result per constraint. Eigen does not vectorize comparisons and select(),
+	// so the results are blended by a mask which is 1 for the constraints with equal Ks.
+	RealBatch equalKs;
+	for (int j = 0; j < BatchSize; j++)
+		equalKs[j] = (std::abs(stretchingAndShearingKs(j, 0) - stretchingAndShearingKs(j, 1)) < eps &&
+			std::abs(stretchingAndShearingKs(j, 0) - stretchingAndShearingKs(j, 2)) < eps) ? static_cast<Real>(1.0) : static_cast<Real>(0.0);
+	const RealBatch rotatedKs = static_cast<Real>(1.0) - equalKs;
+	gamma.col(0) = equalKs * gamma.col(0) * stretchingAndShearingKs.col(0) + rotatedKs * (R00 * l0 + R01 * l1 + R02 * l2);
+	gamma.col(1) = equalKs * gamma.col(1) * stretchingAndShearingKs.col(1) + rotatedKs * (R10 * l0 + R11 * l1 + R12 * l2);
+	gamma.col(2) = equalKs * gamma.col(2) * stretchingAndShearingKs.col(2) + rotatedKs * (R20 * l0 + R21 * l1 + R22 * l2);
+
+	for (int i = 0; i < 3; i++)
+	{
+		corr0.col(i) = invMass0 * gamma.col(i);
+		corr1.col(i) = -invMass1 * gamma.col(i);
+	}
+
+	// corrq0 = (0, gamma) * q_e_3_bar with q_e_3_bar = (w: q0.z, x: -q0.y, y: q0.x, z: -q0.w)
+	const RealBatch s = static_cast<Real>(2.0) * invMassq0 * restLength;
+	corrq0.col(0) = (gamma.col(0) * qz + gamma.col(1) * (-qw) - gamma.col(2) * qx) * s;
+	corrq0.col(1) = (gamma.col(1) * qz + gamma.col(2) * (-qy) - gamma.col(0) * (-qw)) * s;
+	corrq0.col(2) = (gamma.col(2) * qz + gamma.col(0) * qx - gamma.col(1) * (-qy)) * s;
+	corrq0.col(3) = -(gamma.col(0) * (-qy) + gamma.col(1) * qx + gamma.col(2) * (-qw)) * s;
+}
+
+// ----------------------------------------------------------------------------------------------
+void PositionBasedCosseratRods::solve_BendTwistConstraintBatch(
+	const QuaternionBatch& q0, const RealBatch& invMassq0,
+	const QuaternionBatch& q1, const RealBatch& invMassq1,
+	const Vector3Batch& bendingAndTwistingKs,
+	const QuaternionBatch& restDarbouxVector,
+	QuaternionBatch& corrq0, QuaternionBatch& corrq1)
+{
+	QuaternionBatch q0conjugate;
+	q0conjugate.leftCols<3>() = -q0.leftCols<3>();
+	q0conjugate.col(3) = q0.col(3);
+
+	QuaternionBatch omega;
+	quaternionProductBatch(q0conjugate, q1, omega);   //darboux vector
+
+	const QuaternionBatch omega_plus = omega + restDarbouxVector;     //delta Omega with -Omega_0
+	omega -= restDarbouxVector;                                       //delta Omega with + omega_0
+	const RealBatch normMinus = omega.col(0).square() + omega.col(1).square() + omega.col(2).square() + omega.col(3).square();
+	const RealBatch normPlus = omega_plus.col(0).square() + omega_plus.col(1).square() + omega_plus.col(2).square() + omega_plus.col(3).square();
+	RealBatch usePlus;		// blend mask since Eigen does not vectorize select()
+	for (int j = 0; j < BatchSize; j++)
+		usePlus[j] = (normMinus[j] > normPlus[j]) ? static_cast<Real>(1.0) : static_cast<Real>(0.0);
+	const RealBatch useMinus = static_cast<Real>(1.0) - usePlus;
+	for (int i = 0; i < 4; i++)
+		omega.col(i) = usePlus * omega_plus.col(i) + useMinus * omega.col(i);
+
+	const RealBatch invMassSum = (invMassq0 + invMassq1 + static_cast<Real>(1.0e-6)).inverse();
+	for (int i = 0; i < 3; i++)
+		omega.col(i) *= bendingAndTwistingKs.col(i) * invMassSum;
+	omega.col(3).setZero();    //discrete Darboux vector does not have vanishing scalar part
+
+	quaternionProductBatch(q1, omega, corrq0);
+	quaternionProductBatch(q0, omega, corrq1);
+	for (int i = 0; i < 4; i++)
+	{
+		corrq0.col(i) *= invMassq0;
+		corrq1.col(i) *= -invMassq1;
+	}
+}
+
 // ----------------------------------------------------------------------------------------------
 bool PositionBasedElasticRods::solve_PerpendiculaBisectorConstraint(
 	const Vector3r &p0, Real invMass0,
@@ -461,177 +582,217 @@ bool PositionBasedElasticRods::computeDarbouxGradient(
 // ----------------------------------------------------------------------------------------------
 
 
-void PBD::DirectPositionBasedSolverForStiffRods::initLists(int numberOfIntervals, std::list <Node*> * &forward, std::list <Node*> * &backward, Node* &root)
+void PBD::DirectPositionBasedSolverForStiffRods::initLists(int numberOfIntervals, RodTree* &trees)
 {
-	if (forward != NULL)
-		delete[] forward;
-	if (backward != NULL)
-		delete[] backward;
-	if (root != NULL)
-		delete[] root;
-	forward = new std::list<Node*>[numberOfIntervals];
-	backward = new std::list<Node*>[numberOfIntervals];
-	root = new Node[numberOfIntervals];
+	if (trees != NULL)
+		delete[] trees;
+	trees = new RodTree[numberOfIntervals];
 }
 
-bool PBD::DirectPositionBasedSolverForStiffRods::isSegmentInInterval(RodSegment *segment, int intervalIndex, Interval* intervals, std::vector<RodConstraint*> &rodConstraints, std::vector<RodSegment*> &rodSegments)
+bool PBD::DirectPositionBasedSolverForStiffRods::isSegmentInInterval(const std::vector<int> &segmentConstraints, int intervalIndex, Interval* intervals)
 {
-	for (int i = intervals[intervalIndex].start; i <= intervals[intervalIndex].end; i++)
+	for (size_t i = 0; i < segmentConstraints.size(); i++)
 	{
-		if ((segment == rodSegments[rodConstraints[i]->segmentIndex(0)])
-			|| (segment == rodSegments[rodConstraints[i]->segmentIndex(1)]))
+		if ((segmentConstraints[i] >= intervals[intervalIndex].start) && (segmentConstraints[i] <= intervals[intervalIndex].end))
 			return true;
 	}
 	return false;
 }
 
-bool PBD::DirectPositionBasedSolverForStiffRods::isConstraintInInterval(RodConstraint *constraint, int intervalIndex, Interval* intervals, std::vector<RodConstraint*> &rodConstraints)
+void PBD::DirectPositionBasedSolverForStiffRods::initNodes(int intervalIndex, std::vector<RodSegment*> &rodSegments, Interval* intervals, std::vector<RodConstraint*> &rodConstraints, const std::vector<std::vector<int>> &segmentConstraints, RodTree &tree)
 {
-	for (int i = intervals[intervalIndex].start; i <= intervals[intervalIndex].end; i++)
+	// find root
+	int rootIndex = -1;
+	for (int i = 0; i < (int)rodSegments.size(); i++)
 	{
-		if (constraint == rodConstraints[i])
-			return true;
-	}
-	return false;
-}
-
-void PBD::DirectPositionBasedSolverForStiffRods::initSegmentNode(Node *n, int intervalIndex, std::vector<RodConstraint*> &rodConstraints, std::vector<RodSegment*> &rodSegments, std::vector <RodConstraint*> &markedConstraints, Interval* intervals)
-{
-	RodSegment *segment =
-		(RodSegment*)n->object;
+		if (!isSegmentInInterval(segmentConstraints[i], intervalIndex, intervals))
+			continue;
+		if (rootIndex == -1)
+			rootIndex = i;
 
-	std::vector<RodConstraint*> constraints;
-	std::vector<int> constraintIndices;
-	for (int j = 0; j < static_cast<int>(rodConstraints.size()); ++j)
-	{
-		RodConstraint* constraint(rodConstraints[j]);
-		if (rodSegments[constraint->segmentIndex(0)] == segment
-			|| rodSegments[constraint->segmentIndex(1)] == segment)
+		if (!rodSegments[i]->isDynamic())
 		{
-			constraints.push_back(constraint);
-			constraintIndices.push_back(j);
+			rootIndex = i;
+			break;
 		}
 	}
+	tree.nodes.clear();
+	tree.childrenStart.clear();
+	tree.children.clear();
+	tree.subtrees.clear();
+	tree.topNodes.clear();
+	if (rootIndex == -1)
+		return;
 
-	for (unsigned int i = 0; i < constraints.size(); i++)
+	// Visit all segments depth first starting at the root and insert constraint nodes
+	// between them. The nodes are created in preorder, an explicit stack is used
+	// since rods may consist of thousands of segments.
+	std::vector<Node> preorderNodes;
+	std::vector<std::vector<int>> preorderChildren;
+	std::vector<bool> markedConstraints(rodConstraints.size(), false);
+	std::vector<std::pair<int, size_t>> stack;		// (segment node, next constraint of the segment)
+
+	preorderNodes.push_back(Node());
+	preorderNodes.back().object = rodSegments[rootIndex];
+	preorderNodes.back().index = rootIndex;
+	preorderChildren.push_back(std::vector<int>());
+	stack.push_back(std::make_pair(0, (size_t)0));
+	while (!stack.empty())
 	{
-		if (!isConstraintInInterval(constraints[i], intervalIndex, intervals, rodConstraints))
-			continue;
-
-		// Test whether the edge has been visited before
-		bool marked = false;
-		for (unsigned int j = 0; j < markedConstraints.size(); j++)
+		const int segmentNodeIndex = stack.back().first;
+		const int segmentIndex = preorderNodes[segmentNodeIndex].index;
+		const std::vector<int> &constraints = segmentConstraints[segmentIndex];
+		size_t &next = stack.back().second;
+
+		// find next constraint of the interval which has not been visited before
+		int constraintIndex = -1;
+		while ((next < constraints.size()) && (constraintIndex == -1))
 		{
-			if (constraints[i] == markedConstraints[j])
-			{
-				marked = true;
-				break;
-			}
+			const int j = constraints[next++];
+			if ((j >= intervals[intervalIndex].start) && (j <= intervals[intervalIndex].end) && !markedConstraints[j])
+				constraintIndex = j;
 		}
-		if (!marked)
+		if (constraintIndex == -1)
 		{
-			Node *constraintNode = new Node();
-			constraintNode->index = constraintIndices[i];
-			constraintNode->object = constraints[i];
-			constraintNode->isconstraint = true;
-			constraintNode->parent = n;
-			constraintNode->D.setZero();
-			constraintNode->Dinv.setZero();
-			constraintNode->J.setZero();
-			constraintNode->soln.setZero();
-
-			n->children.push_back(constraintNode);
-
-			Node *segmentNode = new Node();
-			segmentNode->isconstraint = false;
-			segmentNode->parent = constraintNode;
-
-			//	get other segment connected to constraint for new node
-			if (rodSegments[constraints[i]->segmentIndex(0)] == segment)
-			{
-				segmentNode->object = rodSegments[constraints[i]->segmentIndex(1)];
-				segmentNode->index = constraints[i]->segmentIndex(1);
-			}
-			else
-			{
-				segmentNode->object = rodSegments[constraints[i]->segmentIndex(0)];
-				segmentNode->index = constraints[i]->segmentIndex(0);
-			}
-
-			segmentNode->D.setZero();
-			segmentNode->Dinv.setZero();
-			segmentNode->J.setZero();
-			segmentNode->soln.setZero();
-
-			constraintNode->children.push_back(segmentNode);
-
-			// mark constraint
-			markedConstraints.push_back(constraints[i]);
+			stack.pop_back();
+			continue;
+		}
+		markedConstraints[constraintIndex] = true;
+
+		RodConstraint *constraint = rodConstraints[constraintIndex];
+		const int constraintNodeIndex = (int)preorderNodes.size();
+		preorderNodes.push_back(Node());
+		preorderNodes.back().index = constraintIndex;
+		preorderNodes.back().object = constraint;
+		preorderNodes.back().isconstraint = true;
+		preorderNodes.back().parent = segmentNodeIndex;
+		preorderChildren.push_back(std::vector<int>());
+		preorderChildren[segmentNodeIndex].push_back(constraintNodeIndex);
+
+		//	get other segment connected to constraint for new node
+		int otherSegmentIndex = constraint->segmentIndex(0);
+		if (otherSegmentIndex == segmentIndex)
+			otherSegmentIndex = constraint->segmentIndex(1);
+
+		const int otherNodeIndex = (int)preorderNodes.size();
+		preorderNodes.push_back(Node());
+		preorderNodes.back().object = rodSegments[otherSegmentIndex];
+		preorderNodes.back().index = otherSegmentIndex;
+		preorderNodes.back().parent = constraintNodeIndex;
+		preorderChildren.push_back(std::vector<int>());
+		preorderChildren[constraintNodeIndex].push_back(otherNodeIndex);
+
+		stack.push_back(std::make_pair(otherNodeIndex, (size_t)0));
+	}
 
-			initSegmentNode(segmentNode, intervalIndex, rodConstraints,
-				rodSegments, markedConstraints, intervals);
+	// Sort the nodes in postorder, i.e. with increasing row index in the system matrix H
+	// (from the leaves to the root).
+	const int numNodes = (int)preorderNodes.size();
+	std::vector<int> order;
+	std::vector<int> newIndex(numNodes);
+	order.reserve(numNodes);
+	std::vector<std::pair<int, size_t>> postorderStack;
+	postorderStack.push_back(std::make_pair(0, (size_t)0));
+	while (!postorderStack.empty())
+	{
+		const int n = postorderStack.back().first;
+		size_t &next = postorderStack.back().second;
+		if (next < preorderChildren[n].size())
+			postorderStack.push_back(std::make_pair(preorderChildren[n][next++], (size_t)0));
+		else
+		{
+			newIndex[n] = (int)order.size();
+			order.push_back(n);
+			postorderStack.pop_back();
 		}
 	}
-}
 
-void PBD::DirectPositionBasedSolverForStiffRods::orderMatrix(Node *n, int intervalIndex, std::list <Node*> * forward, std::list <Node*> * backward)
-{
-	for (unsigned int i = 0; i < n->children.size(); i++)
-		orderMatrix(n->children[i], intervalIndex, forward, backward);
-	forward[intervalIndex].push_back(n);
-	backward[intervalIndex].push_front(n);
+	tree.nodes.resize(numNodes);
+	tree.childrenStart.resize(numNodes + 1);
+	tree.children.reserve(numNodes - 1);
+	for (int i = 0; i < numNodes; i++)
+	{
+		const int n = order[i];
+		tree.nodes[i] = preorderNodes[n];
+		if (preorderNodes[n].parent != -1)
+			tree.nodes[i].parent = newIndex[preorderNodes[n].parent];
+		tree.childrenStart[i] = (int)tree.children.size();
+		for (size_t j = 0; j < preorderChildren[n].size(); j++)
+			tree.children.push_back(newIndex[preorderChildren[n][j]]);
+	}
+	tree.childrenStart[numNodes] = (int)tree.children.size();
+
+	initSubtrees(tree);
 }
 
-void PBD::DirectPositionBasedSolverForStiffRods::initNodes(int intervalIndex, std::vector<RodSegment*> &rodSegments, Node* &root, Interval* intervals, std::vector<RodConstraint*> &rodConstraints, std::list <Node*> * forward, std::list <Node*> * backward, std::vector <RodConstraint*> &markedConstraints)
+void PBD::DirectPositionBasedSolverForStiffRods::initSubtrees(RodTree &tree)
 {
-	// find root
-	for (int i = 0; i < (int)rodSegments.size(); i++)
+	// Only subtrees with branches are split. A subtree without branches (a chain of segments)
+	// is processed by one thread since each node depends on its child.
+	const int numNodes = (int)tree.nodes.size();
+	std::vector<int> subtreeSize(numNodes);
+	std::vector<bool> split(numNodes);
+	for (int i = 0; i < numNodes; i++)
 	{
-		RodSegment * rb(rodSegments[i]);
-		if (!isSegmentInInterval(rb, intervalIndex, intervals, rodConstraints, rodSegments))
-			continue;
-		else
+		subtreeSize[i] = 1;
+		bool splitChild = false;
+		for (int j = tree.childrenStart[i]; j < tree.childrenStart[i + 1]; j++)
 		{
-			if (root[intervalIndex].object == NULL)
-			{
-				root[intervalIndex].object = rb;
-				root[intervalIndex].index = i;
-			}
+			const int child = tree.children[j];
+			subtreeSize[i] += subtreeSize[child];
+			splitChild = splitChild || split[child];
 		}
+		split[i] = (subtreeSize[i] > MIN_PARALLEL_SIZE) &&
+			((tree.childrenStart[i + 1] - tree.childrenStart[i] > 1) || splitChild);
+	}
 
-		if (!rb->isDynamic())
+	std::vector<int> todo;
+	if (numNodes > 0)
+		todo.push_back(numNodes - 1);
+	while (!todo.empty())
+	{
+		const int n = todo.back();
+		todo.pop_back();
+		if (split[n])
 		{
-			root[intervalIndex].object = rb;
-			root[intervalIndex].index = i;
-			break;
+			tree.topNodes.push_back(n);
+			for (int j = tree.childrenStart[n]; j < tree.childrenStart[n + 1]; j++)
+				todo.push_back(tree.children[j]);
+		}
+		else
+		{
+			Interval subtree;
+			subtree.start = n - subtreeSize[n] + 1;
+			subtree.end = n;
+			tree.subtrees.push_back(subtree);
 		}
 	}
-	root[intervalIndex].isconstraint = false;
-	root[intervalIndex].parent = NULL;
-
-	root[intervalIndex].D.setZero();
-	root[intervalIndex].Dinv.setZero();
-	root[intervalIndex].soln.setZero();
-
-	initSegmentNode(&root[intervalIndex], intervalIndex, rodConstraints,
-		rodSegments, markedConstraints, intervals);
-	orderMatrix(&root[intervalIndex], intervalIndex, forward, backward);
+	std::sort(tree.topNodes.begin(), tree.topNodes.end());
 }
 
-void PBD::DirectPositionBasedSolverForStiffRods::initTree(std::vector<RodConstraint*> &rodConstraints, std::vector<RodSegment*> & rodSegments, Interval* &intervals, int &numberOfIntervals, std::list <Node*> * &forward, std::list <Node*> * &backward, Node* &root)
+void PBD::DirectPositionBasedSolverForStiffRods::initTree(std::vector<RodConstraint*> &rodConstraints, std::vector<RodSegment*> & rodSegments, Interval* &intervals, int &numberOfIntervals, RodTree* &trees)
 {
 	numberOfIntervals = 1;
+	if (intervals != NULL)
+		delete[] intervals;
 	intervals = new Interval[1];
 	intervals[0].start = 0;
 	intervals[0].end = (int)rodConstraints.size() - 1;
-	initLists(numberOfIntervals, forward, backward, root);
+	initLists(numberOfIntervals, trees);
 
-	std::vector <RodConstraint*> markedConstraints;
-	for (int i = 0; i < numberOfIntervals; i++)
+	// constraints of each segment
+	std::vector<std::vector<int>> segmentConstraints(rodSegments.size());
+	for (int j = 0; j < (int)rodConstraints.size(); j++)
 	{
-		initNodes(i, rodSegments, root, intervals, rodConstraints, forward, backward, markedConstraints);
-		markedConstraints.clear();
+		const unsigned int s0 = rodConstraints[j]->segmentIndex(0);
+		const unsigned int s1 = rodConstraints[j]->segmentIndex(1);
+		segmentConstraints[s0].push_back(j);
+		if (s1 != s0)
+			segmentConstraints[s1].push_back(j);
 	}
+
+	for (int i = 0; i < numberOfIntervals; i++)
+		initNodes(i, rodSegments, intervals, rodConstraints, segmentConstraints, trees[i]);
 }
 
 bool PBD::DirectPositionBasedSolverForStiffRods::computeDarbouxVector(const Quaternionr & q0, const Quaternionr & q1, const Real averageSegmentLength, Vector3r & darbouxVector)
@@ -732,275 +893,319 @@ void PBD::DirectPositionBasedSolverForStiffRods::getMassMatrix(RodSegment *segme
 		M(i, j) = inertia(i - 3, j - 3);
 }
 
-Real PBD::DirectPositionBasedSolverForStiffRods::factor(const int intervalIndex, const std::vector<RodConstraint*> &rodConstraints, std::vector<RodSegment*> & rodSegments, const Interval* &intervals, std::list <Node*> * forward, std::list <Node*> * backward, std::vector<Vector6r> & RHS, std::vector<Vector6r> & lambdaSums, std::vector<std::vector<Matrix3r>> & bendingAndTorsionJacobians)
+Real PBD::DirectPositionBasedSolverForStiffRods::computeRightHandSide(const std::vector<RodConstraint*> &rodConstraints, std::vector<RodSegment*> & rodSegments, std::vector<Vector6r> & RHS, std::vector<Vector6r> & lambdaSums, std::vector<std::vector<Matrix3r>> & bendingAndTorsionJacobians)
 {
-	Real maxError(0.);
-	
 	// compute right hand side of linear equation system
-	for (size_t currentConstraintIndex = 0; currentConstraintIndex < rodConstraints.size(); ++currentConstraintIndex)
+	const int numConstraints = (int)rodConstraints.size();
+	#pragma omp parallel if(numConstraints > MIN_PARALLEL_SIZE) default(shared)
 	{
-		RodConstraint* currentConstraint = rodConstraints[currentConstraintIndex];
+		#pragma omp for schedule(static)
+		for (int currentConstraintIndex = 0; currentConstraintIndex < numConstraints; ++currentConstraintIndex)
+		{
+			RodConstraint* currentConstraint = rodConstraints[currentConstraintIndex];
 
-		RodSegment* segment0 = rodSegments[currentConstraint->segmentIndex(0)];
-		RodSegment* segment1 = rodSegments[currentConstraint->segmentIndex(1)];
+			RodSegment* segment0 = rodSegments[currentConstraint->segmentIndex(0)];
+			RodSegment* segment1 = rodSegments[currentConstraint->segmentIndex(1)];
 
-		const Quaternionr &q0 = segment0->Rotation();
-		const Quaternionr &q1 = segment1->Rotation();
+			const Quaternionr &q0 = segment0->Rotation();
+			const Quaternionr &q1 = segment1->Rotation();
 
-		const Eigen::Matrix<Real, 3, 4, Eigen::DontAlign> &constraintInfo(currentConstraint->getConstraintInfo());
-		Vector6r &rhs(RHS[currentConstraintIndex]);
+			const Eigen::Matrix<Real, 3, 4, Eigen::DontAlign> &constraintInfo(currentConstraint->getConstraintInfo());
+			Vector6r &rhs(RHS[currentConstraintIndex]);
 
-		// Compute zero-stretch part of constraint violation
-		const Vector3r &connector0 = constraintInfo.col(2);
-		const Vector3r &connector1 = constraintInfo.col(3);
-		Vector3r stretchViolation = connector0 - connector1;
+			// Compute zero-stretch part of constraint violation
+			const Vector3r &connector0 = constraintInfo.col(2);
+			const Vector3r &connector1 = constraintInfo.col(3);
+			Vector3r stretchViolation = connector0 - connector1;
 
-		// compute Darboux vector (Equation (7))
-		Vector3r omega;
-		computeDarbouxVector(q0, q1, currentConstraint->getAverageSegmentLength(), omega);
+			// compute Darboux vector (Equation (7))
+			Vector3r omega;
+			computeDarbouxVector(q0, q1, currentConstraint->getAverageSegmentLength(), omega);
 
-		// Compute bending and torsion part of constraint violation
-		Vector3r bendingAndTorsionViolation = omega - currentConstraint->getRestDarbouxVector();
+			// Compute bending and torsion part of constraint violation
+			Vector3r bendingAndTorsionViolation = omega - currentConstraint->getRestDarbouxVector();
 
-		// fill right hand side of the linear equation system
-		const Vector6r &lambdaSum(lambdaSums[currentConstraintIndex]);
-		rhs.block<3, 1>(0, 0) = -stretchViolation
-			- Vector3r(currentConstraint->getStretchCompliance().array() *
-			lambdaSum.block<3, 1>(0, 0).array());
+			// fill right hand side of the linear equation system
+			const Vector6r &lambdaSum(lambdaSums[currentConstraintIndex]);
+			rhs.block<3, 1>(0, 0) = -stretchViolation
+				- Vector3r(currentConstraint->getStretchCompliance().array() *
+				lambdaSum.block<3, 1>(0, 0).array());
 
-		rhs.block<3, 1>(3, 0) = -bendingAndTorsionViolation
-			- Vector3r(currentConstraint->getBendingAndTorsionCompliance().array() *
-			lambdaSum.block<3, 1>(3, 0).array());
+			rhs.block<3, 1>(3, 0) = -bendingAndTorsionViolation
+				- Vector3r(currentConstraint->getBendingAndTorsionCompliance().array() *
+				lambdaSum.block<3, 1>(3, 0).array());
 
-		// compute max error
-		for (unsigned char i(0); i < 6; ++i)
-		{
-			maxError = std::max(maxError, std::abs(rhs[i]));
-		}
+			// Compute a part of the Jacobian here, because the relationship
+			// of the first and second segment to the constraint can be determined directly
+
+			// compute G matrices
+			Eigen::Matrix<Real, 4, 3> G0, G1;
+			computeMatrixG(q0, G0);
+			computeMatrixG(q1, G1);
 
-		// Compute a part of the Jacobian here, because the relationship
-		// of the first and second segment to the constraint can be determined directly
+			// compute stretching bending Jacobians (Equation (10) and Equation (11))
+			Eigen::Matrix<Real, 3, 4> jOmega0, jOmega1;
+			computeBendingAndTorsionJacobians(q0, q1, currentConstraint->getAverageSegmentLength(), jOmega0, jOmega1);
 
-		// compute G matrices
-		Eigen::Matrix<Real, 4, 3> G0, G1;
-		computeMatrixG(q0, G0);
-		computeMatrixG(q1, G1);
+			bendingAndTorsionJacobians[currentConstraintIndex][0] = jOmega0*G0;
+			bendingAndTorsionJacobians[currentConstraintIndex][1] = jOmega1*G1;
+		}
+	}
 
-		// compute stretching bending Jacobians (Equation (10) and Equation (11))
-		Eigen::Matrix<Real, 3, 4> jOmega0, jOmega1;
-		computeBendingAndTorsionJacobians(q0, q1, currentConstraint->getAverageSegmentLength(), jOmega0, jOmega1);
+	// compute max error
+	Real maxError(0.);
+	for (int i = 0; i < numConstraints; i++)
+		maxError = std::max(maxError, RHS[i].cwiseAbs().maxCoeff());
+	return maxError;
+}
 
-		bendingAndTorsionJacobians[currentConstraintIndex][0] = jOmega0*G0;
-		bendingAndTorsionJacobians[currentConstraintIndex][1] = jOmega1*G1;
+void PBD::DirectPositionBasedSolverForStiffRods::factorNode(RodTree &tree, const int nodeIndex)
+{
+	Node &node = tree.nodes[nodeIndex];
+	for (int i = tree.childrenStart[nodeIndex]; i < tree.childrenStart[nodeIndex + 1]; i++)
+	{
+		const Node &child = tree.nodes[tree.children[i]];
+		Matrix6r JT = child.J.transpose();
+		Matrix6r JTDJ = ((JT * child.D) * child.J);
+		node.D = node.D - JTDJ;
+	}
+	bool chk = false;
+	if (!node.isconstraint)
+	{
+		RodSegment *segment = (RodSegment*)node.object;
+		chk = !segment->isDynamic();
 	}
 
-	std::list<Node*>::iterator nodeIter;
-	for (nodeIter = forward[intervalIndex].begin(); nodeIter != forward[intervalIndex].end(); nodeIter++)
+	node.DLDLT.compute(node.D); // result reused in solve()
+	if (node.parent != -1)
 	{
-		Node *node = *nodeIter;
-		// compute system matrix diagonal
-		if (node->isconstraint)
+		if (!chk)
 		{
-			RodConstraint* currentConstraint = (RodConstraint*)node->object;
-			//insert compliance
-			node->D.setZero();
-			const Vector3r &stretchCompliance(currentConstraint->getStretchCompliance());
-
-			node->D(0, 0) -= stretchCompliance[0];
-			node->D(1, 1) -= stretchCompliance[1];
-			node->D(2, 2) -= stretchCompliance[2];
-
-			const Vector3r &bendingAndTorsionCompliance(currentConstraint->getBendingAndTorsionCompliance());
-			node->D(3, 3) -= bendingAndTorsionCompliance[0];
-			node->D(4, 4) -= bendingAndTorsionCompliance[1];
-			node->D(5, 5) -= bendingAndTorsionCompliance[2];
+			node.J = node.DLDLT.solve(node.J);
 		}
 		else
 		{
-			getMassMatrix((RodSegment*)node->object, node->D);
+			node.J.setZero();
 		}
+	}
+}
 
-		// compute Jacobian
-		if (node->parent != NULL)
+void PBD::DirectPositionBasedSolverForStiffRods::factor(RodTree &tree, std::vector<RodSegment*> & rodSegments, std::vector<std::vector<Matrix3r>> & bendingAndTorsionJacobians)
+{
+	const int numNodes = (int)tree.nodes.size();
+	#pragma omp parallel if(numNodes > MIN_PARALLEL_SIZE) default(shared)
+	{
+		#pragma omp for schedule(static)
+		for (int nodeIndex = 0; nodeIndex < numNodes; nodeIndex++)
 		{
+			Node *node = &tree.nodes[nodeIndex];
+			// compute system matrix diagonal
 			if (node->isconstraint)
 			{
-				//compute J 
-				RodConstraint *constraint = (RodConstraint*)node->object;
-				RodSegment *segment = (RodSegment*)node->parent->object;
-
-				Real sign = 1;
-				int segmentIndex = 0;
-				if (segment == rodSegments[constraint->segmentIndex(1)])
-				{
-					segmentIndex = 1;
-					sign = -1;
-				}
-
-				const Eigen::Matrix<Real, 3, 4, Eigen::DontAlign> &constraintInfo(constraint->getConstraintInfo());
-				const Vector3r r = constraintInfo.col(2 + segmentIndex) - segment->Position();
-				Matrix3r r_cross;
-				Real crossSign(-static_cast<Real>(1.0)*sign);
-				MathFunctions::crossProductMatrix(crossSign*r, r_cross);
-
-				Eigen::DiagonalMatrix<Real, 3> upperLeft(sign, sign, sign);
-				node->J.block<3, 3>(0, 0) = upperLeft;
-
-				Matrix3r lowerLeft(Matrix3r::Zero());
-				node->J.block<3, 3>(3, 0) = lowerLeft;
-
-				node->J.block<3, 3>(0, 3) = r_cross;
-
-				Matrix3r &lowerRight(bendingAndTorsionJacobians[node->index][segmentIndex]);
-				node->J.block<3, 3>(3, 3) = lowerRight;
+				RodConstraint* currentConstraint = (RodConstraint*)node->object;
+				//insert compliance
+				node->D.setZero();
+				const Vector3r &stretchCompliance(currentConstraint->getStretchCompliance());
+
+				node->D(0, 0) -= stretchCompliance[0];
+				node->D(1, 1) -= stretchCompliance[1];
+				node->D(2, 2) -= stretchCompliance[2];
+
+				const Vector3r &bendingAndTorsionCompliance(currentConstraint->getBendingAndTorsionCompliance());
+				node->D(3, 3) -= bendingAndTorsionCompliance[0];
+				node->D(4, 4) -= bendingAndTorsionCompliance[1];
+				node->D(5, 5) -= bendingAndTorsionCompliance[2];
 			}
 			else
 			{
-				//compute JT
-				RodConstraint *constraint = (RodConstraint*)node->parent->object;
-				RodSegment *segment = (RodSegment*)node->object;
+				getMassMatrix((RodSegment*)node->object, node->D);
+			}
 
-				Real sign = 1;
-				int segmentIndex = 0;
-				if (segment == rodSegments[constraint->segmentIndex(1)])
+			// compute Jacobian
+			if (node->parent != -1)
+			{
+				const Node *parent = &tree.nodes[node->parent];
+				if (node->isconstraint)
 				{
-					segmentIndex = 1;
-					sign = -1;
+					//compute J 
+					RodConstraint *constraint = (RodConstraint*)node->object;
+					RodSegment *segment = (RodSegment*)parent->object;
+
+					Real sign = 1;
+					int segmentIndex = 0;
+					if (segment == rodSegments[constraint->segmentIndex(1)])
+					{
+						segmentIndex = 1;
+						sign = -1;
+					}
+
+					const Eigen::Matrix<Real, 3, 4, Eigen::DontAlign> &constraintInfo(constraint->getConstraintInfo());
+					const Vector3r r = constraintInfo.col(2 + segmentIndex) - segment->Position();
+					Matrix3r r_cross;
+					Real crossSign(-static_cast<Real>(1.0)*sign);
+					MathFunctions::crossProductMatrix(crossSign*r, r_cross);
+
+					Eigen::DiagonalMatrix<Real, 3> upperLeft(sign, sign, sign);
+					node->J.block<3, 3>(0, 0) = upperLeft;
+
+					Matrix3r lowerLeft(Matrix3r::Zero());
+					node->J.block<3, 3>(3, 0) = lowerLeft;
+
+					node->J.block<3, 3>(0, 3) = r_cross;
+
+					Matrix3r &lowerRight(bendingAndTorsionJacobians[node->index][segmentIndex]);
+					node->J.block<3, 3>(3, 3) = lowerRight;
 				}
+				else
+				{
+					//compute JT
+					RodConstraint *constraint = (RodConstraint*)parent->object;
+					RodSegment *segment = (RodSegment*)node->object;
+
+					Real sign = 1;
+					int segmentIndex = 0;
+					if (segment == rodSegments[constraint->segmentIndex(1)])
+					{
+						segmentIndex = 1;
+						sign = -1;
+					}
 
-				const Eigen::Matrix<Real, 3, 4, Eigen::DontAlign> &constraintInfo(constraint->getConstraintInfo());
-				const Vector3r r = constraintInfo.col(2 + segmentIndex) - segment->Position();
-				Matrix3r r_crossT;
-				MathFunctions::crossProductMatrix(sign*r, r_crossT);
+					const Eigen::Matrix<Real, 3, 4, Eigen::DontAlign> &constraintInfo(constraint->getConstraintInfo());
+					const Vector3r r = constraintInfo.col(2 + segmentIndex) - segment->Position();
+					Matrix3r r_crossT;
+					MathFunctions::crossProductMatrix(sign*r, r_crossT);
 
-				Eigen::DiagonalMatrix<Real, 3> upperLeft(sign, sign, sign);
-				node->J.block<3, 3>(0, 0) = upperLeft;
+					Eigen::DiagonalMatrix<Real, 3> upperLeft(sign, sign, sign);
+					node->J.block<3, 3>(0, 0) = upperLeft;
 
-				node->J.block<3, 3>(3, 0) = r_crossT;
+					node->J.block<3, 3>(3, 0) = r_crossT;
 
-				Matrix3r upperRight(Matrix3r::Zero());
-				node->J.block<3, 3>(0, 3) = upperRight;
+					Matrix3r upperRight(Matrix3r::Zero());
+					node->J.block<3, 3>(0, 3) = upperRight;
 
-				Matrix3r lowerRight(bendingAndTorsionJacobians[node->parent->index][segmentIndex].transpose());
-				node->J.block<3, 3>(3, 3) = lowerRight;
+					Matrix3r lowerRight(bendingAndTorsionJacobians[parent->index][segmentIndex].transpose());
+					node->J.block<3, 3>(3, 3) = lowerRight;
+				}
 			}
 		}
 	}
 
-	for (nodeIter = forward[intervalIndex].begin(); nodeIter != forward[intervalIndex].end(); nodeIter++)
+	// eliminate the independent subtrees in parallel and then their ancestors
+	const int numSubtrees = (int)tree.subtrees.size();
+	#pragma omp parallel if(numSubtrees > 1) default(shared)
 	{
-		Node *node = *nodeIter;
-		std::vector <Node*> children = node->children;
-		for (size_t i = 0; i < children.size(); i++)
-		{
-			Matrix6r JT = (children[i]->J).transpose();
-			Matrix6r &D = children[i]->D;
-			Matrix6r &J = children[i]->J;
-			Matrix6r JTDJ = ((JT * D) * J);
-			node->D = node->D - JTDJ;
-		}
-		bool chk = false;
-		if (!node->isconstraint)
-		{
-			RodSegment *segment = (RodSegment*)node->object;
-			if (!segment->isDynamic())
-			{
-				node->Dinv.setZero();
-				chk = true;
-			}
-		}
-
-		node->DLDLT.compute(node->D); // result reused in solve()
-		if (node->parent != NULL)
+		#pragma omp for schedule(dynamic, 1)
+		for (int s = 0; s < numSubtrees; s++)
 		{
-			if (!chk)
-			{
-				node->J = node->DLDLT.solve(node->J);
-			}
-			else
-			{
-				node->J.setZero();
-			}
+			for (int nodeIndex = tree.subtrees[s].start; nodeIndex <= tree.subtrees[s].end; nodeIndex++)
+				factorNode(tree, nodeIndex);
 		}
 	}
-	return maxError;
+	for (size_t i = 0; i < tree.topNodes.size(); i++)
+		factorNode(tree, tree.topNodes[i]);
 }
 
-bool PBD::DirectPositionBasedSolverForStiffRods::solve(int intervalIndex, std::list <Node*> * forward, std::list <Node*> * backward, std::vector<Vector6r> & RHS, std::vector<Vector6r> & lambdaSums, std::vector<Vector3r> & corr_x, std::vector<Quaternionr> & corr_q)
+void PBD::DirectPositionBasedSolverForStiffRods::forwardSubstitution(RodTree &tree, const int nodeIndex, std::vector<Vector6r> & RHS)
 {
-	std::list<Node*>::iterator nodeIter;
-	for (nodeIter = forward[intervalIndex].begin(); nodeIter != forward[intervalIndex].end(); nodeIter++)
+	Node &node = tree.nodes[nodeIndex];
+	if (node.isconstraint)
 	{
-		Node *node = *nodeIter;
-		if (node->isconstraint)
-		{
-			node->soln = -RHS[node->index];
-		}
-		else
-		{
-			node->soln.setZero();
-		}
-		std::vector <Node*> &children = node->children;
-		for (size_t i = 0; i < children.size(); ++i)
-		{
-			Matrix6r cJT = children[i]->J.transpose();
-			Vector6r &csoln = children[i]->soln;
-			Vector6r v = cJT * csoln;
-			node->soln = node->soln - v;
-		}
+		node.soln = -RHS[node.index];
 	}
+	else
+	{
+		node.soln.setZero();
+	}
+	for (int i = tree.childrenStart[nodeIndex]; i < tree.childrenStart[nodeIndex + 1]; ++i)
+	{
+		const Node &child = tree.nodes[tree.children[i]];
+		Matrix6r cJT = child.J.transpose();
+		Vector6r v = cJT * child.soln;
+		node.soln = node.soln - v;
+	}
+}
 
-	for (nodeIter = backward[intervalIndex].begin(); nodeIter != backward[intervalIndex].end(); nodeIter++)
+void PBD::DirectPositionBasedSolverForStiffRods::backwardSubstitution(RodTree &tree, const int nodeIndex, std::vector<Vector6r> & lambdaSums)
+{
+	Node &node = tree.nodes[nodeIndex];
+
+	bool noZeroDinv(true);
+	if (!node.isconstraint)
+	{
+		RodSegment *segment = (RodSegment*)node.object;
+		noZeroDinv = segment->isDynamic();
+	}
+	if (noZeroDinv) // if DInv == 0 child value is 0 and node->soln is not altered
 	{
-		Node *node = *nodeIter;
+		node.soln = node.DLDLT.solve(node.soln);
 
-		bool noZeroDinv(true);
-		if (!node->isconstraint)
+		if (node.parent != -1)
 		{
-			RodSegment *segment = (RodSegment*)node->object;
-			noZeroDinv = segment->isDynamic();
+			node.soln -= node.J * tree.nodes[node.parent].soln;
 		}
-		if (noZeroDinv) // if DInv == 0 child value is 0 and node->soln is not altered
-		{
-			node->soln = node->DLDLT.solve(node->soln);
+	}
+	else
+	{
+		node.soln.setZero(); // segment of node is not dynamic
+	}
 
-			if (node->parent != NULL)
-			{
-				node->soln -= node->J * node->parent->soln;
-			}
-		}
-		else
+	if (node.isconstraint)
+	{
+		lambdaSums[node.index] += node.soln;
+	}
+}
+
+bool PBD::DirectPositionBasedSolverForStiffRods::solve(RodTree &tree, std::vector<Vector6r> & RHS, std::vector<Vector6r> & lambdaSums, std::vector<Vector3r> & corr_x, std::vector<Quaternionr> & corr_q)
+{
+	const int numSubtrees = (int)tree.subtrees.size();
+	#pragma omp parallel if(numSubtrees > 1) default(shared)
+	{
+		#pragma omp for schedule(dynamic, 1)
+		for (int s = 0; s < numSubtrees; s++)
 		{
-			node->soln.setZero(); // segment of node is not dynamic
+			for (int nodeIndex = tree.subtrees[s].start; nodeIndex <= tree.subtrees[s].end; nodeIndex++)
+				forwardSubstitution(tree, nodeIndex, RHS);
 		}
+	}
+	for (size_t i = 0; i < tree.topNodes.size(); i++)
+		forwardSubstitution(tree, tree.topNodes[i], RHS);
 
-		if (node->isconstraint)
+	for (int i = (int)tree.topNodes.size() - 1; i >= 0; i--)
+		backwardSubstitution(tree, tree.topNodes[i], lambdaSums);
+	#pragma omp parallel if(numSubtrees > 1) default(shared)
+	{
+		#pragma omp for schedule(dynamic, 1)
+		for (int s = 0; s < numSubtrees; s++)
 		{
-			lambdaSums[node->index] += node->soln;
+			for (int nodeIndex = tree.subtrees[s].end; nodeIndex >= tree.subtrees[s].start; nodeIndex--)
+				backwardSubstitution(tree, nodeIndex, lambdaSums);
 		}
 	}
 
 	// compute position and orientation updates
-	for (nodeIter = forward[intervalIndex].begin(); nodeIter != forward[intervalIndex].end(); nodeIter++)
+	const int numNodes = (int)tree.nodes.size();
+	#pragma omp parallel if(numNodes > MIN_PARALLEL_SIZE) default(shared)
 	{
-		Node *node = *nodeIter;
-		if (!node->isconstraint)
+		#pragma omp for schedule(static)
+		for (int nodeIndex = 0; nodeIndex < numNodes; nodeIndex++)
 		{
-			RodSegment *segment = (RodSegment *)node->object;
+			const Node &node = tree.nodes[nodeIndex];
+			if (node.isconstraint)
+				continue;
+
+			RodSegment *segment = (RodSegment *)node.object;
 			if (!segment->isDynamic())
-			{
-				break;
-			}
+				continue;
 
-			const Vector6r & soln(node->soln);
+			const Vector6r & soln(node.soln);
 			Vector3r deltaXSoln = Vector3r(-soln[0], -soln[1], -soln[2]);
-			corr_x[node->index] = deltaXSoln;
+			corr_x[node.index] = deltaXSoln;
 
 			Eigen::Matrix<Real, 4, 3> G;
 			computeMatrixG(segment->Rotation(), G);
 			Quaternionr deltaQSoln;
 			deltaQSoln.coeffs() = G * Vector3r(-soln[3], -soln[4], -soln[5]);
-			corr_q[node->index] = deltaQSoln;
+			corr_q[node.index] = deltaQSoln;
 		}
 	}
 	return true;
@@ -1011,9 +1216,7 @@ bool PBD::DirectPositionBasedSolverForStiffRods::init_DirectPositionBasedSolverF
 	std::vector<RodSegment*> & rodSegments, 
 	Interval* &intervals, 
 	int &numberOfIntervals, 
-	std::list <Node*> * &forward, 
-	std::list <Node*> * &backward, 
-	Node* &root, 
+	RodTree* &trees, 
 	const std::vector<Vector3r> &constraintPositions,
 	const std::vector<Real> &averageRadii,
 	const std::vector<Real> &youngsModuli,
@@ -1040,7 +1243,7 @@ bool PBD::DirectPositionBasedSolverForStiffRods::init_DirectPositionBasedSolverF
 	}
 	
 	// compute tree data structure for direct solver
-	initTree(rodConstraints, rodSegments, intervals, numberOfIntervals, forward, backward, root);
+	initTree(rodConstraints, rodSegments, intervals, numberOfIntervals, trees);
 
 	RHS.resize(rodConstraints.size());
 	std::fill(RHS.begin(), RHS.end(), Vector6r::Zero());
@@ -1112,8 +1315,7 @@ bool PBD::DirectPositionBasedSolverForStiffRods::solve_DirectPositionBasedSolver
 	std::vector<RodSegment*> & rodSegments, 
 	const Interval* intervals, 
 	const int &numberOfIntervals, 
-	std::list <Node*> * forward, 
-	std::list <Node*> * backward, 
+	RodTree* trees, 
 	std::vector<Vector6r> & RHS, 
 	std::vector<Vector6r> & lambdaSums, 
 	std::vector<std::vector<Matrix3r>> & bendingAndTorsionJacobians, 
@@ -1121,14 +1323,17 @@ bool PBD::DirectPositionBasedSolverForStiffRods::solve_DirectPositionBasedSolver
 	std::vector<Quaternionr> & corr_q
 	)
 {
-	for (int i = 0; i < numberOfIntervals; i++)
-	{
-		factor(i, rodConstraints, rodSegments, intervals,
-			forward, backward, RHS, lambdaSums, bendingAndTorsionJacobians);
-	}
-	for (int i = 0; i < numberOfIntervals; i++)
+	computeRightHandSide(rodConstraints, rodSegments, RHS, lambdaSums, bendingAndTorsionJacobians);
+
+	// the intervals are independent
+	#pragma omp parallel if(numberOfIntervals > 1) default(shared)
 	{
-		solve(i, forward, backward, RHS, lambdaSums, corr_x, corr_q);
+		#pragma omp for schedule(dynamic, 1)
+		for (int i = 0; i < numberOfIntervals; i++)
+		{
+			factor(trees[i], rodSegments, bendingAndTorsionJacobians);
+			solve(trees[i], RHS, lambdaSums, corr_x, corr_q);
+		}
 	}
 	return true;
 }
@@ -6,7 +6,6 @@
 #include "DirectPositionBasedSolverForStiffRodsInterface.h"
 
 #include <vector>
-#include <list>
 
 // ------------------------------------------------------------------------------------
 namespace PBD
@@ -28,14 +27,14 @@ namespace PBD
 	/** Node in the simulated tree structure */
 	struct Node {
 		Node() {
-			object = NULL; D = Dinv = J = Matrix6r::Zero(); parent = NULL;
-			soln.setZero(); index = 0;
+			object = NULL; D = J = Matrix6r::Zero(); parent = -1;
+			soln.setZero(); index = 0; isconstraint = false;
 		};
 		bool isconstraint;
 		void *object;
-		Matrix6r D, Dinv, J;
-		std::vector <Node*> children;
-		Node *parent;
+		Matrix6r D, J;
+		/** index of the parent node in RodTree::nodes, -1 for the root */
+		int parent;
 		Vector6r soln;
 		int index;
 		Eigen::LDLT<Matrix6r> DLDLT;
@@ -47,79 +46,62 @@ namespace PBD
 		int end;
 	};
 
+	/** Tree of the nodes of an interval in flat storage.
+	* The nodes are stored in the order in which the system matrix H is factorized
+	* (from the leaves to the root). Each node is stored after all of its children,
+	* so the root is the last node and each subtree is a contiguous range of nodes.
+	* The nodes are processed in reverse order to solve from the root to the leaves.
+	*/
+	struct RodTree
+	{
+		std::vector<Node> nodes;
+		/** the children of node i are children[childrenStart[i]], ..., children[childrenStart[i+1]-1] */
+		std::vector<int> childrenStart;
+		std::vector<int> children;
+		/** disjoint subtrees (ranges of nodes) which are processed in parallel */
+		std::vector<Interval> subtrees;
+		/** nodes which are not part of a subtree in the order of the nodes */
+		std::vector<int> topNodes;
+	};
+
 	class DirectPositionBasedSolverForStiffRods
 	{
 	private:
 
 		static void initLists(
 			int numberOfIntervals,
-			std::list <Node*> * &forward,
-			std::list <Node*> * &backward,
-			Node* &root);
+			RodTree* &trees);
 
 		/** Returns, whether the passed segment is connected to a constraint in the
 		* passed index range of the entire constraints.
 		*/
 		static bool isSegmentInInterval(
-			RodSegment *segment,
+			const std::vector<int> &segmentConstraints,
 			int intervalIndex,
-			Interval* intervals,
-			std::vector<RodConstraint*> &rodConstraints,
-			std::vector<RodSegment*> &rodSegments);
-
-		/** Returns, whether the passed constraint is within the passed index range
-		* of the entire constraints.
-		*/
-		static bool isConstraintInInterval(
-			RodConstraint *constraint,
-			int intervalIndex,
-			Interval* intervals,
-			std::vector<RodConstraint*> &rodConstraints);
-
-
-		/** This method recursively visits all segment nodes and inserts constraint nodes between them.
-		*/
-		static void initSegmentNode(
-			Node *n,
-			int intervalIndex,
-			std::vector<RodConstraint*> &rodConstraints,
-			std::vector<RodSegment*> &rodSegments,
-			std::vector <RodConstraint*> &markedConstraints,
 			Interval* intervals);
 
-
-		/** Sorts matrix H.
-		*/
-		static void orderMatrix(
-			Node *n,
-			int intervalIndex,
-			std::list <Node*> * forward,
-			std::list <Node*> * backward);
-
-		/** Initializes the nodes.
-		* The first static node is selected as the root of the tree.
-		* Then, starting from this node, all edges (joints) are followed
-		* and the children and the parent node are saved.
+		/** Builds the tree of an interval. The first static segment is selected as the root of
+		* the tree. Then, starting from this segment, all edges (joints) are followed
+		* (depth first) and constraint nodes are inserted between the segment nodes.
 		*/
 		static void initNodes(
 			int intervalIndex,
 			std::vector<RodSegment*> &rodSegments,
-			Node* &root,
 			Interval* intervals,
 			std::vector<RodConstraint*> &rodConstraints,
-			std::list <Node*> * forward,
-			std::list <Node*> * backward,
-			std::vector <RodConstraint*> &markedConstraints);
+			const std::vector<std::vector<int>> &segmentConstraints,
+			RodTree &tree);
 
+		/** Splits a tree in disjoint subtrees which can be processed in parallel.
+		*/
+		static void initSubtrees(RodTree &tree);
 
 		static void initTree(
 			std::vector<RodConstraint*> &rodConstraints,
 			std::vector<RodSegment*> & rodSegments,
 			Interval* &intervals,
 			int &numberOfIntervals,
-			std::list <Node*> * &forward,
-			std::list <Node*> * &backward,
-			Node* &root
+			RodTree* &trees
 			);
 
 
@@ -157,27 +139,36 @@ namespace PBD
 		*/
 		static void getMassMatrix(RodSegment *segment, Matrix6r &M);
 
-		/** Factorizes matrix H and computes the right hand side vector -b.
+		/** Computes the right hand side vector -b and the bending and torsion Jacobians of all constraints.
+		* Returns the maximum constraint violation.
 		*/
-		static Real factor(
-			const int intervalIndex,
+		static Real computeRightHandSide(
 			const std::vector<RodConstraint*> &rodConstraints,
 			std::vector<RodSegment*> & rodSegments,
-			const Interval* &intervals,
-			std::list <Node*> * forward,
-			std::list <Node*> * backward,
 			std::vector<Vector6r> & RHS,
 			std::vector<Vector6r> & lambdaSums,
 			std::vector<std::vector<Matrix3r>> & bendingAndTorsionJacobians
 			);
 
+		/** Eliminates a node in the factorization of matrix H (its children are already eliminated).
+		*/
+		static void factorNode(RodTree &tree, const int nodeIndex);
+
+		/** Factorizes matrix H.
+		*/
+		static void factor(
+			RodTree &tree,
+			std::vector<RodSegment*> & rodSegments,
+			std::vector<std::vector<Matrix3r>> & bendingAndTorsionJacobians
+			);
+
+		static void forwardSubstitution(RodTree &tree, const int nodeIndex, std::vector<Vector6r> & RHS);
+		static void backwardSubstitution(RodTree &tree, const int nodeIndex, std::vector<Vector6r> & lambdaSums);
 
 		/** Solves the system of equations with the factorized matrix H.
 		*/
 		static bool solve(
-			int intervalIndex,
-			std::list <Node*> * forward,
-			std::list <Node*> * backward,
+			RodTree &tree,
 			std::vector<Vector6r> & RHS,
 			std::vector<Vector6r> & lambdaSums,
 			std::vector<Vector3r> & corr_x,
@@ -187,16 +178,16 @@ namespace PBD
 
 		///** Initialize the zero-stretch, bending, and torsion constraints of the rod.
 		//* Computes constraint connectors in segment space, computes the diagonal stiffness matrices
-		//* and the Darboux vectors of the initial state. Initializes the forward and backward lists
-		//* of nodes  for the direct solver\n\n
+		//* and the Darboux vectors of the initial state. Initializes the trees
+		//* of nodes for the direct solver\n\n
 		//*
 		//* @param rodConstraints contains the combined zero-stretch, bending
 		//* and torsion constraints of the rod. The set of constraints must by acyclic.
 		//* @param rodSegments contains the segments of the rod
-		//* @param forward list of nodes in the acyclic tree of rod segments and zero-stretch,
-		//* bending and torsion constraints so that parent nodes occur later in the list than their children
-		//* @param backward list of nodes in the acyclic tree of rod segments and zero-stretch,
-		//* bending and torsion constraints. The reverse of the forward list.
+		//* @param intervals intervals of constraints which are solved independently
+		//* @param numberOfIntervals number of intervals
+		//* @param trees acyclic tree of rod segments and zero-stretch, bending and torsion constraints
+		//* for each interval so that parent nodes occur later in the tree than their children
 		//* @param constraintPositions positions of the rod's constraints in world coordinates
 		//* @param averageRadii the average radii at the constraint positions of the rod. Value in Meters (m)
 		//* @param averageSegmentLengths vector of the average lengths of the two rod segments
@@ -223,9 +214,7 @@ namespace PBD
 			std::vector<RodSegment*> & rodSegments,
 			Interval* &intervals,
 			int &numberOfIntervals,
-			std::list <Node*> * &forward,
-			std::list <Node*> * &backward,
-			Node* &root,
+			RodTree* &trees,
 			const std::vector<Vector3r> &constraintPositions,
 			const std::vector<Real> &averageRadii,
 			const std::vector<Real> &youngsModuli,
@@ -265,8 +254,9 @@ namespace PBD
 		//*
 		//* @param rodConstraints contains the combined zero-stretch, bending and torsion constraints of the rod. The set of constraints must by acyclic.
 		//* @param rodSegments contains the segments of the rod
-		//* @param forward list of nodes in the acyclic tree of rod segments and zero-stretch, bending and torsion constraints so that parent nodes occur later in the list than their children
-		//* @param backward list of nodes in the acyclic tree of rod segments and zero-stretch, bending and torsion constraints. The reverse of the forward list.
+		//* @param intervals intervals of constraints which are solved independently
+		//* @param numberOfIntervals number of intervals
+		//* @param trees acyclic tree of rod segments and zero-stretch, bending and torsion constraints for each interval so that parent nodes occur later in the tree than their children
 		//* @param RHS vector with entries for each constraint. In concatenation these entries represent the right hand side of the system of equations to be solved. (eq. 22 in the paper)
 		//* @param lambdaSums contains entries of the sum of all lambda updates for
 		//* each constraint in the rod during one time step which is needed by the solver to handle
@@ -283,8 +273,7 @@ namespace PBD
 			std::vector<RodSegment*> & rodSegments,
 			const Interval* intervals,
 			const int &numberOfIntervals,
-			std::list <Node*> * forward,
-			std::list <Node*> * backward,
+			RodTree* trees,
 			std::vector<Vector6r> & RHS,
 			std::vector<Vector6r> & lambdaSums,
 			std::vector<std::vector<Matrix3r>> & bendingAndTorsionJacobians,
@@ -463,6 +452,44 @@ namespace PBD
 			const Vector3r& bendingAndTwistingKs,
 			const Quaternionr& restDarbouxVector,
 			Quaternionr& corrq0, Quaternionr&  corrq1);
+
+		/** Number of constraints which are processed by the batch variants of the solvers. */
+		static const int BatchSize = 8;
+		/** One value per constraint of a batch */
+		typedef Eigen::Array<Real, BatchSize, 1> RealBatch;
+		/** Vectors of a batch of constraints. Column i contains the i-th component of all vectors,
+		* so that the arithmetic is performed in SIMD lanes across the constraints.
+		*/
+		typedef Eigen::Array<Real, BatchSize, 3> Vector3Batch;
+		/** Quaternions of a batch of constraints. The columns contain the coefficients in the
+		* order of Quaternionr::coeffs() (x, y, z, w).
+		*/
+		typedef Eigen::Array<Real, BatchSize, 4> QuaternionBatch;
+
+		/** Batch variant of solve_StretchShearConstraint() which determines the corrections of
+		* BatchSize independent constraints at once. The parameters are the same as for the
+		* single constraint, where row j of each batch belongs to the j-th constraint.
+		*/
+		static void solve_StretchShearConstraintBatch(
+			const Vector3Batch& p0, const RealBatch& invMass0,
+			const Vector3Batch& p1, const RealBatch& invMass1,
+			const QuaternionBatch& q0, const RealBatch& invMassq0,
+			const Vector3Batch& stretchingAndShearingKs,
+			const RealBatch& restLength,
+			Vector3Batch& corr0, Vector3Batch& corr1, QuaternionBatch& corrq0);
+
+		/** Batch variant of solve_BendTwistConstraint() which determines the corrections of
+		* BatchSize independent constraints at once. The parameters are the same as for the
+		* single constraint, where row j of each batch belongs to the j-th constraint.
+		* Including the gather and scatter of the quaternions it is not faster than the single
+		* constraint solver (see CosseratBatchBenchmark), so BendTwistConstraint does not use it.
+		*/
+		static void solve_BendTwistConstraintBatch(
+			const QuaternionBatch& q0, const RealBatch& invMassq0,
+			const QuaternionBatch& q1, const RealBatch& invMassq1,
+			const Vector3Batch& bendingAndTwistingKs,
+			const QuaternionBatch& restDarbouxVector,
+			QuaternionBatch& corrq0, QuaternionBatch& corrq1);
 	};
 
 	// Implementation of "Position Based Elastic Rods" paper
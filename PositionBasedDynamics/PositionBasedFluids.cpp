@@ -1,6 +1,5 @@
 #include "PositionBasedFluids.h"
 #include <cfloat>
-#include "SPHKernels.h"
 
 using namespace PBD;
 
@@ -14,6 +13,7 @@ bool PositionBasedFluids::computePBFDensity(
 	const Real boundaryPsi[],
 	const unsigned int numNeighbors,
 	const unsigned int neighbors[],
+	const CubicKernel &kernel,
 	const Real density0,
 	const bool boundaryHandling,
 	Real &density_err,
@@ -25,13 +25,13 @@ bool PositionBasedFluids::computePBFDensity(
 	int sign = 0;
 
 	// Compute current density for particle i
-	density = mass[particleIndex] * CubicKernel::W_zero();
+	density = mass[particleIndex] * kernel.W_zero();
 	for (unsigned int j = 0; j < numNeighbors; j++)
 	{
 		const unsigned int neighborIndex = neighbors[j];
 		if (neighborIndex < numberOfParticles)		// Test if fluid particle
 		{
-			density += mass[neighborIndex] * CubicKernel::W(x[particleIndex] - x[neighborIndex]);
+			density += mass[neighborIndex] * kernel.W(x[particleIndex] - x[neighborIndex]);
 
 			if (sign == -1) frag++;
 			sign = 1;
@@ -40,7 +40,7 @@ bool PositionBasedFluids::computePBFDensity(
 		else if (boundaryHandling)
 		{
 			// Boundary: Akinci2012
-			density += boundaryPsi[neighborIndex - numberOfParticles] * CubicKernel::W(x[particleIndex] - boundaryX[neighborIndex - numberOfParticles]);
+			density += boundaryPsi[neighborIndex - numberOfParticles] * kernel.W(x[particleIndex] - boundaryX[neighborIndex - numberOfParticles]);
 
 			if (sign == 1) frag++;
 			sign = -1;
@@ -65,6 +65,7 @@ bool PositionBasedFluids::computePBFLagrangeMultiplier(
 	const Real density,
 	const unsigned int numNeighbors,
 	const unsigned int neighbors[],
+	const CubicKernel &kernel,
 	const Real density0,
 	const bool boundaryHandling,
 	Real &lambda)
@@ -85,14 +86,14 @@ bool PositionBasedFluids::computePBFLagrangeMultiplier(
 			const unsigned int neighborIndex = neighbors[j];
 			if (neighborIndex < numberOfParticles)		// Test if fluid particle
 			{
-				const Vector3r gradC_j = -mass[neighborIndex] / density0 * CubicKernel::gradW(x[particleIndex] - x[neighborIndex]);
+				const Vector3r gradC_j = -mass[neighborIndex] / density0 * kernel.gradW(x[particleIndex] - x[neighborIndex]);
 				sum_grad_C2 += gradC_j.squaredNorm();
 				gradC_i -= gradC_j;
 			}
 			else if (boundaryHandling)
 			{
 				// Boundary: Akinci2012
-				const Vector3r gradC_j = -boundaryPsi[neighborIndex - numberOfParticles] / density0 * CubicKernel::gradW(x[particleIndex] - boundaryX[neighborIndex - numberOfParticles]);
+				const Vector3r gradC_j = -boundaryPsi[neighborIndex - numberOfParticles] / density0 * kernel.gradW(x[particleIndex] - boundaryX[neighborIndex - numberOfParticles]);
 				sum_grad_C2 += gradC_j.squaredNorm();
 				gradC_i -= gradC_j;
 			}
@@ -119,6 +120,7 @@ bool PositionBasedFluids::solveDensityConstraint(
 	const Real boundaryPsi[],
 	const unsigned int numNeighbors,
 	const unsigned int neighbors[],
+	const CubicKernel &kernel,
 	const Real density0,
 	const bool boundaryHandling,
 	const Real lambda[],
@@ -131,13 +133,13 @@ bool PositionBasedFluids::solveDensityConstraint(
 		const unsigned int neighborIndex = neighbors[j];
 		if (neighborIndex < numberOfParticles)		// Test if fluid particle
 		{
-			const Vector3r gradC_j = -mass[neighborIndex] / density0 * CubicKernel::gradW(x[particleIndex] - x[neighborIndex]);
+			const Vector3r gradC_j = -mass[neighborIndex] / density0 * kernel.gradW(x[particleIndex] - x[neighborIndex]);
 			corr -= (lambda[particleIndex] + lambda[neighborIndex]) * gradC_j;
 		}
 		else if (boundaryHandling)
 		{
 			// Boundary: Akinci2012
-			const Vector3r gradC_j = -boundaryPsi[neighborIndex - numberOfParticles] / density0 * CubicKernel::gradW(x[particleIndex] - boundaryX[neighborIndex - numberOfParticles]);
+			const Vector3r gradC_j = -boundaryPsi[neighborIndex - numberOfParticles] / density0 * kernel.gradW(x[particleIndex] - boundaryX[neighborIndex - numberOfParticles]);
 			corr -= (lambda[particleIndex]) * gradC_j;
 		}
 	}
@@ -2,6 +2,7 @@
 #define POSITION_BASED_FLUIDS_H
 
 #include "Common/Common.h"
+#include "SPHKernels.h"
 
 // ------------------------------------------------------------------------------------
 namespace PBD
@@ -30,6 +31,7 @@ namespace PBD
 		* @param boundaryPsi array of all boundary psi values (see \cite Akinci:2012)
 		* @param numNeighbors number of neighbors
 		* @param neighbors array with indices of all neighbors (indices larger than numberOfParticles are boundary particles)
+		* @param kernel SPH kernel
 		* @param density0 rest density
 		* @param boundaryHandling perform boundary handling (see \cite Akinci:2012)
 		* @param density_err returns the clamped density error (can be used for enforcing a maximal global density error)
@@ -44,6 +46,7 @@ namespace PBD
 			const Real boundaryPsi[],						// array of all boundary psi values (Akinci2012)
 			const unsigned int numNeighbors,				// number of neighbors 
 			const unsigned int neighbors[],					// array with indices of all neighbors (indices larger than numberOfParticles are boundary particles)
+			const CubicKernel &kernel,						// SPH kernel
 			const Real density0,							// rest density
 			const bool boundaryHandling,					// perform boundary handling (Akinci2012)
 			Real &density_err,								// returns the clamped density error (can be used for enforcing a maximal global density error)
@@ -80,6 +83,7 @@ namespace PBD
 		 * @param density density of current fluid particle
 		 * @param numNeighbors number of neighbors
 		 * @param neighbors array with indices of all neighbors (indices larger than numberOfParticles are boundary particles)
+		 * @param kernel SPH kernel
 		 * @param density0 rest density
 		 * @param boundaryHandling perform boundary handling (see \cite Akinci:2012)
 		 * @param lambda returns the Lagrange multiplier
@@ -94,6 +98,7 @@ namespace PBD
 			const Real density,							// density of current fluid particle
 			const unsigned int numNeighbors,				// number of neighbors 
 			const unsigned int neighbors[],					// array with indices of all neighbors
+			const CubicKernel &kernel,						// SPH kernel
 			const Real density0,							// rest density
 			const bool boundaryHandling,					// perform boundary handling (Akinci2012)
 			Real &lambda);									// returns the Lagrange multiplier
@@ -119,6 +124,7 @@ namespace PBD
 		* @param boundaryPsi array of all boundary psi values (see \cite Akinci:2012)
 		* @param numNeighbors number of neighbors
 		* @param neighbors array with indices of all neighbors (indices larger than numberOfParticles are boundary particles)
+		* @param kernel SPH kernel
 		* @param density0 rest density
 		* @param boundaryHandling perform boundary handling (see \cite Akinci:2012)
 		* @param lambda Lagrange multipliers
@@ -133,6 +139,7 @@ namespace PBD
 			const Real boundaryPsi[],						// array of all boundary psi values (Akinci2012)
 			const unsigned int numNeighbors,				// number of neighbors 
 			const unsigned int neighbors[],					// array with indices of all neighbors
+			const CubicKernel &kernel,						// SPH kernel
 			const Real density0,							// rest density
 			const bool boundaryHandling,					// perform boundary handling (Akinci2012)
 			const Real lambda[],							// Lagrange multiplier
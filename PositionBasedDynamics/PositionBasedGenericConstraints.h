@@ -2,6 +2,7 @@
 #define POSITIONBASEDGENERICCONSTRAINTS_H
 
 #include "Common/Common.h"
+#include "DualNumber.h"
 
 // ------------------------------------------------------------------------------------
 namespace PBD
@@ -16,6 +17,20 @@ namespace PBD
 	class PositionBasedGenericConstraints
 	{
 	public:
+		/** Scalar type of the automatic differentiation of a constraint function 
+		 * of numberOfParticles particles. The derivatives are taken with respect 
+		 * to the 3*numberOfParticles position coordinates.
+		 */
+		template<unsigned int numberOfParticles>
+		using ParticleDual = DualNumber<Real, 3 * numberOfParticles>;
+
+		/** Scalar type of the automatic differentiation of a constraint function 
+		 * of numberOfRigidBodies rigid bodies. The derivatives are taken with respect 
+		 * to the position (3) and the quaternion coefficients (4) of each body.
+		 */
+		template<unsigned int numberOfRigidBodies>
+		using RigidBodyDual = DualNumber<Real, 7 * numberOfRigidBodies>;
+
 		/** Determine the position corrections for a constraint function
 		 * with a known gradient function.\n\n
 		 * More information can be found here: \ref secGenericConstraintsCGFct
@@ -102,6 +117,59 @@ namespace PBD
 
 			Eigen::Matrix<Real, dim, 3> &jacobian);
 
+		/** Determine the position corrections for a constraint function.
+		* The gradient is determined exactly by automatic differentiation. The constraint
+		* function is evaluated once with dual numbers, which yields the constraint value 
+		* and the Jacobians of all particles.\n\n
+		* More information can be found here: \ref secGenericConstraintsADFct
+		*
+		* @param  invMass inverse mass of constrained particles
+		* @param  x positions of constrained particles
+		* @param  userData	user data which is required in the callback functions
+		* @param  constraintFct constraint callback which is instantiated with the scalar type ParticleDual<numberOfParticles>
+		* @param  corr_x position corrections of constrained particles
+		*/
+		template<unsigned int numberOfParticles, unsigned int dim>
+		static bool solve_GenericConstraint_AD(
+			const Real invMass[numberOfParticles],							// inverse mass is zero if particle is static
+			const Vector3r x[numberOfParticles],						// positions of particles
+			void *userData,
+
+			void(*constraintFct)(
+				const unsigned int numParticles,
+				const Real invMass[],							// inverse mass is zero if particle is static
+				const Eigen::Matrix<ParticleDual<numberOfParticles>, 3, 1> x[],		// positions of particles
+				void *userData,
+				Eigen::Matrix<ParticleDual<numberOfParticles>, dim, 1> &constraintValue),
+
+			Vector3r corr_x[numberOfParticles]);
+
+		/** Evaluates a constraint function and determines the Jacobians of all particles
+		* by automatic differentiation.
+		*
+		* @param  invMass inverse mass of constrained particles
+		* @param  x positions of constrained particles
+		* @param  userData	user data which is required in the callback functions
+		* @param  constraintFct constraint callback which is instantiated with the scalar type ParticleDual<numberOfParticles>
+		* @param  constraintValue value of the constraint function
+		* @param  jacobians Jacobians of the particles
+		*/
+		template<unsigned int numberOfParticles, unsigned int dim>
+		static void evaluateConstraint_AD(
+			const Real invMass[numberOfParticles],							// inverse mass is zero if particle is static
+			const Vector3r x[numberOfParticles],						// positions of particles
+			void *userData,
+
+			void(*constraintFct)(
+				const unsigned int numParticles,
+				const Real invMass[],							// inverse mass is zero if particle is static
+				const Eigen::Matrix<ParticleDual<numberOfParticles>, 3, 1> x[],		// positions of particles
+				void *userData,
+				Eigen::Matrix<ParticleDual<numberOfParticles>, dim, 1> &constraintValue),
+
+			Eigen::Matrix<Real, dim, 1> &constraintValue,
+			Eigen::Matrix<Real, dim, 3> jacobians[numberOfParticles]);
+
 
 		/** Determine the position corrections for a constraint function
 		 * with a known gradient function.\n\n
@@ -213,6 +281,296 @@ namespace PBD
 
 			Eigen::Matrix<Real, dim, 6> &jacobian);
 
+		/** Determine the position corrections for a constraint function.
+		* The gradient is determined exactly by automatic differentiation. The constraint
+		* function is evaluated once with dual numbers, which yields the constraint value 
+		* and the Jacobians of all rigid bodies.\n\n
+		* More information can be found here: \ref secGenericConstraintsADFct
+		*
+		* @param  invMass inverse mass of constrained rigid bodies
+		* @param  x positions of constrained rigid bodies
+		* @param  inertiaInverseW inverse inertia tensor in world coordinates of the rigid bodies
+		* @param  q rotation of the rigid bodies
+		* @param  userData	user data which is required in the callback functions
+		* @param  constraintFct constraint callback which is instantiated with the scalar type RigidBodyDual<numberOfRigidBodies>
+		* @param  corr_x position corrections of the constrained rigid bodies
+		* @param  corr_q rotation corrections of the constrained rigid bodies
+		*/
+		template<unsigned int numberOfRigidBodies, unsigned int dim>
+		static bool solve_GenericConstraint_AD(
+			const Real invMass[numberOfRigidBodies],					// inverse mass is zero if body is static
+			const Vector3r x[numberOfRigidBodies],						// positions of bodies
+			const Matrix3r inertiaInverseW[numberOfRigidBodies],		// inverse inertia tensor (world space) of bodies
+			const Quaternionr q[numberOfRigidBodies],
+			void *userData,
+
+			void(*constraintFct)(
+				const unsigned int numRigidBodies,
+				const Real invMass[],											// inverse mass is zero if body is static
+				const Eigen::Matrix<RigidBodyDual<numberOfRigidBodies>, 3, 1> x[],	// positions of bodies
+				const Matrix3r inertiaInverseW[],								// inverse inertia tensor (world space) of bodies
+				const Eigen::Quaternion<RigidBodyDual<numberOfRigidBodies> > q[],	// rotation of bodies
+				void *userData,
+				Eigen::Matrix<RigidBodyDual<numberOfRigidBodies>, dim, 1> &constraintValue),
+
+			Vector3r corr_x[numberOfRigidBodies],
+			Quaternionr corr_q[numberOfRigidBodies]);
+
+		/** Evaluates a constraint function and determines the Jacobians of all rigid bodies
+		* by automatic differentiation. The derivatives with respect to the quaternion are 
+		* transformed to angular derivatives.
+		*
+		* @param  invMass inverse mass of constrained rigid bodies
+		* @param  x positions of constrained rigid bodies
+		* @param  inertiaInverseW inverse inertia tensor in world coordinates of the rigid bodies
+		* @param  q rotation of the rigid bodies
+		* @param  userData	user data which is required in the callback functions
+		* @param  constraintFct constraint callback which is instantiated with the scalar type RigidBodyDual<numberOfRigidBodies>
+		* @param  constraintValue value of the constraint function
+		* @param  jacobians Jacobians of the rigid bodies
+		*/
+		template<unsigned int numberOfRigidBodies, unsigned int dim>
+		static void evaluateConstraint_AD(
+			const Real invMass[numberOfRigidBodies],					// inverse mass is zero if body is static
+			const Vector3r x[numberOfRigidBodies],						// positions of bodies
+			const Matrix3r inertiaInverseW[numberOfRigidBodies],		// inverse inertia tensor (world space) of bodies
+			const Quaternionr q[numberOfRigidBodies],
+			void *userData,
+
+			void(*constraintFct)(
+				const unsigned int numRigidBodies,
+				const Real invMass[],											// inverse mass is zero if body is static
+				const Eigen::Matrix<RigidBodyDual<numberOfRigidBodies>, 3, 1> x[],	// positions of bodies
+				const Matrix3r inertiaInverseW[],								// inverse inertia tensor (world space) of bodies
+				const Eigen::Quaternion<RigidBodyDual<numberOfRigidBodies> > q[],	// rotation of bodies
+				void *userData,
+				Eigen::Matrix<RigidBodyDual<numberOfRigidBodies>, dim, 1> &constraintValue),
+
+			Eigen::Matrix<Real, dim, 1> &constraintValue,
+			Eigen::Matrix<Real, dim, 6> jacobians[numberOfRigidBodies]);
+
+
+		/** Determine the position corrections for a constraint function
+		* with a known gradient function. In contrast to the callback variant, the functions
+		* are function objects (e.g. lambdas) which are inlined by the compiler. Data of the
+		* constraint is stored in the function objects instead of a user data pointer.\n\n
+		* More information can be found here: \ref secGenericConstraintsFunctor
+		*
+		* @param  invMass inverse mass of constrained particles
+		* @param  x positions of constrained particles
+		* @param  constraintFct constraint function: void(const Vector3r x[], Eigen::Matrix<Real, dim, 1> &constraintValue)
+		* @param  gradientFct gradient function: void(const unsigned int i, const Vector3r x[], Eigen::Matrix<Real, dim, 3> &jacobian)
+		* @param  corr_x position corrections of constrained particles
+		*/
+		template<unsigned int numberOfParticles, unsigned int dim, typename ConstraintFct, typename GradientFct>
+		static bool solve_GenericConstraint_Functor(
+			const Real invMass[numberOfParticles],							// inverse mass is zero if particle is static
+			const Vector3r x[numberOfParticles],						// positions of particles
+			const ConstraintFct &constraintFct,
+			const GradientFct &gradientFct,
+			Vector3r corr_x[numberOfParticles]);
+
+		/** Determine the position corrections for a constraint function object. The gradient
+		* is determined by automatic differentiation.\n\n
+		* More information can be found here: \ref secGenericConstraintsFunctor
+		*
+		* @param  invMass inverse mass of constrained particles
+		* @param  x positions of constrained particles
+		* @param  constraintFct constraint function: void(const Eigen::Matrix<ParticleDual<numberOfParticles>, 3, 1> x[], Eigen::Matrix<ParticleDual<numberOfParticles>, dim, 1> &constraintValue)
+		* @param  corr_x position corrections of constrained particles
+		*/
+		template<unsigned int numberOfParticles, unsigned int dim, typename ConstraintFct>
+		static bool solve_GenericConstraint_Functor(
+			const Real invMass[numberOfParticles],							// inverse mass is zero if particle is static
+			const Vector3r x[numberOfParticles],						// positions of particles
+			const ConstraintFct &constraintFct,
+			Vector3r corr_x[numberOfParticles]);
+
+		/** Evaluates a constraint function object and determines the Jacobians of all particles
+		* by automatic differentiation.
+		*
+		* @param  x positions of constrained particles
+		* @param  constraintFct constraint function which is called with the scalar type ParticleDual<numberOfParticles>
+		* @param  constraintValue value of the constraint function
+		* @param  jacobians Jacobians of the particles
+		*/
+		template<unsigned int numberOfParticles, unsigned int dim, typename ConstraintFct>
+		static void evaluateConstraint_AD(
+			const Vector3r x[numberOfParticles],						// positions of particles
+			const ConstraintFct &constraintFct,
+			Eigen::Matrix<Real, dim, 1> &constraintValue,
+			Eigen::Matrix<Real, dim, 3> jacobians[numberOfParticles]);
+
+		/** Determine the position corrections for a constraint function object
+		* with a known gradient function object.\n\n
+		* More information can be found here: \ref secGenericConstraintsFunctor
+		*
+		* @param  invMass inverse mass of constrained rigid bodies
+		* @param  x positions of constrained rigid bodies
+		* @param  inertiaInverseW inverse inertia tensor in world coordinates of the rigid bodies
+		* @param  q rotation of the rigid bodies
+		* @param  constraintFct constraint function: void(const Vector3r x[], const Quaternionr q[], Eigen::Matrix<Real, dim, 1> &constraintValue)
+		* @param  gradientFct gradient function: void(const unsigned int i, const Vector3r x[], const Quaternionr q[], Eigen::Matrix<Real, dim, 6> &jacobian)
+		* @param  corr_x position corrections of the constrained rigid bodies
+		* @param  corr_q rotation corrections of the constrained rigid bodies
+		*/
+		template<unsigned int numberOfRigidBodies, unsigned int dim, typename ConstraintFct, typename GradientFct>
+		static bool solve_GenericConstraint_Functor(
+			const Real invMass[numberOfRigidBodies],					// inverse mass is zero if body is static
+			const Vector3r x[numberOfRigidBodies],						// positions of bodies
+			const Matrix3r inertiaInverseW[numberOfRigidBodies],		// inverse inertia tensor (world space) of bodies
+			const Quaternionr q[numberOfRigidBodies],					// rotation of bodies
+			const ConstraintFct &constraintFct,
+			const GradientFct &gradientFct,
+			Vector3r corr_x[numberOfRigidBodies],
+			Quaternionr corr_q[numberOfRigidBodies]);
+
+		/** Determine the position corrections for a constraint function object. The gradient
+		* is determined by automatic differentiation.\n\n
+		* More information can be found here: \ref secGenericConstraintsFunctor
+		*
+		* @param  invMass inverse mass of constrained rigid bodies
+		* @param  x positions of constrained rigid bodies
+		* @param  inertiaInverseW inverse inertia tensor in world coordinates of the rigid bodies
+		* @param  q rotation of the rigid bodies
+		* @param  constraintFct constraint function: void(const Eigen::Matrix<RigidBodyDual<numberOfRigidBodies>, 3, 1> x[], const Eigen::Quaternion<RigidBodyDual<numberOfRigidBodies> > q[], Eigen::Matrix<RigidBodyDual<numberOfRigidBodies>, dim, 1> &constraintValue)
+		* @param  corr_x position corrections of the constrained rigid bodies
+		* @param  corr_q rotation corrections of the constrained rigid bodies
+		*/
+		template<unsigned int numberOfRigidBodies, unsigned int dim, typename ConstraintFct>
+		static bool solve_GenericConstraint_Functor(
+			const Real invMass[numberOfRigidBodies],					// inverse mass is zero if body is static
+			const Vector3r x[numberOfRigidBodies],						// positions of bodies
+			const Matrix3r inertiaInverseW[numberOfRigidBodies],		// inverse inertia tensor (world space) of bodies
+			const Quaternionr q[numberOfRigidBodies],					// rotation of bodies
+			const ConstraintFct &constraintFct,
+			Vector3r corr_x[numberOfRigidBodies],
+			Quaternionr corr_q[numberOfRigidBodies]);
+
+		/** Evaluates a constraint function object and determines the Jacobians of all rigid bodies
+		* by automatic differentiation. The derivatives with respect to the quaternion are
+		* transformed to angular derivatives.
+		*
+		* @param  x positions of constrained rigid bodies
+		* @param  q rotation of the rigid bodies
+		* @param  constraintFct constraint function which is called with the scalar type RigidBodyDual<numberOfRigidBodies>
+		* @param  constraintValue value of the constraint function
+		* @param  jacobians Jacobians of the rigid bodies
+		*/
+		template<unsigned int numberOfRigidBodies, unsigned int dim, typename ConstraintFct>
+		static void evaluateConstraint_AD(
+			const Vector3r x[numberOfRigidBodies],						// positions of bodies
+			const Quaternionr q[numberOfRigidBodies],					// rotation of bodies
+			const ConstraintFct &constraintFct,
+			Eigen::Matrix<Real, dim, 1> &constraintValue,
+			Eigen::Matrix<Real, dim, 6> jacobians[numberOfRigidBodies]);
+
+		/** Number of constraints which are processed by the batch variants of the solvers. */
+		static const int BatchSize = 8;
+		/** One value per constraint of a batch */
+		typedef Eigen::Array<Real, BatchSize, 1> RealBatch;
+		/** Vectors of a batch of constraints. Column i contains the i-th component of all vectors,
+		* so that the arithmetic is performed in SIMD lanes across the constraints.
+		*/
+		typedef Eigen::Array<Real, BatchSize, 3> Vector3Batch;
+
+		/** Batch variant of solve_GenericConstraint_Functor() which determines the corrections of
+		* BatchSize independent constraints with function objects of the same type at once.
+		* The function objects are evaluated for each constraint, the system matrices are
+		* assembled and solved in SIMD lanes across the constraints. Row j of each batch
+		* belongs to the j-th constraint.
+		*
+		* @param  invMass inverse masses of the constrained particles
+		* @param  x positions of the constrained particles
+		* @param  constraintFct constraint function object of each constraint
+		* @param  gradientFct gradient function object of each constraint
+		* @param  corr_x position corrections of the constrained particles
+		* @param  valid 1 for the constraints which were solved, 0 if the system matrix is singular
+		*/
+		template<unsigned int numberOfParticles, unsigned int dim, typename ConstraintFct, typename GradientFct>
+		static void solve_GenericConstraintBatch(
+			const RealBatch invMass[numberOfParticles],
+			const Vector3Batch x[numberOfParticles],
+			const ConstraintFct constraintFct[BatchSize],
+			const GradientFct gradientFct[BatchSize],
+			Vector3Batch corr_x[numberOfParticles],
+			RealBatch &valid);
+
+		/** Batch variant of solve_GenericConstraint_Functor() with automatic differentiation.
+		* The parameters are the same as for solve_GenericConstraintBatch() with a known
+		* gradient.
+		*/
+		template<unsigned int numberOfParticles, unsigned int dim, typename ConstraintFct>
+		static void solve_GenericConstraintBatch(
+			const RealBatch invMass[numberOfParticles],
+			const Vector3Batch x[numberOfParticles],
+			const ConstraintFct constraintFct[BatchSize],
+			Vector3Batch corr_x[numberOfParticles],
+			RealBatch &valid);
+
+		/** Solve the linear system K x = b with a symmetric positive definite matrix by an
+		* LDL^T decomposition. The loops have a fixed size, so that the solve is unrolled
+		* for small dimensions.
+		*
+		* @param  K symmetric system matrix, only the lower triangle is used
+		* @param  b right hand side
+		* @param  minDeterminant the solve fails if the determinant of K is smaller
+		* @param  x solution
+		* @return false if K is not positive definite or its determinant is smaller than minDeterminant
+		*/
+		template<unsigned int dim>
+		static bool solveLDLT(
+			const Eigen::Matrix<Real, dim, dim> &K,
+			const Eigen::Matrix<Real, dim, 1> &b,
+			const Real minDeterminant,
+			Eigen::Matrix<Real, dim, 1> &x);
+
+		/** Batch variant of solveLDLT() which solves BatchSize systems at once.
+		* The mask valid is 1 for the systems which were solved and 0 otherwise.
+		* The solution of the failed systems is zero.
+		*/
+		template<unsigned int dim>
+		static void solveLDLTBatch(
+			const RealBatch K[dim][dim],
+			const RealBatch b[dim],
+			const Real minDeterminant,
+			RealBatch x[dim],
+			RealBatch &valid);
+
+		/** Determine the position corrections of the particles from the value of the
+		* constraint function and the Jacobians.
+		*/
+		template<unsigned int numberOfParticles, unsigned int dim>
+		static bool computeCorrections(
+			const Real invMass[numberOfParticles],
+			const Eigen::Matrix<Real, dim, 3> jacobians[numberOfParticles],
+			const Eigen::Matrix<Real, dim, 1> &constraintValue,
+			Vector3r corr_x[numberOfParticles]);
+
+		/** Determine the position and rotation corrections of the rigid bodies from the value
+		* of the constraint function and the Jacobians.
+		*/
+		template<unsigned int numberOfRigidBodies, unsigned int dim>
+		static bool computeCorrections(
+			const Real invMass[numberOfRigidBodies],
+			const Matrix3r inertiaInverseW[numberOfRigidBodies],
+			const Quaternionr q[numberOfRigidBodies],
+			const Eigen::Matrix<Real, dim, 6> jacobians[numberOfRigidBodies],
+			const Eigen::Matrix<Real, dim, 1> &constraintValue,
+			Vector3r corr_x[numberOfRigidBodies],
+			Quaternionr corr_q[numberOfRigidBodies]);
+
+		/** Batch variant of computeCorrections() for particles.
+		* jacobians[i][k] contains row k of the Jacobians of particle i.
+		*/
+		template<unsigned int numberOfParticles, unsigned int dim>
+		static void computeCorrectionsBatch(
+			const RealBatch invMass[numberOfParticles],
+			const Vector3Batch jacobians[numberOfParticles][dim],
+			const RealBatch constraintValue[dim],
+			Vector3Batch corr_x[numberOfParticles],
+			RealBatch &valid);
+
 		/** Compute matrix that is required to transform quaternion in 
 		 * a 3D representation. */
 		static void computeMatrixG(const Quaternionr &q, Eigen::Matrix<Real, 4, 3> &G);
@@ -244,44 +602,10 @@ namespace PBD
 
 		Vector3r corr_x[numberOfParticles])
 	{
-		// evaluate constraint function
-		Eigen::Matrix<Real, dim, 1> C;
-		constraintFct(numberOfParticles, invMass, x, userData, C);
-
-		Eigen::Matrix<Real, dim, dim> K;
-		K.setZero();
-
-		Eigen::Matrix<Real, dim, 3> gradients[numberOfParticles];
-		for (unsigned int i = 0u; i < numberOfParticles; i++)
-		{
-			if (invMass[i] != 0.0)
-			{
-				// compute gradient
-				gradientFct(i, numberOfParticles, invMass, x, userData, gradients[i]);
-				K += invMass[i] * gradients[i] * gradients[i].transpose();
-			}
-		}
-
-		// compute Kinv
-		if (K.determinant() < 1.0e-6)
-			return false;
-
-		Eigen::Matrix<Real, dim, dim> Kinv = K.inverse();
-
-		Eigen::Matrix<Real, dim, 1> lambda = -Kinv * C;
-
-		for (unsigned int i = 0u; i < numberOfParticles; i++)
-		{
-			if (invMass[i] != 0.0)
-			{
-				// compute position correction
-				corr_x[i] = invMass[i] * gradients[i].transpose() * lambda;
-			}
-			else
-				corr_x[i].setZero();
-		}
-
-		return true;
+		return solve_GenericConstraint_Functor<numberOfParticles, dim>(invMass, x,
+			[&](const Vector3r xi[], Eigen::Matrix<Real, dim, 1> &C) { constraintFct(numberOfParticles, invMass, xi, userData, C); },
+			[&](const unsigned int i, const Vector3r xi[], Eigen::Matrix<Real, dim, 3> &jacobian) { gradientFct(i, numberOfParticles, invMass, xi, userData, jacobian); },
+			corr_x);
 	}
 
 	template<unsigned int numberOfParticles, unsigned int dim>
@@ -308,40 +632,15 @@ namespace PBD
 		constraintFct(numberOfParticles, invMass, xTemp, userData, Cd);
 		Eigen::Matrix<Real, dim, 1> C = Cd.template cast<Real>();
 
-		Eigen::Matrix<Real, dim, dim> K;
-		K.setZero();
-
 		Eigen::Matrix<Real, dim, 3> gradients[numberOfParticles];
 		for (unsigned int i = 0u; i < numberOfParticles; i++)
 		{
+			// compute gradient
 			if (invMass[i] != 0.0)
-			{
-				// compute gradient
 				approximateGradient<numberOfParticles, dim>(i, invMass, x, userData, constraintFct, gradients[i]);
-				K += invMass[i] * gradients[i] * gradients[i].transpose();
-			}
-		}
-
-		// compute Kinv
-		if (K.determinant() < 1.0e-6)
-			return false;
-
-		Eigen::Matrix<Real, dim, dim> Kinv = K.inverse();
-
-		Eigen::Matrix<Real, dim, 1> lambda = -Kinv * C;
-
-		for (unsigned int i = 0u; i < numberOfParticles; i++)
-		{
-			if (invMass[i] != 0.0)
-			{
-				// compute position correction
-				corr_x[i] = invMass[i] * gradients[i].transpose() * lambda;
-			}
-			else
-				corr_x[i].setZero();
 		}
 
-		return true;
+		return computeCorrections<numberOfParticles, dim>(invMass, gradients, C, corr_x);
 	}
 
 	template<unsigned int numberOfParticles, unsigned int dim>
@@ -383,6 +682,49 @@ namespace PBD
 		}
 	}
 
+	template<unsigned int numberOfParticles, unsigned int dim>
+	void PositionBasedGenericConstraints::evaluateConstraint_AD(
+		const Real invMass[numberOfParticles],							// inverse mass is zero if particle is static
+		const Vector3r x[numberOfParticles],						// positions of particles
+		void *userData,
+
+		void(*constraintFct)(
+			const unsigned int numParticles,
+			const Real invMass[],							// inverse mass is zero if particle is static
+			const Eigen::Matrix<ParticleDual<numberOfParticles>, 3, 1> x[],		// positions of particles
+			void *userData,
+			Eigen::Matrix<ParticleDual<numberOfParticles>, dim, 1> &constraintValue),
+
+		Eigen::Matrix<Real, dim, 1> &constraintValue,
+		Eigen::Matrix<Real, dim, 3> jacobians[numberOfParticles])
+	{
+		typedef ParticleDual<numberOfParticles> Dual;
+		evaluateConstraint_AD<numberOfParticles, dim>(x,
+			[&](const Eigen::Matrix<Dual, 3, 1> xi[], Eigen::Matrix<Dual, dim, 1> &C) { constraintFct(numberOfParticles, invMass, xi, userData, C); },
+			constraintValue, jacobians);
+	}
+
+	template<unsigned int numberOfParticles, unsigned int dim>
+	bool PositionBasedGenericConstraints::solve_GenericConstraint_AD(
+		const Real invMass[numberOfParticles],							// inverse mass is zero if particle is static
+		const Vector3r x[numberOfParticles],						// positions of particles
+		void *userData,
+
+		void(*constraintFct)(
+			const unsigned int numParticles,
+			const Real invMass[],							// inverse mass is zero if particle is static
+			const Eigen::Matrix<ParticleDual<numberOfParticles>, 3, 1> x[],		// positions of particles
+			void *userData,
+			Eigen::Matrix<ParticleDual<numberOfParticles>, dim, 1> &constraintValue),
+
+		Vector3r corr_x[numberOfParticles])
+	{
+		typedef ParticleDual<numberOfParticles> Dual;
+		return solve_GenericConstraint_Functor<numberOfParticles, dim>(invMass, x,
+			[&](const Eigen::Matrix<Dual, 3, 1> xi[], Eigen::Matrix<Dual, dim, 1> &C) { constraintFct(numberOfParticles, invMass, xi, userData, C); },
+			corr_x);
+	}
+
 
 	template<unsigned int numberOfRigidBodies, unsigned int dim>
 	bool PositionBasedGenericConstraints::solve_GenericConstraint(
@@ -414,65 +756,21 @@ namespace PBD
 		Vector3r corr_x[numberOfRigidBodies],
 		Quaternionr corr_q[numberOfRigidBodies])
 	{
-		// evaluate constraint function
-		Eigen::Matrix<Real, dim, 1> C;
-		constraintFct(numberOfRigidBodies, invMass, x, inertiaInverseW, q, userData, C);
+		return solve_GenericConstraint_Functor<numberOfRigidBodies, dim>(invMass, x, inertiaInverseW, q,
+			[&](const Vector3r xi[], const Quaternionr qi[], Eigen::Matrix<Real, dim, 1> &C)
+				{ constraintFct(numberOfRigidBodies, invMass, xi, inertiaInverseW, qi, userData, C); },
+			[&](const unsigned int i, const Vector3r xi[], const Quaternionr qi[], Eigen::Matrix<Real, dim, 6> &jacobian)
+				{ gradientFct(i, numberOfRigidBodies, invMass, xi, inertiaInverseW, qi, userData, jacobian); },
+			corr_x, corr_q);
+	}
 
-		Eigen::Matrix<Real, dim, dim> K;
-		K.setZero();
-
-		Eigen::Matrix<Real, dim, 6> gradients[numberOfRigidBodies];
-		for (unsigned int i = 0u; i < numberOfRigidBodies; i++)
-		{
-			if (invMass[i] != 0.0)
-			{
-				// compute gradient
-				gradientFct(i, numberOfRigidBodies, invMass, x, inertiaInverseW, q, userData, gradients[i]);
-
-				// inverse mass matrix
-				Eigen::Matrix<Real, 6, 6> Minv;
-				Minv.setZero();
-				Minv(0, 0) = invMass[i];
-				Minv(1, 1) = invMass[i];
-				Minv(2, 2) = invMass[i];
-				Minv.block<3, 3>(3, 3) = inertiaInverseW[i];
-
-				K += gradients[i] * Minv * gradients[i].transpose();
-			}
-		}
-
-		Eigen::Matrix<Real, dim, dim> Kinv = K.inverse();
-
-		Eigen::Matrix<Real, dim, 1> lambda = -Kinv * C;
-
-		for (unsigned int i = 0u; i < numberOfRigidBodies; i++)
-		{
-			if (invMass[i] != 0.0)
-			{
-				// compute position correction
-				const Vector6r pt = gradients[i].transpose() * lambda;
-				corr_x[i] = invMass[i] * pt.block<3, 1>(0, 0);
-				const Vector3r ot = (inertiaInverseW[i] * pt.block<3, 1>(3, 0));
-				const Quaternionr otQ(0.0, ot[0], ot[1], ot[2]);
-				corr_q[i].coeffs() = 0.5 *(otQ*q[i]).coeffs();
-			}
-			else
-			{
-				corr_x[i].setZero();
-				corr_q[i].coeffs().setZero();
-			}
-		}
-
-		return true;
-	}
-
-	template<unsigned int numberOfRigidBodies, unsigned int dim>
-	bool PositionBasedGenericConstraints::solve_GenericConstraint(
-		const Real invMass[numberOfRigidBodies],					// inverse mass is zero if body is static
-		const Vector3r x[numberOfRigidBodies],						// positions of bodies
-		const Matrix3r inertiaInverseW[numberOfRigidBodies],		// inverse inertia tensor (world space) of bodies
-		const Quaternionr q[numberOfRigidBodies],
-		void *userData,
+	template<unsigned int numberOfRigidBodies, unsigned int dim>
+	bool PositionBasedGenericConstraints::solve_GenericConstraint(
+		const Real invMass[numberOfRigidBodies],					// inverse mass is zero if body is static
+		const Vector3r x[numberOfRigidBodies],						// positions of bodies
+		const Matrix3r inertiaInverseW[numberOfRigidBodies],		// inverse inertia tensor (world space) of bodies
+		const Quaternionr q[numberOfRigidBodies],
+		void *userData,
 
 		void(*constraintFct)(
 			const unsigned int numParticles,
@@ -490,52 +788,15 @@ namespace PBD
 		Eigen::Matrix<Real, dim, 1> C;
 		constraintFct(numberOfRigidBodies, invMass, x, inertiaInverseW, q, userData, C);
 
-		Eigen::Matrix<Real, dim, dim> K;
-		K.setZero();
-
 		Eigen::Matrix<Real, dim, 6> gradients[numberOfRigidBodies];
 		for (unsigned int i = 0u; i < numberOfRigidBodies; i++)
 		{
+			// compute gradient
 			if (invMass[i] != 0.0)
-			{
-				// compute gradient
 				approximateGradient<numberOfRigidBodies, dim>(i, invMass, x, inertiaInverseW, q, userData, constraintFct, gradients[i]);
-				
-				// inverse mass matrix
-				Eigen::Matrix<Real, 6, 6> Minv;
-				Minv.setZero();
-				Minv(0, 0) = invMass[i];
-				Minv(1, 1) = invMass[i];
-				Minv(2, 2) = invMass[i];
-				Minv.block<3, 3>(3, 3) = inertiaInverseW[i];
-
-				K += gradients[i] * Minv * gradients[i].transpose();
-			}
 		}
 
-		Eigen::Matrix<Real, dim, dim> Kinv = K.inverse();
-
-		Eigen::Matrix<Real, dim, 1> lambda = -Kinv * C;
-
-		for (unsigned int i = 0u; i < numberOfRigidBodies; i++)
-		{
-			if (invMass[i] != 0.0)
-			{
-				// compute position correction
-				const Vector6r pt = gradients[i].transpose() * lambda;
-				corr_x[i] = invMass[i] * pt.block<3, 1>(0, 0);
-				const Vector3r ot = (inertiaInverseW[i] * pt.block<3, 1>(3, 0));
-				const Quaternionr otQ(0.0, ot[0], ot[1], ot[2]);
-				corr_q[i].coeffs() = 0.5 *(otQ*q[i]).coeffs();
-			}
-			else
-			{
-				corr_x[i].setZero();
-				corr_q[i].coeffs().setZero();
-			}
-		}
-
-		return true;
+		return computeCorrections<numberOfRigidBodies, dim>(invMass, inertiaInverseW, q, gradients, C, corr_x, corr_q);
 	}
 
 	void PositionBasedGenericConstraints::computeMatrixG(const Quaternionr &q, Eigen::Matrix<Real, 4, 3> &G)
@@ -630,6 +891,513 @@ namespace PBD
 		jacobian.template block<dim, 3>(0, 3) = jh * G;
 	}
 
+	template<unsigned int numberOfRigidBodies, unsigned int dim>
+	void PositionBasedGenericConstraints::evaluateConstraint_AD(
+		const Real invMass[numberOfRigidBodies],					// inverse mass is zero if body is static
+		const Vector3r x[numberOfRigidBodies],						// positions of bodies
+		const Matrix3r inertiaInverseW[numberOfRigidBodies],		// inverse inertia tensor (world space) of bodies
+		const Quaternionr q[numberOfRigidBodies],
+		void *userData,
+
+		void(*constraintFct)(
+			const unsigned int numRigidBodies,
+			const Real invMass[],											// inverse mass is zero if body is static
+			const Eigen::Matrix<RigidBodyDual<numberOfRigidBodies>, 3, 1> x[],	// positions of bodies
+			const Matrix3r inertiaInverseW[],								// inverse inertia tensor (world space) of bodies
+			const Eigen::Quaternion<RigidBodyDual<numberOfRigidBodies> > q[],	// rotation of bodies
+			void *userData,
+			Eigen::Matrix<RigidBodyDual<numberOfRigidBodies>, dim, 1> &constraintValue),
+
+		Eigen::Matrix<Real, dim, 1> &constraintValue,
+		Eigen::Matrix<Real, dim, 6> jacobians[numberOfRigidBodies])
+	{
+		typedef RigidBodyDual<numberOfRigidBodies> Dual;
+		evaluateConstraint_AD<numberOfRigidBodies, dim>(x, q,
+			[&](const Eigen::Matrix<Dual, 3, 1> xi[], const Eigen::Quaternion<Dual> qi[], Eigen::Matrix<Dual, dim, 1> &C)
+				{ constraintFct(numberOfRigidBodies, invMass, xi, inertiaInverseW, qi, userData, C); },
+			constraintValue, jacobians);
+	}
+
+	template<unsigned int numberOfRigidBodies, unsigned int dim>
+	bool PositionBasedGenericConstraints::solve_GenericConstraint_AD(
+		const Real invMass[numberOfRigidBodies],					// inverse mass is zero if body is static
+		const Vector3r x[numberOfRigidBodies],						// positions of bodies
+		const Matrix3r inertiaInverseW[numberOfRigidBodies],		// inverse inertia tensor (world space) of bodies
+		const Quaternionr q[numberOfRigidBodies],
+		void *userData,
+
+		void(*constraintFct)(
+			const unsigned int numRigidBodies,
+			const Real invMass[],											// inverse mass is zero if body is static
+			const Eigen::Matrix<RigidBodyDual<numberOfRigidBodies>, 3, 1> x[],	// positions of bodies
+			const Matrix3r inertiaInverseW[],								// inverse inertia tensor (world space) of bodies
+			const Eigen::Quaternion<RigidBodyDual<numberOfRigidBodies> > q[],	// rotation of bodies
+			void *userData,
+			Eigen::Matrix<RigidBodyDual<numberOfRigidBodies>, dim, 1> &constraintValue),
+
+		Vector3r corr_x[numberOfRigidBodies],
+		Quaternionr corr_q[numberOfRigidBodies])
+	{
+		typedef RigidBodyDual<numberOfRigidBodies> Dual;
+		return solve_GenericConstraint_Functor<numberOfRigidBodies, dim>(invMass, x, inertiaInverseW, q,
+			[&](const Eigen::Matrix<Dual, 3, 1> xi[], const Eigen::Quaternion<Dual> qi[], Eigen::Matrix<Dual, dim, 1> &C)
+				{ constraintFct(numberOfRigidBodies, invMass, xi, inertiaInverseW, qi, userData, C); },
+			corr_x, corr_q);
+	}
+
+	template<unsigned int numberOfParticles, unsigned int dim, typename ConstraintFct, typename GradientFct>
+	bool PositionBasedGenericConstraints::solve_GenericConstraint_Functor(
+		const Real invMass[numberOfParticles],							// inverse mass is zero if particle is static
+		const Vector3r x[numberOfParticles],						// positions of particles
+		const ConstraintFct &constraintFct,
+		const GradientFct &gradientFct,
+		Vector3r corr_x[numberOfParticles])
+	{
+		// evaluate constraint function
+		Eigen::Matrix<Real, dim, 1> C;
+		constraintFct(x, C);
+
+		Eigen::Matrix<Real, dim, 3> gradients[numberOfParticles];
+		for (unsigned int i = 0u; i < numberOfParticles; i++)
+		{
+			// compute gradient
+			if (invMass[i] != 0.0)
+				gradientFct(i, x, gradients[i]);
+		}
+
+		return computeCorrections<numberOfParticles, dim>(invMass, gradients, C, corr_x);
+	}
+
+	template<unsigned int numberOfParticles, unsigned int dim, typename ConstraintFct>
+	bool PositionBasedGenericConstraints::solve_GenericConstraint_Functor(
+		const Real invMass[numberOfParticles],							// inverse mass is zero if particle is static
+		const Vector3r x[numberOfParticles],						// positions of particles
+		const ConstraintFct &constraintFct,
+		Vector3r corr_x[numberOfParticles])
+	{
+		// evaluate constraint function and gradients
+		Eigen::Matrix<Real, dim, 1> C;
+		Eigen::Matrix<Real, dim, 3> gradients[numberOfParticles];
+		evaluateConstraint_AD<numberOfParticles, dim>(x, constraintFct, C, gradients);
+
+		return computeCorrections<numberOfParticles, dim>(invMass, gradients, C, corr_x);
+	}
+
+	template<unsigned int numberOfParticles, unsigned int dim, typename ConstraintFct>
+	void PositionBasedGenericConstraints::evaluateConstraint_AD(
+		const Vector3r x[numberOfParticles],						// positions of particles
+		const ConstraintFct &constraintFct,
+		Eigen::Matrix<Real, dim, 1> &constraintValue,
+		Eigen::Matrix<Real, dim, 3> jacobians[numberOfParticles])
+	{
+		typedef ParticleDual<numberOfParticles> Dual;
+
+		// each position coordinate is a variable
+		Eigen::Matrix<Dual, 3, 1> xDual[numberOfParticles];
+		for (unsigned int i = 0; i < numberOfParticles; i++)
+			for (unsigned int j = 0; j < 3; j++)
+				xDual[i][j] = Dual(x[i][j], 3 * i + j);
+
+		Eigen::Matrix<Dual, dim, 1> C;
+		constraintFct(xDual, C);
+
+		for (unsigned int k = 0; k < dim; k++)
+		{
+			constraintValue[k] = C[k].value();
+			for (unsigned int i = 0; i < numberOfParticles; i++)
+				jacobians[i].row(k) = C[k].derivatives().template segment<3>(3 * i).transpose();
+		}
+	}
+
+	template<unsigned int numberOfRigidBodies, unsigned int dim, typename ConstraintFct, typename GradientFct>
+	bool PositionBasedGenericConstraints::solve_GenericConstraint_Functor(
+		const Real invMass[numberOfRigidBodies],					// inverse mass is zero if body is static
+		const Vector3r x[numberOfRigidBodies],						// positions of bodies
+		const Matrix3r inertiaInverseW[numberOfRigidBodies],		// inverse inertia tensor (world space) of bodies
+		const Quaternionr q[numberOfRigidBodies],					// rotation of bodies
+		const ConstraintFct &constraintFct,
+		const GradientFct &gradientFct,
+		Vector3r corr_x[numberOfRigidBodies],
+		Quaternionr corr_q[numberOfRigidBodies])
+	{
+		// evaluate constraint function
+		Eigen::Matrix<Real, dim, 1> C;
+		constraintFct(x, q, C);
+
+		Eigen::Matrix<Real, dim, 6> gradients[numberOfRigidBodies];
+		for (unsigned int i = 0u; i < numberOfRigidBodies; i++)
+		{
+			// compute gradient
+			if (invMass[i] != 0.0)
+				gradientFct(i, x, q, gradients[i]);
+		}
+
+		return computeCorrections<numberOfRigidBodies, dim>(invMass, inertiaInverseW, q, gradients, C, corr_x, corr_q);
+	}
+
+	template<unsigned int numberOfRigidBodies, unsigned int dim, typename ConstraintFct>
+	bool PositionBasedGenericConstraints::solve_GenericConstraint_Functor(
+		const Real invMass[numberOfRigidBodies],					// inverse mass is zero if body is static
+		const Vector3r x[numberOfRigidBodies],						// positions of bodies
+		const Matrix3r inertiaInverseW[numberOfRigidBodies],		// inverse inertia tensor (world space) of bodies
+		const Quaternionr q[numberOfRigidBodies],					// rotation of bodies
+		const ConstraintFct &constraintFct,
+		Vector3r corr_x[numberOfRigidBodies],
+		Quaternionr corr_q[numberOfRigidBodies])
+	{
+		// evaluate constraint function and gradients
+		Eigen::Matrix<Real, dim, 1> C;
+		Eigen::Matrix<Real, dim, 6> gradients[numberOfRigidBodies];
+		evaluateConstraint_AD<numberOfRigidBodies, dim>(x, q, constraintFct, C, gradients);
+
+		return computeCorrections<numberOfRigidBodies, dim>(invMass, inertiaInverseW, q, gradients, C, corr_x, corr_q);
+	}
+
+	template<unsigned int numberOfRigidBodies, unsigned int dim, typename ConstraintFct>
+	void PositionBasedGenericConstraints::evaluateConstraint_AD(
+		const Vector3r x[numberOfRigidBodies],						// positions of bodies
+		const Quaternionr q[numberOfRigidBodies],					// rotation of bodies
+		const ConstraintFct &constraintFct,
+		Eigen::Matrix<Real, dim, 1> &constraintValue,
+		Eigen::Matrix<Real, dim, 6> jacobians[numberOfRigidBodies])
+	{
+		typedef RigidBodyDual<numberOfRigidBodies> Dual;
+
+		// variables of body i: 7*i + (0,1,2) position, 7*i + (3,4,5,6) quaternion coefficients (x,y,z,w)
+		Eigen::Matrix<Dual, 3, 1> xDual[numberOfRigidBodies];
+		Eigen::Quaternion<Dual> qDual[numberOfRigidBodies];
+		for (unsigned int i = 0; i < numberOfRigidBodies; i++)
+		{
+			for (unsigned int j = 0; j < 3; j++)
+				xDual[i][j] = Dual(x[i][j], 7 * i + j);
+			for (unsigned int j = 0; j < 4; j++)
+				qDual[i].coeffs()[j] = Dual(q[i].coeffs()[j], 7 * i + 3 + j);
+		}
+
+		Eigen::Matrix<Dual, dim, 1> C;
+		constraintFct(xDual, qDual, C);
+
+		for (unsigned int k = 0; k < dim; k++)
+			constraintValue[k] = C[k].value();
+
+		for (unsigned int i = 0; i < numberOfRigidBodies; i++)
+		{
+			// derivatives with respect to the quaternion in the order (w,x,y,z)
+			Eigen::Matrix<Real, dim, 4> jh;
+			for (unsigned int k = 0; k < dim; k++)
+			{
+				const typename Dual::DerivativeType &d = C[k].derivatives();
+				jacobians[i].template block<1, 3>(k, 0) = d.template segment<3>(7 * i).transpose();
+				jh(k, 0) = d[7 * i + 6];
+				jh(k, 1) = d[7 * i + 3];
+				jh(k, 2) = d[7 * i + 4];
+				jh(k, 3) = d[7 * i + 5];
+			}
+			Eigen::Matrix<Real, 4, 3> G;
+			computeMatrixG(q[i], G);
+			jacobians[i].template block<dim, 3>(0, 3) = jh * G;
+		}
+	}
+
+	template<unsigned int numberOfParticles, unsigned int dim, typename ConstraintFct, typename GradientFct>
+	void PositionBasedGenericConstraints::solve_GenericConstraintBatch(
+		const RealBatch invMass[numberOfParticles],
+		const Vector3Batch x[numberOfParticles],
+		const ConstraintFct constraintFct[BatchSize],
+		const GradientFct gradientFct[BatchSize],
+		Vector3Batch corr_x[numberOfParticles],
+		RealBatch &valid)
+	{
+		// evaluate the constraint functions and gradients of each constraint
+		RealBatch C[dim];
+		Vector3Batch gradients[numberOfParticles][dim];
+		for (int j = 0; j < BatchSize; j++)
+		{
+			Vector3r xj[numberOfParticles];
+			for (unsigned int i = 0; i < numberOfParticles; i++)
+				xj[i] = x[i].row(j).transpose().matrix();
+
+			Eigen::Matrix<Real, dim, 1> Cj;
+			constraintFct[j](xj, Cj);
+			for (unsigned int k = 0; k < dim; k++)
+				C[k][j] = Cj[k];
+
+			for (unsigned int i = 0; i < numberOfParticles; i++)
+			{
+				Eigen::Matrix<Real, dim, 3> jacobian;
+				if (invMass[i][j] != 0.0)
+					gradientFct[j](i, xj, jacobian);
+				else
+					jacobian.setZero();
+				for (unsigned int k = 0; k < dim; k++)
+					gradients[i][k].row(j) = jacobian.row(k).array();
+			}
+		}
+
+		computeCorrectionsBatch<numberOfParticles, dim>(invMass, gradients, C, corr_x, valid);
+	}
+
+	template<unsigned int numberOfParticles, unsigned int dim, typename ConstraintFct>
+	void PositionBasedGenericConstraints::solve_GenericConstraintBatch(
+		const RealBatch invMass[numberOfParticles],
+		const Vector3Batch x[numberOfParticles],
+		const ConstraintFct constraintFct[BatchSize],
+		Vector3Batch corr_x[numberOfParticles],
+		RealBatch &valid)
+	{
+		// evaluate the constraint functions and gradients of each constraint
+		RealBatch C[dim];
+		Vector3Batch gradients[numberOfParticles][dim];
+		for (int j = 0; j < BatchSize; j++)
+		{
+			Vector3r xj[numberOfParticles];
+			for (unsigned int i = 0; i < numberOfParticles; i++)
+				xj[i] = x[i].row(j).transpose().matrix();
+
+			Eigen::Matrix<Real, dim, 1> Cj;
+			Eigen::Matrix<Real, dim, 3> jacobians[numberOfParticles];
+			evaluateConstraint_AD<numberOfParticles, dim>(xj, constraintFct[j], Cj, jacobians);
+			for (unsigned int k = 0; k < dim; k++)
+			{
+				C[k][j] = Cj[k];
+				for (unsigned int i = 0; i < numberOfParticles; i++)
+					gradients[i][k].row(j) = jacobians[i].row(k).array();
+			}
+		}
+
+		computeCorrectionsBatch<numberOfParticles, dim>(invMass, gradients, C, corr_x, valid);
+	}
+
+	template<unsigned int dim>
+	bool PositionBasedGenericConstraints::solveLDLT(
+		const Eigen::Matrix<Real, dim, dim> &K,
+		const Eigen::Matrix<Real, dim, 1> &b,
+		const Real minDeterminant,
+		Eigen::Matrix<Real, dim, 1> &x)
+	{
+		// K = L D L^T, L is stored in the strict lower triangle
+		Eigen::Matrix<Real, dim, dim> L;
+		Eigen::Matrix<Real, dim, 1> D;
+		Real det = static_cast<Real>(1.0);
+		for (unsigned int j = 0; j < dim; j++)
+		{
+			Real d = K(j, j);
+			for (unsigned int k = 0; k < j; k++)
+				d -= L(j, k) * L(j, k) * D[k];
+			if (d <= static_cast<Real>(0.0))
+				return false;
+			D[j] = d;
+			det *= d;
+
+			const Real invD = static_cast<Real>(1.0) / d;
+			for (unsigned int i = j + 1; i < dim; i++)
+			{
+				Real l = K(i, j);
+				for (unsigned int k = 0; k < j; k++)
+					l -= L(i, k) * L(j, k) * D[k];
+				L(i, j) = l * invD;
+			}
+		}
+		if (det < minDeterminant)
+			return false;
+
+		// forward substitution, diagonal and backward substitution
+		for (unsigned int i = 0; i < dim; i++)
+		{
+			x[i] = b[i];
+			for (unsigned int k = 0; k < i; k++)
+				x[i] -= L(i, k) * x[k];
+		}
+		for (unsigned int i = 0; i < dim; i++)
+			x[i] /= D[i];
+		for (int i = dim - 1; i >= 0; i--)
+		{
+			for (unsigned int k = i + 1; k < dim; k++)
+				x[i] -= L(k, i) * x[k];
+		}
+		return true;
+	}
+
+	template<unsigned int dim>
+	void PositionBasedGenericConstraints::solveLDLTBatch(
+		const RealBatch K[dim][dim],
+		const RealBatch b[dim],
+		const Real minDeterminant,
+		RealBatch x[dim],
+		RealBatch &valid)
+	{
+		RealBatch L[dim][dim];
+		RealBatch D[dim];
+		RealBatch det = RealBatch::Ones();
+		valid.setOnes();
+		for (unsigned int j = 0; j < dim; j++)
+		{
+			RealBatch d = K[j][j];
+			for (unsigned int k = 0; k < j; k++)
+				d -= L[j][k] * L[j][k] * D[k];
+
+			// Eigen does not vectorize comparisons and select(), so the failed systems
+			// are masked and get a unit pivot to keep the arithmetic finite
+			for (int l = 0; l < BatchSize; l++)
+			{
+				if (!(d[l] > static_cast<Real>(0.0)))
+					valid[l] = static_cast<Real>(0.0);
+			}
+			d = valid * d + (static_cast<Real>(1.0) - valid);
+			D[j] = d;
+			det *= d;
+
+			const RealBatch invD = d.inverse();
+			for (unsigned int i = j + 1; i < dim; i++)
+			{
+				RealBatch l = K[i][j];
+				for (unsigned int k = 0; k < j; k++)
+					l -= L[i][k] * L[j][k] * D[k];
+				L[i][j] = l * invD;
+			}
+		}
+		for (int l = 0; l < BatchSize; l++)
+		{
+			if (det[l] < minDeterminant)
+				valid[l] = static_cast<Real>(0.0);
+		}
+
+		// forward substitution, diagonal and backward substitution
+		for (unsigned int i = 0; i < dim; i++)
+		{
+			x[i] = b[i];
+			for (unsigned int k = 0; k < i; k++)
+				x[i] -= L[i][k] * x[k];
+		}
+		for (unsigned int i = 0; i < dim; i++)
+			x[i] *= valid / D[i];
+		for (int i = dim - 1; i >= 0; i--)
+		{
+			for (unsigned int k = i + 1; k < dim; k++)
+				x[i] -= L[k][i] * x[k];
+		}
+	}
+
+	template<unsigned int numberOfParticles, unsigned int dim>
+	bool PositionBasedGenericConstraints::computeCorrections(
+		const Real invMass[numberOfParticles],
+		const Eigen::Matrix<Real, dim, 3> jacobians[numberOfParticles],
+		const Eigen::Matrix<Real, dim, 1> &constraintValue,
+		Vector3r corr_x[numberOfParticles])
+	{
+		Eigen::Matrix<Real, dim, dim> K;
+		K.setZero();
+		for (unsigned int i = 0u; i < numberOfParticles; i++)
+		{
+			if (invMass[i] != 0.0)
+				K.noalias() += invMass[i] * jacobians[i] * jacobians[i].transpose();
+		}
+
+		Eigen::Matrix<Real, dim, 1> lambda;
+		if (!solveLDLT<dim>(K, -constraintValue, static_cast<Real>(1.0e-6), lambda))
+			return false;
+
+		for (unsigned int i = 0u; i < numberOfParticles; i++)
+		{
+			if (invMass[i] != 0.0)
+			{
+				// compute position correction
+				corr_x[i] = invMass[i] * jacobians[i].transpose() * lambda;
+			}
+			else
+				corr_x[i].setZero();
+		}
+
+		return true;
+	}
+
+	template<unsigned int numberOfRigidBodies, unsigned int dim>
+	bool PositionBasedGenericConstraints::computeCorrections(
+		const Real invMass[numberOfRigidBodies],
+		const Matrix3r inertiaInverseW[numberOfRigidBodies],
+		const Quaternionr q[numberOfRigidBodies],
+		const Eigen::Matrix<Real, dim, 6> jacobians[numberOfRigidBodies],
+		const Eigen::Matrix<Real, dim, 1> &constraintValue,
+		Vector3r corr_x[numberOfRigidBodies],
+		Quaternionr corr_q[numberOfRigidBodies])
+	{
+		// K = sum J M^-1 J^T with the block diagonal inverse mass matrix M^-1 = diag(invMass I, inertiaInverseW)
+		Eigen::Matrix<Real, dim, dim> K;
+		K.setZero();
+		for (unsigned int i = 0u; i < numberOfRigidBodies; i++)
+		{
+			if (invMass[i] != 0.0)
+			{
+				K.noalias() += invMass[i] * jacobians[i].template leftCols<3>() * jacobians[i].template leftCols<3>().transpose();
+				K.noalias() += jacobians[i].template rightCols<3>() * inertiaInverseW[i] * jacobians[i].template rightCols<3>().transpose();
+			}
+		}
+
+		// the rigid body solvers do not reject a small determinant
+		Eigen::Matrix<Real, dim, 1> lambda;
+		if (!solveLDLT<dim>(K, -constraintValue, static_cast<Real>(0.0), lambda))
+			return false;
+
+		for (unsigned int i = 0u; i < numberOfRigidBodies; i++)
+		{
+			if (invMass[i] != 0.0)
+			{
+				// compute position correction
+				const Vector6r pt = jacobians[i].transpose() * lambda;
+				corr_x[i] = invMass[i] * pt.template block<3, 1>(0, 0);
+				const Vector3r ot = (inertiaInverseW[i] * pt.template block<3, 1>(3, 0));
+				const Quaternionr otQ(0.0, ot[0], ot[1], ot[2]);
+				corr_q[i].coeffs() = 0.5 *(otQ*q[i]).coeffs();
+			}
+			else
+			{
+				corr_x[i].setZero();
+				corr_q[i].coeffs().setZero();
+			}
+		}
+
+		return true;
+	}
+
+	template<unsigned int numberOfParticles, unsigned int dim>
+	void PositionBasedGenericConstraints::computeCorrectionsBatch(
+		const RealBatch invMass[numberOfParticles],
+		const Vector3Batch jacobians[numberOfParticles][dim],
+		const RealBatch constraintValue[dim],
+		Vector3Batch corr_x[numberOfParticles],
+		RealBatch &valid)
+	{
+		// lower triangle of K = sum invMass J J^T, the Jacobians of static particles are zero
+		RealBatch K[dim][dim];
+		for (unsigned int r = 0; r < dim; r++)
+		{
+			for (unsigned int c = 0; c <= r; c++)
+			{
+				K[r][c].setZero();
+				for (unsigned int i = 0; i < numberOfParticles; i++)
+					K[r][c] += invMass[i] * (jacobians[i][r].col(0) * jacobians[i][c].col(0) +
+						jacobians[i][r].col(1) * jacobians[i][c].col(1) + jacobians[i][r].col(2) * jacobians[i][c].col(2));
+			}
+		}
+
+		RealBatch minusC[dim];
+		for (unsigned int k = 0; k < dim; k++)
+			minusC[k] = -constraintValue[k];
+		RealBatch lambda[dim];
+		solveLDLTBatch<dim>(K, minusC, static_cast<Real>(1.0e-6), lambda, valid);
+
+		for (unsigned int i = 0; i < numberOfParticles; i++)
+		{
+			for (unsigned int l = 0; l < 3; l++)
+			{
+				corr_x[i].col(l).setZero();
+				for (unsigned int k = 0; k < dim; k++)
+					corr_x[i].col(l) += jacobians[i][k].col(l) * lambda[k];
+				corr_x[i].col(l) *= invMass[i];
+			}
+		}
+	}
+
 }
 
 #endif
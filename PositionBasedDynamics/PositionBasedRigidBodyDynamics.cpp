@@ -2381,6 +2381,56 @@ bool PositionBasedRigidBodyDynamics::velocitySolve_RigidBodyContactConstraint(
 	return true;
 }
 
+// ----------------------------------------------------------------------------------------------
+bool PositionBasedRigidBodyDynamics::velocityWarmStart_RigidBodyContactConstraint(
+	const Real invMass0,							// inverse mass is zero if body is static
+	const Vector3r &x0, 						// center of mass of body 0
+	const Matrix3r &inertiaInverseW0,		// inverse inertia tensor (world space) of body 0
+	const Real invMass1,							// inverse mass is zero if body is static
+	const Vector3r &x1, 						// center of mass of body 1
+	const Matrix3r &inertiaInverseW1,		// inverse inertia tensor (world space) of body 1
+	const Real frictionCoeff,						// friction coefficient
+	const Real sum_impulses,						// accumulated impulse of the last step
+	const Eigen::Matrix<Real, 3, 5, Eigen::DontAlign> &constraintInfo,		// precomputed contact info
+	Vector3r &corr_v0, Vector3r &corr_omega0,
+	Vector3r &corr_v1, Vector3r &corr_omega1)
+{
+	if (((invMass0 == 0.0) && (invMass1 == 0.0)) || (sum_impulses <= 0.0))
+		return false;
+
+	const Vector3r &connector0 = constraintInfo.col(0);
+	const Vector3r &connector1 = constraintInfo.col(1);
+	const Vector3r &normal = constraintInfo.col(2);
+	const Vector3r &tangent = constraintInfo.col(3);
+
+	// maximal impulse in tangent direction
+	const Real pMax = constraintInfo(1, 4);
+
+	Vector3r p(sum_impulses * normal);
+
+	// dynamic friction
+	if (frictionCoeff * sum_impulses > pMax)
+		p -= pMax * tangent;
+	else
+		p -= frictionCoeff * sum_impulses * tangent;
+
+	const Vector3r r0 = connector0 - x0;
+	const Vector3r r1 = connector1 - x1;
+
+	if (invMass0 != 0.0)
+	{
+		corr_v0 = invMass0*p;
+		corr_omega0 = inertiaInverseW0 * (r0.cross(p));
+	}
+
+	if (invMass1 != 0.0)
+	{
+		corr_v1 = -invMass1*p;
+		corr_omega1 = inertiaInverseW1 * (r1.cross(-p));
+	}
+
+	return true;
+}
 
 // ----------------------------------------------------------------------------------------------
 bool PositionBasedRigidBodyDynamics::init_ParticleRigidBodyContactConstraint(
@@ -1086,6 +1086,38 @@ namespace PBD
 			Vector3r &corr_v0, Vector3r &corr_omega0,
 			Vector3r &corr_v1, Vector3r &corr_omega1);
 
+		/** Apply the accumulated normal impulse of a contact constraint between two 
+		* rigid bodies from the last time step (warm starting). The friction impulse is 
+		* determined as in velocitySolve_RigidBodyContactConstraint().
+		*
+		* @param invMass0 inverse mass of rigid body
+		* @param x0 center of mass of first body
+		* @param inertiaInverseW0 inverse inertia tensor in world coordinates of first body
+		* @param invMass1 inverse mass of second body
+		* @param x1 center of mass of second body
+		* @param inertiaInverseW1 inverse inertia tensor in world coordinates of second body
+		* @param frictionCoeff friction coefficient
+		* @param sum_impulses impulse in normal direction which is applied
+		* @param constraintInfo information which is required by the solver. This
+		* information must be generated in the beginning by calling init_RigidBodyContactConstraint().
+		* @param corr_v0 velocity correction of first body
+		* @param corr_omega0 angular velocity correction of first body
+		* @param corr_v1 velocity correction of second body
+		* @param corr_omega1 angular velocity correction of second body
+		*/
+		static bool velocityWarmStart_RigidBodyContactConstraint(
+			const Real invMass0,							// inverse mass is zero if body is static
+			const Vector3r &x0, 						// center of mass of body 0
+			const Matrix3r &inertiaInverseW0,		// inverse inertia tensor (world space) of body 0
+			const Real invMass1,							// inverse mass is zero if body is static
+			const Vector3r &x1, 						// center of mass of body 1
+			const Matrix3r &inertiaInverseW1,		// inverse inertia tensor (world space) of body 1
+			const Real frictionCoeff,						// friction coefficient
+			const Real sum_impulses,						// accumulated impulse of the last step
+			const Eigen::Matrix<Real, 3, 5, Eigen::DontAlign> &constraintInfo,		// precomputed contact info
+			Vector3r &corr_v0, Vector3r &corr_omega0,
+			Vector3r &corr_v1, Vector3r &corr_omega1);
+
 
 		/** Initialize contact between a rigid body and a particle and return
 		* info which is required by the solver step.
@@ -1,8 +0,0 @@
-#include "SPHKernels.h"
-
-using namespace PBD;
-
-Real CubicKernel::m_radius;
-Real CubicKernel::m_k;
-Real CubicKernel::m_l;
-Real CubicKernel::m_W_zero;
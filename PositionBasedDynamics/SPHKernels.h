@@ -10,19 +10,25 @@
 
 namespace PBD
 {
+	/** Cubic spline kernel. Each fluid model owns its kernel, so that simulations 
+	* with different support radii can be performed in parallel.
+	*/
 	class CubicKernel
 	{
 	protected:
-		static Real m_radius;
-		static Real m_k;
-		static Real m_l;
-		static Real m_W_zero;
+		Real m_radius;
+		Real m_k;
+		Real m_l;
+		Real m_W_zero;
 	public:
-		static Real getRadius() { return m_radius; }
-		static void setRadius(Real val)
+		CubicKernel() : m_radius(0.0), m_k(0.0), m_l(0.0), m_W_zero(0.0) {}
+		explicit CubicKernel(const Real radius) { setRadius(radius); }
+
+		Real getRadius() const { return m_radius; }
+		void setRadius(Real val)
 		{
 			m_radius = val;
-			static const Real pi = static_cast<Real>(M_PI);
+			const Real pi = static_cast<Real>(M_PI);
 
 			const Real h3 = m_radius*m_radius*m_radius;
 			m_k = static_cast<Real>(8.0) / (pi*h3);
@@ -32,7 +38,7 @@ namespace PBD
 
 	public:
 		//static unsigned int counter;
-		static Real W(const Vector3r &r)
+		Real W(const Vector3r &r) const
 		{
 			//counter++;
 			Real res = 0.0;
@@ -56,7 +62,7 @@ namespace PBD
 			return res;
 		}
 
-		static Vector3r gradW(const Vector3r &r)
+		Vector3r gradW(const Vector3r &r) const
 		{
 			Vector3r res;
 			const Real rl = r.norm();
@@ -87,7 +93,7 @@ namespace PBD
 			return res;
 		}
 
-		static Real W_zero()
+		Real W_zero() const
 		{
 			return m_W_zero;
 		}
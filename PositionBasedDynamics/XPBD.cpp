@@ -291,3 +291,81 @@ bool XPBD::solve_FEMTetraConstraint(
 
 	return true;
 }
+
+// ----------------------------------------------------------------------------------------------
+void XPBD::solve_FEMTetraConstraintBatch(
+	const PositionBasedDynamics::Vector3Batch& p0, const PositionBasedDynamics::RealBatch& invMass0,
+	const PositionBasedDynamics::Vector3Batch& p1, const PositionBasedDynamics::RealBatch& invMass1,
+	const PositionBasedDynamics::Vector3Batch& p2, const PositionBasedDynamics::RealBatch& invMass2,
+	const PositionBasedDynamics::Vector3Batch& p3, const PositionBasedDynamics::RealBatch& invMass3,
+	const PositionBasedDynamics::RealBatch& restVolume,
+	const PositionBasedDynamics::Matrix3Batch& invRestMat,
+	const PositionBasedDynamics::RealBatch& youngsModulus,
+	const PositionBasedDynamics::RealBatch& poissonRatio,
+	const PositionBasedDynamics::RealBatch& handleInversion,
+	const Real dt,
+	const PositionBasedDynamics::RealBatch& lambda,
+	PositionBasedDynamics::Vector3Batch& corr0, PositionBasedDynamics::Vector3Batch& corr1,
+	PositionBasedDynamics::Vector3Batch& corr2, PositionBasedDynamics::Vector3Batch& corr3)
+{
+	typedef PositionBasedDynamics::RealBatch RealBatch;
+	typedef PositionBasedDynamics::Vector3Batch Vector3Batch;
+	const int batchSize = PositionBasedDynamics::BatchSize;
+
+	// only the sign of the volume is required
+	const Vector3Batch a = p1 - p0;
+	const Vector3Batch b = p2 - p0;
+	const Vector3Batch c = p3 - p0;
+	const RealBatch volume = (a.col(1) * b.col(2) - a.col(2) * b.col(1)) * c.col(0) +
+		(a.col(2) * b.col(0) - a.col(0) * b.col(2)) * c.col(1) +
+		(a.col(0) * b.col(1) - a.col(1) * b.col(0)) * c.col(2);
+
+	// Constraints with a non-positive Young's modulus or an invalid Poisson ratio have no
+	// corrections. Their values are replaced, so that no invalid values arise in the SIMD lanes.
+	RealBatch valid, nu, E, inversion;
+	for (int j = 0; j < batchSize; j++)
+	{
+		valid[j] = ((youngsModulus[j] > 0.0) && (poissonRatio[j] >= 0.0) && (poissonRatio[j] <= 0.49)) ? static_cast<Real>(1.0) : static_cast<Real>(0.0);
+		nu[j] = (valid[j] != 0.0) ? poissonRatio[j] : static_cast<Real>(0.0);
+		E[j] = (valid[j] != 0.0) ? youngsModulus[j] : static_cast<Real>(1.0);
+		inversion[j] = ((handleInversion[j] != 0.0) && !(volume[j] > 0.0)) ? static_cast<Real>(1.0) : static_cast<Real>(0.0);
+	}
+
+	// compute the Lame coefficients mu and lambda divided by Young's modulus E
+	// since we use Young's modulus as compliance factor alpha = 1/E.
+	const RealBatch mu_ = static_cast<Real>(0.5) / (static_cast<Real>(1.0) + nu);
+	const RealBatch lambda_ = nu / (static_cast<Real>(1.0) + nu) / (static_cast<Real>(1.0) - static_cast<Real>(2.0) * nu);
+
+	// compute value U' which is the potential energy of the elastic solid U divided by Young's modulus E
+	PositionBasedDynamics::Matrix3Batch sigma;
+	RealBatch U_;
+	Vector3Batch gradU_[4];
+	PositionBasedDynamics::computeGreenStrainAndPiolaStressBatch(p0, p1, p2, p3, invRestMat, restVolume, mu_, lambda_, inversion, sigma, U_);
+	PositionBasedDynamics::computeGradCGreenBatch(restVolume, invRestMat, sigma, gradU_);
+
+	// C = sqrt(2 U'), see solve_FEMTetraConstraint()
+	const RealBatch C = (static_cast<Real>(2.0) * U_).sqrt();
+
+	const RealBatch alpha = (E * dt * dt).inverse();
+	const RealBatch sum_normGradU_ =
+		invMass0 * gradU_[0].square().rowwise().sum() +
+		invMass1 * gradU_[1].square().rowwise().sum() +
+		invMass2 * gradU_[2].square().rowwise().sum() +
+		invMass3 * gradU_[3].square().rowwise().sum() +
+		C * C * alpha;
+
+	RealBatch solved;
+	for (int j = 0; j < batchSize; j++)
+		solved[j] = ((valid[j] != 0.0) && (sum_normGradU_[j] >= eps)) ? static_cast<Real>(1.0) : static_cast<Real>(0.0);
+
+	// compute scaling factor
+	const RealBatch s = solved * (C * C + C * alpha * lambda) / sum_normGradU_.max(eps);
+
+	for (int i = 0; i < 3; i++)
+	{
+		corr0.col(i) = -s * invMass0 * gradU_[0].col(i);
+		corr1.col(i) = -s * invMass1 * gradU_[1].col(i);
+		corr2.col(i) = -s * invMass2 * gradU_[2].col(i);
+		corr3.col(i) = -s * invMass3 * gradU_[3].col(i);
+	}
+}
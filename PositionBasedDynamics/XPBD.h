@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Common/Common.h"
+#include "PositionBasedDynamics.h"
 
 // ------------------------------------------------------------------------------------
 namespace PBD
@@ -147,6 +148,27 @@ namespace PBD
 			const Real dt,
 			Real& lambda,
 			Vector3r& corr0, Vector3r& corr1, Vector3r& corr2, Vector3r& corr3);
+
+		/** Batch variant of solve_FEMTetraConstraint() which determines the corrections of
+		* PositionBasedDynamics::BatchSize independent constraints at once. The parameters are
+		* the same as for the single constraint, where row j of each batch belongs to the j-th
+		* constraint and handleInversion is 1 or 0. The corrections of the constraints which
+		* cannot be solved (e.g. with an invalid Poisson ratio) are zero.
+		*/
+		static void solve_FEMTetraConstraintBatch(
+			const PositionBasedDynamics::Vector3Batch& p0, const PositionBasedDynamics::RealBatch& invMass0,
+			const PositionBasedDynamics::Vector3Batch& p1, const PositionBasedDynamics::RealBatch& invMass1,
+			const PositionBasedDynamics::Vector3Batch& p2, const PositionBasedDynamics::RealBatch& invMass2,
+			const PositionBasedDynamics::Vector3Batch& p3, const PositionBasedDynamics::RealBatch& invMass3,
+			const PositionBasedDynamics::RealBatch& restVolume,
+			const PositionBasedDynamics::Matrix3Batch& invRestMat,
+			const PositionBasedDynamics::RealBatch& youngsModulus,
+			const PositionBasedDynamics::RealBatch& poissonRatio,
+			const PositionBasedDynamics::RealBatch& handleInversion,
+			const Real dt,
+			const PositionBasedDynamics::RealBatch& lambda,
+			PositionBasedDynamics::Vector3Batch& corr0, PositionBasedDynamics::Vector3Batch& corr1,
+			PositionBasedDynamics::Vector3Batch& corr2, PositionBasedDynamics::Vector3Batch& corr3);
 	};
 }
 
@@ -102,7 +102,7 @@ void TimeStepFluidModel::computeDensities(FluidModel &model)
 		{
 			Real &density = model.getDensity(i);
 			Real density_err;
-			PositionBasedFluids::computePBFDensity(i, numParticles, &pd.getPosition(0), &pd.getMass(0), &model.getBoundaryX(0), &model.getBoundaryPsi(0), numNeighbors[i], neighbors[i], model.getDensity0(), true, density_err, density);
+			PositionBasedFluids::computePBFDensity(i, numParticles, &pd.getPosition(0), &pd.getMass(0), &model.getBoundaryX(0), &model.getBoundaryPsi(0), numNeighbors[i], neighbors[i], model.getKernel(), model.getDensity0(), true, density_err, density);
 		}
 	}
 }
@@ -169,13 +169,13 @@ void TimeStepFluidModel::computeXSPHViscosity(FluidModel &model)
 					const Vector3r &xj = pd.getPosition(neighborIndex);
 					const Vector3r &vj = pd.getVelocity(neighborIndex);
 					const Real density_j = model.getDensity(neighborIndex);
-					vi -= viscosity * (pd.getMass(neighborIndex) / density_j) * (vi - vj) * CubicKernel::W(xi - xj);
+					vi -= viscosity * (pd.getMass(neighborIndex) / density_j) * (vi - vj) * model.getKernel().W(xi - xj);
 
 				}
 // 				else 
 // 				{
 // 					const Vector3r &xj = model.getBoundaryX(neighborIndex - numParticles);
-// 					vi -= viscosity * (model.getBoundaryPsi(neighborIndex - numParticles) / density_i) * (vi)* CubicKernel::W(xi - xj);
+// 					vi -= viscosity * (model.getBoundaryPsi(neighborIndex - numParticles) / density_i) * (vi)* model.getKernel().W(xi - xj);
 // 				}
 			}
 		}
@@ -213,8 +213,8 @@ void TimeStepFluidModel::constraintProjection(FluidModel &model)
 			for (int i = 0; i < (int)nParticles; i++)
 			{
 				Real density_err;
-				PositionBasedFluids::computePBFDensity(i, nParticles, &pd.getPosition(0), &pd.getMass(0), &model.getBoundaryX(0), &model.getBoundaryPsi(0), numNeighbors[i], neighbors[i], model.getDensity0(), true, density_err, model.getDensity(i));
-				PositionBasedFluids::computePBFLagrangeMultiplier(i, nParticles, &pd.getPosition(0), &pd.getMass(0), &model.getBoundaryX(0), &model.getBoundaryPsi(0), model.getDensity(i), numNeighbors[i], neighbors[i], model.getDensity0(), true, model.getLambda(i));
+				PositionBasedFluids::computePBFDensity(i, nParticles, &pd.getPosition(0), &pd.getMass(0), &model.getBoundaryX(0), &model.getBoundaryPsi(0), numNeighbors[i], neighbors[i], model.getKernel(), model.getDensity0(), true, density_err, model.getDensity(i));
+				PositionBasedFluids::computePBFLagrangeMultiplier(i, nParticles, &pd.getPosition(0), &pd.getMass(0), &model.getBoundaryX(0), &model.getBoundaryPsi(0), model.getDensity(i), numNeighbors[i], neighbors[i], model.getKernel(), model.getDensity0(), true, model.getLambda(i));
 			}
 		}
 		
@@ -224,7 +224,7 @@ void TimeStepFluidModel::constraintProjection(FluidModel &model)
 			for (int i = 0; i < (int)nParticles; i++)
 			{
 				Vector3r corr;
-				PositionBasedFluids::solveDensityConstraint(i, nParticles, &pd.getPosition(0), &pd.getMass(0), &model.getBoundaryX(0), &model.getBoundaryPsi(0), numNeighbors[i], neighbors[i], model.getDensity0(), true, &model.getLambda(0), corr);
+				PositionBasedFluids::solveDensityConstraint(i, nParticles, &pd.getPosition(0), &pd.getMass(0), &model.getBoundaryX(0), &model.getBoundaryPsi(0), numNeighbors[i], neighbors[i], model.getKernel(), model.getDensity0(), true, &model.getLambda(0), corr);
 				model.getDeltaX(i) = corr;
 			}
 		}
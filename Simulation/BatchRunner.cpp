@@ -0,0 +1,108 @@
+#include "BatchRunner.h"
+#include "Simulation.h"
+#include "omp.h"
+
+using namespace PBD;
+using namespace std;
+
+BatchRunner::BatchRunner(const unsigned int numThreads)
+{
+	m_task = nullptr;
+	m_numTasks = 0;
+	m_nextTask = 0;
+	m_numActiveThreads = 0;
+	m_batchIndex = 0;
+	m_stop = false;
+
+	unsigned int n = numThreads;
+	if (n == 0)
+		n = std::max(1u, std::thread::hardware_concurrency());
+	m_threads.reserve(n);
+	for (unsigned int i = 0; i < n; i++)
+		m_threads.push_back(std::thread(&BatchRunner::workerLoop, this));
+}
+
+BatchRunner::~BatchRunner()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_startCondition.notify_all();
+	for (size_t i = 0; i < m_threads.size(); i++)
+		m_threads[i].join();
+}
+
+void BatchRunner::workerLoop()
+{
+	// one simulation per worker, the batch is the parallelism
+	omp_set_num_threads(1);
+
+	unsigned int batchIndex = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_startCondition.wait(lock, [&] { return m_stop || (m_batchIndex != batchIndex); });
+			if (m_stop)
+				return;
+			batchIndex = m_batchIndex;
+		}
+
+		try
+		{
+			for (unsigned int i = m_nextTask++; i < m_numTasks; i = m_nextTask++)
+				(*m_task)(i);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!m_exception)
+				m_exception = std::current_exception();
+			// skip the remaining tasks
+			m_nextTask = m_numTasks;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_numActiveThreads--;
+			if (m_numActiveThreads == 0)
+				m_doneCondition.notify_all();
+		}
+	}
+}
+
+void BatchRunner::run(const unsigned int numTasks, const std::function<void(const unsigned int)> &task)
+{
+	if (numTasks == 0)
+		return;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_task = &task;
+	m_numTasks = numTasks;
+	m_nextTask = 0;
+	m_numActiveThreads = static_cast<unsigned int>(m_threads.size());
+	m_exception = nullptr;
+	m_batchIndex++;
+	m_startCondition.notify_all();
+	m_doneCondition.wait(lock, [&] { return m_numActiveThreads == 0; });
+	m_task = nullptr;
+
+	if (m_exception)
+	{
+		std::exception_ptr e = m_exception;
+		m_exception = nullptr;
+		std::rethrow_exception(e);
+	}
+}
+
+void BatchRunner::step(const std::vector<Simulation*> &simulations, const unsigned int numSteps)
+{
+	run(static_cast<unsigned int>(simulations.size()), [&](const unsigned int i)
+	{
+		Simulation *sim = simulations[i];
+		sim->makeCurrent();
+		for (unsigned int s = 0; s < numSteps; s++)
+			sim->getTimeStep()->step(*sim->getModel());
+	});
+}
@@ -0,0 +1,68 @@
+#ifndef __BatchRunner_h__
+#define __BatchRunner_h__
+
+#include "Common/Common.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+namespace PBD
+{
+	class Simulation;
+
+	/** \brief Thread pool to perform many independent simulations in parallel,
+	* e.g. for parameter studies or for learning tasks.
+	* Each simulation is stepped by one worker thread at a time. The worker makes
+	* the simulation its current one (see Simulation::makeCurrent()), so the
+	* simulations must not share models, time steps or time managers.
+	* The OpenMP parallelization of the simulation steps is disabled in the
+	* workers since the parallelism comes from the batch.
+	*/
+	class BatchRunner
+	{
+	public:
+		/** Create the worker threads. If numThreads is 0, the number of hardware threads is used. */
+		explicit BatchRunner(const unsigned int numThreads = 0);
+		BatchRunner(const BatchRunner&) = delete;
+		BatchRunner& operator=(const BatchRunner&) = delete;
+		~BatchRunner();
+
+		unsigned int getNumThreads() const { return static_cast<unsigned int>(m_threads.size()); }
+
+		/** Call task(i) for i = 0,...,numTasks-1 in the worker threads and wait
+		* until all tasks are finished. The tasks are distributed dynamically.
+		* If a task throws an exception, the first one is rethrown in the calling thread
+		* after all tasks are finished.
+		*/
+		void run(const unsigned int numTasks, const std::function<void(const unsigned int)> &task);
+
+		/** Perform numSteps time steps of each simulation. The current simulation
+		* of the calling thread is not changed.
+		*/
+		void step(const std::vector<Simulation*> &simulations, const unsigned int numSteps);
+
+	protected:
+		std::vector<std::thread> m_threads;
+		std::mutex m_mutex;
+		std::condition_variable m_startCondition;
+		std::condition_variable m_doneCondition;
+		/** Task of the current batch, only valid during run() */
+		const std::function<void(const unsigned int)> *m_task;
+		unsigned int m_numTasks;
+		std::atomic<unsigned int> m_nextTask;
+		/** Number of workers which are still processing the current batch */
+		unsigned int m_numActiveThreads;
+		/** Incremented for each batch to wake up the workers */
+		unsigned int m_batchIndex;
+		bool m_stop;
+		std::exception_ptr m_exception;
+
+		void workerLoop();
+	};
+}
+
+#endif
@@ -9,9 +9,28 @@ using namespace Eigen;
 using pool_set = std::set<unsigned int>;
 using namespace PBD;
 
+/** Compute the smallest sphere which contains the spheres of both children of an inner node. */
+static void mergeSpheres(const BoundingSphere &s0, const BoundingSphere &s1, BoundingSphere& hull)
+{
+	const Vector3r d = s1.x() - s0.x();
+	const Real dist = d.norm();
+	if (dist + s1.r() <= s0.r())
+	{
+		hull = s0;
+		return;
+	}
+	if (dist + s0.r() <= s1.r())
+	{
+		hull = s1;
+		return;
+	}
+	const Real r = static_cast<Real>(0.5) * (dist + s0.r() + s1.r());
+	hull.x() = s0.x() + ((r - s0.r()) / dist) * d;
+	hull.r() = r;
+}
 
 PointCloudBSH::PointCloudBSH()
-    : super(0, 10)
+    : super(0, 10), m_vertices(nullptr), m_numVertices(0)
 {
 }
 
@@ -51,6 +70,12 @@ void PointCloudBSH::compute_hull_approx(unsigned int b, unsigned int n, Bounding
 	hull.r() = sqrt(radius2);
 }
 
+void PointCloudBSH::compute_hull_from_children(unsigned int node_index, BoundingSphere& hull) const
+{
+	Node const& nd = m_nodes[node_index];
+	mergeSpheres(m_hulls[nd.children[0]], m_hulls[nd.children[1]], hull);
+}
+
 void PointCloudBSH::init(const Vector3r *vertices, const unsigned int numVertices)
 {
 	m_lst.resize(numVertices);
@@ -58,6 +83,11 @@ void PointCloudBSH::init(const Vector3r *vertices, const unsigned int numVertice
 	m_numVertices = numVertices;
 }
 
+void PointCloudBSH::updateVertices(const Vector3r* vertices)
+{
+	m_vertices = vertices;
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 
@@ -105,6 +135,12 @@ void TetMeshBSH::compute_hull_approx(unsigned int b, unsigned int n, BoundingSph
 	hull.r() = sqrt(radius2) + m_tolerance;
 }
 
+void TetMeshBSH::compute_hull_from_children(unsigned int node_index, BoundingSphere& hull) const
+{
+	Node const& nd = m_nodes[node_index];
+	mergeSpheres(m_hulls[nd.children[0]], m_hulls[nd.children[1]], hull);
+}
+
 void TetMeshBSH::init(const Vector3r *vertices, const unsigned int numVertices, const unsigned int *indices, const unsigned int numTets, const Real tolerance)
 {
 	m_lst.resize(numTets);
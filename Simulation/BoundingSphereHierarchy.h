@@ -22,6 +22,11 @@ namespace PBD
 			const final;
 		void compute_hull_approx(unsigned int b, unsigned int n, BoundingSphere& hull)
 			const final;
+		void compute_hull_from_children(unsigned int node_index, BoundingSphere& hull)
+			const final;
+		/** Set the vertex array if the number of vertices is unchanged. */
+		void updateVertices(const Vector3r* vertices);
+		unsigned int numVertices() const { return m_numVertices; }
 
 	private:
 		const Vector3r *m_vertices;
@@ -44,6 +49,8 @@ namespace PBD
 			const final;
 		void compute_hull_approx(unsigned int b, unsigned int n, BoundingSphere& hull)
 			const final;
+		void compute_hull_from_children(unsigned int node_index, BoundingSphere& hull)
+			const final;
 		void updateVertices(const Vector3r* vertices);
 
 	private:
@@ -62,6 +69,53 @@ namespace PBD
 
 		static void traverse(PointCloudBSH const& b1, TetMeshBSH const& b2, TraversalCallback func);
 		static void traverse(PointCloudBSH const& b1, const unsigned int node_index1, TetMeshBSH const& b2, const unsigned int node_index2, TraversalCallback func);
+
+		/** Simultaneous traversal of both hierarchies with an inlined callback and an explicit 
+		 * stack (TraversalStack). The leaf pairs are reported in the same order as by the
+		 * recursive version. Lambdas which are passed directly bind to this overload.
+		 */
+		template <typename Callback>
+		static void traverse(PointCloudBSH const& b1, TetMeshBSH const& b2, Callback const& func)
+		{
+			if ((b1.numNodes() == 0) || (b2.numNodes() == 0))
+				return;
+
+			// Each step replaces one pair by two pairs of which one node is a child.
+			// Hence the stack size is bounded by the sum of the depths of both trees.
+			TraversalStack<std::array<unsigned int, 2>, 2 * PointCloudBSH::MaxStackSize> stack;
+			stack.push({ { 0, 0 } });
+			while (!stack.empty())
+			{
+				const std::array<unsigned int, 2> item = stack.pop();
+				const unsigned int node_index1 = item[0];
+				const unsigned int node_index2 = item[1];
+				const BoundingSphere &bs1 = b1.hull(node_index1);
+				const BoundingSphere &bs2 = b2.hull(node_index2);
+				if (!bs1.overlaps(bs2))
+					continue;
+
+				auto const& node1 = b1.node(node_index1);
+				auto const& node2 = b2.node(node_index2);
+				if (node1.is_leaf() && node2.is_leaf())
+				{
+					func(node_index1, node_index2);
+					continue;
+				}
+
+				// descend into the hierarchy with the smaller sphere unless its node is a leaf
+				const bool descend1 = (bs1.r() < bs2.r()) ? !node1.is_leaf() : node2.is_leaf();
+				if (descend1)
+				{
+					stack.push({ { static_cast<unsigned int>(node1.children[1]), node_index2 } });
+					stack.push({ { static_cast<unsigned int>(node1.children[0]), node_index2 } });
+				}
+				else
+				{
+					stack.push({ { node_index1, static_cast<unsigned int>(node2.children[1]) } });
+					stack.push({ { node_index1, static_cast<unsigned int>(node2.children[0]) } });
+				}
+			}
+		}
 	};
 }
 
@@ -0,0 +1,173 @@
+#include "BroadPhase.h"
+#include <algorithm>
+#include "omp.h"
+
+using namespace PBD;
+
+/** Merge the pairs found by the different threads and sort them lexicographically
+ * so that the result does not depend on the number of threads.
+ */
+static void mergePairs(std::vector<BroadPhase::PairVector> &pairs_mt, BroadPhase::PairVector &pairs)
+{
+	size_t numPairs = 0;
+	for (size_t i = 0; i < pairs_mt.size(); i++)
+		numPairs += pairs_mt[i].size();
+
+	pairs.clear();
+	pairs.reserve(numPairs);
+	for (size_t i = 0; i < pairs_mt.size(); i++)
+		pairs.insert(pairs.end(), pairs_mt[i].begin(), pairs_mt[i].end());
+	std::sort(pairs.begin(), pairs.end());
+}
+
+BruteForceBroadPhase::BruteForceBroadPhase() :
+	BroadPhase()
+{
+}
+
+BruteForceBroadPhase::~BruteForceBroadPhase()
+{
+}
+
+void BruteForceBroadPhase::computePairs(const std::vector<AABB> &aabbs, PairVector &pairs)
+{
+	const int numObjects = (int)aabbs.size();
+	m_pairs_mt.resize(omp_get_max_threads());
+	for (size_t i = 0; i < m_pairs_mt.size(); i++)
+		m_pairs_mt[i].clear();
+
+	#pragma omp parallel if(numObjects > MIN_PARALLEL_SIZE) default(shared)
+	{
+		PairVector &localPairs = m_pairs_mt[omp_get_thread_num()];
+		#pragma omp for schedule(dynamic, 16)
+		for (int i = 0; i < numObjects; i++)
+		{
+			for (int k = i + 1; k < numObjects; k++)
+			{
+				if (AABB::intersection(aabbs[i], aabbs[k]))
+					localPairs.push_back({ (unsigned int)i, (unsigned int)k });
+			}
+		}
+	}
+	mergePairs(m_pairs_mt, pairs);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+SweepAndPruneBroadPhase::SweepAndPruneBroadPhase() :
+	BroadPhase()
+{
+}
+
+SweepAndPruneBroadPhase::~SweepAndPruneBroadPhase()
+{
+}
+
+void SweepAndPruneBroadPhase::reset()
+{
+	for (unsigned int axis = 0; axis < 3; axis++)
+		m_endPoints[axis].clear();
+	m_pairSet.clear();
+}
+
+void SweepAndPruneBroadPhase::rebuild(const std::vector<AABB> &aabbs)
+{
+	const unsigned int numObjects = static_cast<unsigned int>(aabbs.size());
+	for (unsigned int axis = 0; axis < 3; axis++)
+	{
+		std::vector<EndPoint> &endPoints = m_endPoints[axis];
+		endPoints.resize(2 * numObjects);
+		for (unsigned int i = 0; i < numObjects; i++)
+		{
+			endPoints[2 * i] = { aabbs[i].m_p[0][axis], 2 * i };
+			endPoints[2 * i + 1] = { aabbs[i].m_p[1][axis], 2 * i + 1 };
+		}
+		std::sort(endPoints.begin(), endPoints.end(), less);
+	}
+
+	// initial pairs by a single sweep along the x-axis
+	m_pairSet.clear();
+	std::vector<unsigned int> active;
+	const std::vector<EndPoint> &endPoints = m_endPoints[0];
+	for (size_t i = 0; i < endPoints.size(); i++)
+	{
+		const unsigned int index = endPoints[i].objectIndex();
+		if (endPoints[i].isMax())
+		{
+			active.erase(std::find(active.begin(), active.end(), index));
+			continue;
+		}
+		for (size_t j = 0; j < active.size(); j++)
+		{
+			if (AABB::intersection(aabbs[index], aabbs[active[j]]))
+				m_pairSet.insert(pairKey(index, active[j]));
+		}
+		active.push_back(index);
+	}
+}
+
+bool SweepAndPruneBroadPhase::insertionSort(const std::vector<AABB> &aabbs, const unsigned int axis)
+{
+	std::vector<EndPoint> &endPoints = m_endPoints[axis];
+
+	// update the endpoint values
+	for (size_t i = 0; i < endPoints.size(); i++)
+	{
+		const EndPoint &ep = endPoints[i];
+		endPoints[i].m_value = aabbs[ep.objectIndex()].m_p[ep.isMax() ? 1 : 0][axis];
+	}
+
+	// If the objects moved too far (e.g. after a reset of the simulation), 
+	// a complete rebuild is cheaper than the insertion sort.
+	const size_t maxSwaps = 32 * endPoints.size();
+	size_t numSwaps = 0;
+	for (size_t i = 1; i < endPoints.size(); i++)
+	{
+		const EndPoint key = endPoints[i];
+		size_t j = i;
+		while ((j > 0) && less(key, endPoints[j - 1]))
+		{
+			const EndPoint &other = endPoints[j - 1];
+			if (!key.isMax() && other.isMax())
+			{
+				// minimum passes a maximum => the intervals begin to overlap on this axis
+				if (AABB::intersection(aabbs[key.objectIndex()], aabbs[other.objectIndex()]))
+					m_pairSet.insert(pairKey(key.objectIndex(), other.objectIndex()));
+			}
+			else if (key.isMax() && !other.isMax())
+			{
+				// maximum passes a minimum => the intervals are separated on this axis
+				m_pairSet.erase(pairKey(key.objectIndex(), other.objectIndex()));
+			}
+			endPoints[j] = endPoints[j - 1];
+			j--;
+			if (++numSwaps > maxSwaps)
+				return false;
+		}
+		endPoints[j] = key;
+	}
+	return true;
+}
+
+void SweepAndPruneBroadPhase::computePairs(const std::vector<AABB> &aabbs, PairVector &pairs)
+{
+	if (m_endPoints[0].size() != 2 * aabbs.size())
+		rebuild(aabbs);
+	else
+	{
+		for (unsigned int axis = 0; axis < 3; axis++)
+		{
+			if (!insertionSort(aabbs, axis))
+			{
+				rebuild(aabbs);
+				break;
+			}
+		}
+	}
+
+	m_sortedPairs.assign(m_pairSet.begin(), m_pairSet.end());
+	std::sort(m_sortedPairs.begin(), m_sortedPairs.end());
+	pairs.resize(m_sortedPairs.size());
+	for (size_t i = 0; i < m_sortedPairs.size(); i++)
+		pairs[i] = { static_cast<unsigned int>(m_sortedPairs[i] >> 32), static_cast<unsigned int>(m_sortedPairs[i] & 0xffffffffu) };
+}
@@ -0,0 +1,94 @@
+#ifndef __BROADPHASE_H__
+#define __BROADPHASE_H__
+
+#include "Common/Common.h"
+#include "AABB.h"
+#include <vector>
+#include <unordered_set>
+
+namespace PBD
+{
+	/** Base class of the broad phase methods which are used by the collision detection
+	 * to determine all pairs of collision objects with overlapping AABBs.
+	 */
+	class BroadPhase
+	{
+	public:
+		typedef std::vector<std::pair<unsigned int, unsigned int>> PairVector;
+
+		BroadPhase() {}
+		virtual ~BroadPhase() {}
+
+		/** Determine all pairs (i, k) with i < k of overlapping AABBs.
+		 * The pairs are sorted lexicographically.
+		 *
+		 * @param aabbs AABBs of the collision objects
+		 * @param pairs resulting pairs of indices in the AABB array
+		 */
+		virtual void computePairs(const std::vector<AABB> &aabbs, PairVector &pairs) = 0;
+
+		/** Discard all data which is kept between two calls of computePairs(). */
+		virtual void reset() {}
+	};
+
+	/** Tests all pairs of AABBs. This has a complexity of O(n^2).
+	 */
+	class BruteForceBroadPhase : public BroadPhase
+	{
+	protected:
+		std::vector<PairVector> m_pairs_mt;
+
+	public:
+		BruteForceBroadPhase();
+		virtual ~BruteForceBroadPhase();
+
+		virtual void computePairs(const std::vector<AABB> &aabbs, PairVector &pairs);
+	};
+
+	/** Incremental sweep and prune (Baraff 1992). The interval endpoints of the AABBs
+	 * are kept sorted along all three axes and the set of overlapping pairs is 
+	 * updated only if two endpoints swap their order. Since the sorted order of the 
+	 * last step is reused (temporal coherence), the insertion sort only has to 
+	 * perform a few swaps if the objects move slowly.
+	 */
+	class SweepAndPruneBroadPhase : public BroadPhase
+	{
+	protected:
+		struct EndPoint
+		{
+			Real m_value;
+			/** object index * 2 + (1 if maximum, 0 if minimum) */
+			unsigned int m_data;
+
+			unsigned int objectIndex() const { return m_data >> 1; }
+			bool isMax() const { return (m_data & 1u) != 0; }
+		};
+
+		std::vector<EndPoint> m_endPoints[3];
+		std::unordered_set<unsigned long long> m_pairSet;
+		std::vector<unsigned long long> m_sortedPairs;
+
+		static FORCE_INLINE bool less(const EndPoint &a, const EndPoint &b)
+		{
+			// a minimum is sorted before a maximum with the same value so that 
+			// touching AABBs are reported as in AABB::intersection()
+			return (a.m_value < b.m_value) || ((a.m_value == b.m_value) && !a.isMax() && b.isMax());
+		}
+		static FORCE_INLINE unsigned long long pairKey(const unsigned int i, const unsigned int k)
+		{
+			return (i < k) ? ((static_cast<unsigned long long>(i) << 32) | k) : ((static_cast<unsigned long long>(k) << 32) | i);
+		}
+
+		void rebuild(const std::vector<AABB> &aabbs);
+		bool insertionSort(const std::vector<AABB> &aabbs, const unsigned int axis);
+
+	public:
+		SweepAndPruneBroadPhase();
+		virtual ~SweepAndPruneBroadPhase();
+
+		virtual void computePairs(const std::vector<AABB> &aabbs, PairVector &pairs);
+		virtual void reset();
+	};
+}
+
+#endif
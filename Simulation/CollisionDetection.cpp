@@ -1,11 +1,15 @@
 #include "CollisionDetection.h"
 #include "Simulation/IDFactory.h"
+#include <cassert>
 
 using namespace PBD;
 using namespace Utilities;
 using namespace GenParam;
 
 int CollisionDetection::CONTACT_TOLERANCE = -1;
+int CollisionDetection::BROAD_PHASE_METHOD = -1;
+int CollisionDetection::ENUM_BROADPHASE_BRUTE_FORCE = -1;
+int CollisionDetection::ENUM_BROADPHASE_SWEEP_AND_PRUNE = -1;
 
 int CollisionDetection::CollisionObjectWithoutGeometry::TYPE_ID = IDFactory::getId();
 const unsigned int CollisionDetection::RigidBodyContactType = 0;
@@ -22,12 +26,16 @@ CollisionDetection::CollisionDetection() : m_collisionObjects()
 	m_collisionObjects.reserve(1000);
 	m_contactCB = NULL;
 	m_solidContactCB = NULL;
+	m_contactBatchCB = NULL;
 	m_tolerance = static_cast<Real>(0.01);
+	m_broadPhaseMethod = 1;
+	m_broadPhase = new SweepAndPruneBroadPhase();
 }
 
 CollisionDetection::~CollisionDetection()
 {
 	cleanup();
+	delete m_broadPhase;
 }
 
 
@@ -44,6 +52,13 @@ void CollisionDetection::initParameters()
 	setGroup(CONTACT_TOLERANCE, "Simulation|Contact");
 	setDescription(CONTACT_TOLERANCE, "Tolerance of the collision detection");
 	static_cast<NumericParameter<Real>*>(getParameter(CONTACT_TOLERANCE))->setMinValue(0.0);
+
+	BROAD_PHASE_METHOD = createEnumParameter("broadPhaseMethod", "Broad phase", std::bind(&CollisionDetection::getBroadPhaseMethod, this), std::bind(static_cast<void (CollisionDetection::*)(const int)>(&CollisionDetection::setBroadPhaseMethod), this, std::placeholders::_1));
+	setGroup(BROAD_PHASE_METHOD, "Simulation|Contact");
+	setDescription(BROAD_PHASE_METHOD, "Method to determine the pairs of collision objects with overlapping AABBs.");
+	EnumParameter* enumParam = static_cast<EnumParameter*>(getParameter(BROAD_PHASE_METHOD));
+	enumParam->addEnumValue("Brute force", ENUM_BROADPHASE_BRUTE_FORCE);
+	enumParam->addEnumValue("Sweep and prune", ENUM_BROADPHASE_SWEEP_AND_PRUNE);
 }
 
 void CollisionDetection::cleanup()
@@ -51,6 +66,33 @@ void CollisionDetection::cleanup()
 	for (unsigned int i = 0; i < m_collisionObjects.size(); i++)
 		delete m_collisionObjects[i];
 	m_collisionObjects.clear();
+	m_aabbs.clear();
+	if (m_broadPhase)
+		m_broadPhase->reset();
+}
+
+void CollisionDetection::setBroadPhaseMethod(const int val)
+{
+	m_broadPhaseMethod = val;
+	delete m_broadPhase;
+	if (m_broadPhaseMethod == 0)
+		m_broadPhase = new BruteForceBroadPhase();
+	else
+		m_broadPhase = new SweepAndPruneBroadPhase();
+}
+
+void CollisionDetection::setBroadPhase(BroadPhase *broadPhase)
+{
+	delete m_broadPhase;
+	m_broadPhase = broadPhase;
+}
+
+void CollisionDetection::computeOverlappingPairs(BroadPhase::PairVector &pairs)
+{
+	m_aabbs.resize(m_collisionObjects.size());
+	for (unsigned int i = 0; i < m_collisionObjects.size(); i++)
+		m_aabbs[i] = m_collisionObjects[i]->m_aabb;
+	m_broadPhase->computePairs(m_aabbs, pairs);
 }
 
 void CollisionDetection::addRigidBodyContact(const unsigned int rbIndex1, const unsigned int rbIndex2,
@@ -60,6 +102,8 @@ void CollisionDetection::addRigidBodyContact(const unsigned int rbIndex1, const
 {
 	if (m_contactCB)
 		m_contactCB(RigidBodyContactType, rbIndex1, rbIndex2, cp1, cp2, normal, dist, restitutionCoeff, frictionCoeff, m_contactCBUserData);
+	else if (m_contactBatchCB)
+		addSingleContact(0, rbIndex1, rbIndex2, RigidBodyContactConstraint::InvalidFeatureIndex, Vector3r::Zero(), cp1, cp2, normal, dist, restitutionCoeff, frictionCoeff);
 }
 
 void CollisionDetection::addParticleRigidBodyContact(const unsigned int particleIndex, const unsigned int rbIndex,
@@ -69,6 +113,8 @@ void CollisionDetection::addParticleRigidBodyContact(const unsigned int particle
 {
 	if (m_contactCB)
 		m_contactCB(ParticleRigidBodyContactType, particleIndex, rbIndex, cp1, cp2, normal, dist, restitutionCoeff, frictionCoeff, m_contactCBUserData);
+	else if (m_contactBatchCB)
+		addSingleContact(1, particleIndex, rbIndex, 0, Vector3r::Zero(), cp1, cp2, normal, dist, restitutionCoeff, frictionCoeff);
 }
 
 void CollisionDetection::addParticleSolidContact(const unsigned int particleIndex, const unsigned int solidIndex,
@@ -77,6 +123,48 @@ void CollisionDetection::addParticleSolidContact(const unsigned int particleInde
 {
 	if (m_solidContactCB)
 		m_solidContactCB(ParticleSolidContactType, particleIndex, solidIndex, tetIndex, bary, cp1, cp2, normal, dist, restitutionCoeff, frictionCoeff, m_contactCBUserData);
+	else if (m_contactBatchCB)
+		addSingleContact(2, particleIndex, solidIndex, tetIndex, bary, cp1, cp2, normal, dist, restitutionCoeff, frictionCoeff);
+}
+
+void CollisionDetection::addSingleContact(const char type, const unsigned int index1, const unsigned int index2,
+										  const unsigned int elementIndex2, const Vector3r &bary2,
+										  const Vector3r &cp1, const Vector3r &cp2,
+										  const Vector3r &normal, const Real dist,
+										  const Real restitutionCoeff, const Real frictionCoeff)
+{
+	m_singleContact.resize(1);
+	m_singleContact[0].resize(1);
+	const unsigned int elementIndex1 = (type == 0) ? RigidBodyContactConstraint::InvalidFeatureIndex : 0;
+	m_singleContact[0][0] = ContactData(type, index1, index2, cp1, cp2, normal, dist, restitutionCoeff, frictionCoeff,
+		elementIndex1, elementIndex2, Vector3r::Zero(), bary2);
+	m_contactBatchCB(m_singleContact, m_contactBatchCBUserData);
+}
+
+void CollisionDetection::addContacts(const std::vector<std::vector<ContactData> > &contacts_mt)
+{
+	if (m_contactBatchCB)
+	{
+		m_contactBatchCB(contacts_mt, m_contactBatchCBUserData);
+		return;
+	}
+
+	for (unsigned int i = 0; i < contacts_mt.size(); i++)
+	{
+		for (unsigned int j = 0; j < contacts_mt[i].size(); j++)
+		{
+			const ContactData &cd = contacts_mt[i][j];
+			if (cd.m_type == 1)
+				addParticleRigidBodyContact(cd.m_index1, cd.m_index2, cd.m_cp1, cd.m_cp2, cd.m_normal,
+					cd.m_dist, cd.m_restitution, cd.m_friction);
+			else if (cd.m_type == 0)
+				addRigidBodyContact(cd.m_index1, cd.m_index2, cd.m_cp1, cd.m_cp2, cd.m_normal,
+					cd.m_dist, cd.m_restitution, cd.m_friction);
+			else if (cd.m_type == 2)
+				addParticleSolidContact(cd.m_index1, cd.m_index2, cd.m_elementIndex2, cd.m_bary2,
+					cd.m_cp1, cd.m_cp2, cd.m_normal, cd.m_dist, cd.m_restitution, cd.m_friction);
+		}
+	}
 }
 
 void CollisionDetection::addCollisionObject(const unsigned int bodyIndex, const unsigned int bodyType)
@@ -89,16 +177,25 @@ void CollisionDetection::addCollisionObject(const unsigned int bodyIndex, const
 
 void CollisionDetection::setContactCallback(CollisionDetection::ContactCallbackFunction val, void *userData)
 {
+	assert((val == NULL) || (m_contactBatchCB == NULL));
 	m_contactCB = val;
 	m_contactCBUserData = userData;
 }
 
 void CollisionDetection::setSolidContactCallback(CollisionDetection::SolidContactCallbackFunction val, void *userData)
 {
+	assert((val == NULL) || (m_contactBatchCB == NULL));
 	m_solidContactCB = val;
 	m_solidContactCBUserData = userData;
 }
 
+void CollisionDetection::setContactBatchCallback(CollisionDetection::ContactBatchCallbackFunction val, void *userData)
+{
+	assert((val == NULL) || ((m_contactCB == NULL) && (m_solidContactCB == NULL)));
+	m_contactBatchCB = val;
+	m_contactBatchCBUserData = userData;
+}
+
 void CollisionDetection::updateAABBs(SimulationModel &model)
 {
 	const SimulationModel::RigidBodyVector &rigidBodies = model.getRigidBodies();
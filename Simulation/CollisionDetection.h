@@ -4,6 +4,7 @@
 #include "Common/Common.h"
 #include "SimulationModel.h"
 #include "AABB.h"
+#include "BroadPhase.h"
 #include "ParameterObject.h"
 
 namespace PBD
@@ -12,6 +13,9 @@ namespace PBD
 	{
 	public:
 		static int CONTACT_TOLERANCE;
+		static int BROAD_PHASE_METHOD;
+		static int ENUM_BROADPHASE_BRUTE_FORCE;
+		static int ENUM_BROADPHASE_SWEEP_AND_PRUNE;
 
 		static const unsigned int RigidBodyContactType;			// = 0;
 		static const unsigned int ParticleContactType;			// = 1;
@@ -29,6 +33,46 @@ namespace PBD
 													 const Vector3r &normal, const Real dist,
 													 const Real restitutionCoeff, const Real frictionCoeff, void *userData);
 
+		/** Contact which is found by the collision detection. m_type is 0 for a rigid body contact,
+		 * 1 for a particle-rigid body contact and 2 for a particle-solid contact.
+		 */
+		struct ContactData
+		{
+			ContactData() {}
+			/** Initialize all members. The element indices and barycentric coordinates are only
+			 * used by some contact types, see TimeStep::contactBatchCallbackFunction().
+			 */
+			ContactData(const char type, const unsigned int index1, const unsigned int index2,
+				const Vector3r &cp1, const Vector3r &cp2, const Vector3r &normal, const Real dist,
+				const Real restitution, const Real friction,
+				const unsigned int elementIndex1 = 0, const unsigned int elementIndex2 = 0,
+				const Vector3r &bary1 = Vector3r::Zero(), const Vector3r &bary2 = Vector3r::Zero())
+				: m_type(type), m_index1(index1), m_index2(index2), m_cp1(cp1), m_cp2(cp2), m_normal(normal),
+				m_dist(dist), m_restitution(restitution), m_friction(friction),
+				m_elementIndex1(elementIndex1), m_elementIndex2(elementIndex2), m_bary1(bary1), m_bary2(bary2) {}
+
+			char m_type;
+			unsigned int m_index1;
+			unsigned int m_index2;
+			Vector3r m_cp1;
+			Vector3r m_cp2;
+			Vector3r m_normal;
+			Real m_dist;
+			Real m_restitution;
+			Real m_friction;
+
+			// Test
+			unsigned int m_elementIndex1;
+			unsigned int m_elementIndex2;
+			Vector3r m_bary1;
+			Vector3r m_bary2;
+		};
+
+		/** Callback which gets all contacts of a collision detection step at once. 
+		 * contacts_mt contains the contacts found by each thread.
+		 */
+		typedef void (*ContactBatchCallbackFunction)(const std::vector<std::vector<ContactData> > &contacts_mt, void *userData);
+
 		struct CollisionObject
 		{
 			static const unsigned int RigidBodyCollisionObjectType;		// = 0;
@@ -54,12 +98,26 @@ namespace PBD
 		Real m_tolerance;
 		ContactCallbackFunction m_contactCB;
 		SolidContactCallbackFunction m_solidContactCB;
+		ContactBatchCallbackFunction m_contactBatchCB;
 		void *m_contactCBUserData;
 		void *m_solidContactCBUserData;
+		void *m_contactBatchCBUserData;
 		std::vector<CollisionObject *> m_collisionObjects;
+		int m_broadPhaseMethod;
+		BroadPhase *m_broadPhase;
+		/** AABBs of the collision objects which are passed to the broad phase */
+		std::vector<AABB> m_aabbs;
+		/** Buffer to pass a single contact to the batch callback */
+		std::vector<std::vector<ContactData> > m_singleContact;
 
 		void updateAABB(const Vector3r &p, AABB &aabb);
 		virtual void initParameters();
+		/** Pass a single contact to the batch callback. */
+		void addSingleContact(const char type, const unsigned int index1, const unsigned int index2,
+							  const unsigned int elementIndex2, const Vector3r &bary2,
+							  const Vector3r &cp1, const Vector3r &cp2,
+							  const Vector3r &normal, const Real dist,
+							  const Real restitutionCoeff, const Real frictionCoeff);
 
 	public:
 		CollisionDetection();
@@ -67,7 +125,7 @@ namespace PBD
 
 		void init();
 
-		void cleanup();
+		virtual void cleanup();
 
 		Real getTolerance() const { return m_tolerance; }
 		void setTolerance(Real val) { m_tolerance = val; }
@@ -88,14 +146,37 @@ namespace PBD
 									 const Vector3r &normal, const Real dist,
 									 const Real restitutionCoeff, const Real frictionCoeff);
 
+		/** Pass the contacts found by all threads to the batch callback. If no batch callback 
+		 * is set, the single contact callbacks are called for each contact in order.
+		 * See setContactBatchCallback().
+		 */
+		void addContacts(const std::vector<std::vector<ContactData> > &contacts_mt);
+
 		virtual void addCollisionObject(const unsigned int bodyIndex, const unsigned int bodyType);
 
 		std::vector<CollisionObject *> &getCollisionObjects() { return m_collisionObjects; }
 
 		virtual void collisionDetection(SimulationModel &model) = 0;
 
+		int getBroadPhaseMethod() const { return m_broadPhaseMethod; }
+		void setBroadPhaseMethod(const int val);
+		BroadPhase *getBroadPhase() { return m_broadPhase; }
+		/** Set a user-defined broad phase. The collision detection takes the ownership. */
+		void setBroadPhase(BroadPhase *broadPhase);
+		/** Determine all pairs (i, k) with i < k of collision objects with overlapping AABBs
+		 * using the current broad phase. The AABBs must be up to date.
+		 */
+		void computeOverlappingPairs(BroadPhase::PairVector &pairs);
+
 		void setContactCallback(CollisionDetection::ContactCallbackFunction val, void *userData);
 		void setSolidContactCallback(CollisionDetection::SolidContactCallbackFunction val, void *userData);
+		/** Set the callback which gets the contacts as batch. The batch callback and the single
+		 * contact callbacks are exclusive, i.e. only one of them may be set (this is asserted).
+		 * Pass NULL to remove a callback before the other one is set. If the batch callback is set,
+		 * the contacts of addRigidBodyContact(), addParticleRigidBodyContact() and
+		 * addParticleSolidContact() are passed to it as batch with a single contact.
+		 */
+		void setContactBatchCallback(CollisionDetection::ContactBatchCallbackFunction val, void *userData);
 		void updateAABBs(SimulationModel &model);
 		void updateAABB(SimulationModel &model, CollisionDetection::CollisionObject *co);
 	};
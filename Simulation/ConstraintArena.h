@@ -0,0 +1,150 @@
+#ifndef __CONSTRAINTARENA_H__
+#define __CONSTRAINTARENA_H__
+
+#include "Common/Common.h"
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <typeindex>
+#include <unordered_map>
+
+namespace PBD
+{
+	class Constraint;
+
+	/** Storage for constraints. Each block holds constraints of one type
+	 * contiguously in memory. Single constraints are appended to the open
+	 * block of their type, constraints which are created in bulk get a block
+	 * of their own. The open blocks are identified by the std::type_index of
+	 * the type since a subclass may inherit the TYPE_ID of its base class. Constraints are not freed individually
+	 * but destroyed when the arena is cleared.
+	 */
+	class ConstraintArena
+	{
+	protected:
+		class Block
+		{
+		public:
+			const char *m_begin;
+			const char *m_end;
+
+			virtual ~Block() {}
+			virtual bool full() const = 0;
+			virtual unsigned int capacity() const = 0;
+		};
+
+		template<typename ConstraintType>
+		class TypedBlock : public Block
+		{
+		public:
+			typedef typename std::aligned_storage<sizeof(ConstraintType), alignof(ConstraintType)>::type Storage;
+			Storage *m_data;
+			unsigned int m_size;
+			unsigned int m_capacity;
+
+			TypedBlock(const unsigned int capacity)
+			{
+				m_data = new Storage[capacity];
+				m_size = 0;
+				m_capacity = capacity;
+				m_begin = reinterpret_cast<const char*>(m_data);
+				m_end = reinterpret_cast<const char*>(m_data + capacity);
+			}
+
+			virtual ~TypedBlock()
+			{
+				for (unsigned int i = 0; i < m_size; i++)
+					reinterpret_cast<ConstraintType*>(&m_data[i])->~ConstraintType();
+				delete[] m_data;
+			}
+
+			template<typename... Args>
+			ConstraintType *construct(Args&&... args)
+			{
+				ConstraintType *c = new (&m_data[m_size]) ConstraintType(std::forward<Args>(args)...);
+				m_size++;
+				return c;
+			}
+
+			virtual bool full() const { return m_size == m_capacity; }
+			virtual unsigned int capacity() const { return m_capacity; }
+		};
+
+		/** blocks sorted by their address */
+		std::vector<std::unique_ptr<Block>> m_blocks;
+		/** block of each constraint type which is filled by create() */
+		std::unordered_map<std::type_index, Block*> m_openBlocks;
+		size_t m_numConstraints;
+
+		template<typename ConstraintType>
+		TypedBlock<ConstraintType> *addBlock(const unsigned int capacity)
+		{
+			TypedBlock<ConstraintType> *block = new TypedBlock<ConstraintType>(capacity);
+			std::vector<std::unique_ptr<Block>>::iterator it = std::upper_bound(m_blocks.begin(), m_blocks.end(), block->m_begin,
+				[](const char *p, const std::unique_ptr<Block> &b) { return p < b->m_begin; });
+			m_blocks.insert(it, std::unique_ptr<Block>(block));
+			return block;
+		}
+
+	public:
+		/** Minimal and maximal number of constraints of the blocks used by create() */
+		static const unsigned int MinBlockSize = 16;
+		static const unsigned int MaxBlockSize = 1024;
+
+		ConstraintArena() : m_numConstraints(0) {}
+
+		/** Create a constraint with the given constructor arguments. */
+		template<typename ConstraintType, typename... Args>
+		ConstraintType *create(Args&&... args)
+		{
+			Block *&open = m_openBlocks[std::type_index(typeid(ConstraintType))];
+			if ((open == nullptr) || open->full())
+			{
+				const unsigned int capacity = (open == nullptr) ? MinBlockSize : std::min(2u * open->capacity(), static_cast<unsigned int>(MaxBlockSize));
+				open = addBlock<ConstraintType>(capacity);
+			}
+			m_numConstraints++;
+			return static_cast<TypedBlock<ConstraintType>*>(open)->construct(std::forward<Args>(args)...);
+		}
+
+		/** Create a block of n constraints. Each constraint is constructed with
+		 * the given constructor arguments.
+		 */
+		template<typename ConstraintType, typename... Args>
+		ConstraintType *allocate(const unsigned int n, Args&&... args)
+		{
+			TypedBlock<ConstraintType> *block = addBlock<ConstraintType>(n);
+			for (unsigned int i = 0; i < n; i++)
+				block->construct(args...);
+			m_numConstraints += n;
+			return reinterpret_cast<ConstraintType*>(block->m_data);
+		}
+
+		/** Return true if the constraint is stored in this arena. */
+		bool owns(const Constraint *c) const
+		{
+			const char *p = reinterpret_cast<const char*>(c);
+			std::vector<std::unique_ptr<Block>>::const_iterator it = std::upper_bound(m_blocks.begin(), m_blocks.end(), p,
+				[](const char *p, const std::unique_ptr<Block> &b) { return p < b->m_begin; });
+			if (it == m_blocks.begin())
+				return false;
+			--it;
+			return p < (*it)->m_end;
+		}
+
+		void clear()
+		{
+			m_blocks.clear();
+			m_openBlocks.clear();
+			m_numConstraints = 0;
+		}
+
+		unsigned int numBlocks() const { return static_cast<unsigned int>(m_blocks.size()); }
+		/** Number of constructed constraints (including the ones whose initialization failed) */
+		size_t numConstraints() const { return m_numConstraints; }
+	};
+}
+
+#endif
@@ -41,6 +41,7 @@ int TargetPositionMotorSliderJoint::TYPE_ID = IDFactory::getId();
 int TargetVelocityMotorSliderJoint::TYPE_ID = IDFactory::getId();
 int DamperJoint::TYPE_ID = IDFactory::getId();
 int RigidBodyContactConstraint::TYPE_ID = IDFactory::getId();
+const unsigned int RigidBodyContactConstraint::InvalidFeatureIndex;
 int ParticleRigidBodyContactConstraint::TYPE_ID = IDFactory::getId();
 int ParticleTetContactConstraint::TYPE_ID = IDFactory::getId();
 int StretchShearConstraint::TYPE_ID = IDFactory::getId();
@@ -48,6 +49,20 @@ int BendTwistConstraint::TYPE_ID = IDFactory::getId();
 int StretchBendingTwistingConstraint::TYPE_ID = IDFactory::getId();
 int DirectPositionBasedSolverForStiffRodsConstraint::TYPE_ID = IDFactory::getId();
 
+//////////////////////////////////////////////////////////////////////////
+// Constraint
+//////////////////////////////////////////////////////////////////////////
+void Constraint::applyPositionCorrections(SimulationModel &model, const Vector3r corr[])
+{
+	ParticleData &pd = model.getParticles();
+	for (unsigned int i = 0; i < numberOfBodies(); i++)
+	{
+		const unsigned int particleIndex = m_bodies[i];
+		if (pd.getInvMass(particleIndex) != 0.0)
+			pd.getPosition(particleIndex) += corr[i];
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // BallJoint
 //////////////////////////////////////////////////////////////////////////
@@ -874,7 +889,7 @@ bool DamperJoint::solvePositionConstraint(SimulationModel &model, const unsigned
 	RigidBody &rb1 = *rb[m_bodies[0]];
 	RigidBody &rb2 = *rb[m_bodies[1]];
 
-	const Real dt = TimeManager::getCurrent()->getTimeStepSize();
+	const Real dt = model.getTimeManager()->getTimeStepSize();
 
 	if (iter == 0)
 		m_lambda = 0.0;
@@ -1029,7 +1044,7 @@ bool RigidBodySpring::solvePositionConstraint(SimulationModel &model, const unsi
 	RigidBody &rb1 = *rb[m_bodies[0]];
 	RigidBody &rb2 = *rb[m_bodies[1]];
 
-	const Real dt = TimeManager::getCurrent()->getTimeStepSize();
+	const Real dt = model.getTimeManager()->getTimeStepSize();
 
 	if (iter == 0)
 		m_lambda = 0.0;
@@ -1178,30 +1193,29 @@ bool DistanceConstraint::initConstraint(SimulationModel &model, const unsigned i
 	return true;
 }
 
-bool DistanceConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
+bool DistanceConstraint::computePositionCorrections(SimulationModel &model, const unsigned int iter, Vector3r corr[])
 {
 	ParticleData &pd = model.getParticles();
 
 	const unsigned i1 = m_bodies[0];
 	const unsigned i2 = m_bodies[1];
 
-	Vector3r &x1 = pd.getPosition(i1);
-	Vector3r &x2 = pd.getPosition(i2);
+	const Vector3r &x1 = pd.getPosition(i1);
+	const Vector3r &x2 = pd.getPosition(i2);
 	const Real invMass1 = pd.getInvMass(i1);
 	const Real invMass2 = pd.getInvMass(i2);
 
-	Vector3r corr1, corr2;
-	const bool res = PositionBasedDynamics::solve_DistanceConstraint(
+	return PositionBasedDynamics::solve_DistanceConstraint(
 		x1, invMass1, x2, invMass2,
-		m_restLength, m_stiffness, corr1, corr2);
+		m_restLength, m_stiffness, corr[0], corr[1]);
+}
 
+bool DistanceConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
+{
+	Vector3r corr[2];
+	const bool res = DistanceConstraint::computePositionCorrections(model, iter, corr);
 	if (res)
-	{
-		if (invMass1 != 0.0)
-			x1 += corr1;
-		if (invMass2 != 0.0)
-			x2 += corr2;
-	}
+		applyPositionCorrections(model, corr);
 	return res;
 }
 
@@ -1224,36 +1238,35 @@ bool DistanceConstraint_XPBD::initConstraint(SimulationModel& model, const unsig
 	return true;
 }
 
-bool DistanceConstraint_XPBD::solvePositionConstraint(SimulationModel& model, const unsigned int iter)
+bool DistanceConstraint_XPBD::computePositionCorrections(SimulationModel& model, const unsigned int iter, Vector3r corr[])
 {
 	ParticleData& pd = model.getParticles();
 
 	const unsigned i1 = m_bodies[0];
 	const unsigned i2 = m_bodies[1];
 
-	Vector3r& x1 = pd.getPosition(i1);
-	Vector3r& x2 = pd.getPosition(i2);
+	const Vector3r& x1 = pd.getPosition(i1);
+	const Vector3r& x2 = pd.getPosition(i2);
 	const Real invMass1 = pd.getInvMass(i1);
 	const Real invMass2 = pd.getInvMass(i2);
 
-	const Real dt = TimeManager::getCurrent()->getTimeStepSize();
+	const Real dt = model.getTimeManager()->getTimeStepSize();
 
 	if (iter == 0)
 		m_lambda = 0.0;
 
-	Vector3r corr1, corr2;
-	const bool res = XPBD::solve_DistanceConstraint(
+	return XPBD::solve_DistanceConstraint(
 		x1, invMass1, x2, invMass2,
 		m_restLength, m_stiffness, dt, m_lambda,
-		corr1, corr2);
+		corr[0], corr[1]);
+}
 
+bool DistanceConstraint_XPBD::solvePositionConstraint(SimulationModel& model, const unsigned int iter)
+{
+	Vector3r corr[2];
+	const bool res = DistanceConstraint_XPBD::computePositionCorrections(model, iter, corr);
 	if (res)
-	{
-		if (invMass1 != 0.0)
-			x1 += corr1;
-		if (invMass2 != 0.0)
-			x2 += corr2;
-	}
+		applyPositionCorrections(model, corr);
 	return res;
 }
 
@@ -1298,7 +1311,7 @@ bool DihedralConstraint::initConstraint(SimulationModel &model, const unsigned i
 	return true;
 }
 
-bool DihedralConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
+bool DihedralConstraint::computePositionCorrections(SimulationModel &model, const unsigned int iter, Vector3r corr[])
 {
 	ParticleData &pd = model.getParticles();
 
@@ -1307,34 +1320,29 @@ bool DihedralConstraint::solvePositionConstraint(SimulationModel &model, const u
 	const unsigned i3 = m_bodies[2];
 	const unsigned i4 = m_bodies[3];
 
-	Vector3r &x1 = pd.getPosition(i1);
-	Vector3r &x2 = pd.getPosition(i2);
-	Vector3r &x3 = pd.getPosition(i3);
-	Vector3r &x4 = pd.getPosition(i4);
+	const Vector3r &x1 = pd.getPosition(i1);
+	const Vector3r &x2 = pd.getPosition(i2);
+	const Vector3r &x3 = pd.getPosition(i3);
+	const Vector3r &x4 = pd.getPosition(i4);
 
 	const Real invMass1 = pd.getInvMass(i1);
 	const Real invMass2 = pd.getInvMass(i2);
 	const Real invMass3 = pd.getInvMass(i3);
 	const Real invMass4 = pd.getInvMass(i4);
 
-	Vector3r corr1, corr2, corr3, corr4;
-	const bool res = PositionBasedDynamics::solve_DihedralConstraint(
+	return PositionBasedDynamics::solve_DihedralConstraint(
 		x1, invMass1, x2, invMass2, x3, invMass3, x4, invMass4,
 		m_restAngle,
 		m_stiffness,
-		corr1, corr2, corr3, corr4);
+		corr[0], corr[1], corr[2], corr[3]);
+}
 
+bool DihedralConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
+{
+	Vector3r corr[4];
+	const bool res = DihedralConstraint::computePositionCorrections(model, iter, corr);
 	if (res)
-	{
-		if (invMass1 != 0.0)
-			x1 += corr1;
-		if (invMass2 != 0.0)
-			x2 += corr2;
-		if (invMass3 != 0.0)
-			x3 += corr3;
-		if (invMass4 != 0.0)
-			x4 += corr4;
-	}
+		applyPositionCorrections(model, corr);
 	return res;
 }
 
@@ -1361,7 +1369,7 @@ bool IsometricBendingConstraint::initConstraint(SimulationModel &model, const un
 	return PositionBasedDynamics::init_IsometricBendingConstraint(x1, x2, x3, x4, m_Q);
 }
 
-bool IsometricBendingConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
+bool IsometricBendingConstraint::computePositionCorrections(SimulationModel &model, const unsigned int iter, Vector3r corr[])
 {
 	ParticleData &pd = model.getParticles();
 
@@ -1370,34 +1378,29 @@ bool IsometricBendingConstraint::solvePositionConstraint(SimulationModel &model,
 	const unsigned i3 = m_bodies[2];
 	const unsigned i4 = m_bodies[3];
 
-	Vector3r &x1 = pd.getPosition(i1);
-	Vector3r &x2 = pd.getPosition(i2);
-	Vector3r &x3 = pd.getPosition(i3);
-	Vector3r &x4 = pd.getPosition(i4);
+	const Vector3r &x1 = pd.getPosition(i1);
+	const Vector3r &x2 = pd.getPosition(i2);
+	const Vector3r &x3 = pd.getPosition(i3);
+	const Vector3r &x4 = pd.getPosition(i4);
 
 	const Real invMass1 = pd.getInvMass(i1);
 	const Real invMass2 = pd.getInvMass(i2);
 	const Real invMass3 = pd.getInvMass(i3);
 	const Real invMass4 = pd.getInvMass(i4);
 
-	Vector3r corr1, corr2, corr3, corr4;
-	const bool res = PositionBasedDynamics::solve_IsometricBendingConstraint(
+	return PositionBasedDynamics::solve_IsometricBendingConstraint(
 		x1, invMass1, x2, invMass2, x3, invMass3, x4, invMass4,
 		m_Q,
 		m_stiffness,
-		corr1, corr2, corr3, corr4);
+		corr[0], corr[1], corr[2], corr[3]);
+}
 
+bool IsometricBendingConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
+{
+	Vector3r corr[4];
+	const bool res = IsometricBendingConstraint::computePositionCorrections(model, iter, corr);
 	if (res)
-	{
-		if (invMass1 != 0.0)
-			x1 += corr1;
-		if (invMass2 != 0.0)
-			x2 += corr2;
-		if (invMass3 != 0.0)
-			x3 += corr3;
-		if (invMass4 != 0.0)
-			x4 += corr4;
-	}
+		applyPositionCorrections(model, corr);
 	return res;
 }
 
@@ -1424,7 +1427,7 @@ bool IsometricBendingConstraint_XPBD::initConstraint(SimulationModel& model, con
 	return PositionBasedDynamics::init_IsometricBendingConstraint(x1, x2, x3, x4, m_Q);
 }
 
-bool IsometricBendingConstraint_XPBD::solvePositionConstraint(SimulationModel& model, const unsigned int iter)
+bool IsometricBendingConstraint_XPBD::computePositionCorrections(SimulationModel& model, const unsigned int iter, Vector3r corr[])
 {
 	ParticleData& pd = model.getParticles();
 
@@ -1433,40 +1436,35 @@ bool IsometricBendingConstraint_XPBD::solvePositionConstraint(SimulationModel& m
 	const unsigned i3 = m_bodies[2];
 	const unsigned i4 = m_bodies[3];
 
-	Vector3r& x1 = pd.getPosition(i1);
-	Vector3r& x2 = pd.getPosition(i2);
-	Vector3r& x3 = pd.getPosition(i3);
-	Vector3r& x4 = pd.getPosition(i4);
+	const Vector3r& x1 = pd.getPosition(i1);
+	const Vector3r& x2 = pd.getPosition(i2);
+	const Vector3r& x3 = pd.getPosition(i3);
+	const Vector3r& x4 = pd.getPosition(i4);
 
 	const Real invMass1 = pd.getInvMass(i1);
 	const Real invMass2 = pd.getInvMass(i2);
 	const Real invMass3 = pd.getInvMass(i3);
 	const Real invMass4 = pd.getInvMass(i4);
 
-	const Real dt = TimeManager::getCurrent()->getTimeStepSize();
+	const Real dt = model.getTimeManager()->getTimeStepSize();
 
 	if (iter == 0)
 		m_lambda = 0.0;
 
-	Vector3r corr1, corr2, corr3, corr4;
-	const bool res = XPBD::solve_IsometricBendingConstraint(
+	return XPBD::solve_IsometricBendingConstraint(
 		x1, invMass1, x2, invMass2, x3, invMass3, x4, invMass4,
 		m_Q, 
 		m_stiffness,
 		dt, m_lambda, 
-		corr1, corr2, corr3, corr4);
+		corr[0], corr[1], corr[2], corr[3]);
+}
 
+bool IsometricBendingConstraint_XPBD::solvePositionConstraint(SimulationModel& model, const unsigned int iter)
+{
+	Vector3r corr[4];
+	const bool res = IsometricBendingConstraint_XPBD::computePositionCorrections(model, iter, corr);
 	if (res)
-	{
-		if (invMass1 != 0.0)
-			x1 += corr1;
-		if (invMass2 != 0.0)
-			x2 += corr2;
-		if (invMass3 != 0.0)
-			x3 += corr3;
-		if (invMass4 != 0.0)
-			x4 += corr4;
-	}
+		applyPositionCorrections(model, corr);
 	return res;
 }
 
@@ -1495,7 +1493,7 @@ bool FEMTriangleConstraint::initConstraint(SimulationModel &model, const unsigne
 	return PositionBasedDynamics::init_FEMTriangleConstraint(x1, x2, x3, m_area, m_invRestMat);
 }
 
-bool FEMTriangleConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
+bool FEMTriangleConstraint::computePositionCorrections(SimulationModel &model, const unsigned int iter, Vector3r corr[])
 {
 	ParticleData &pd = model.getParticles();
 
@@ -1503,16 +1501,15 @@ bool FEMTriangleConstraint::solvePositionConstraint(SimulationModel &model, cons
 	const unsigned i2 = m_bodies[1];
 	const unsigned i3 = m_bodies[2];
 
-	Vector3r &x1 = pd.getPosition(i1);
-	Vector3r &x2 = pd.getPosition(i2);
-	Vector3r &x3 = pd.getPosition(i3);
+	const Vector3r &x1 = pd.getPosition(i1);
+	const Vector3r &x2 = pd.getPosition(i2);
+	const Vector3r &x3 = pd.getPosition(i3);
 
 	const Real invMass1 = pd.getInvMass(i1);
 	const Real invMass2 = pd.getInvMass(i2);
 	const Real invMass3 = pd.getInvMass(i3);
 	
-	Vector3r corr1, corr2, corr3;
-	const bool res = PositionBasedDynamics::solve_FEMTriangleConstraint(
+	return PositionBasedDynamics::solve_FEMTriangleConstraint(
 		x1, invMass1,
 		x2, invMass2,
 		x3, invMass3,
@@ -1523,17 +1520,15 @@ bool FEMTriangleConstraint::solvePositionConstraint(SimulationModel &model, cons
 		m_xyStiffness,
 		m_xyPoissonRatio,
 		m_yxPoissonRatio,
-		corr1, corr2, corr3);
+		corr[0], corr[1], corr[2]);
+}
 
+bool FEMTriangleConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
+{
+	Vector3r corr[3];
+	const bool res = FEMTriangleConstraint::computePositionCorrections(model, iter, corr);
 	if (res)
-	{
-		if (invMass1 != 0.0)
-			x1 += corr1;
-		if (invMass2 != 0.0)
-			x2 += corr2;
-		if (invMass3 != 0.0)
-			x3 += corr3;
-	}
+		applyPositionCorrections(model, corr);
 	return res;
 }
 
@@ -1568,7 +1563,7 @@ bool StrainTriangleConstraint::initConstraint(SimulationModel &model, const unsi
 	return PositionBasedDynamics::init_StrainTriangleConstraint(y1, y2, y3, m_invRestMat);
 }
 
-bool StrainTriangleConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
+bool StrainTriangleConstraint::computePositionCorrections(SimulationModel &model, const unsigned int iter, Vector3r corr[])
 {
 	ParticleData &pd = model.getParticles();
 
@@ -1576,16 +1571,15 @@ bool StrainTriangleConstraint::solvePositionConstraint(SimulationModel &model, c
 	const unsigned i2 = m_bodies[1];
 	const unsigned i3 = m_bodies[2];
 
-	Vector3r &x1 = pd.getPosition(i1);
-	Vector3r &x2 = pd.getPosition(i2);
-	Vector3r &x3 = pd.getPosition(i3);
+	const Vector3r &x1 = pd.getPosition(i1);
+	const Vector3r &x2 = pd.getPosition(i2);
+	const Vector3r &x3 = pd.getPosition(i3);
 
 	const Real invMass1 = pd.getInvMass(i1);
 	const Real invMass2 = pd.getInvMass(i2);
 	const Real invMass3 = pd.getInvMass(i3);
 
-	Vector3r corr1, corr2, corr3;
-	const bool res = PositionBasedDynamics::solve_StrainTriangleConstraint(
+	return PositionBasedDynamics::solve_StrainTriangleConstraint(
 		x1, invMass1,
 		x2, invMass2,
 		x3, invMass3,
@@ -1595,17 +1589,15 @@ bool StrainTriangleConstraint::solvePositionConstraint(SimulationModel &model, c
 		m_xyStiffness,
 		m_normalizeStretch,
 		m_normalizeShear,
-		corr1, corr2, corr3);
+		corr[0], corr[1], corr[2]);
+}
 
+bool StrainTriangleConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
+{
+	Vector3r corr[3];
+	const bool res = StrainTriangleConstraint::computePositionCorrections(model, iter, corr);
 	if (res)
-	{
-		if (invMass1 != 0.0)
-			x1 += corr1;
-		if (invMass2 != 0.0)
-			x2 += corr2;
-		if (invMass3 != 0.0)
-			x3 += corr3;
-	}
+		applyPositionCorrections(model, corr);
 	return res;
 }
 
@@ -1634,7 +1626,7 @@ bool VolumeConstraint::initConstraint(SimulationModel &model, const unsigned int
 	return true;
 }
 
-bool VolumeConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
+bool VolumeConstraint::computePositionCorrections(SimulationModel &model, const unsigned int iter, Vector3r corr[])
 {
 	ParticleData &pd = model.getParticles();
 
@@ -1643,36 +1635,31 @@ bool VolumeConstraint::solvePositionConstraint(SimulationModel &model, const uns
 	const unsigned i3 = m_bodies[2];
 	const unsigned i4 = m_bodies[3];
 
-	Vector3r &x1 = pd.getPosition(i1);
-	Vector3r &x2 = pd.getPosition(i2);
-	Vector3r &x3 = pd.getPosition(i3);
-	Vector3r &x4 = pd.getPosition(i4);
+	const Vector3r &x1 = pd.getPosition(i1);
+	const Vector3r &x2 = pd.getPosition(i2);
+	const Vector3r &x3 = pd.getPosition(i3);
+	const Vector3r &x4 = pd.getPosition(i4);
 
 	const Real invMass1 = pd.getInvMass(i1);
 	const Real invMass2 = pd.getInvMass(i2);
 	const Real invMass3 = pd.getInvMass(i3);
 	const Real invMass4 = pd.getInvMass(i4);
 
-	Vector3r corr1, corr2, corr3, corr4;
-	const bool res = PositionBasedDynamics::solve_VolumeConstraint(x1, invMass1,
+	return PositionBasedDynamics::solve_VolumeConstraint(x1, invMass1,
 		x2, invMass2,
 		x3, invMass3,
 		x4, invMass4,
 		m_restVolume,
 		m_stiffness,
-		corr1, corr2, corr3, corr4);
+		corr[0], corr[1], corr[2], corr[3]);
+}
 
+bool VolumeConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
+{
+	Vector3r corr[4];
+	const bool res = VolumeConstraint::computePositionCorrections(model, iter, corr);
 	if (res)
-	{
-		if (invMass1 != 0.0)
-			x1 += corr1;
-		if (invMass2 != 0.0)
-			x2 += corr2;
-		if (invMass3 != 0.0)
-			x3 += corr3;
-		if (invMass4 != 0.0)
-			x4 += corr4;
-	}
+		applyPositionCorrections(model, corr);
 	return res;
 }
 
@@ -1701,7 +1688,7 @@ bool VolumeConstraint_XPBD::initConstraint(SimulationModel& model, const unsigne
 	return true;
 }
 
-bool VolumeConstraint_XPBD::solvePositionConstraint(SimulationModel& model, const unsigned int iter)
+bool VolumeConstraint_XPBD::computePositionCorrections(SimulationModel& model, const unsigned int iter, Vector3r corr[])
 {
 	ParticleData& pd = model.getParticles();
 
@@ -1710,48 +1697,118 @@ bool VolumeConstraint_XPBD::solvePositionConstraint(SimulationModel& model, cons
 	const unsigned i3 = m_bodies[2];
 	const unsigned i4 = m_bodies[3];
 
-	Vector3r& x1 = pd.getPosition(i1);
-	Vector3r& x2 = pd.getPosition(i2);
-	Vector3r& x3 = pd.getPosition(i3);
-	Vector3r& x4 = pd.getPosition(i4);
+	const Vector3r& x1 = pd.getPosition(i1);
+	const Vector3r& x2 = pd.getPosition(i2);
+	const Vector3r& x3 = pd.getPosition(i3);
+	const Vector3r& x4 = pd.getPosition(i4);
 
 	const Real invMass1 = pd.getInvMass(i1);
 	const Real invMass2 = pd.getInvMass(i2);
 	const Real invMass3 = pd.getInvMass(i3);
 	const Real invMass4 = pd.getInvMass(i4);
 
-	const Real dt = TimeManager::getCurrent()->getTimeStepSize();
+	const Real dt = model.getTimeManager()->getTimeStepSize();
 
 	if (iter == 0)
 		m_lambda = 0.0;
 
-	Vector3r corr1, corr2, corr3, corr4;
-	const bool res = XPBD::solve_VolumeConstraint(x1, invMass1,
+	return XPBD::solve_VolumeConstraint(x1, invMass1,
 		x2, invMass2,
 		x3, invMass3,
 		x4, invMass4,
 		m_restVolume,
 		m_stiffness,
 		dt, m_lambda,
-		corr1, corr2, corr3, corr4);
+		corr[0], corr[1], corr[2], corr[3]);
+}
 
+bool VolumeConstraint_XPBD::solvePositionConstraint(SimulationModel& model, const unsigned int iter)
+{
+	Vector3r corr[4];
+	const bool res = VolumeConstraint_XPBD::computePositionCorrections(model, iter, corr);
 	if (res)
-	{
-		if (invMass1 != 0.0)
-			x1 += corr1;
-		if (invMass2 != 0.0)
-			x2 += corr2;
-		if (invMass3 != 0.0)
-			x3 += corr3;
-		if (invMass4 != 0.0)
-			x4 += corr4;
-	}
+		applyPositionCorrections(model, corr);
 	return res;
 }
 
 //////////////////////////////////////////////////////////////////////////
 // FEMTetConstraint
 //////////////////////////////////////////////////////////////////////////
+/** Gather the particles and the rest data of a batch of FEM tet constraints for the batch
+ * solvers. The rest data is loaded from the SoA blocks of SimulationModel::FEMTetBatchData.
+ * Returns false if the constraints are not stored in one block, e.g. if the batches of the
+ * caller differ from the ones of the constraint groups.
+ */
+template<class FEMTetConstraintType>
+static bool gatherFEMTetBatch(SimulationModel &model, const unsigned int *constraintIndices,
+	PositionBasedDynamics::Vector3Batch x[4], PositionBasedDynamics::RealBatch invMass[4],
+	PositionBasedDynamics::Matrix3Batch &invRestMat, PositionBasedDynamics::RealBatch &restVolume,
+	PositionBasedDynamics::RealBatch &stiffness, PositionBasedDynamics::RealBatch &poissonRatio,
+	PositionBasedDynamics::RealBatch &handleInversion)
+{
+	typedef PositionBasedDynamics::RealBatch RealBatch;
+	const int batchSize = PositionBasedDynamics::BatchSize;
+
+	const SimulationModel::FEMTetBatchData &bd = model.getFEMTetBatchData();
+	if (!bd.m_initialized)
+		return false;
+	const unsigned int index = bd.m_restDataIndex[constraintIndices[0]];
+	if ((index == 0xffffffff) || (index % batchSize != 0))
+		return false;
+	for (int j = 1; j < batchSize; j++)
+	{
+		if (bd.m_restDataIndex[constraintIndices[j]] != index + j)
+			return false;
+	}
+	const Real *restData = &bd.m_restData[10 * index];
+	invRestMat = Eigen::Map<const PositionBasedDynamics::Matrix3Batch>(restData);
+	restVolume = Eigen::Map<const RealBatch>(&restData[9 * batchSize]);
+
+	ParticleData &pd = model.getParticles();
+	SimulationModel::ConstraintVector &constraints = model.getConstraints();
+	for (int j = 0; j < batchSize; j++)
+	{
+		const FEMTetConstraintType *c = static_cast<const FEMTetConstraintType*>(constraints[constraintIndices[j]]);
+		for (int k = 0; k < 4; k++)
+		{
+			x[k].row(j) = pd.getPosition(c->m_bodies[k]).transpose();
+			invMass[k][j] = pd.getInvMass(c->m_bodies[k]);
+		}
+		stiffness[j] = c->m_stiffness;
+		poissonRatio[j] = c->m_poissonRatio;
+	}
+
+	// currentVolume = -1/6 (x4 - x1) . ((x3 - x1) x (x2 - x1))
+	const PositionBasedDynamics::Vector3Batch a = x[3] - x[0];
+	const PositionBasedDynamics::Vector3Batch b = x[2] - x[0];
+	const PositionBasedDynamics::Vector3Batch d = x[1] - x[0];
+	const RealBatch currentVolume = -static_cast<Real>(1.0 / 6.0) * (
+		a.col(0) * (b.col(1) * d.col(2) - b.col(2) * d.col(1)) +
+		a.col(1) * (b.col(2) * d.col(0) - b.col(0) * d.col(2)) +
+		a.col(2) * (b.col(0) * d.col(1) - b.col(1) * d.col(0)));
+	const RealBatch volumeRatio = currentVolume / restVolume;
+	for (int j = 0; j < batchSize; j++)
+		handleInversion[j] = (volumeRatio[j] < 0.2) ? static_cast<Real>(1.0) : static_cast<Real>(0.0);		// Only 20% of initial volume left
+	return true;
+}
+
+/** Add the corrections of a batch of FEM tet constraints to the particles. */
+static void applyFEMTetBatchCorrections(SimulationModel &model, const unsigned int *constraintIndices,
+	const PositionBasedDynamics::RealBatch invMass[4], const PositionBasedDynamics::Vector3Batch corr[4])
+{
+	ParticleData &pd = model.getParticles();
+	SimulationModel::ConstraintVector &constraints = model.getConstraints();
+	for (int j = 0; j < PositionBasedDynamics::BatchSize; j++)
+	{
+		const Constraint *c = constraints[constraintIndices[j]];
+		for (int k = 0; k < 4; k++)
+		{
+			if (invMass[k][j] != 0.0)
+				pd.getPosition(c->m_bodies[k]) += corr[k].row(j).transpose().matrix();
+		}
+	}
+}
+
 bool FEMTetConstraint::initConstraint(SimulationModel &model, const unsigned int particle1, const unsigned int particle2,
 									const unsigned int particle3, const unsigned int particle4, 
 									const Real stiffness, const Real poissonRatio)
@@ -1773,7 +1830,7 @@ bool FEMTetConstraint::initConstraint(SimulationModel &model, const unsigned int
 	return PositionBasedDynamics::init_FEMTetraConstraint(x1, x2, x3, x4, m_volume, m_invRestMat);
 }
 
-bool FEMTetConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
+bool FEMTetConstraint::computePositionCorrections(SimulationModel &model, const unsigned int iter, Vector3r corr[])
 {
 	ParticleData &pd = model.getParticles();
 
@@ -1782,10 +1839,10 @@ bool FEMTetConstraint::solvePositionConstraint(SimulationModel &model, const uns
 	const unsigned i3 = m_bodies[2];
 	const unsigned i4 = m_bodies[3];
 
-	Vector3r &x1 = pd.getPosition(i1);
-	Vector3r &x2 = pd.getPosition(i2);
-	Vector3r &x3 = pd.getPosition(i3);
-	Vector3r &x4 = pd.getPosition(i4);
+	const Vector3r &x1 = pd.getPosition(i1);
+	const Vector3r &x2 = pd.getPosition(i2);
+	const Vector3r &x3 = pd.getPosition(i3);
+	const Vector3r &x4 = pd.getPosition(i4);
 
 	const Real invMass1 = pd.getInvMass(i1);
 	const Real invMass2 = pd.getInvMass(i2);
@@ -1798,8 +1855,7 @@ bool FEMTetConstraint::solvePositionConstraint(SimulationModel &model, const uns
 		handleInversion = true;
 
 
-	Vector3r corr1, corr2, corr3, corr4;
-	const bool res = PositionBasedDynamics::solve_FEMTetraConstraint(
+	return PositionBasedDynamics::solve_FEMTetraConstraint(
 		x1, invMass1,
 		x2, invMass2,
 		x3, invMass3,
@@ -1808,20 +1864,57 @@ bool FEMTetConstraint::solvePositionConstraint(SimulationModel &model, const uns
 		m_invRestMat,
 		m_stiffness,
 		m_poissonRatio, handleInversion,
-		corr1, corr2, corr3, corr4);
+		corr[0], corr[1], corr[2], corr[3]);
+}
 
+bool FEMTetConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
+{
+	Vector3r corr[4];
+	const bool res = FEMTetConstraint::computePositionCorrections(model, iter, corr);
 	if (res)
+		applyPositionCorrections(model, corr);
+	return res;
+}
+
+void FEMTetConstraint::solvePositionConstraints(SimulationModel &model, const unsigned int *constraintIndices, const int numConstraints, const unsigned int iter)
+{
+	const int batchSize = PositionBasedDynamics::BatchSize;
+	const int numBatches = numConstraints / batchSize;
+
+	SimulationModel::ConstraintVector &constraints = model.getConstraints();
+
+	#pragma omp for schedule(static) 
+	for (int b = 0; b < numBatches; b++)
 	{
-		if (invMass1 != 0.0)
-			x1 += corr1;
-		if (invMass2 != 0.0)
-			x2 += corr2;
-		if (invMass3 != 0.0)
-			x3 += corr3;
-		if (invMass4 != 0.0)
-			x4 += corr4;
+		const unsigned int *batchConstraints = &constraintIndices[b * batchSize];
+		PositionBasedDynamics::Vector3Batch x[4], corr[4];
+		PositionBasedDynamics::Matrix3Batch invRestMat;
+		PositionBasedDynamics::RealBatch invMass[4], restVolume, stiffness, poissonRatio, handleInversion;
+		if (gatherFEMTetBatch<FEMTetConstraint>(model, batchConstraints, x, invMass, invRestMat, restVolume, stiffness, poissonRatio, handleInversion))
+		{
+			PositionBasedDynamics::solve_FEMTetraConstraintBatch(
+				x[0], invMass[0],
+				x[1], invMass[1],
+				x[2], invMass[2],
+				x[3], invMass[3],
+				restVolume,
+				invRestMat,
+				stiffness,
+				poissonRatio, handleInversion,
+				corr[0], corr[1], corr[2], corr[3]);
+			applyFEMTetBatchCorrections(model, batchConstraints, invMass, corr);
+		}
+		else
+		{
+			for (int j = 0; j < batchSize; j++)
+				constraints[batchConstraints[j]]->solvePositionConstraint(model, iter);
+		}
 	}
-	return res;
+
+	// remaining constraints which do not fill a batch
+	#pragma omp for schedule(static) 
+	for (int i = numBatches * batchSize; i < numConstraints; i++)
+		constraints[constraintIndices[i]]->solvePositionConstraint(model, iter);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -1848,7 +1941,7 @@ bool XPBD_FEMTetConstraint::initConstraint(SimulationModel &model, const unsigne
 	return PositionBasedDynamics::init_FEMTetraConstraint(x1, x2, x3, x4, m_volume, m_invRestMat);
 }
 
-bool XPBD_FEMTetConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
+bool XPBD_FEMTetConstraint::computePositionCorrections(SimulationModel &model, const unsigned int iter, Vector3r corr[])
 {
 	ParticleData &pd = model.getParticles();
 
@@ -1857,10 +1950,10 @@ bool XPBD_FEMTetConstraint::solvePositionConstraint(SimulationModel &model, cons
 	const unsigned i3 = m_bodies[2];
 	const unsigned i4 = m_bodies[3];
 
-	Vector3r &x1 = pd.getPosition(i1);
-	Vector3r &x2 = pd.getPosition(i2);
-	Vector3r &x3 = pd.getPosition(i3);
-	Vector3r &x4 = pd.getPosition(i4);
+	const Vector3r &x1 = pd.getPosition(i1);
+	const Vector3r &x2 = pd.getPosition(i2);
+	const Vector3r &x3 = pd.getPosition(i3);
+	const Vector3r &x4 = pd.getPosition(i4);
 
 	const Real invMass1 = pd.getInvMass(i1);
 	const Real invMass2 = pd.getInvMass(i2);
@@ -1872,13 +1965,12 @@ bool XPBD_FEMTetConstraint::solvePositionConstraint(SimulationModel &model, cons
 	if (currentVolume / m_volume < 0.2)		// Only 20% of initial volume left
 		handleInversion = true;
 
-	const Real dt = TimeManager::getCurrent()->getTimeStepSize();
+	const Real dt = model.getTimeManager()->getTimeStepSize();
 
 	if (iter == 0)
 		m_lambda = 0.0;
 
-	Vector3r corr1, corr2, corr3, corr4;
-	const bool res = XPBD::solve_FEMTetraConstraint(
+	return XPBD::solve_FEMTetraConstraint(
 		x1, invMass1,
 		x2, invMass2,
 		x3, invMass3,
@@ -1889,20 +1981,68 @@ bool XPBD_FEMTetConstraint::solvePositionConstraint(SimulationModel &model, cons
 		m_poissonRatio, handleInversion,
 		dt,
 		m_lambda,
-		corr1, corr2, corr3, corr4);
+		corr[0], corr[1], corr[2], corr[3]);
+}
 
+bool XPBD_FEMTetConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
+{
+	Vector3r corr[4];
+	const bool res = XPBD_FEMTetConstraint::computePositionCorrections(model, iter, corr);
 	if (res)
+		applyPositionCorrections(model, corr);
+	return res;
+}
+
+void XPBD_FEMTetConstraint::solvePositionConstraints(SimulationModel &model, const unsigned int *constraintIndices, const int numConstraints, const unsigned int iter)
+{
+	const int batchSize = PositionBasedDynamics::BatchSize;
+	const int numBatches = numConstraints / batchSize;
+
+	SimulationModel::ConstraintVector &constraints = model.getConstraints();
+	const Real dt = model.getTimeManager()->getTimeStepSize();
+
+	#pragma omp for schedule(static) 
+	for (int b = 0; b < numBatches; b++)
 	{
-		if (invMass1 != 0.0)
-			x1 += corr1;
-		if (invMass2 != 0.0)
-			x2 += corr2;
-		if (invMass3 != 0.0)
-			x3 += corr3;
-		if (invMass4 != 0.0)
-			x4 += corr4;
+		const unsigned int *batchConstraints = &constraintIndices[b * batchSize];
+		PositionBasedDynamics::Vector3Batch x[4], corr[4];
+		PositionBasedDynamics::Matrix3Batch invRestMat;
+		PositionBasedDynamics::RealBatch invMass[4], restVolume, stiffness, poissonRatio, handleInversion, lambda;
+		if (gatherFEMTetBatch<XPBD_FEMTetConstraint>(model, batchConstraints, x, invMass, invRestMat, restVolume, stiffness, poissonRatio, handleInversion))
+		{
+			for (int j = 0; j < batchSize; j++)
+			{
+				XPBD_FEMTetConstraint *c = static_cast<XPBD_FEMTetConstraint*>(constraints[batchConstraints[j]]);
+				if (iter == 0)
+					c->m_lambda = 0.0;
+				lambda[j] = c->m_lambda;
+			}
+
+			XPBD::solve_FEMTetraConstraintBatch(
+				x[0], invMass[0],
+				x[1], invMass[1],
+				x[2], invMass[2],
+				x[3], invMass[3],
+				restVolume,
+				invRestMat,
+				stiffness,
+				poissonRatio, handleInversion,
+				dt,
+				lambda,
+				corr[0], corr[1], corr[2], corr[3]);
+			applyFEMTetBatchCorrections(model, batchConstraints, invMass, corr);
+		}
+		else
+		{
+			for (int j = 0; j < batchSize; j++)
+				constraints[batchConstraints[j]]->solvePositionConstraint(model, iter);
+		}
 	}
-	return res;
+
+	// remaining constraints which do not fill a batch
+	#pragma omp for schedule(static) 
+	for (int i = numBatches * batchSize; i < numConstraints; i++)
+		constraints[constraintIndices[i]]->solvePositionConstraint(model, iter);
 }
 
 
@@ -1933,7 +2073,7 @@ bool StrainTetConstraint::initConstraint(SimulationModel &model, const unsigned
 	return PositionBasedDynamics::init_StrainTetraConstraint(x1, x2, x3, x4, m_invRestMat);
 }
 
-bool StrainTetConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
+bool StrainTetConstraint::computePositionCorrections(SimulationModel &model, const unsigned int iter, Vector3r corr[])
 {
 	ParticleData &pd = model.getParticles();
 
@@ -1942,18 +2082,17 @@ bool StrainTetConstraint::solvePositionConstraint(SimulationModel &model, const
 	const unsigned i3 = m_bodies[2];
 	const unsigned i4 = m_bodies[3];
 
-	Vector3r &x1 = pd.getPosition(i1);
-	Vector3r &x2 = pd.getPosition(i2);
-	Vector3r &x3 = pd.getPosition(i3);
-	Vector3r &x4 = pd.getPosition(i4);
+	const Vector3r &x1 = pd.getPosition(i1);
+	const Vector3r &x2 = pd.getPosition(i2);
+	const Vector3r &x3 = pd.getPosition(i3);
+	const Vector3r &x4 = pd.getPosition(i4);
 
 	const Real invMass1 = pd.getInvMass(i1);
 	const Real invMass2 = pd.getInvMass(i2);
 	const Real invMass3 = pd.getInvMass(i3);
 	const Real invMass4 = pd.getInvMass(i4);
 
-	Vector3r corr1, corr2, corr3, corr4;
-	const bool res = PositionBasedDynamics::solve_StrainTetraConstraint(
+	return PositionBasedDynamics::solve_StrainTetraConstraint(
 		x1, invMass1,
 		x2, invMass2,
 		x3, invMass3,
@@ -1963,19 +2102,15 @@ bool StrainTetConstraint::solvePositionConstraint(SimulationModel &model, const
 		m_shearStiffness * Vector3r::Ones(),
 		m_normalizeStretch,
 		m_normalizeShear,
-		corr1, corr2, corr3, corr4);
+		corr[0], corr[1], corr[2], corr[3]);
+}
 
+bool StrainTetConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
+{
+	Vector3r corr[4];
+	const bool res = StrainTetConstraint::computePositionCorrections(model, iter, corr);
 	if (res)
-	{
-		if (invMass1 != 0.0)
-			x1 += corr1;
-		if (invMass2 != 0.0)
-			x2 += corr2;
-		if (invMass3 != 0.0)
-			x3 += corr3;
-		if (invMass4 != 0.0)
-			x4 += corr4;
-	}
+		applyPositionCorrections(model, corr);
 	return res;
 }
 
@@ -2034,18 +2169,20 @@ bool ShapeMatchingConstraint::solvePositionConstraint(SimulationModel &model, co
 bool RigidBodyContactConstraint::initConstraint(SimulationModel &model, const unsigned int rbIndex1, const unsigned int rbIndex2,
 		const Vector3r &cp1, const Vector3r &cp2,
 		const Vector3r &normal, const Real dist,
-		const Real restitutionCoeff, const Real stiffness, const Real frictionCoeff)
+		const Real restitutionCoeff, const Real stiffness, const Real frictionCoeff,
+		const unsigned int featureIndex)
 {
 	m_stiffness = stiffness;
 	m_frictionCoeff = frictionCoeff;
 
 	m_bodies[0] = rbIndex1;
 	m_bodies[1] = rbIndex2;
+	m_featureIndex = featureIndex;
 	SimulationModel::RigidBodyVector &rb = model.getRigidBodies();
 	RigidBody &rb1 = *rb[m_bodies[0]];
 	RigidBody &rb2 = *rb[m_bodies[1]];
 
-	m_sum_impulses = 0.0;
+	m_sum_impulses = model.getWarmStartImpulse(rbIndex1, rbIndex2, featureIndex);
 
 	return PositionBasedRigidBodyDynamics::init_RigidBodyContactConstraint(
 		rb1.getInvMass(),
@@ -2064,6 +2201,51 @@ bool RigidBodyContactConstraint::initConstraint(SimulationModel &model, const un
 		m_constraintInfo);
 }
 
+bool RigidBodyContactConstraint::warmStart(SimulationModel &model)
+{
+	if (m_sum_impulses == 0.0)
+		return false;
+
+	SimulationModel::RigidBodyVector &rb = model.getRigidBodies();
+
+	RigidBody &rb1 = *rb[m_bodies[0]];
+	RigidBody &rb2 = *rb[m_bodies[1]];
+
+	Vector3r corr_v1, corr_v2;
+	Vector3r corr_omega1, corr_omega2;
+	const bool res = PositionBasedRigidBodyDynamics::velocityWarmStart_RigidBodyContactConstraint(
+		rb1.getInvMass(),
+		rb1.getPosition(),
+		rb1.getInertiaTensorInverseW(),
+		rb2.getInvMass(),
+		rb2.getPosition(),
+		rb2.getInertiaTensorInverseW(),
+		m_frictionCoeff,
+		m_sum_impulses,
+		m_constraintInfo,
+		corr_v1,
+		corr_omega1,
+		corr_v2,
+		corr_omega2);
+
+	if (res)
+	{
+		if (rb1.getMass() != 0.0)
+		{
+			rb1.getVelocity() += corr_v1;
+			rb1.getAngularVelocity() += corr_omega1;
+		}
+		if (rb2.getMass() != 0.0)
+		{
+			rb2.getVelocity() += corr_v2;
+			rb2.getAngularVelocity() += corr_omega2;
+		}
+	}
+	else
+		m_sum_impulses = 0.0;
+	return res;
+}
+
 bool RigidBodyContactConstraint::solveVelocityConstraint(SimulationModel &model, const unsigned int iter)
 {
 	SimulationModel::RigidBodyVector &rb = model.getRigidBodies();
@@ -2388,6 +2570,62 @@ bool StretchShearConstraint::solvePositionConstraint(SimulationModel &model, con
 	return res;
 }
 
+void StretchShearConstraint::solvePositionConstraints(SimulationModel &model, const unsigned int *constraintIndices, const int numConstraints, const unsigned int iter)
+{
+	typedef PositionBasedCosseratRods Rods;
+	const int batchSize = Rods::BatchSize;
+	const int numBatches = numConstraints / batchSize;
+
+	ParticleData &pd = model.getParticles();
+	OrientationData &od = model.getOrientations();
+	SimulationModel::ConstraintVector &constraints = model.getConstraints();
+
+	#pragma omp for schedule(static) 
+	for (int b = 0; b < numBatches; b++)
+	{
+		Rods::Vector3Batch x1, x2, stiffness;
+		Rods::QuaternionBatch q1;
+		Rods::RealBatch invMass1, invMass2, invMassq1, restLength;
+		for (int j = 0; j < batchSize; j++)
+		{
+			const StretchShearConstraint *c = static_cast<const StretchShearConstraint*>(constraints[constraintIndices[b * batchSize + j]]);
+			x1.row(j) = pd.getPosition(c->m_bodies[0]).transpose();
+			x2.row(j) = pd.getPosition(c->m_bodies[1]).transpose();
+			q1.row(j) = od.getQuaternion(c->m_bodies[2]).coeffs().transpose();
+			invMass1[j] = pd.getInvMass(c->m_bodies[0]);
+			invMass2[j] = pd.getInvMass(c->m_bodies[1]);
+			invMassq1[j] = od.getInvMass(c->m_bodies[2]);
+			stiffness.row(j) << c->m_shearingStiffness1, c->m_shearingStiffness2, c->m_stretchingStiffness;
+			restLength[j] = c->m_restLength;
+		}
+
+		Rods::Vector3Batch corr1, corr2;
+		Rods::QuaternionBatch corrq1;
+		Rods::solve_StretchShearConstraintBatch(x1, invMass1, x2, invMass2, q1, invMassq1,
+			stiffness, restLength, corr1, corr2, corrq1);
+
+		for (int j = 0; j < batchSize; j++)
+		{
+			const StretchShearConstraint *c = static_cast<const StretchShearConstraint*>(constraints[constraintIndices[b * batchSize + j]]);
+			if (invMass1[j] != 0.0)
+				pd.getPosition(c->m_bodies[0]) += corr1.row(j).transpose().matrix();
+			if (invMass2[j] != 0.0)
+				pd.getPosition(c->m_bodies[1]) += corr2.row(j).transpose().matrix();
+			if (invMassq1[j] != 0.0)
+			{
+				Quaternionr &q = od.getQuaternion(c->m_bodies[2]);
+				q.coeffs() += corrq1.row(j).transpose().matrix();
+				q.normalize();
+			}
+		}
+	}
+
+	// remaining constraints which do not fill a batch
+	#pragma omp for schedule(static) 
+	for (int i = numBatches * batchSize; i < numConstraints; i++)
+		constraints[constraintIndices[i]]->solvePositionConstraint(model, iter);
+}
+
 //////////////////////////////////////////////////////////////////////////
 // BendTwistConstraint
 //////////////////////////////////////////////////////////////////////////
@@ -2497,7 +2735,7 @@ bool StretchBendingTwistingConstraint::initConstraintBeforeProjection(Simulation
 {
 	DirectPositionBasedSolverForStiffRods::initBeforeProjection_StretchBendingTwistingConstraint(
 		m_stiffnessCoefficientK,
-		static_cast<Real>(1.0) / TimeManager::getCurrent()->getTimeStepSize(),
+		static_cast<Real>(1.0) / model.getTimeManager()->getTimeStepSize(),
 		m_averageSegmentLength,
 		m_stretchCompliance,
 		m_bendingAndTorsionCompliance,
@@ -2573,38 +2811,15 @@ bool StretchBendingTwistingConstraint::solvePositionConstraint(SimulationModel &
 
 PBD::DirectPositionBasedSolverForStiffRodsConstraint::~DirectPositionBasedSolverForStiffRodsConstraint()
 {
-	deleteNodes();
 	if (intervals != NULL)
 		delete[] intervals;
-	if (forward != NULL)
-		delete[] forward;
-	if (backward != NULL)
-		delete[] backward;
-	if (root != NULL)
-		delete[] root;
-	root = NULL;
-	forward = NULL;
-	backward = NULL;
+	if (trees != NULL)
+		delete[] trees;
+	trees = NULL;
 	intervals = NULL;
 	numberOfIntervals = 0;
 }
 
-void DirectPositionBasedSolverForStiffRodsConstraint::deleteNodes()
-{
-	std::list<Node*>::iterator nodeIter;
-	for (int i = 0; i < numberOfIntervals; i++)
-	{
-		for (nodeIter = forward[i].begin(); nodeIter != forward[i].end(); nodeIter++)
-		{
-			Node *node = *nodeIter;
-
-			// Root node does not have to be deleted
-			if (node->parent != NULL)
-				delete node;
-		}
-	}
-}
-
 bool PBD::DirectPositionBasedSolverForStiffRodsConstraint::initConstraint(
 	SimulationModel &model, 
 	const std::vector<std::pair<unsigned int, unsigned int>> & constraintSegmentIndices, 
@@ -2669,9 +2884,8 @@ bool PBD::DirectPositionBasedSolverForStiffRodsConstraint::initConstraint(
 	}
 
 	// initialize data of the sparse direct solver
-	deleteNodes();
 	DirectPositionBasedSolverForStiffRods::init_DirectPositionBasedSolverForStiffRodsConstraint(
-		m_rodConstraints, m_rodSegments, intervals, numberOfIntervals, forward, backward, root,
+		m_rodConstraints, m_rodSegments, intervals, numberOfIntervals, trees,
 		constraintPositions, averageRadii, youngsModuli, torsionModuli,
 		m_rightHandSide, m_lambdaSums, m_bendingAndTorsionJacobians, m_corr_x, m_corr_q);
 
@@ -2681,7 +2895,7 @@ bool PBD::DirectPositionBasedSolverForStiffRodsConstraint::initConstraint(
 bool PBD::DirectPositionBasedSolverForStiffRodsConstraint::initConstraintBeforeProjection(SimulationModel &model)
 {
 	DirectPositionBasedSolverForStiffRods::initBeforeProjection_DirectPositionBasedSolverForStiffRodsConstraint(
-		m_rodConstraints, static_cast<Real>(1.0) / TimeManager::getCurrent()->getTimeStepSize(), m_lambdaSums);
+		m_rodConstraints, static_cast<Real>(1.0) / model.getTimeManager()->getTimeStepSize(), m_lambdaSums);
 	return true;
 }
 
@@ -2697,7 +2911,7 @@ bool PBD::DirectPositionBasedSolverForStiffRodsConstraint::updateConstraint(Simu
 bool PBD::DirectPositionBasedSolverForStiffRodsConstraint::solvePositionConstraint(SimulationModel &model, const unsigned int iter)
 {
 	const bool res = DirectPositionBasedSolverForStiffRods::solve_DirectPositionBasedSolverForStiffRodsConstraint(
-		m_rodConstraints, m_rodSegments, intervals, numberOfIntervals, forward, backward,
+		m_rodConstraints, m_rodSegments, intervals, numberOfIntervals, trees,
 		m_rightHandSide, m_lambdaSums, m_bendingAndTorsionJacobians, m_corr_x, m_corr_q
 		);
 	
@@ -17,6 +17,11 @@ namespace PBD
 	class Constraint
 	{
 	public: 
+		/** Solver for a run of independent constraints of one type, see getBatchSolver().
+		* It is called by all threads of a parallel region and distributes the work by
+		* orphaned omp for loops. */
+		typedef void(*BatchSolver)(SimulationModel &model, const unsigned int *constraintIndices, const int numConstraints, const unsigned int iter);
+
 		/** indices of the linked bodies */
 		std::vector<unsigned int> m_bodies;
 
@@ -33,6 +38,19 @@ namespace PBD
 		virtual bool updateConstraint(SimulationModel &model) { return true; };
 		virtual bool solvePositionConstraint(SimulationModel &model, const unsigned int iter) { return true; };
 		virtual bool solveVelocityConstraint(SimulationModel &model, const unsigned int iter) { return true; };
+		/** Return a function which solves the position constraints of this type in batches
+		* or nullptr if the constraints are solved one by one. */
+		virtual BatchSolver getBatchSolver() const { return nullptr; }
+
+		/** Return true if the constraint only acts on particles and can compute its position 
+		* corrections without applying them (see computePositionCorrections()). Such constraints 
+		* can be solved by the Jacobi solver. */
+		virtual bool hasPositionCorrections() const { return false; }
+		/** Compute the position corrections of the linked particles (one per body) for the
+		* current positions without changing them. Return false if no corrections were computed. */
+		virtual bool computePositionCorrections(SimulationModel &model, const unsigned int iter, Vector3r corr[]) { return false; }
+		/** Add the position corrections to the linked particles with non-zero inverse mass. */
+		void applyPositionCorrections(SimulationModel &model, const Vector3r corr[]);
 	};
 
 	class BallJoint : public Constraint
@@ -264,6 +282,8 @@ namespace PBD
 
 		virtual bool initConstraint(SimulationModel &model, const unsigned int particle1, const unsigned int particle2, const Real stiffness);
 		virtual bool solvePositionConstraint(SimulationModel &model, const unsigned int iter);
+		virtual bool hasPositionCorrections() const { return true; }
+		virtual bool computePositionCorrections(SimulationModel &model, const unsigned int iter, Vector3r corr[]);
 	};
 
 	class DistanceConstraint_XPBD : public Constraint
@@ -279,6 +299,8 @@ namespace PBD
 
 		virtual bool initConstraint(SimulationModel& model, const unsigned int particle1, const unsigned int particle2, const Real stiffness);
 		virtual bool solvePositionConstraint(SimulationModel& model, const unsigned int iter);
+		virtual bool hasPositionCorrections() const { return true; }
+		virtual bool computePositionCorrections(SimulationModel& model, const unsigned int iter, Vector3r corr[]);
 	};
 
 	class DihedralConstraint : public Constraint
@@ -294,6 +316,8 @@ namespace PBD
 		virtual bool initConstraint(SimulationModel &model, const unsigned int particle1, const unsigned int particle2,
 									const unsigned int particle3, const unsigned int particle4, const Real stiffness);
 		virtual bool solvePositionConstraint(SimulationModel &model, const unsigned int iter);
+		virtual bool hasPositionCorrections() const { return true; }
+		virtual bool computePositionCorrections(SimulationModel &model, const unsigned int iter, Vector3r corr[]);
 	};
 	
 	class IsometricBendingConstraint : public Constraint
@@ -309,6 +333,8 @@ namespace PBD
 		virtual bool initConstraint(SimulationModel &model, const unsigned int particle1, const unsigned int particle2,
 									const unsigned int particle3, const unsigned int particle4, const Real stiffness);
 		virtual bool solvePositionConstraint(SimulationModel &model, const unsigned int iter);
+		virtual bool hasPositionCorrections() const { return true; }
+		virtual bool computePositionCorrections(SimulationModel &model, const unsigned int iter, Vector3r corr[]);
 	};
 
 	class IsometricBendingConstraint_XPBD : public Constraint
@@ -325,6 +351,8 @@ namespace PBD
 		virtual bool initConstraint(SimulationModel& model, const unsigned int particle1, const unsigned int particle2,
 					const unsigned int particle3, const unsigned int particle4, const Real stiffness);
 		virtual bool solvePositionConstraint(SimulationModel& model, const unsigned int iter);
+		virtual bool hasPositionCorrections() const { return true; }
+		virtual bool computePositionCorrections(SimulationModel& model, const unsigned int iter, Vector3r corr[]);
 	};
 
 	class FEMTriangleConstraint : public Constraint
@@ -346,6 +374,8 @@ namespace PBD
 			const unsigned int particle3, const Real xxStiffness, const Real yyStiffness, const Real xyStiffness, 
 			const Real xyPoissonRatio, const Real yxPoissonRatio);
 		virtual bool solvePositionConstraint(SimulationModel &model, const unsigned int iter);
+		virtual bool hasPositionCorrections() const { return true; }
+		virtual bool computePositionCorrections(SimulationModel &model, const unsigned int iter, Vector3r corr[]);
 	};
 
 	class StrainTriangleConstraint : public Constraint
@@ -366,6 +396,8 @@ namespace PBD
 			const unsigned int particle3, const Real xxStiffness, const Real yyStiffness, const Real xyStiffness, 
 			const bool normalizeStretch, const bool normalizeShear);
 		virtual bool solvePositionConstraint(SimulationModel &model, const unsigned int iter);
+		virtual bool hasPositionCorrections() const { return true; }
+		virtual bool computePositionCorrections(SimulationModel &model, const unsigned int iter, Vector3r corr[]);
 	};
 
 	class VolumeConstraint : public Constraint
@@ -381,6 +413,8 @@ namespace PBD
 		virtual bool initConstraint(SimulationModel &model, const unsigned int particle1, const unsigned int particle2,
 								const unsigned int particle3, const unsigned int particle4, const Real stiffness);
 		virtual bool solvePositionConstraint(SimulationModel &model, const unsigned int iter);
+		virtual bool hasPositionCorrections() const { return true; }
+		virtual bool computePositionCorrections(SimulationModel &model, const unsigned int iter, Vector3r corr[]);
 	};
 
 	class VolumeConstraint_XPBD : public Constraint
@@ -397,6 +431,8 @@ namespace PBD
 		virtual bool initConstraint(SimulationModel& model, const unsigned int particle1, const unsigned int particle2,
 			const unsigned int particle3, const unsigned int particle4, const Real stiffness);
 		virtual bool solvePositionConstraint(SimulationModel& model, const unsigned int iter);
+		virtual bool hasPositionCorrections() const { return true; }
+		virtual bool computePositionCorrections(SimulationModel& model, const unsigned int iter, Vector3r corr[]);
 	};
 
 	class FEMTetConstraint : public Constraint
@@ -415,6 +451,16 @@ namespace PBD
 									const unsigned int particle3, const unsigned int particle4, 
 									const Real stiffness, const Real poissonRatio);
 		virtual bool solvePositionConstraint(SimulationModel &model, const unsigned int iter);
+		virtual bool hasPositionCorrections() const { return true; }
+		virtual bool computePositionCorrections(SimulationModel &model, const unsigned int iter, Vector3r corr[]);
+
+		/** Solve the FEM tet constraints with the given indices in batches of
+		* PositionBasedDynamics::BatchSize constraints. The constraints must be independent
+		* (e.g. constraints of the same constraint group). The rest data is read from
+		* SimulationModel::FEMTetBatchData.
+		*/
+		static void solvePositionConstraints(SimulationModel &model, const unsigned int *constraintIndices, const int numConstraints, const unsigned int iter);
+		virtual BatchSolver getBatchSolver() const { return &solvePositionConstraints; }
 	};
 
 	class XPBD_FEMTetConstraint : public Constraint
@@ -434,6 +480,12 @@ namespace PBD
 									const unsigned int particle3, const unsigned int particle4, 
 									const Real stiffness, const Real poissonRatio);
 		virtual bool solvePositionConstraint(SimulationModel& model, const unsigned int iter);
+		virtual bool hasPositionCorrections() const { return true; }
+		virtual bool computePositionCorrections(SimulationModel& model, const unsigned int iter, Vector3r corr[]);
+
+		/** Batch solver of the XPBD FEM tet constraints, see FEMTetConstraint::solvePositionConstraints() */
+		static void solvePositionConstraints(SimulationModel &model, const unsigned int *constraintIndices, const int numConstraints, const unsigned int iter);
+		virtual BatchSolver getBatchSolver() const { return &solvePositionConstraints; }
 	};
 
 	class StrainTetConstraint : public Constraint
@@ -454,6 +506,8 @@ namespace PBD
 			const Real stretchStiffness, const Real shearStiffness, 
 			const bool normalizeStretch, const bool normalizeShear);
 		virtual bool solvePositionConstraint(SimulationModel &model, const unsigned int iter);
+		virtual bool hasPositionCorrections() const { return true; }
+		virtual bool computePositionCorrections(SimulationModel &model, const unsigned int iter, Vector3r corr[]);
 	};
 
 	class ShapeMatchingConstraint : public Constraint
@@ -494,21 +548,31 @@ namespace PBD
 	{
 	public:
 		static int TYPE_ID;
+		static const unsigned int InvalidFeatureIndex = 0xffffffffu;
 		/** indices of the linked bodies */
 		std::array<unsigned int, 2> m_bodies;
 		Real m_stiffness; 
 		Real m_frictionCoeff;
 		Real m_sum_impulses;
+		/** index of the vertex of the first body which identifies the contact in the next step */
+		unsigned int m_featureIndex;
 		Eigen::Matrix<Real, 3, 5, Eigen::DontAlign> m_constraintInfo;
 
 		RigidBodyContactConstraint() {}
 		~RigidBodyContactConstraint() {}
 		virtual int &getTypeId() const { return TYPE_ID; }
 
+		/** Initialize the contact. If warm starting is enabled in the model, the accumulated 
+		 * impulse of the contact with the same bodies and feature in the last step is 
+		 * stored in m_sum_impulses. 
+		 */
 		bool initConstraint(SimulationModel &model, const unsigned int rbIndex1, const unsigned int rbIndex2, 
 			const Vector3r &cp1, const Vector3r &cp2, 
 			const Vector3r &normal, const Real dist, 
-			const Real restitutionCoeff, const Real stiffness, const Real frictionCoeff);
+			const Real restitutionCoeff, const Real stiffness, const Real frictionCoeff,
+			const unsigned int featureIndex = InvalidFeatureIndex);
+		/** Apply the impulse m_sum_impulses of the initialization. */
+		bool warmStart(SimulationModel &model);
 		virtual bool solveVelocityConstraint(SimulationModel &model, const unsigned int iter);
 	};
 
@@ -579,6 +643,14 @@ namespace PBD
 			const unsigned int quaternion1, const Real stretchingStiffness, 
 			const Real shearingStiffness1, const Real shearingStiffness2);
 		virtual bool solvePositionConstraint(SimulationModel &model, const unsigned int iter);
+
+		/** Solve the stretch shear constraints with the given indices in batches of
+		* PositionBasedCosseratRods::BatchSize constraints. The constraints must be independent
+		* (e.g. constraints of the same constraint group). The corrections are always applied
+		* since solve_StretchShearConstraint() cannot fail.
+		*/
+		static void solvePositionConstraints(SimulationModel &model, const unsigned int *constraintIndices, const int numConstraints, const unsigned int iter);
+		virtual BatchSolver getBatchSolver() const { return &solvePositionConstraints; }
 	};
 
 	class BendTwistConstraint : public Constraint
@@ -626,8 +698,8 @@ namespace PBD
 		virtual bool solvePositionConstraint(SimulationModel &model, const unsigned int iter);
 	};
 
-	struct Node;
 	struct Interval;
+	struct RodTree;
 	class SimulationModel;
 	using Vector6r = Eigen::Matrix<Real, 6, 1, Eigen::DontAlign>;
 
@@ -680,7 +752,7 @@ namespace PBD
 		static int TYPE_ID;
 
 		DirectPositionBasedSolverForStiffRodsConstraint() :  Constraint(2),
-			root(NULL), numberOfIntervals(0), intervals(NULL), forward(NULL), backward(NULL){}
+			intervals(NULL), numberOfIntervals(0), trees(NULL){}
 		~DirectPositionBasedSolverForStiffRodsConstraint();
 
 		virtual int &getTypeId() const { return TYPE_ID; }
@@ -699,16 +771,12 @@ namespace PBD
 
 	protected:
 		
-		/** root node */
-		Node *root;
 		/** intervals of constraints */
 		Interval *intervals;
 		/** number of intervals */
 		int numberOfIntervals;		
-		/** list to process nodes with increasing row index in the system matrix H (from the leaves to the root) */
-		std::list <Node*> *forward;
-		/** list to process nodes starting with the highest row index to row index zero in the matrix H (from the root to the leaves) */
-		std::list <Node*> *backward;
+		/** tree of nodes of each interval in the order of increasing row index in the system matrix H (from the leaves to the root) */
+		RodTree *trees;
 
 		std::vector<RodConstraintImpl> m_Constraints;
 		std::vector<RodConstraint*> m_rodConstraints;
@@ -721,8 +789,6 @@ namespace PBD
 		std::vector<std::vector<Matrix3r>> m_bendingAndTorsionJacobians;
 		std::vector<Vector3r> m_corr_x;
 		std::vector<Quaternionr> m_corr_q;
-
-		void deleteNodes();
 	};
 }
 
@@ -1,5 +1,6 @@
 #include "CubicSDFCollisionDetection.h"
 #include "Simulation/IDFactory.h"
+#include "Utils/Logger.h"
 #include "Eigen/Dense"
 
 using namespace PBD;
@@ -15,20 +16,57 @@ CubicSDFCollisionDetection::~CubicSDFCollisionDetection()
 {
 }
 
+void CubicSDFCollisionDetection::cleanup()
+{
+	DistanceFieldCollisionDetection::cleanup();
+	m_floatSDFs.clear();
+	m_floatSDFFiles.clear();
+}
+
+FloatCubicSDFPtr CubicSDFCollisionDetection::getFloatSDF(GridPtr sdf)
+{
+	FloatCubicSDFPtr &floatSDF = m_floatSDFs[sdf];
+	if (!floatSDF)
+	{
+		floatSDF = std::make_shared<FloatCubicSDF>();
+		floatSDF->init(*sdf);
+	}
+	return floatSDF;
+}
+
+FloatCubicSDFPtr CubicSDFCollisionDetection::getFloatSDF(const std::string &sdfFile)
+{
+	FloatCubicSDFPtr &floatSDF = m_floatSDFFiles[sdfFile];
+	if (!floatSDF)
+	{
+		floatSDF = std::make_shared<FloatCubicSDF>();
+		if (!floatSDF->load(sdfFile))
+			LOG_ERR << "Cannot load SDF file: " << sdfFile;
+	}
+	return floatSDF;
+}
+
 bool CubicSDFCollisionDetection::isDistanceFieldCollisionObject(CollisionObject *co) const
 {
  	return DistanceFieldCollisionDetection::isDistanceFieldCollisionObject(co) ||
 		(co->getTypeId() == CubicSDFCollisionDetection::CubicSDFCollisionObject::TYPE_ID);
 }
 
-void CubicSDFCollisionDetection::addCubicSDFCollisionObject(const unsigned int bodyIndex, const unsigned int bodyType, const Vector3r *vertices, const unsigned int numVertices, const std::string &sdfFile, const Vector3r &scale, const bool testMesh, const bool invertSDF)
+void CubicSDFCollisionDetection::addCubicSDFCollisionObject(const unsigned int bodyIndex, const unsigned int bodyType, const Vector3r *vertices, const unsigned int numVertices, const std::string &sdfFile, const Vector3r &scale, const bool testMesh, const bool invertSDF, const bool useFloatSDF)
 {
 	CubicSDFCollisionDetection::CubicSDFCollisionObject *co = new CubicSDFCollisionDetection::CubicSDFCollisionObject();
 	co->m_bodyIndex = bodyIndex;
 	co->m_bodyType = bodyType;
 	co->m_sdfFile = sdfFile;
 	co->m_scale = scale;
-	co->m_sdf = std::make_shared<Grid>(co->m_sdfFile);
+	if (FloatCubicSDF::isFloatCubicSDFFile(co->m_sdfFile))
+		co->m_floatSDF = getFloatSDF(co->m_sdfFile);
+	else
+	{
+		co->m_sdf = std::make_shared<Grid>(co->m_sdfFile);
+		if (useFloatSDF)
+			co->m_floatSDF = getFloatSDF(co->m_sdf);
+	}
  	co->m_bvh.init(vertices, numVertices);
  	co->m_bvh.construct();
 	co->m_testMesh = testMesh;
@@ -38,7 +76,7 @@ void CubicSDFCollisionDetection::addCubicSDFCollisionObject(const unsigned int b
 	m_collisionObjects.push_back(co);
 }
 
-void PBD::CubicSDFCollisionDetection::addCubicSDFCollisionObject(const unsigned int bodyIndex, const unsigned int bodyType, const Vector3r *vertices, const unsigned int numVertices, GridPtr sdf, const Vector3r &scale, const bool testMesh /*= true*/, const bool invertSDF /*= false*/)
+void PBD::CubicSDFCollisionDetection::addCubicSDFCollisionObject(const unsigned int bodyIndex, const unsigned int bodyType, const Vector3r *vertices, const unsigned int numVertices, GridPtr sdf, const Vector3r &scale, const bool testMesh /*= true*/, const bool invertSDF /*= false*/, const bool useFloatSDF /*= false*/)
 {
 	CubicSDFCollisionDetection::CubicSDFCollisionObject *co = new CubicSDFCollisionDetection::CubicSDFCollisionObject();
 	co->m_bodyIndex = bodyIndex;
@@ -46,6 +84,25 @@ void PBD::CubicSDFCollisionDetection::addCubicSDFCollisionObject(const unsigned
 	co->m_sdfFile = "";
 	co->m_scale = scale;
 	co->m_sdf = sdf;
+	if (useFloatSDF)
+		co->m_floatSDF = getFloatSDF(co->m_sdf);
+	co->m_bvh.init(vertices, numVertices);
+	co->m_bvh.construct();
+	co->m_testMesh = testMesh;
+	co->m_invertSDF = 1.0;
+	if (invertSDF)
+		co->m_invertSDF = -1.0;
+	m_collisionObjects.push_back(co);
+}
+
+void CubicSDFCollisionDetection::addCubicSDFCollisionObject(const unsigned int bodyIndex, const unsigned int bodyType, const Vector3r *vertices, const unsigned int numVertices, FloatCubicSDFPtr sdf, const Vector3r &scale, const bool testMesh, const bool invertSDF)
+{
+	CubicSDFCollisionDetection::CubicSDFCollisionObject *co = new CubicSDFCollisionDetection::CubicSDFCollisionObject();
+	co->m_bodyIndex = bodyIndex;
+	co->m_bodyType = bodyType;
+	co->m_sdfFile = "";
+	co->m_scale = scale;
+	co->m_floatSDF = sdf;
 	co->m_bvh.init(vertices, numVertices);
 	co->m_bvh.construct();
 	co->m_testMesh = testMesh;
@@ -66,6 +123,18 @@ CubicSDFCollisionDetection::CubicSDFCollisionObject::~CubicSDFCollisionObject()
 double CubicSDFCollisionDetection::CubicSDFCollisionObject::distance(const Eigen::Vector3d &x, const Real tolerance)
 {
 	const Eigen::Vector3d scaled_x = x.cwiseProduct(m_scale.template cast<double>().cwiseInverse());
+	if (!m_sdf)
+	{
+		if (!m_floatSDF || !m_floatSDF->isInitialized())
+			return std::numeric_limits<double>::max();
+		const float d = m_floatSDF->interpolate(scaled_x.template cast<float>());
+		if (d == FLT_MAX)
+			return std::numeric_limits<double>::max();
+		// inside of the surface but outside of the narrow band: the distance is at least the band width
+		if (d == -FLT_MAX)
+			return (m_invertSDF > 0.0) ? -m_scale[0] * m_floatSDF->getBandWidth() - tolerance : std::numeric_limits<double>::max();
+		return m_invertSDF * m_scale[0] * d - tolerance;
+	}
 	const double dist = m_sdf->interpolate(0, scaled_x);
 	if (dist == std::numeric_limits<double>::max())
 		return dist;
@@ -74,6 +143,12 @@ double CubicSDFCollisionDetection::CubicSDFCollisionObject::distance(const Eigen
 
 bool CubicSDFCollisionDetection::CubicSDFCollisionObject::collisionTest(const Vector3r &x, const Real tolerance, Vector3r &cp, Vector3r &n, Real &dist, const Real maxDist)
 {
+	if (!m_sdf)
+	{
+		unsigned int index;
+		return collisionTestBatch(1, &x, tolerance, &index, &cp, &n, &dist, maxDist) == 1;
+	}
+
 	const Vector3r scaled_x = x.cwiseProduct(m_scale.cwiseInverse());
 
 	Eigen::Vector3d normal;	
@@ -96,3 +171,66 @@ bool CubicSDFCollisionDetection::CubicSDFCollisionObject::collisionTest(const Ve
 	return false;
 }
 
+
+unsigned int CubicSDFCollisionDetection::CubicSDFCollisionObject::collisionTestBatch(const unsigned int numPoints, const Vector3r *x, const Real tolerance,
+	unsigned int *contactIndices, Vector3r *cp, Vector3r *n, Real *dist, const Real maxDist)
+{
+	if (!m_floatSDF || !m_floatSDF->isInitialized())
+	{
+		if (!m_sdf)
+			return 0;
+		return DistanceFieldCollisionObject::collisionTestBatch(numPoints, x, tolerance, contactIndices, cp, n, dist, maxDist);
+	}
+
+	Eigen::Vector3f scaled_x[MaxBatchSize];
+	float d[MaxBatchSize];
+	Eigen::Vector3f normal[MaxBatchSize];
+	const Vector3r invScale = m_scale.cwiseInverse();
+	for (unsigned int i = 0; i < numPoints; i++)
+		scaled_x[i] = x[i].cwiseProduct(invScale).template cast<float>();
+
+	m_floatSDF->interpolate(numPoints, scaled_x, d, normal);
+
+	unsigned int numContacts = 0;
+	for (unsigned int i = 0; i < numPoints; i++)
+	{
+		// no data or outside of the narrow band (outside of the surface)
+		if (d[i] == FLT_MAX)
+			continue;
+		// Inside of the surface but outside of the narrow band. The point has penetrated deeply.
+		// The distance and the normal are determined by the double precision grid if there is one.
+		// Otherwise, a contact is generated with the band width as conservative distance and
+		// the normal points away from the center of the inside cells of the field.
+		const bool deepInside = (d[i] == -FLT_MAX);
+		if (deepInside)
+		{
+			if (m_invertSDF < 0.0)
+				continue;
+			Eigen::Vector3d gradient;
+			const double gridDist = m_sdf ? m_sdf->interpolate(0, scaled_x[i].template cast<double>(), &gradient) : std::numeric_limits<double>::max();
+			if (gridDist != std::numeric_limits<double>::max())
+			{
+				d[i] = static_cast<float>(gridDist);
+				normal[i] = gradient.template cast<float>();
+			}
+			else
+			{
+				d[i] = -m_floatSDF->getBandWidth();
+				normal[i] = scaled_x[i] - m_floatSDF->getInsideCenter();
+			}
+			if (normal[i].squaredNorm() < FLT_MIN)
+				normal[i] = Eigen::Vector3f(0.0f, 1.0f, 0.0f);
+		}
+		const Real di = static_cast<Real>(m_invertSDF * d[i] - tolerance);
+		if (di < maxDist)
+		{
+			const Vector3r ni = (m_invertSDF * normal[i].template cast<Real>()).normalized();
+			contactIndices[numContacts] = i;
+			dist[numContacts] = di;
+			n[numContacts] = ni;
+			cp[numContacts] = (scaled_x[i].template cast<Real>() - di * ni).cwiseProduct(m_scale);
+			numContacts++;
+		}
+	}
+	return numContacts;
+}
\ No newline at end of file
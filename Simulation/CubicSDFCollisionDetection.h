@@ -3,7 +3,9 @@
 
 #include "Common/Common.h"
 #include "Simulation/DistanceFieldCollisionDetection.h"
+#include "Simulation/FloatCubicSDF.h"
 #include <memory>
+#include <map>
 
 #include "Discregrid/All"
 
@@ -21,24 +23,56 @@ namespace PBD
 		{
 			std::string m_sdfFile;
 			Vector3r m_scale;
+			/** Discregrid field (may be null if only m_floatSDF is used) */
 			GridPtr m_sdf;
+			/** Single precision copy of m_sdf which is used for batch queries if it was
+			 * requested (useFloatSDF) or the only field if a sparse field was loaded from a file.
+			 */
+			FloatCubicSDFPtr m_floatSDF;
 			static int TYPE_ID;
 
 			CubicSDFCollisionObject();
 			virtual ~CubicSDFCollisionObject();
 			virtual int &getTypeId() const { return TYPE_ID; }
 			virtual bool collisionTest(const Vector3r &x, const Real tolerance, Vector3r &cp, Vector3r &n, Real &dist, const Real maxDist = 0.0);
+			virtual unsigned int collisionTestBatch(const unsigned int numPoints, const Vector3r *x, const Real tolerance,
+				unsigned int *contactIndices, Vector3r *cp, Vector3r *n, Real *dist, const Real maxDist = 0.0);
 			virtual double distance(const Eigen::Vector3d &x, const Real tolerance);
 		};
 
+	protected:
+		/** Single precision copies of the grids. Rigid bodies which share a grid also share its copy. */
+		std::map<GridPtr, FloatCubicSDFPtr> m_floatSDFs;
+		/** Memory mapped fields which were loaded by their file name */
+		std::map<std::string, FloatCubicSDFPtr> m_floatSDFFiles;
+
+		FloatCubicSDFPtr getFloatSDF(GridPtr sdf);
+		FloatCubicSDFPtr getFloatSDF(const std::string &sdfFile);
+
 	public:
 		CubicSDFCollisionDetection();
 		virtual ~CubicSDFCollisionDetection();
 
+		virtual void cleanup();
+
 		virtual bool isDistanceFieldCollisionObject(CollisionObject *co) const;
 
-		void addCubicSDFCollisionObject(const unsigned int bodyIndex, const unsigned int bodyType, const Vector3r *vertices, const unsigned int numVertices, const std::string &sdfFile, const Vector3r &scale, const bool testMesh = true, const bool invertSDF = false);
-		void addCubicSDFCollisionObject(const unsigned int bodyIndex, const unsigned int bodyType, const Vector3r *vertices, const unsigned int numVertices, GridPtr sdf, const Vector3r &scale, const bool testMesh = true, const bool invertSDF = false);
+		/** Add a collision object with the SDF in the given file. The file is either a Discregrid grid 
+		 * or a (sparse) field in the format of FloatCubicSDF::save() which is memory mapped. 
+		 * If useFloatSDF is set, a single precision copy of a Discregrid grid is used for the
+		 * batch queries. Otherwise the grid is queried in double precision.
+		 */
+		void addCubicSDFCollisionObject(const unsigned int bodyIndex, const unsigned int bodyType, const Vector3r *vertices, const unsigned int numVertices, const std::string &sdfFile, const Vector3r &scale, const bool testMesh = true, const bool invertSDF = false, const bool useFloatSDF = false);
+		/** Add a collision object with the given grid. If useFloatSDF is set, a single precision copy
+		 * of the grid is used for the batch queries. The copy is shared by all objects with this grid.
+		 */
+		void addCubicSDFCollisionObject(const unsigned int bodyIndex, const unsigned int bodyType, const Vector3r *vertices, const unsigned int numVertices, GridPtr sdf, const Vector3r &scale, const bool testMesh = true, const bool invertSDF = false, const bool useFloatSDF = false);
+		/** Add a collision object which only uses a single precision (sparse) field. Points which are
+		 * inside of the surface but outside of the narrow band of the field generate contacts with the
+		 * negative band width as distance and a normal which points away from the center of the inside
+		 * cells of the field (see FloatCubicSDF::getInsideCenter()).
+		 */
+		void addCubicSDFCollisionObject(const unsigned int bodyIndex, const unsigned int bodyType, const Vector3r *vertices, const unsigned int numVertices, FloatCubicSDFPtr sdf, const Vector3r &scale, const bool testMesh = true, const bool invertSDF = false);
 	};
 }
 
@@ -1,6 +1,7 @@
 #include "DistanceFieldCollisionDetection.h"
 #include "Simulation/IDFactory.h"
 #include "omp.h"
+#include <algorithm>
 
 using namespace PBD;
 using namespace Utilities;
@@ -26,38 +27,45 @@ DistanceFieldCollisionDetection::~DistanceFieldCollisionDetection()
 void DistanceFieldCollisionDetection::collisionDetection(SimulationModel &model)
 {
 	model.resetContacts();
-	const SimulationModel::RigidBodyVector &rigidBodies = model.getRigidBodies();
 	const SimulationModel::TriangleModelVector &triModels = model.getTriangleModels();
 	const SimulationModel::TetModelVector &tetModels = model.getTetModels();
 	const ParticleData &pd = model.getParticles();
 
-	std::vector < std::pair<unsigned int, unsigned int>> coPairs;
-	for (unsigned int i = 0; i < m_collisionObjects.size(); i++)
-	{
-		CollisionDetection::CollisionObject *co1 = m_collisionObjects[i];
-		for (unsigned int k = 0; k < m_collisionObjects.size(); k++)
-		{
-			CollisionDetection::CollisionObject *co2 = m_collisionObjects[k];
-			if ((i != k))
-			{
-				// ToDo: self collisions for deformables
-				coPairs.push_back({ i, k });
-			}
-		}
-	}
-
 	//omp_set_num_threads(1);
-	std::vector<std::vector<ContactData> > contacts_mt;	
+	// the contact buffers of the threads keep their memory from the last step
+	std::vector<std::vector<ContactData> > &contacts_mt = m_contacts_mt;
 #ifdef _DEBUG
 	const unsigned int maxThreads = 1;
 #else
 	const unsigned int maxThreads = omp_get_max_threads();
 #endif
 	contacts_mt.resize(maxThreads);
+	for (unsigned int i = 0; i < maxThreads; i++)
+		contacts_mt[i].clear();
+
+	// The BVHs of the deformable models are refitted in the loop over the collision objects.
+	// Only if there are fewer deformable models than threads, the BVHs of the large ones are
+	// refitted afterwards, each with the level-parallel refit, so that a single large cloth
+	// does not serialize the update.
+	unsigned int numDeformables = 0;
+	for (unsigned int i = 0; i < m_collisionObjects.size(); i++)
+	{
+		CollisionDetection::CollisionObject *co = m_collisionObjects[i];
+		if (isDistanceFieldCollisionObject(co) &&
+			((co->m_bodyType == CollisionDetection::CollisionObject::TriangleModelCollisionObjectType) ||
+			(co->m_bodyType == CollisionDetection::CollisionObject::TetModelCollisionObjectType)))
+			numDeformables++;
+	}
+	const bool refitLargeBVHsSeparately = numDeformables < maxThreads;
+	// a BVH is large if its leaves give each thread more than MIN_PARALLEL_SIZE nodes to refit
+	auto isLargeBVH = [maxThreads](const KDTree<BoundingSphere> &bvh)
+	{
+		return bvh.numNodes() / 2 > MIN_PARALLEL_SIZE * maxThreads;
+	};
 
 	#pragma omp parallel default(shared)
 	{
-		// Update BVHs
+		// Update AABBs and the vertex arrays of the BVHs and refit the BVHs
 		#pragma omp for schedule(static)  
 		for (int i = 0; i < (int)m_collisionObjects.size(); i++)
 		{
@@ -73,8 +81,12 @@ void DistanceFieldCollisionDetection::collisionDetection(SimulationModel &model)
 					const unsigned int offset = tm->getIndexOffset();
 					const IndexedFaceMesh& mesh = tm->getParticleMesh();
 					const unsigned int numVert = mesh.numVertices();
-					sco->m_bvh.init(&pd.getPosition(offset), numVert);
-					sco->m_bvh.update();
+					if (sco->m_bvh.numVertices() == numVert)
+						sco->m_bvh.updateVertices(&pd.getPosition(offset));
+					else
+						sco->m_bvh.init(&pd.getPosition(offset), numVert);
+					if (!(refitLargeBVHsSeparately && isLargeBVH(sco->m_bvh)))
+						sco->m_bvh.update();
 				}
 				else if (co->m_bodyType == CollisionDetection::CollisionObject::TetModelCollisionObjectType)
 				{
@@ -84,116 +96,182 @@ void DistanceFieldCollisionDetection::collisionDetection(SimulationModel &model)
 					const unsigned int numVert = mesh.numVertices();
 
 					DistanceFieldCollisionObject *sco = (DistanceFieldCollisionObject*)co;
-					sco->m_bvh.init(&pd.getPosition(offset), numVert);
+					if (sco->m_bvh.numVertices() == numVert)
+						sco->m_bvh.updateVertices(&pd.getPosition(offset));
+					else
+						sco->m_bvh.init(&pd.getPosition(offset), numVert);
 					sco->m_bvhTets.updateVertices(&pd.getPosition(offset));
 					sco->m_bvhTets0.updateVertices(&pd.getPosition(offset));
-
-					sco->m_bvh.update();
-					sco->m_bvhTets.update();
+					if (!(refitLargeBVHsSeparately && isLargeBVH(sco->m_bvh)))
+						sco->m_bvh.update();
+					if (!(refitLargeBVHsSeparately && isLargeBVH(sco->m_bvhTets)))
+						sco->m_bvhTets.update();
 				}
 			}
 		}
+	}
 
-		#pragma omp for schedule(static)
-		for (int i = 0; i < (int)coPairs.size(); i++)
+	// Refit the large BVHs which were skipped above. The refit of a single BVH is parallelized.
+	if (refitLargeBVHsSeparately)
+	{
+		for (unsigned int i = 0; i < m_collisionObjects.size(); i++)
 		{
-			std::pair<unsigned int, unsigned int> &coPair = coPairs[i];
-			CollisionDetection::CollisionObject *co1 = m_collisionObjects[coPair.first];
-			CollisionDetection::CollisionObject *co2 = m_collisionObjects[coPair.second];
-
-			if (((co2->m_bodyType != CollisionDetection::CollisionObject::RigidBodyCollisionObjectType) &&
-				(co2->m_bodyType != CollisionDetection::CollisionObject::TetModelCollisionObjectType)) ||
-				!isDistanceFieldCollisionObject(co1) ||
-				!isDistanceFieldCollisionObject(co2) ||
-				!AABB::intersection(co1->m_aabb, co2->m_aabb))
-				continue;
-
-
-			if ((co1->m_bodyType == CollisionDetection::CollisionObject::RigidBodyCollisionObjectType) &&
-				(co2->m_bodyType == CollisionDetection::CollisionObject::RigidBodyCollisionObjectType) &&
-				((DistanceFieldCollisionObject*) co1)->m_testMesh)
-			{
-				RigidBody *rb1 = rigidBodies[co1->m_bodyIndex];				
-				RigidBody *rb2 = rigidBodies[co2->m_bodyIndex];
-				const Real restitutionCoeff = rb1->getRestitutionCoeff() * rb2->getRestitutionCoeff();
-				const Real frictionCoeff = rb1->getFrictionCoeff() + rb2->getFrictionCoeff();
-				collisionDetectionRigidBodies(rb1, (DistanceFieldCollisionObject*)co1, rb2, (DistanceFieldCollisionObject*)co2,
-					restitutionCoeff, frictionCoeff
-					, contacts_mt
-					);
-			}
-			else if ((co1->m_bodyType == CollisionDetection::CollisionObject::TriangleModelCollisionObjectType) &&
-					(co2->m_bodyType == CollisionDetection::CollisionObject::RigidBodyCollisionObjectType) &&
-					((DistanceFieldCollisionObject*)co1)->m_testMesh)
-			{
-				TriangleModel *tm = triModels[co1->m_bodyIndex];
-				RigidBody *rb2 = rigidBodies[co2->m_bodyIndex];
-				const unsigned int offset = tm->getIndexOffset();
-				const IndexedFaceMesh &mesh = tm->getParticleMesh();
-				const unsigned int numVert = mesh.numVertices();
-				const Real restitutionCoeff = tm->getRestitutionCoeff() * rb2->getRestitutionCoeff();
-				const Real frictionCoeff = tm->getFrictionCoeff() + rb2->getFrictionCoeff();
-				collisionDetectionRBSolid(pd, offset, numVert, (DistanceFieldCollisionObject*)co1, rb2, (DistanceFieldCollisionObject*)co2,
-					restitutionCoeff, frictionCoeff
-					, contacts_mt
-					);
-			}
-			else if ((co1->m_bodyType == CollisionDetection::CollisionObject::TetModelCollisionObjectType) && 
-					(co2->m_bodyType == CollisionDetection::CollisionObject::RigidBodyCollisionObjectType) &&
-					((DistanceFieldCollisionObject*)co1)->m_testMesh)
+			CollisionDetection::CollisionObject *co = m_collisionObjects[i];
+			if (isDistanceFieldCollisionObject(co))
 			{
-				TetModel *tm = tetModels[co1->m_bodyIndex];
-				RigidBody *rb2 = rigidBodies[co2->m_bodyIndex];
-				const unsigned int offset = tm->getIndexOffset();
-				const IndexedTetMesh &mesh = tm->getParticleMesh();
-				const unsigned int numVert = mesh.numVertices();
-				const Real restitutionCoeff = tm->getRestitutionCoeff() * rb2->getRestitutionCoeff();
-				const Real frictionCoeff = tm->getFrictionCoeff() + rb2->getFrictionCoeff();
-				collisionDetectionRBSolid(pd, offset, numVert, (DistanceFieldCollisionObject*)co1, rb2, (DistanceFieldCollisionObject*)co2,
-					restitutionCoeff, frictionCoeff
-					, contacts_mt
-					);
+				DistanceFieldCollisionObject *sco = (DistanceFieldCollisionObject*)co;
+				if ((co->m_bodyType == CollisionDetection::CollisionObject::TriangleModelCollisionObjectType) ||
+					(co->m_bodyType == CollisionDetection::CollisionObject::TetModelCollisionObjectType))
+				{
+					if (isLargeBVH(sco->m_bvh))
+						sco->m_bvh.update();
+				}
+				if ((co->m_bodyType == CollisionDetection::CollisionObject::TetModelCollisionObjectType) &&
+					isLargeBVH(sco->m_bvhTets))
+					sco->m_bvhTets.update();
 			}
- 			else if ((co1->m_bodyType == CollisionDetection::CollisionObject::TetModelCollisionObjectType) &&
- 				(co2->m_bodyType == CollisionDetection::CollisionObject::TetModelCollisionObjectType) &&
- 				((DistanceFieldCollisionObject*)co1)->m_testMesh)
- 			{
- 				TetModel *tm1 = tetModels[co1->m_bodyIndex];
- 				TetModel *tm2 = tetModels[co2->m_bodyIndex];
- 				const unsigned int offset = tm1->getIndexOffset();
- 				const IndexedTetMesh &mesh = tm1->getParticleMesh();
- 				const unsigned int numVert = mesh.numVertices();
- 				const Real restitutionCoeff = tm1->getRestitutionCoeff() * tm2->getRestitutionCoeff();
- 				const Real frictionCoeff = tm1->getFrictionCoeff() + tm2->getFrictionCoeff();
- 				collisionDetectionSolidSolid(pd, offset, numVert, (DistanceFieldCollisionObject*)co1, tm2, (DistanceFieldCollisionObject*)co2,
- 					restitutionCoeff, frictionCoeff
- 					, contacts_mt
- 				);
- 			}
 		}
 	}
 
-	for (unsigned int i = 0; i < contacts_mt.size(); i++)
+	// Broad phase: determine the pairs of collision objects with overlapping AABBs.
+	// Each pair is tested in both directions since the narrow phase tests the 
+	// vertices of the first object against the distance field of the second one.
+	// ToDo: self collisions for deformables
+	computeOverlappingPairs(m_overlappingPairs);
+	std::vector<std::pair<unsigned int, unsigned int>> &coPairs = m_coPairs;
+	coPairs.clear();
+	coPairs.reserve(2 * m_overlappingPairs.size());
+	for (size_t i = 0; i < m_overlappingPairs.size(); i++)
+	{
+		coPairs.push_back(m_overlappingPairs[i]);
+		coPairs.push_back({ m_overlappingPairs[i].second, m_overlappingPairs[i].first });
+	}
+	// keep the order of the exhaustive pair loop for deterministic results
+	std::sort(coPairs.begin(), coPairs.end());
+
+	// Consecutive rigid-rigid pairs with the same first body are tested as one packet, 
+	// so the BVH of the first body is traversed only once for all of them.
+	std::vector<std::pair<unsigned int, unsigned int>> &pairGroups = m_pairGroups;
+	pairGroups.clear();
+	for (unsigned int i = 0; i < (unsigned int)coPairs.size(); )
 	{
-		for (unsigned int j = 0; j < contacts_mt[i].size(); j++)
+		unsigned int end = i + 1;
+		if (isRigidBodyPacketPair(coPairs[i]))
 		{
-			if (contacts_mt[i][j].m_type == 1)
-				addParticleRigidBodyContact(contacts_mt[i][j].m_index1, contacts_mt[i][j].m_index2,
-					contacts_mt[i][j].m_cp1, contacts_mt[i][j].m_cp2, contacts_mt[i][j].m_normal,
-					contacts_mt[i][j].m_dist, contacts_mt[i][j].m_restitution, contacts_mt[i][j].m_friction);
-			else if (contacts_mt[i][j].m_type == 0)
-				addRigidBodyContact(contacts_mt[i][j].m_index1, contacts_mt[i][j].m_index2,
-					contacts_mt[i][j].m_cp1, contacts_mt[i][j].m_cp2, contacts_mt[i][j].m_normal,
-					contacts_mt[i][j].m_dist, contacts_mt[i][j].m_restitution, contacts_mt[i][j].m_friction);
-			else if (contacts_mt[i][j].m_type == 2)
-			{
-				addParticleSolidContact(contacts_mt[i][j].m_index1, contacts_mt[i][j].m_index2,
-					contacts_mt[i][j].m_elementIndex2, contacts_mt[i][j].m_bary2,
-					contacts_mt[i][j].m_cp1, contacts_mt[i][j].m_cp2, contacts_mt[i][j].m_normal,					
-					contacts_mt[i][j].m_dist, contacts_mt[i][j].m_restitution, contacts_mt[i][j].m_friction);
-			}
+			while ((end < coPairs.size()) && (end - i < 32) && 
+				(coPairs[end].first == coPairs[i].first) && isRigidBodyPacketPair(coPairs[end]))
+				end++;
 		}
+		pairGroups.push_back({ i, end });
+		i = end;
+	}
+
+	#pragma omp parallel default(shared)
+	{
+		#pragma omp for schedule(static)
+		for (int i = 0; i < (int)pairGroups.size(); i++)
+		{
+			const unsigned int begin = pairGroups[i].first;
+			const unsigned int numPairs = pairGroups[i].second - begin;
+			if (numPairs > 1)
+				collisionDetectionRigidBodies(model, &coPairs[begin], numPairs, contacts_mt);
+			else
+				collisionDetectionPair(model, coPairs[begin].first, coPairs[begin].second, contacts_mt);
+		}
+	}
+
+	addContacts(contacts_mt);
+}
+bool DistanceFieldCollisionDetection::isRigidBodyPacketPair(const std::pair<unsigned int, unsigned int> &coPair)
+{
+	CollisionDetection::CollisionObject *co1 = m_collisionObjects[coPair.first];
+	CollisionDetection::CollisionObject *co2 = m_collisionObjects[coPair.second];
+	return (co1->m_bodyType == CollisionDetection::CollisionObject::RigidBodyCollisionObjectType) &&
+		(co2->m_bodyType == CollisionDetection::CollisionObject::RigidBodyCollisionObjectType) &&
+		isDistanceFieldCollisionObject(co1) &&
+		isDistanceFieldCollisionObject(co2) &&
+		((DistanceFieldCollisionObject*)co1)->m_testMesh;
+}
+
+void DistanceFieldCollisionDetection::collisionDetectionPair(SimulationModel &model, const unsigned int coIndex1, const unsigned int coIndex2,
+	std::vector<std::vector<ContactData> > &contacts_mt)
+{
+	const SimulationModel::RigidBodyVector &rigidBodies = model.getRigidBodies();
+	const SimulationModel::TriangleModelVector &triModels = model.getTriangleModels();
+	const SimulationModel::TetModelVector &tetModels = model.getTetModels();
+	const ParticleData &pd = model.getParticles();
+
+	CollisionDetection::CollisionObject *co1 = m_collisionObjects[coIndex1];
+	CollisionDetection::CollisionObject *co2 = m_collisionObjects[coIndex2];
+
+	if (((co2->m_bodyType != CollisionDetection::CollisionObject::RigidBodyCollisionObjectType) &&
+		(co2->m_bodyType != CollisionDetection::CollisionObject::TetModelCollisionObjectType)) ||
+		!isDistanceFieldCollisionObject(co1) ||
+		!isDistanceFieldCollisionObject(co2))
+		return;
+
+
+	if ((co1->m_bodyType == CollisionDetection::CollisionObject::RigidBodyCollisionObjectType) &&
+		(co2->m_bodyType == CollisionDetection::CollisionObject::RigidBodyCollisionObjectType) &&
+		((DistanceFieldCollisionObject*) co1)->m_testMesh)
+	{
+		RigidBody *rb1 = rigidBodies[co1->m_bodyIndex];				
+		RigidBody *rb2 = rigidBodies[co2->m_bodyIndex];
+		const Real restitutionCoeff = rb1->getRestitutionCoeff() * rb2->getRestitutionCoeff();
+		const Real frictionCoeff = rb1->getFrictionCoeff() + rb2->getFrictionCoeff();
+		collisionDetectionRigidBodies(rb1, (DistanceFieldCollisionObject*)co1, rb2, (DistanceFieldCollisionObject*)co2,
+			restitutionCoeff, frictionCoeff
+			, contacts_mt
+			);
 	}
+	else if ((co1->m_bodyType == CollisionDetection::CollisionObject::TriangleModelCollisionObjectType) &&
+			(co2->m_bodyType == CollisionDetection::CollisionObject::RigidBodyCollisionObjectType) &&
+			((DistanceFieldCollisionObject*)co1)->m_testMesh)
+	{
+		TriangleModel *tm = triModels[co1->m_bodyIndex];
+		RigidBody *rb2 = rigidBodies[co2->m_bodyIndex];
+		const unsigned int offset = tm->getIndexOffset();
+		const IndexedFaceMesh &mesh = tm->getParticleMesh();
+		const unsigned int numVert = mesh.numVertices();
+		const Real restitutionCoeff = tm->getRestitutionCoeff() * rb2->getRestitutionCoeff();
+		const Real frictionCoeff = tm->getFrictionCoeff() + rb2->getFrictionCoeff();
+		collisionDetectionRBSolid(pd, offset, numVert, (DistanceFieldCollisionObject*)co1, rb2, (DistanceFieldCollisionObject*)co2,
+			restitutionCoeff, frictionCoeff
+			, contacts_mt
+			);
+	}
+	else if ((co1->m_bodyType == CollisionDetection::CollisionObject::TetModelCollisionObjectType) && 
+			(co2->m_bodyType == CollisionDetection::CollisionObject::RigidBodyCollisionObjectType) &&
+			((DistanceFieldCollisionObject*)co1)->m_testMesh)
+	{
+		TetModel *tm = tetModels[co1->m_bodyIndex];
+		RigidBody *rb2 = rigidBodies[co2->m_bodyIndex];
+		const unsigned int offset = tm->getIndexOffset();
+		const IndexedTetMesh &mesh = tm->getParticleMesh();
+		const unsigned int numVert = mesh.numVertices();
+		const Real restitutionCoeff = tm->getRestitutionCoeff() * rb2->getRestitutionCoeff();
+		const Real frictionCoeff = tm->getFrictionCoeff() + rb2->getFrictionCoeff();
+		collisionDetectionRBSolid(pd, offset, numVert, (DistanceFieldCollisionObject*)co1, rb2, (DistanceFieldCollisionObject*)co2,
+			restitutionCoeff, frictionCoeff
+			, contacts_mt
+			);
+	}
+ 	else if ((co1->m_bodyType == CollisionDetection::CollisionObject::TetModelCollisionObjectType) &&
+ 		(co2->m_bodyType == CollisionDetection::CollisionObject::TetModelCollisionObjectType) &&
+ 		((DistanceFieldCollisionObject*)co1)->m_testMesh)
+ 	{
+ 		TetModel *tm1 = tetModels[co1->m_bodyIndex];
+ 		TetModel *tm2 = tetModels[co2->m_bodyIndex];
+ 		const unsigned int offset = tm1->getIndexOffset();
+ 		const IndexedTetMesh &mesh = tm1->getParticleMesh();
+ 		const unsigned int numVert = mesh.numVertices();
+ 		const Real restitutionCoeff = tm1->getRestitutionCoeff() * tm2->getRestitutionCoeff();
+ 		const Real frictionCoeff = tm1->getFrictionCoeff() + tm2->getFrictionCoeff();
+ 		collisionDetectionSolidSolid(pd, offset, numVert, (DistanceFieldCollisionObject*)co1, tm2, (DistanceFieldCollisionObject*)co2,
+ 			restitutionCoeff, frictionCoeff
+ 			, contacts_mt
+ 		);
+ 	}
 }
 
 void DistanceFieldCollisionDetection::collisionDetectionRigidBodies(RigidBody *rb1, DistanceFieldCollisionObject *co1, RigidBody *rb2, DistanceFieldCollisionObject *co2, 
@@ -223,7 +301,7 @@ void DistanceFieldCollisionDetection::collisionDetectionRigidBodies(RigidBody *r
 	const Vector3r &v2 = rb2->getTransformationV2();
 
 	const PointCloudBSH &bvh = ((DistanceFieldCollisionDetection::DistanceFieldCollisionObject*) co1)->m_bvh;
-	std::function<bool(unsigned int, unsigned int)> predicate = [&](unsigned int node_index, unsigned int depth)
+	auto predicate = [&](unsigned int node_index, unsigned int depth)
 	{
 		const BoundingSphere &bs = bvh.hull(node_index);
 		const Vector3r &sphere_x = bs.x();
@@ -247,38 +325,155 @@ void DistanceFieldCollisionDetection::collisionDetectionRigidBodies(RigidBody *r
 		}
 		return false;
 	};
-	std::function<void(unsigned int, unsigned int)> cb = [&](unsigned int node_index, unsigned int depth)
+	auto cb = [&](unsigned int node_index, unsigned int depth)
 	{
 		auto const& node = bvh.node(node_index);
 		if (!node.is_leaf())
 			return;
 
-		for (auto i = node.begin; i < node.begin + node.n; ++i)
+#ifdef _DEBUG
+		int tid = 0;
+#else
+		int tid = omp_get_thread_num();
+#endif			
+
+		// test the vertices of the leaf as a batch
+		const unsigned int batchSize = DistanceFieldCollisionObject::MaxBatchSize;
+		Vector3r x[batchSize], cp[batchSize], n[batchSize];
+		Real dist[batchSize];
+		unsigned int contactIndices[batchSize];
+		for (unsigned int begin = node.begin; begin < node.begin + node.n; begin += batchSize)
 		{
-			unsigned int index = bvh.entity(i);
-			const Vector3r &x_w = vd.getPosition(index);
-			const Vector3r x = R * (x_w - com2) + v1;
-			Vector3r cp, n;
-			Real dist;
-			if (co2->collisionTest(x, m_tolerance, cp, n, dist))
+			const unsigned int numPoints = std::min(batchSize, node.begin + node.n - begin);
+			for (unsigned int i = 0; i < numPoints; i++)
+				x[i] = R * (vd.getPosition(bvh.entity(begin + i)) - com2) + v1;
+
+			const unsigned int numContacts = co2->collisionTestBatch(numPoints, x, m_tolerance, contactIndices, cp, n, dist);
+			for (unsigned int c = 0; c < numContacts; c++)
 			{
-				const Vector3r cp_w = R.transpose() * cp + v2;
-				const Vector3r n_w = R.transpose() * n;
+				const unsigned int index = bvh.entity(begin + contactIndices[c]);
+				const Vector3r &x_w = vd.getPosition(index);
+				const Vector3r cp_w = R.transpose() * cp[c] + v2;
+				const Vector3r n_w = R.transpose() * n[c];
+				contacts_mt[tid].emplace_back(0, co1->m_bodyIndex, co2->m_bodyIndex, x_w, cp_w, n_w, dist[c], restitutionCoeff, frictionCoeff, index);
+			}
+		}
+	};
+	bvh.traverse_depth_first(predicate, cb);
+}
+
+
+void DistanceFieldCollisionDetection::collisionDetectionRigidBodies(SimulationModel &model, const std::pair<unsigned int, unsigned int> *coPairs, const unsigned int numPairs,
+	std::vector<std::vector<ContactData> > &contacts_mt)
+{
+	const SimulationModel::RigidBodyVector &rigidBodies = model.getRigidBodies();
+	DistanceFieldCollisionObject *co1 = (DistanceFieldCollisionObject*)m_collisionObjects[coPairs[0].first];
+	RigidBody *rb1 = rigidBodies[co1->m_bodyIndex];
+	const VertexData &vd = rb1->getGeometry().getVertexData();
+	const PointCloudBSH &bvh = co1->m_bvh;
+
+	// data of the queries in the packet, see collisionDetectionRigidBodies() for the transformations
+	struct Query
+	{
+		DistanceFieldCollisionObject *co2;
+		unsigned int bodyIndex2;
+		Vector3r com2;
+		Matrix3r R;
+		Vector3r v1;
+		Vector3r v2;
+		AlignedBox3r box;
+		Real restitutionCoeff;
+		Real frictionCoeff;
+	};
+	Query queries[32];
+	unsigned int mask = 0;
+	for (unsigned int q = 0; q < numPairs; q++)
+	{
+		Query &query = queries[q];
+		query.co2 = (DistanceFieldCollisionObject*)m_collisionObjects[coPairs[q].second];
+		query.bodyIndex2 = query.co2->m_bodyIndex;
+		RigidBody *rb2 = rigidBodies[query.bodyIndex2];
+		if ((rb1->getMass() == 0.0) && (rb2->getMass() == 0.0))
+			continue;
+		query.com2 = rb2->getPosition();
+		query.R = rb2->getTransformationR();
+		query.v1 = rb2->getTransformationV1();
+		query.v2 = rb2->getTransformationV2();
+		query.box.setEmpty();
+		query.box.extend(query.co2->m_aabb.m_p[0]);
+		query.box.extend(query.co2->m_aabb.m_p[1]);
+		query.restitutionCoeff = rb1->getRestitutionCoeff() * rb2->getRestitutionCoeff();
+		query.frictionCoeff = rb1->getFrictionCoeff() + rb2->getFrictionCoeff();
+		mask |= 1u << q;
+	}
+
+	auto predicate = [&](unsigned int node_index, unsigned int depth, unsigned int activeMask)
+	{
+		const BoundingSphere &bs = bvh.hull(node_index);
+		const Vector3r sphere_x_w = rb1->getRotation() * bs.x() + rb1->getPosition();
+
+		unsigned int result = 0;
+		for (unsigned int q = 0; q < numPairs; q++)
+		{
+			if ((activeMask & (1u << q)) == 0)
+				continue;
+			const Query &query = queries[q];
+
+			// Test if center of bounding sphere intersects AABB
+			if (query.box.exteriorDistance(sphere_x_w) < bs.r())
+			{
+				// Test if distance of center of bounding sphere to collision object is smaller than the radius
+				const Vector3r x = query.R * (sphere_x_w - query.com2) + query.v1;
+				const double dist2 = query.co2->distance(x.template cast<double>(), m_tolerance);
+				if ((dist2 == std::numeric_limits<double>::max()) || (dist2 < bs.r()))
+					result |= 1u << q;
+			}
+		}
+		return result;
+	};
+	auto cb = [&](unsigned int node_index, unsigned int depth, unsigned int activeMask)
+	{
+		auto const& node = bvh.node(node_index);
+		if (!node.is_leaf())
+			return;
 
 #ifdef _DEBUG
-				int tid = 0;
+		int tid = 0;
 #else
-				int tid = omp_get_thread_num();
+		int tid = omp_get_thread_num();
 #endif			
 
-				contacts_mt[tid].push_back({ 0, co1->m_bodyIndex, co2->m_bodyIndex, x_w, cp_w, n_w, dist, restitutionCoeff, frictionCoeff });
+		// test the vertices of the leaf as a batch against each active query
+		const unsigned int batchSize = DistanceFieldCollisionObject::MaxBatchSize;
+		Vector3r x[batchSize], cp[batchSize], n[batchSize];
+		Real dist[batchSize];
+		unsigned int contactIndices[batchSize];
+		for (unsigned int begin = node.begin; begin < node.begin + node.n; begin += batchSize)
+		{
+			const unsigned int numPoints = std::min(batchSize, node.begin + node.n - begin);
+			for (unsigned int q = 0; q < numPairs; q++)
+			{
+				if ((activeMask & (1u << q)) == 0)
+					continue;
+				const Query &query = queries[q];
+				for (unsigned int i = 0; i < numPoints; i++)
+					x[i] = query.R * (vd.getPosition(bvh.entity(begin + i)) - query.com2) + query.v1;
+
+				const unsigned int numContacts = query.co2->collisionTestBatch(numPoints, x, m_tolerance, contactIndices, cp, n, dist);
+				for (unsigned int c = 0; c < numContacts; c++)
+				{
+					const unsigned int index = bvh.entity(begin + contactIndices[c]);
+					const Vector3r &x_w = vd.getPosition(index);
+					const Vector3r cp_w = query.R.transpose() * cp[c] + query.v2;
+					const Vector3r n_w = query.R.transpose() * n[c];
+					contacts_mt[tid].emplace_back(0, co1->m_bodyIndex, query.bodyIndex2, x_w, cp_w, n_w, dist[c], query.restitutionCoeff, query.frictionCoeff, index);
+				}
 			}
 		}
 	};
-	bvh.traverse_depth_first(predicate, cb);
+	bvh.traverse_depth_first_packet(mask, predicate, cb);
 }
 
-
 void DistanceFieldCollisionDetection::collisionDetectionRBSolid(const ParticleData &pd, const unsigned int offset, const unsigned int numVert,
 	DistanceFieldCollisionObject *co1, RigidBody *rb2, DistanceFieldCollisionObject *co2, 
 	const Real restitutionCoeff, const Real frictionCoeff
@@ -303,7 +498,7 @@ void DistanceFieldCollisionDetection::collisionDetectionRBSolid(const ParticleDa
 
 	const PointCloudBSH &bvh = ((DistanceFieldCollisionDetection::DistanceFieldCollisionObject*) co1)->m_bvh;
 
-	std::function<bool(unsigned int, unsigned int)> predicate = [&](unsigned int node_index, unsigned int depth)
+	auto predicate = [&](unsigned int node_index, unsigned int depth)
 	{
 		const BoundingSphere &bs = bvh.hull(node_index);
 		const Vector3r &sphere_x_w = bs.x();
@@ -327,30 +522,37 @@ void DistanceFieldCollisionDetection::collisionDetectionRBSolid(const ParticleDa
 		return false;
 	};
 
-	std::function<void(unsigned int, unsigned int)> cb = [&](unsigned int node_index, unsigned int depth)
+	auto cb = [&](unsigned int node_index, unsigned int depth)
 	{
 		auto const& node = bvh.node(node_index);
 		if (!node.is_leaf())
 			return;
 
-		for (auto i = node.begin; i < node.begin + node.n; ++i)
-		{
-			unsigned int index = bvh.entity(i) + offset;
-			const Vector3r &x_w = pd.getPosition(index);
-			const Vector3r x = R * (x_w - com2) + v1;
-			Vector3r cp, n;
-			Real dist;
-			if (co2->collisionTest(x, m_tolerance, cp, n, dist))
-			{
-				const Vector3r cp_w = R.transpose() * cp + v2;
-				const Vector3r n_w = R.transpose() * n;
-
 #ifdef _DEBUG
-				int tid = 0;
+		int tid = 0;
 #else
-				int tid = omp_get_thread_num();
+		int tid = omp_get_thread_num();
 #endif			
-				contacts_mt[tid].push_back({ 1, index, co2->m_bodyIndex, x_w, cp_w, n_w, dist, restitutionCoeff, frictionCoeff });
+
+		// test the particles of the leaf as a batch
+		const unsigned int batchSize = DistanceFieldCollisionObject::MaxBatchSize;
+		Vector3r x[batchSize], cp[batchSize], n[batchSize];
+		Real dist[batchSize];
+		unsigned int contactIndices[batchSize];
+		for (unsigned int begin = node.begin; begin < node.begin + node.n; begin += batchSize)
+		{
+			const unsigned int numPoints = std::min(batchSize, node.begin + node.n - begin);
+			for (unsigned int i = 0; i < numPoints; i++)
+				x[i] = R * (pd.getPosition(bvh.entity(begin + i) + offset) - com2) + v1;
+
+			const unsigned int numContacts = co2->collisionTestBatch(numPoints, x, m_tolerance, contactIndices, cp, n, dist);
+			for (unsigned int c = 0; c < numContacts; c++)
+			{
+				const unsigned int index = bvh.entity(begin + contactIndices[c]) + offset;
+				const Vector3r &x_w = pd.getPosition(index);
+				const Vector3r cp_w = R.transpose() * cp[c] + v2;
+				const Vector3r n_w = R.transpose() * n[c];
+				contacts_mt[tid].emplace_back(1, index, co2->m_bodyIndex, x_w, cp_w, n_w, dist[c], restitutionCoeff, frictionCoeff);
 			}
 		}
 	};
@@ -372,7 +574,7 @@ void DistanceFieldCollisionDetection::collisionDetectionSolidSolid(const Particl
 
 	// callback function for BVH which is called if a leaf node in the point cloud BVH
 	// has a collision with a leaf node in the tet BVH
-	std::function<void(unsigned int, unsigned int)> cb = [&](unsigned int node_index1, unsigned int node_index2)
+	auto cb = [&](unsigned int node_index1, unsigned int node_index2)
 	{
 		auto const& node1 = bvh1.node(node_index1);
 		auto const& node2 = bvh2.node(node_index2);
@@ -470,7 +672,7 @@ void DistanceFieldCollisionDetection::collisionDetectionSolidSolid(const Particl
 							if (dist > 1.0e-6)
 								n_w /= dist;
 
-	 						contacts_mt[tid].push_back({ 2, index, co2->m_bodyIndex, x_w, cp_w, n_w, dist, restitutionCoeff, frictionCoeff, tetIndex, cp_tetIndex, bary, cp_bary });
+	 						contacts_mt[tid].emplace_back(2, index, co2->m_bodyIndex, x_w, cp_w, n_w, dist, restitutionCoeff, frictionCoeff, tetIndex, cp_tetIndex, bary, cp_bary);
 						}
 					}
 				}
@@ -727,6 +929,18 @@ bool DistanceFieldCollisionDetection::DistanceFieldCollisionObject::collisionTes
 	return false;
 }
 
+unsigned int DistanceFieldCollisionDetection::DistanceFieldCollisionObject::collisionTestBatch(const unsigned int numPoints, const Vector3r *x, const Real tolerance,
+	unsigned int *contactIndices, Vector3r *cp, Vector3r *n, Real *dist, const Real maxDist)
+{
+	unsigned int numContacts = 0;
+	for (unsigned int i = 0; i < numPoints; i++)
+	{
+		if (collisionTest(x[i], tolerance, cp[numContacts], n[numContacts], dist[numContacts], maxDist))
+			contactIndices[numContacts++] = i;
+	}
+	return numContacts;
+}
+
 void DistanceFieldCollisionDetection::DistanceFieldCollisionObject::initTetBVH(const Vector3r *vertices, const unsigned int numVertices, const unsigned int *indices, const unsigned int numTets, const Real tolerance)
 {
 	if (m_bodyType == CollisionDetection::CollisionObject::TetModelCollisionObjectType)
@@ -752,12 +966,12 @@ bool DistanceFieldCollisionDetection::findRefTetAt(const ParticleData &pd, TetMo
 	bary.reserve(100);
 	tets.reserve(100);
 
-	std::function<bool(unsigned int, unsigned int)> predicate = [&](unsigned int node_index, unsigned int depth)
+	auto predicate = [&](unsigned int node_index, unsigned int depth)
  	{
  		const BoundingSphere &bs = bvh0.hull(node_index);
 		return bs.contains(X);
  	};
- 	std::function<void(unsigned int, unsigned int)> cb = [&](unsigned int node_index, unsigned int depth)
+ 	auto cb = [&](unsigned int node_index, unsigned int depth)
  	{
  		auto const& node = bvh0.node(node_index);
  		if (!node.is_leaf())
@@ -14,6 +14,9 @@ namespace PBD
 	public:
 		struct DistanceFieldCollisionObject : public CollisionObject
 		{		
+			/** Maximum number of points in a call of collisionTestBatch() */
+			static const unsigned int MaxBatchSize = 16;
+
 			bool m_testMesh;
 			Real m_invertSDF;
 			PointCloudBSH m_bvh;
@@ -23,6 +26,13 @@ namespace PBD
 			DistanceFieldCollisionObject() { m_testMesh = true; m_invertSDF = 1.0; }
 			virtual ~DistanceFieldCollisionObject() {}
 			virtual bool collisionTest(const Vector3r &x, const Real tolerance, Vector3r &cp, Vector3r &n, Real &dist, const Real maxDist = 0.0);
+			/** Collision test for a batch of points (e.g. the vertices in a leaf of a BVH). 
+			 * The indices of the points in contact (w.r.t. the batch) are written to contactIndices 
+			 * and their contact data to cp, n and dist. Returns the number of contacts. 
+			 * The default implementation calls collisionTest() for each point.
+			 */
+			virtual unsigned int collisionTestBatch(const unsigned int numPoints, const Vector3r *x, const Real tolerance, 
+				unsigned int *contactIndices, Vector3r *cp, Vector3r *n, Real *dist, const Real maxDist = 0.0);
 			virtual void approximateNormal(const Eigen::Vector3d &x, const Real tolerance, Vector3r &n);
 
 			virtual double distance(const Eigen::Vector3d &x, const Real tolerance) = 0;
@@ -103,26 +113,26 @@ namespace PBD
 			virtual double distance(const Eigen::Vector3d &x, const Real tolerance);
 		};
 
-		struct ContactData
-		{
-			char m_type;
-			unsigned int m_index1;
-			unsigned int m_index2;
-			Vector3r m_cp1;
-			Vector3r m_cp2;
-			Vector3r m_normal;
-			Real m_dist;
-			Real m_restitution;
-			Real m_friction;
-
-			// Test
-			unsigned int m_elementIndex1;
-			unsigned int m_elementIndex2;
-			Vector3r m_bary1;
-			Vector3r m_bary2;
-		};
-
 	protected:
+		BroadPhase::PairVector m_overlappingPairs;
+		std::vector<std::pair<unsigned int, unsigned int>> m_coPairs;
+		/** Ranges [begin, end) in m_coPairs which are processed together in the narrow phase */
+		std::vector<std::pair<unsigned int, unsigned int>> m_pairGroups;
+		/** Contacts found by each thread in the current step */
+		std::vector<std::vector<ContactData> > m_contacts_mt;
+
+		bool isRigidBodyPacketPair(const std::pair<unsigned int, unsigned int> &coPair);
+		void collisionDetectionPair(SimulationModel &model, const unsigned int coIndex1, const unsigned int coIndex2,
+			std::vector<std::vector<ContactData> > &contacts_mt);
+		/** Test the vertices of a rigid body against the distance fields of up to 32 other rigid bodies 
+		 * in a single traversal of its BVH. All pairs must have the same first collision object.
+		 * The contacts are the same as for separate traversals but they are emitted per leaf for all
+		 * pairs, so the order of the contact constraints differs. It is still deterministic for
+		 * a fixed number of threads.
+		 */
+		void collisionDetectionRigidBodies(SimulationModel &model, const std::pair<unsigned int, unsigned int> *coPairs, const unsigned int numPairs,
+			std::vector<std::vector<ContactData> > &contacts_mt);
+
 		void collisionDetectionRigidBodies(RigidBody *rb1, DistanceFieldCollisionObject *co1, RigidBody *rb2, DistanceFieldCollisionObject *co2,
 			const Real restitutionCoeff, const Real frictionCoeff
 			, std::vector<std::vector<ContactData> > &contacts_mt
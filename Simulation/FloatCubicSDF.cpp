@@ -0,0 +1,379 @@
+#include "FloatCubicSDF.h"
+#include "Utils/MemoryMappedFile.h"
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include "omp.h"
+
+using namespace PBD;
+
+typedef FloatCubicSDF::Array8f Array8f;
+
+// Signs of the local node coordinates of the 8 nodes in a block.
+// Corner k is at (s0[k], s1[k], s2[k]). The edge node k in direction a
+// is at s0[k]/3 on axis a, s1[k] on axis (a+1)%3 and s2[k] on axis (a+2)%3.
+static const Array8f s_sign0 = (Array8f() << -1, 1, -1, 1, -1, 1, -1, 1).finished();
+static const Array8f s_sign1 = (Array8f() << -1, -1, 1, 1, -1, -1, 1, 1).finished();
+static const Array8f s_sign2 = (Array8f() << -1, -1, -1, -1, 1, 1, 1, 1).finished();
+
+static const char s_fileMagic[8] = { 'P', 'B', 'D', 'F', 'S', 'D', 'F', '\0' };
+/** Alignment of the data blocks in a file */
+static const unsigned long long s_fileAlignment = 64;
+
+FloatCubicSDF::FloatCubicSDF() :
+	m_cellMap(nullptr),
+	m_coefficients(nullptr)
+{
+	cleanup();
+}
+
+FloatCubicSDF::~FloatCubicSDF()
+{
+	cleanup();
+}
+
+void FloatCubicSDF::cleanup()
+{
+	m_cellMap = nullptr;
+	m_coefficients = nullptr;
+	m_cellMapStorage.clear();
+	m_coefficientStorage.clear();
+	m_file.reset();
+	m_domainMin.setZero();
+	m_domainMax.setZero();
+	m_invCellSize.setZero();
+	m_resolution[0] = m_resolution[1] = m_resolution[2] = 0;
+	m_bandWidth = FLT_MAX;
+	m_numCells = 0;
+	m_insideCenter.setZero();
+}
+
+void FloatCubicSDF::computeInsideCenter()
+{
+	Eigen::Vector3d sum = Eigen::Vector3d::Zero();
+	unsigned long long numInside = 0;
+	const unsigned int numGridCells = m_resolution[0] * m_resolution[1] * m_resolution[2];
+	for (unsigned int cell = 0; cell < numGridCells; cell++)
+	{
+		if (m_cellMap[cell] == InsideCell)
+		{
+			const unsigned int i = cell % m_resolution[0];
+			const unsigned int j = (cell / m_resolution[0]) % m_resolution[1];
+			const unsigned int k = cell / (m_resolution[0] * m_resolution[1]);
+			sum += Eigen::Vector3d(i + 0.5, j + 0.5, k + 0.5);
+			numInside++;
+		}
+	}
+	if (numInside == 0)
+		m_insideCenter = 0.5f * (m_domainMin + m_domainMax);
+	else
+		m_insideCenter = m_domainMin + (sum / static_cast<double>(numInside)).cast<float>().cwiseQuotient(m_invCellSize);
+}
+
+void FloatCubicSDF::init(const Discregrid::CubicLagrangeDiscreteGrid &grid, const unsigned int fieldId, const float bandWidth)
+{
+	cleanup();
+	const Eigen::AlignedBox3d &domain = grid.domain();
+	for (unsigned int i = 0; i < 3; i++)
+		m_resolution[i] = grid.resolution()[i];
+	const Eigen::Vector3d cellSize = domain.diagonal().cwiseQuotient(Eigen::Vector3d(m_resolution[0], m_resolution[1], m_resolution[2]));
+	m_domainMin = domain.min().cast<float>();
+	m_domainMax = domain.max().cast<float>();
+	m_invCellSize = cellSize.cwiseInverse().cast<float>();
+
+	// local coordinates of the nodes in the order of the coefficients
+	Eigen::Vector3d nodes[NodesPerCell];
+	for (unsigned int k = 0; k < 8; k++)
+	{
+		nodes[k] = Eigen::Vector3d(s_sign0[k], s_sign1[k], s_sign2[k]);
+		for (unsigned int a = 0; a < 3; a++)
+		{
+			Eigen::Vector3d &node = nodes[8 * (a + 1) + k];
+			node[a] = s_sign0[k] / 3.0;
+			node[(a + 1) % 3] = s_sign1[k];
+			node[(a + 2) % 3] = s_sign2[k];
+		}
+	}
+
+	// Sample the grid at the nodes. The nodes are moved slightly into the cell
+	// so that the grid does not evaluate a neighboring cell without data.
+	const double shrink = 1.0 - 1.0e-9;
+	// Since the distance function is 1-Lipschitz, all distances in a cell are outside 
+	// of the band if the distances at all nodes are larger than this threshold.
+	const double farThreshold = static_cast<double>(bandWidth) + 0.5 * cellSize.norm();
+	const int numGridCells = static_cast<int>(m_resolution[0] * m_resolution[1] * m_resolution[2]);
+	std::vector<float> coefficients(static_cast<std::size_t>(numGridCells) * NodesPerCell);
+	m_cellMapStorage.resize(numGridCells);
+
+	#pragma omp parallel if(numGridCells > MIN_PARALLEL_SIZE) default(shared)
+	{
+		#pragma omp for schedule(static)
+		for (int cell = 0; cell < numGridCells; cell++)
+		{
+			const unsigned int i = cell % m_resolution[0];
+			const unsigned int j = (cell / m_resolution[0]) % m_resolution[1];
+			const unsigned int k = cell / (m_resolution[0] * m_resolution[1]);
+			const Eigen::Vector3d cellMin = domain.min() + Eigen::Vector3d(i, j, k).cwiseProduct(cellSize);
+
+			// temporarily mark the cells with data by 0
+			m_cellMapStorage[cell] = 0;
+			unsigned int numInside = 0;
+			unsigned int numOutside = 0;
+			for (unsigned int n = 0; n < NodesPerCell; n++)
+			{
+				const Eigen::Vector3d x = cellMin + (0.5 * (shrink * nodes[n] + Eigen::Vector3d::Ones())).cwiseProduct(cellSize);
+				const double d = grid.interpolate(fieldId, x);
+				if (d == std::numeric_limits<double>::max())
+				{
+					m_cellMapStorage[cell] = InvalidCell;
+					break;
+				}
+				if (d < -farThreshold)
+					numInside++;
+				else if (d > farThreshold)
+					numOutside++;
+				coefficients[cell * NodesPerCell + n] = static_cast<float>(d);
+			}
+			if (numInside == NodesPerCell)
+				m_cellMapStorage[cell] = InsideCell;
+			else if (numOutside == NodesPerCell)
+				m_cellMapStorage[cell] = InvalidCell;
+		}
+	}
+
+	// store only the cells with data
+	unsigned int numCells = 0;
+	for (int cell = 0; cell < numGridCells; cell++)
+	{
+		if (m_cellMapStorage[cell] == 0)
+		{
+			if (numCells != static_cast<unsigned int>(cell))
+				std::copy(&coefficients[cell * NodesPerCell], &coefficients[cell * NodesPerCell] + NodesPerCell, &coefficients[numCells * NodesPerCell]);
+			m_cellMapStorage[cell] = numCells++;
+		}
+	}
+	coefficients.resize(static_cast<std::size_t>(numCells) * NodesPerCell);
+	coefficients.shrink_to_fit();
+	m_coefficientStorage.swap(coefficients);
+
+	m_bandWidth = bandWidth;
+	m_numCells = numCells;
+	m_cellMap = m_cellMapStorage.data();
+	m_coefficients = m_coefficientStorage.data();
+	computeInsideCenter();
+}
+
+bool FloatCubicSDF::save(const std::string &fileName) const
+{
+	if (!isInitialized())
+		return false;
+
+	const unsigned long long numGridCells = static_cast<unsigned long long>(m_resolution[0]) * m_resolution[1] * m_resolution[2];
+	FileHeader header;
+	memset(&header, 0, sizeof(FileHeader));
+	memcpy(header.m_magic, s_fileMagic, sizeof(s_fileMagic));
+	header.m_version = FileVersion;
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		header.m_resolution[i] = m_resolution[i];
+		header.m_domainMin[i] = m_domainMin[i];
+		header.m_domainMax[i] = m_domainMax[i];
+		header.m_invCellSize[i] = m_invCellSize[i];
+	}
+	header.m_bandWidth = m_bandWidth;
+	header.m_numCells = m_numCells;
+	const unsigned long long cellMapSize = numGridCells * sizeof(unsigned int);
+	header.m_cellMapOffset = (sizeof(FileHeader) + s_fileAlignment - 1) / s_fileAlignment * s_fileAlignment;
+	header.m_coefficientsOffset = (header.m_cellMapOffset + cellMapSize + s_fileAlignment - 1) / s_fileAlignment * s_fileAlignment;
+
+	std::ofstream output(fileName, std::ios::binary);
+	if (!output.is_open())
+		return false;
+	const char padding[s_fileAlignment] = {};
+	output.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+	output.write(padding, header.m_cellMapOffset - sizeof(FileHeader));
+	output.write(reinterpret_cast<const char*>(m_cellMap), cellMapSize);
+	output.write(padding, header.m_coefficientsOffset - header.m_cellMapOffset - cellMapSize);
+	output.write(reinterpret_cast<const char*>(m_coefficients), static_cast<std::streamsize>(m_numCells) * NodesPerCell * sizeof(float));
+	return output.good();
+}
+
+bool FloatCubicSDF::convert(const std::string &gridFileName, const std::string &fileName, const float bandWidth, const unsigned int fieldId)
+{
+	Discregrid::CubicLagrangeDiscreteGrid grid(gridFileName);
+	if (fieldId >= grid.nFields())
+		return false;
+	FloatCubicSDF sdf;
+	sdf.init(grid, fieldId, bandWidth);
+	return sdf.save(fileName);
+}
+
+bool FloatCubicSDF::isFloatCubicSDFFile(const std::string &fileName)
+{
+	std::ifstream input(fileName, std::ios::binary);
+	char magic[sizeof(s_fileMagic)];
+	if (!input.read(magic, sizeof(magic)))
+		return false;
+	return memcmp(magic, s_fileMagic, sizeof(s_fileMagic)) == 0;
+}
+
+bool FloatCubicSDF::load(const std::string &fileName)
+{
+	cleanup();
+	std::unique_ptr<Utilities::MemoryMappedFile> file(new Utilities::MemoryMappedFile());
+	if (!file->open(fileName) || (file->size() < sizeof(FileHeader)))
+		return false;
+
+	FileHeader header;
+	memcpy(&header, file->data(), sizeof(FileHeader));
+	if ((memcmp(header.m_magic, s_fileMagic, sizeof(s_fileMagic)) != 0) || (header.m_version != FileVersion))
+		return false;
+	const unsigned long long numGridCells = static_cast<unsigned long long>(header.m_resolution[0]) * header.m_resolution[1] * header.m_resolution[2];
+	if ((numGridCells == 0) ||
+		(header.m_cellMapOffset % s_fileAlignment != 0) || (header.m_coefficientsOffset % s_fileAlignment != 0) ||
+		(header.m_cellMapOffset + numGridCells * sizeof(unsigned int) > file->size()) ||
+		(header.m_coefficientsOffset + static_cast<unsigned long long>(header.m_numCells) * NodesPerCell * sizeof(float) > file->size()))
+		return false;
+
+	// check the cell map once so that the queries do not have to
+	const unsigned int *cellMap = reinterpret_cast<const unsigned int*>(file->data() + header.m_cellMapOffset);
+	for (unsigned long long cell = 0; cell < numGridCells; cell++)
+	{
+		if ((cellMap[cell] >= header.m_numCells) && (cellMap[cell] != InvalidCell) && (cellMap[cell] != InsideCell))
+			return false;
+	}
+
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		m_resolution[i] = header.m_resolution[i];
+		m_domainMin[i] = header.m_domainMin[i];
+		m_domainMax[i] = header.m_domainMax[i];
+		m_invCellSize[i] = header.m_invCellSize[i];
+	}
+	m_bandWidth = header.m_bandWidth;
+	m_numCells = header.m_numCells;
+	m_cellMap = cellMap;
+	m_coefficients = reinterpret_cast<const float*>(file->data() + header.m_coefficientsOffset);
+	m_file = std::move(file);
+	computeInsideCenter();
+	return true;
+}
+
+float FloatCubicSDF::evaluate(const Array8f *c, const Eigen::Vector3f &xi, Eigen::Vector3f &gradient)
+{
+	const float x = xi[0];
+	const float y = xi[1];
+	const float z = xi[2];
+
+	// corner nodes: N = 1/64 (1 +- x)(1 +- y)(1 +- z)(9(x^2 + y^2 + z^2) - 19)
+	const Array8f px = 1.0f + s_sign0 * x;
+	const Array8f py = 1.0f + s_sign1 * y;
+	const Array8f pz = 1.0f + s_sign2 * z;
+	const Array8f cpyz = c[0] * py * pz;
+	const Array8f cpxz = c[0] * px * pz;
+	const float f = (1.0f / 64.0f) * (9.0f * (x*x + y*y + z*z) - 19.0f);
+	const float df = 18.0f / 64.0f;
+	const float s = (cpyz * px).sum();
+	float phi = f * s;
+	gradient[0] = f * (cpyz * s_sign0).sum() + df * x * s;
+	gradient[1] = f * (cpxz * s_sign1).sum() + df * y * s;
+	gradient[2] = f * (c[0] * px * py * s_sign2).sum() + df * z * s;
+
+	// edge nodes in direction a: N = 9/64 (1 - u^2)(1 +- 3u)(1 +- v)(1 +- w)
+	for (unsigned int a = 0; a < 3; a++)
+	{
+		const unsigned int b = (a + 1) % 3;
+		const unsigned int e = (a + 2) % 3;
+		const float u = xi[a];
+		const float one_m_u2 = 1.0f - u*u;
+		const Array8f p3u = 1.0f + 3.0f * s_sign0 * u;
+		const Array8f g = one_m_u2 * p3u;
+		const Array8f dg = -2.0f * u * p3u + 3.0f * one_m_u2 * s_sign0;
+		const Array8f pv = 1.0f + s_sign1 * xi[b];
+		const Array8f pw = 1.0f + s_sign2 * xi[e];
+		const Array8f cpvw = (9.0f / 64.0f) * c[a + 1] * pv * pw;
+		const Array8f cg = (9.0f / 64.0f) * c[a + 1] * g;
+		phi += (cpvw * g).sum();
+		gradient[a] += (cpvw * dg).sum();
+		gradient[b] += (cg * s_sign1 * pw).sum();
+		gradient[e] += (cg * pv * s_sign2).sum();
+	}
+	return phi;
+}
+
+void FloatCubicSDF::interpolate(const unsigned int numPoints, const Eigen::Vector3f *x, float *dist, Eigen::Vector3f *gradient) const
+{
+	const unsigned int batchSize = 64;
+	unsigned int cells[batchSize];
+	unsigned int order[batchSize];
+	Eigen::Vector3f xi[batchSize];
+	const Eigen::Vector3f gradientScale = 2.0f * m_invCellSize;
+
+	for (unsigned int begin = 0; begin < numPoints; begin += batchSize)
+	{
+		const unsigned int n = std::min(batchSize, numPoints - begin);
+
+		// determine the cells and sort the points by their cell (insertion sort since the
+		// points of a batch are usually close to each other)
+		unsigned int numValid = 0;
+		for (unsigned int i = 0; i < n; i++)
+		{
+			cells[i] = findCell(x[begin + i], xi[i]);
+			if (cells[i] >= InsideCell)
+			{
+				dist[begin + i] = distanceWithoutData(cells[i]);
+				gradient[begin + i].setZero();
+				continue;
+			}
+			unsigned int j = numValid++;
+			while ((j > 0) && (cells[order[j - 1]] > cells[i]))
+			{
+				order[j] = order[j - 1];
+				j--;
+			}
+			order[j] = i;
+		}
+
+		unsigned int i = 0;
+		while (i < numValid)
+		{
+			// load the coefficients of the cell once for all its points
+			const unsigned int cell = cells[order[i]];
+			const float *coeffs = &m_coefficients[static_cast<std::size_t>(cell) * NodesPerCell];
+			Array8f c[4];
+			for (unsigned int block = 0; block < 4; block++)
+				c[block] = Eigen::Map<const Array8f>(coeffs + 8 * block);
+
+			for (; (i < numValid) && (cells[order[i]] == cell); i++)
+			{
+				const unsigned int index = order[i];
+				Eigen::Vector3f &grad = gradient[begin + index];
+				dist[begin + index] = evaluate(c, xi[index], grad);
+				grad = grad.cwiseProduct(gradientScale);
+			}
+		}
+	}
+}
+
+float FloatCubicSDF::interpolate(const Eigen::Vector3f &x, Eigen::Vector3f *gradient) const
+{
+	Eigen::Vector3f xi;
+	const unsigned int cell = findCell(x, xi);
+	if (cell >= InsideCell)
+	{
+		if (gradient)
+			gradient->setZero();
+		return distanceWithoutData(cell);
+	}
+
+	const float *coeffs = &m_coefficients[static_cast<std::size_t>(cell) * NodesPerCell];
+	Array8f c[4];
+	for (unsigned int block = 0; block < 4; block++)
+		c[block] = Eigen::Map<const Array8f>(coeffs + 8 * block);
+
+	Eigen::Vector3f grad;
+	const float d = evaluate(c, xi, grad);
+	if (gradient)
+		*gradient = grad.cwiseProduct(2.0f * m_invCellSize);
+	return d;
+}
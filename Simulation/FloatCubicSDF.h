@@ -0,0 +1,180 @@
+#ifndef __FLOATCUBICSDF_H__
+#define __FLOATCUBICSDF_H__
+
+#include "Common/Common.h"
+#include <vector>
+#include <memory>
+#include <string>
+
+#include "Discregrid/All"
+
+namespace Utilities
+{
+	class MemoryMappedFile;
+}
+
+namespace PBD
+{
+	/** Single precision copy of a cubic Lagrange signed distance field of Discregrid which
+	 * is optimized for the evaluation of batches of points (e.g. the vertices in a leaf
+	 * of a BVH).
+	 *
+	 * The 32 coefficients of a cell are stored contiguously. The points of a batch are
+	 * sorted by their cell so that the coefficients of a cell are loaded only once for all
+	 * of its points. The shape functions are evaluated as four SIMD blocks of 8 nodes
+	 * (corners and the edge nodes in x-, y- and z-direction).
+	 *
+	 * Optionally only the cells in a narrow band around the surface are stored. For points
+	 * in a cell outside of the band the field returns FLT_MAX (outside) or -FLT_MAX (inside).
+	 *
+	 * The field can be saved in a binary format which is memory mapped when it is loaded.
+	 * Therefore, the pages of the file are only read when they are accessed and they are
+	 * shared by all fields (also in different processes) which load the same file.
+	 * File layout (native byte order):
+	 * - FileHeader
+	 * - cell map: one unsigned int per grid cell (at m_cellMapOffset)
+	 * - coefficients: NodesPerCell floats per stored cell (at m_coefficientsOffset)
+	 */
+	class FloatCubicSDF
+	{
+	public:
+		typedef Eigen::Array<float, 8, 1> Array8f;
+
+		/** Cell map entry of a cell without data or a cell outside of the band (outside of the surface) */
+		static const unsigned int InvalidCell = 0xffffffffu;
+		/** Cell map entry of a cell outside of the band (inside of the surface) */
+		static const unsigned int InsideCell = 0xfffffffeu;
+		static const unsigned int NodesPerCell = 32;
+		static const unsigned int FileVersion = 1;
+
+	protected:
+		struct FileHeader
+		{
+			char m_magic[8];
+			unsigned int m_version;
+			unsigned int m_resolution[3];
+			float m_domainMin[3];
+			float m_domainMax[3];
+			float m_invCellSize[3];
+			float m_bandWidth;
+			unsigned int m_numCells;
+			unsigned int m_reserved;
+			unsigned long long m_cellMapOffset;
+			unsigned long long m_coefficientsOffset;
+		};
+
+		Eigen::Vector3f m_domainMin;
+		Eigen::Vector3f m_domainMax;
+		Eigen::Vector3f m_invCellSize;
+		unsigned int m_resolution[3];
+		float m_bandWidth;
+		unsigned int m_numCells;
+		/** Center of the cells inside of the surface but outside of the band */
+		Eigen::Vector3f m_insideCenter;
+
+		/** Data of a field which was generated from a grid */
+		std::vector<unsigned int> m_cellMapStorage;
+		std::vector<float> m_coefficientStorage;
+		/** Mapping of a loaded file */
+		std::unique_ptr<Utilities::MemoryMappedFile> m_file;
+
+		/** Index of the coefficients of each cell of the grid, InvalidCell or InsideCell.
+		 * Points either to m_cellMapStorage or to the mapped file.
+		 */
+		const unsigned int *m_cellMap;
+		/** NodesPerCell coefficients for each stored cell.
+		 * Points either to m_coefficientStorage or to the mapped file.
+		 */
+		const float *m_coefficients;
+
+		/** Determine the cell containing x and the local coordinates xi in [-1,1]^3 of x in this cell.
+		 * Returns the index of the coefficients of the cell, InvalidCell or InsideCell.
+		 */
+		FORCE_INLINE unsigned int findCell(const Eigen::Vector3f &x, Eigen::Vector3f &xi) const
+		{
+			if ((x.array() < m_domainMin.array()).any() || (x.array() > m_domainMax.array()).any())
+				return InvalidCell;
+
+			const Eigen::Vector3f p = (x - m_domainMin).cwiseProduct(m_invCellSize);
+			unsigned int mi[3];
+			for (unsigned int i = 0; i < 3; i++)
+			{
+				mi[i] = std::min(static_cast<unsigned int>(p[i]), m_resolution[i] - 1u);
+				xi[i] = static_cast<float>(2.0) * (p[i] - static_cast<float>(mi[i])) - static_cast<float>(1.0);
+			}
+			return m_cellMap[mi[0] + m_resolution[0] * (mi[1] + m_resolution[1] * mi[2])];
+		}
+
+		/** Distance which is returned for a cell without coefficients. */
+		static FORCE_INLINE float distanceWithoutData(const unsigned int cell)
+		{
+			return (cell == InsideCell) ? -FLT_MAX : FLT_MAX;
+		}
+
+		/** Evaluate the distance and the gradient (w.r.t. the local coordinates) in a cell
+		 * with the coefficients c at the local coordinates xi.
+		 */
+		static float evaluate(const Array8f *c, const Eigen::Vector3f &xi, Eigen::Vector3f &gradient);
+
+		/** Determine m_insideCenter from the cell map. */
+		void computeInsideCenter();
+
+	public:
+		FloatCubicSDF();
+		FloatCubicSDF(const FloatCubicSDF&) = delete;
+		FloatCubicSDF& operator=(const FloatCubicSDF&) = delete;
+		~FloatCubicSDF();
+
+		/** Copy the field with the given id of a cubic Lagrange grid.
+		 * The coefficients are determined by sampling the grid at the nodes of each cell.
+		 *
+		 * @param grid cubic Lagrange grid
+		 * @param fieldId id of the field in the grid
+		 * @param bandWidth only the cells which may contain distances in [-bandWidth, bandWidth] are stored
+		 */
+		void init(const Discregrid::CubicLagrangeDiscreteGrid &grid, const unsigned int fieldId = 0, const float bandWidth = FLT_MAX);
+		/** Save the field in the memory mappable format. */
+		bool save(const std::string &fileName) const;
+		/** Convert the field with the given id of a Discregrid grid file to a file in the memory mappable
+		 * format (see save()).
+		 *
+		 * @param gridFileName file of the cubic Lagrange grid
+		 * @param fileName resulting file
+		 * @param bandWidth only the cells which may contain distances in [-bandWidth, bandWidth] are stored
+		 * @param fieldId id of the field in the grid
+		 */
+		static bool convert(const std::string &gridFileName, const std::string &fileName, const float bandWidth = FLT_MAX, const unsigned int fieldId = 0);
+		/** Map a file which was written by save(). */
+		bool load(const std::string &fileName);
+		/** Check if the file starts with the header of the format written by save(). */
+		static bool isFloatCubicSDFFile(const std::string &fileName);
+		void cleanup();
+
+		bool isInitialized() const { return m_cellMap != nullptr; }
+		bool isMemoryMapped() const { return m_file != nullptr; }
+		unsigned int numCells() const { return m_numCells; }
+		float getBandWidth() const { return m_bandWidth; }
+		/** Return the center of the cells inside of the surface but outside of the band (the center
+		 * of the domain if there are none). Points in these cells have no gradient, so the direction
+		 * from this center is used as normal.
+		 */
+		const Eigen::Vector3f &getInsideCenter() const { return m_insideCenter; }
+
+		/** Interpolate the distance and the gradient at a batch of points. Points outside of the
+		 * domain or in a cell without data get the distance FLT_MAX, points inside of the surface
+		 * but outside of the band get -FLT_MAX.
+		 *
+		 * @param numPoints number of points
+		 * @param x points
+		 * @param dist resulting distances
+		 * @param gradient resulting gradients
+		 */
+		void interpolate(const unsigned int numPoints, const Eigen::Vector3f *x, float *dist, Eigen::Vector3f *gradient) const;
+		/** Interpolate the distance (and the gradient) at a single point. */
+		float interpolate(const Eigen::Vector3f &x, Eigen::Vector3f *gradient = nullptr) const;
+	};
+
+	typedef std::shared_ptr<FloatCubicSDF> FloatCubicSDFPtr;
+}
+
+#endif
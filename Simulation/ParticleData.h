@@ -78,6 +78,11 @@ namespace PBD
 		{
 			return m_x;
 		}
+
+		FORCE_INLINE std::vector<Vector3r>& getVertices()
+		{
+			return m_x;
+		}
 	};
 
 	/** This class encapsulates the state of all particles of a particle model.
@@ -265,6 +270,21 @@ namespace PBD
 				return m_x;
 			}
 
+			FORCE_INLINE std::vector<Vector3r>& getVertices()
+			{
+				return m_x;
+			}
+
+			FORCE_INLINE const std::vector<Real>& getMasses() const
+			{
+				return m_masses;
+			}
+
+			FORCE_INLINE const std::vector<Real>& getInvMasses() const
+			{
+				return m_invMasses;
+			}
+
 			/** Resize the array containing the particle data.
 			 */
 			FORCE_INLINE void resize(const unsigned int newSize)
@@ -45,13 +45,14 @@ void RigidBodyGeometry::updateMeshNormals(const VertexData &vd)
 	m_mesh.updateVertexNormals(vd);
 }
 
-void RigidBodyGeometry::updateMeshTransformation(const Vector3r &x, const Matrix3r &R)
+void RigidBodyGeometry::updateMeshTransformation(const Vector3r &x, const Matrix3r &R, const bool updateNormals)
 {
 	for (unsigned int i = 0; i < m_vertexData_local.size(); i++)
 	{
 		m_vertexData.getPosition(i) = R * m_vertexData_local.getPosition(i) + x;
 	}
-	updateMeshNormals(m_vertexData);
+	if (updateNormals)
+		updateMeshNormals(m_vertexData);
 }
 
 VertexData & RigidBodyGeometry::getVertexData()
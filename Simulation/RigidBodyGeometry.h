@@ -29,7 +29,8 @@ namespace PBD
 			const VertexData &getVertexDataLocal() const;
 
 			void initMesh(const unsigned int nVertices, const unsigned int nFaces, const Vector3r *vertices, const unsigned int* indices, const Mesh::UVIndices& uvIndices, const Mesh::UVs& uvs, const Vector3r &scale = Vector3r(1.0, 1.0, 1.0), const bool flatShading = false);
-			void updateMeshTransformation(const Vector3r &x, const Matrix3r &R);
+			/** Transform the mesh vertices. The normals are only updated if updateNormals is true. */
+			void updateMeshTransformation(const Vector3r &x, const Matrix3r &R, const bool updateNormals = true);
 			void updateMeshNormals(const VertexData &vd);
 			
 	};
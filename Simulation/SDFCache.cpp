@@ -0,0 +1,233 @@
+#include "SDFCache.h"
+#include "Utils/FileSystem.h"
+#include "Utils/Logger.h"
+#include "omp.h"
+
+using namespace PBD;
+using namespace Utilities;
+
+
+SDFCache::SDFCache(const std::string &cachePath) :
+	m_cachePath(cachePath)
+{
+	m_useFloatSDF = false;
+	m_bandWidth = FLT_MAX;
+	m_progressCallback = [](const unsigned int finished, const unsigned int total, const std::string &name)
+	{
+		LOG_INFO << "SDF " << finished << "/" << total << ": " << name;
+	};
+}
+
+SDFCache::~SDFCache()
+{
+	clear();
+}
+
+void SDFCache::clear()
+{
+	m_entries.clear();
+	m_keys.clear();
+}
+
+std::string SDFCache::computeKey(const VertexData &vd, const Utilities::IndexedFaceMesh &mesh, const Eigen::Matrix<unsigned int, 3, 1> &resolution)
+{
+	MD5 context;
+	if (vd.size() > 0)
+		context.update((unsigned char*)&vd.getPosition(0)[0], static_cast<unsigned int>(vd.size() * sizeof(Vector3r)));
+	const Utilities::IndexedFaceMesh::Faces &faces = mesh.getFaces();
+	if (faces.size() > 0)
+		context.update((unsigned char*)faces.data(), static_cast<unsigned int>(faces.size() * sizeof(unsigned int)));
+	context.finalize();
+	char *md5hex = context.hex_digest();
+	std::string key(md5hex);
+	delete[] md5hex;
+	return key + "_" + std::to_string(resolution[0]) + "_" + std::to_string(resolution[1]) + "_" + std::to_string(resolution[2]);
+}
+
+unsigned int SDFCache::requestSDF(const std::string &name, const VertexData &vd, const Utilities::IndexedFaceMesh &mesh, const Eigen::Matrix<unsigned int, 3, 1> &resolution)
+{
+	const std::string key = computeKey(vd, mesh, resolution);
+	std::map<std::string, unsigned int>::const_iterator it = m_keys.find(key);
+	if (it != m_keys.end())
+		return it->second;
+
+	const unsigned int index = static_cast<unsigned int>(m_entries.size());
+	m_keys[key] = index;
+	m_entries.resize(index + 1);
+	Entry &entry = m_entries[index];
+	entry.m_name = name;
+	entry.m_fileName = FileSystem::normalizePath(m_cachePath + "/" + key + ".cdf");
+	entry.m_floatFileName = FileSystem::normalizePath(m_cachePath + "/" + key + ".csdf");
+	entry.m_generate = true;
+	entry.m_resolution = resolution;
+
+	// copy the mesh since the field is generated later in double precision
+	entry.m_vertices.resize(3 * vd.size());
+	for (unsigned int i = 0; i < vd.size(); i++)
+		for (unsigned int j = 0; j < 3; j++)
+			entry.m_vertices[3 * i + j] = vd.getPosition(i)[j];
+	entry.m_faces = mesh.getFaces();
+	return index;
+}
+
+unsigned int SDFCache::requestSDFFile(const std::string &fileName, const std::string &basePath)
+{
+	std::string key = fileName;
+	if ((basePath != "") && FileSystem::isRelativePath(key))
+		key = basePath + "/" + key;
+	key = FileSystem::normalizePath(key);
+	std::map<std::string, unsigned int>::const_iterator it = m_keys.find(key);
+	if (it != m_keys.end())
+		return it->second;
+
+	const unsigned int index = static_cast<unsigned int>(m_entries.size());
+	m_keys[key] = index;
+	m_entries.resize(index + 1);
+	Entry &entry = m_entries[index];
+	entry.m_name = key;
+	entry.m_fileName = key;
+	entry.m_generate = false;
+	entry.m_resolution.setZero();
+	return index;
+}
+
+CubicSDFCollisionDetection::GridPtr SDFCache::generateGrid(const Entry &entry) const
+{
+	Discregrid::TriangleMesh sdfMesh(entry.m_vertices.data(), entry.m_faces.data(),
+		static_cast<unsigned int>(entry.m_vertices.size() / 3), static_cast<unsigned int>(entry.m_faces.size() / 3));
+	Discregrid::TriangleMeshDistance md(sdfMesh);
+	Eigen::AlignedBox3d domain;
+	for (auto const& x : sdfMesh.vertices())
+	{
+		domain.extend(x);
+	}
+	domain.max() += 0.1 * Eigen::Vector3d::Ones();
+	domain.min() -= 0.1 * Eigen::Vector3d::Ones();
+
+	CubicSDFCollisionDetection::GridPtr grid = std::make_shared<CubicSDFCollisionDetection::Grid>(domain,
+		std::array<unsigned int, 3>({ entry.m_resolution[0], entry.m_resolution[1], entry.m_resolution[2] }));
+	auto func = Discregrid::DiscreteGrid::ContinuousFunction{};
+	func = [&md](Eigen::Vector3d const& xi) {return md.signed_distance(xi).distance; };
+	grid->addFunction(func, false);
+	return grid;
+}
+
+void SDFCache::loadOrGenerate(Entry &entry)
+{
+	// file given by the user
+	if (!entry.m_generate)
+	{
+		if (!FileSystem::fileExists(entry.m_fileName))
+			return;
+		if (FloatCubicSDF::isFloatCubicSDFFile(entry.m_fileName))
+		{
+			FloatCubicSDFPtr sdf = std::make_shared<FloatCubicSDF>();
+			if (sdf->load(entry.m_fileName))
+				entry.m_floatSDF = sdf;
+		}
+		else
+			entry.m_grid = std::make_shared<CubicSDFCollisionDetection::Grid>(entry.m_fileName);
+		return;
+	}
+
+	// cached field
+	if (m_useFloatSDF && FloatCubicSDF::isFloatCubicSDFFile(entry.m_floatFileName))
+	{
+		FloatCubicSDFPtr sdf = std::make_shared<FloatCubicSDF>();
+		if (sdf->load(entry.m_floatFileName))
+		{
+			entry.m_floatSDF = sdf;
+			return;
+		}
+	}
+	const bool gridCached = FileSystem::fileExists(entry.m_fileName);
+	if (!m_useFloatSDF && gridCached)
+	{
+		entry.m_grid = std::make_shared<CubicSDFCollisionDetection::Grid>(entry.m_fileName);
+		return;
+	}
+
+	// Generate the grid if it is not cached
+	CubicSDFCollisionDetection::GridPtr grid;
+	if (gridCached)
+		grid = std::make_shared<CubicSDFCollisionDetection::Grid>(entry.m_fileName);
+	else
+	{
+		grid = generateGrid(entry);
+		grid->save(entry.m_fileName);
+	}
+
+	// Write the single precision field and use the memory mapped file. The grid is used
+	// if the file cannot be written or mapped.
+	if (m_useFloatSDF)
+	{
+		FloatCubicSDF floatSDF;
+		floatSDF.init(*grid, 0, m_bandWidth);
+		FloatCubicSDFPtr sdf = std::make_shared<FloatCubicSDF>();
+		if (floatSDF.save(entry.m_floatFileName) && sdf->load(entry.m_floatFileName))
+		{
+			entry.m_floatSDF = sdf;
+			return;
+		}
+		LOG_WARN << "Cannot write or map SDF: " << entry.m_floatFileName << ", using the grid";
+	}
+	entry.m_grid = grid;
+}
+
+void SDFCache::generate()
+{
+	std::vector<unsigned int> pending;
+	for (unsigned int i = 0; i < m_entries.size(); i++)
+	{
+		if ((m_entries[i].m_grid == nullptr) && (m_entries[i].m_floatSDF == nullptr))
+			pending.push_back(i);
+	}
+	if (pending.size() == 0)
+		return;
+
+	bool generateFields = false;
+	for (unsigned int i = 0; i < pending.size(); i++)
+		generateFields = generateFields || m_entries[pending[i]].m_generate;
+	if (generateFields && (FileSystem::makeDir(m_cachePath) != 0))
+		LOG_ERR << "Cannot create the SDF cache directory: " << m_cachePath;
+
+	// Fields of different meshes are generated concurrently if there are enough of them to
+	// keep all threads busy. Otherwise, they are generated one after another and Discregrid
+	// uses the threads to generate the cells (nested parallelism is disabled).
+	const int numPending = static_cast<int>(pending.size());
+	const bool concurrentFields = (numPending >= omp_get_max_threads()) && (numPending > 1);
+	unsigned int finished = 0;
+	#pragma omp parallel for schedule(dynamic, 1) if(concurrentFields) default(shared)
+	for (int i = 0; i < numPending; i++)
+	{
+		Entry &entry = m_entries[pending[i]];
+		loadOrGenerate(entry);
+
+		#pragma omp critical (sdfCacheProgress)
+		{
+			finished++;
+			if ((entry.m_grid == nullptr) && (entry.m_floatSDF == nullptr))
+				LOG_ERR << "Cannot load SDF: " << entry.m_fileName;
+			else if (m_progressCallback)
+				m_progressCallback(finished, static_cast<unsigned int>(numPending), entry.m_name);
+		}
+	}
+
+	// the mesh data is not required anymore
+	for (unsigned int i = 0; i < pending.size(); i++)
+	{
+		Entry &entry = m_entries[pending[i]];
+		std::vector<double>().swap(entry.m_vertices);
+		std::vector<unsigned int>().swap(entry.m_faces);
+	}
+}
+
+void SDFCache::addCollisionObject(CubicSDFCollisionDetection &cd, const unsigned int index, const unsigned int bodyIndex, const unsigned int bodyType,
+	const Vector3r *vertices, const unsigned int numVertices, const Vector3r &scale, const bool testMesh, const bool invertSDF) const
+{
+	const Entry &entry = m_entries[index];
+	if (entry.m_floatSDF != nullptr)
+		cd.addCubicSDFCollisionObject(bodyIndex, bodyType, vertices, numVertices, entry.m_floatSDF, scale, testMesh, invertSDF);
+	else if (entry.m_grid != nullptr)
+		cd.addCubicSDFCollisionObject(bodyIndex, bodyType, vertices, numVertices, entry.m_grid, scale, testMesh, invertSDF);
+}
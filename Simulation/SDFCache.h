@@ -0,0 +1,110 @@
+#ifndef __SDFCACHE_H__
+#define __SDFCACHE_H__
+
+#include "Common/Common.h"
+#include "Simulation/CubicSDFCollisionDetection.h"
+#include "Simulation/ParticleData.h"
+#include "Utils/IndexedFaceMesh.h"
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace PBD
+{
+	/** Cache for the signed distance fields of the meshes in a scene.
+	 *
+	 * The fields are stored in a cache directory. The key of a field is the MD5 hash
+	 * of the mesh (vertices and faces) and the resolution of the field. Therefore,
+	 * identical meshes share a field independent of their file names and a modified
+	 * mesh gets a new field.
+	 *
+	 * First all fields of a scene are requested. Then generate() loads the cached
+	 * fields and generates the missing ones. Fields of different meshes are generated
+	 * concurrently if there are enough of them to use all threads. Otherwise, they are
+	 * generated one after another and Discregrid uses the threads for the cells.
+	 *
+	 * A generated field is cached as Discregrid grid (<key>.cdf). If setUseFloatSDF() is
+	 * enabled, it is also cached as single precision field in the memory mappable format
+	 * of FloatCubicSDF (<key>.csdf) and the collision objects use the mapped field.
+	 */
+	class SDFCache
+	{
+	public:
+		/** Called when a field is available: (number of finished fields, number of fields, name of the field) */
+		typedef std::function<void(const unsigned int, const unsigned int, const std::string &)> ProgressCallback;
+
+		struct Entry
+		{
+			/** Name which is used in the progress report (e.g. the mesh file) */
+			std::string m_name;
+			/** File of the field (cache file of the grid or a file given by the user) */
+			std::string m_fileName;
+			/** Cache file of the single precision field (empty for a file given by the user) */
+			std::string m_floatFileName;
+			/** true if the field must be generated if m_fileName does not exist */
+			bool m_generate;
+			Eigen::Matrix<unsigned int, 3, 1> m_resolution;
+			/** Mesh data which is only kept until the field is generated */
+			std::vector<double> m_vertices;
+			std::vector<unsigned int> m_faces;
+
+			CubicSDFCollisionDetection::GridPtr m_grid;
+			/** Field if m_fileName is a (sparse) field in the format of FloatCubicSDF */
+			FloatCubicSDFPtr m_floatSDF;
+		};
+
+	protected:
+		std::string m_cachePath;
+		std::vector<Entry> m_entries;
+		/** Map from the key of a field to its index in m_entries */
+		std::map<std::string, unsigned int> m_keys;
+		ProgressCallback m_progressCallback;
+		/** Load the single precision fields of the cache instead of the grids */
+		bool m_useFloatSDF;
+		/** Band width of the cached single precision fields */
+		float m_bandWidth;
+
+		void loadOrGenerate(Entry &entry);
+		CubicSDFCollisionDetection::GridPtr generateGrid(const Entry &entry) const;
+
+	public:
+		SDFCache(const std::string &cachePath);
+		~SDFCache();
+
+		/** Compute the key of the field of a mesh with the given resolution. */
+		static std::string computeKey(const VertexData &vd, const Utilities::IndexedFaceMesh &mesh, const Eigen::Matrix<unsigned int, 3, 1> &resolution);
+
+		/** Request the field of a mesh. Returns the index of the field which is
+		 * the same for all requests with the same key.
+		 */
+		unsigned int requestSDF(const std::string &name, const VertexData &vd, const Utilities::IndexedFaceMesh &mesh, const Eigen::Matrix<unsigned int, 3, 1> &resolution);
+		/** Request a field which is stored in a file (Discregrid grid or FloatCubicSDF file).
+		 * A relative file name is relative to basePath. Returns the index of the field.
+		 */
+		unsigned int requestSDFFile(const std::string &fileName, const std::string &basePath = "");
+
+		/** Load or generate all requested fields which are not available yet. */
+		void generate();
+
+		/** Add a collision object which uses the field with the given index (after generate()). */
+		void addCollisionObject(CubicSDFCollisionDetection &cd, const unsigned int index, const unsigned int bodyIndex, const unsigned int bodyType,
+			const Vector3r *vertices, const unsigned int numVertices, const Vector3r &scale, const bool testMesh = true, const bool invertSDF = false) const;
+
+		void clear();
+
+		void setProgressCallback(ProgressCallback cb) { m_progressCallback = cb; }
+		bool getUseFloatSDF() const { return m_useFloatSDF; }
+		void setUseFloatSDF(const bool useFloatSDF) { m_useFloatSDF = useFloatSDF; }
+		float getBandWidth() const { return m_bandWidth; }
+		/** Set the band width of the single precision fields which are generated. The band width
+		 * is not part of the key, so existing cache files are not regenerated.
+		 */
+		void setBandWidth(const float bandWidth) { m_bandWidth = bandWidth; }
+		const std::string &getCachePath() const { return m_cachePath; }
+		unsigned int numEntries() const { return static_cast<unsigned int>(m_entries.size()); }
+		const Entry &getEntry(const unsigned int index) const { return m_entries[index]; }
+	};
+}
+
+#endif
@@ -3,12 +3,15 @@
 #include "Utils/Timing.h"
 #include "TimeStep.h"
 #include "TimeStepController.h"
+#include <mutex>
 
 using namespace PBD;
 using namespace std;
 using namespace GenParam;
 
-Simulation* Simulation::current = nullptr;
+thread_local Simulation* Simulation::current = nullptr;
+std::atomic<Simulation*> Simulation::processCurrent(nullptr);
+static std::mutex s_processCurrentMutex;
 int Simulation::GRAVITATION = -1;
 
 Simulation::Simulation () 
@@ -17,34 +20,77 @@ Simulation::Simulation ()
 
 	m_timeStep = nullptr;
 	m_model = nullptr;
+	m_timeManager = nullptr;
 }
 
 Simulation::~Simulation () 
 {
 	delete m_timeStep;
-	delete TimeManager::getCurrent();
+	delete m_timeManager;
+	if ((m_model != nullptr) && (m_model->getSimulation() == this))
+		m_model->setSimulation(nullptr);
 
-	current = nullptr;
+	if (current == this)
+		current = nullptr;
+	Simulation *sim = this;
+	processCurrent.compare_exchange_strong(sim, nullptr);
 }
 
 Simulation* Simulation::getCurrent ()
 {
-	if (current == nullptr)
+	if (current != nullptr)
+		return current;
+	Simulation *sim = processCurrent.load();
+	if (sim == nullptr)
 	{
-		current = new Simulation ();
-		current->init();
+		// only one simulation is created for all threads
+		std::lock_guard<std::mutex> lock(s_processCurrentMutex);
+		sim = processCurrent.load();
+		if (sim == nullptr)
+		{
+			sim = new Simulation ();
+			sim->init();
+			processCurrent = sim;
+		}
 	}
-	return current;
+	return sim;
 }
 
 void Simulation::setCurrent (Simulation* tm)
 {
 	current = tm;
+	if (tm != nullptr)
+		processCurrent = tm;
+}
+
+Simulation* Simulation::bindToThread (Simulation* sim)
+{
+	Simulation *last = current;
+	current = sim;
+	return last;
+}
+
+Simulation::ThreadBinding::ThreadBinding(Simulation *sim)
+{
+	m_lastSimulation = Simulation::bindToThread(sim);
+	m_lastTimeManager = TimeManager::bindToThread(sim->getTimeManager());
+}
+
+Simulation::ThreadBinding::~ThreadBinding()
+{
+	Simulation::bindToThread(m_lastSimulation);
+	TimeManager::bindToThread(m_lastTimeManager);
 }
 
 bool Simulation::hasCurrent()
 {
-	return (current != nullptr);
+	return (current != nullptr) || (processCurrent.load() != nullptr);
+}
+
+void Simulation::makeCurrent()
+{
+	setCurrent(this);
+	TimeManager::setCurrent(m_timeManager);
 }
 
 void Simulation::init()
@@ -53,7 +99,10 @@ void Simulation::init()
 	
 	m_timeStep = new TimeStepController();
 	m_timeStep->init();
-	TimeManager::getCurrent()->setTimeStepSize(static_cast<Real>(0.005));
+	// each simulation has its own time manager which becomes the current one
+	m_timeManager = new TimeManager();
+	m_timeManager->setTimeStepSize(static_cast<Real>(0.005));
+	TimeManager::setCurrent(m_timeManager);
 }
 
 void Simulation::initParameters()
@@ -71,6 +120,6 @@ void Simulation::reset()
 	if (m_timeStep)
 		m_timeStep->reset();
 
-	TimeManager::getCurrent()->setTime(static_cast<Real>(0.0));
+	m_timeManager->setTime(static_cast<Real>(0.0));
 }
 
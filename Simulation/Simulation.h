@@ -5,12 +5,17 @@
 #include "SimulationModel.h"
 #include "ParameterObject.h"
 #include "TimeStep.h"
+#include "TimeManager.h"
+#include <atomic>
 
 
 namespace PBD
 {
 	/** \brief Class to manage the current simulation time and the time step size. 
-	* This class is a singleton.
+	* The current simulation is bound per thread, so independent simulations
+	* can be performed in different threads (see makeCurrent()). Threads without a
+	* bound simulation (e.g. OpenMP worker threads) use the one which was made
+	* current last in the process.
 	*/
 	class Simulation : public GenParam::ParameterObject
 	{
@@ -20,13 +25,17 @@ namespace PBD
 	protected:
 		SimulationModel *m_model;
 		TimeStep *m_timeStep;
+		/** Time manager of the simulation which is created by init() */
+		TimeManager *m_timeManager;
 		Vector3r m_gravitation;
 
 		virtual void initParameters();
 		
 
 	private:
-		static Simulation *current;
+		static thread_local Simulation *current;
+		/** Simulation which was made current last in any thread */
+		static std::atomic<Simulation*> processCurrent;
 
 	public:
 		Simulation ();
@@ -37,16 +46,47 @@ namespace PBD
 		void init();
 		void reset();
 
-		// Singleton
+		/** Return the simulation of the calling thread or the one of the process if no
+		* simulation is bound to the thread. A simulation is only created if there
+		* is none in the process. */
 		static Simulation* getCurrent ();
 		static void setCurrent (Simulation* tm);
 		static bool hasCurrent();
+		/** Bind the simulation to the calling thread only, the one of the process is not
+		* changed. Return the simulation which was bound to the thread before (may be null). */
+		static Simulation* bindToThread (Simulation* sim);
+
+		/** Binds a simulation and its time manager to the calling thread while the guard
+		* exists and restores the previous binding of the thread afterwards (also if an
+		* exception is thrown). The current simulation of the process is not changed.
+		*/
+		class ThreadBinding
+		{
+		public:
+			ThreadBinding(Simulation *sim);
+			~ThreadBinding();
+			ThreadBinding(const ThreadBinding&) = delete;
+			ThreadBinding& operator=(const ThreadBinding&) = delete;
+
+		private:
+			Simulation *m_lastSimulation;
+			TimeManager *m_lastTimeManager;
+		};
+
+		/** Make this simulation and its time manager the current ones of the calling thread. 
+		* This is required before a step is performed in another thread than the one 
+		* which initialized the simulation.
+		*/
+		void makeCurrent();
 
 		SimulationModel *getModel() { return m_model; }
-		void setModel(SimulationModel *model) { m_model = model; }
+		/** Set the model and make this simulation its context. */
+		void setModel(SimulationModel *model) { m_model = model; if (model != nullptr) model->setSimulation(this); }
 
 		TimeStep *getTimeStep() { return m_timeStep; }
 		void setTimeStep(TimeStep *ts) { m_timeStep = ts; }
+
+		TimeManager *getTimeManager() { return m_timeManager; }
 	};
 }
 
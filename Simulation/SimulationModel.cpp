@@ -1,6 +1,9 @@
 #include "SimulationModel.h"
 #include "PositionBasedDynamics/PositionBasedRigidBodyDynamics.h"
+#include "PositionBasedDynamics/PositionBasedDynamics.h"
 #include "Constraints.h"
+#include "Simulation.h"
+#include <algorithm>
 
 using namespace PBD;
 using namespace GenParam;
@@ -49,12 +52,25 @@ int SimulationModel::ROD_TWISTING_STIFFNESS = -1;
 
 int SimulationModel::CONTACT_STIFFNESS_RB = -1;
 int SimulationModel::CONTACT_STIFFNESS_PARTICLE_RB = -1;
+int SimulationModel::CONTACT_WARM_STARTING = -1;
+
+int SimulationModel::UPDATE_NORMALS = -1;
+
+int SimulationModel::SOLVER_METHOD = -1;
+int SimulationModel::ENUM_SOLVER_GAUSS_SEIDEL = -1;
+int SimulationModel::ENUM_SOLVER_JACOBI = -1;
+int SimulationModel::JACOBI_RELAXATION = -1;
 
 
 SimulationModel::SimulationModel()
 {
 	m_contactStiffnessRigidBody = 1.0;
 	m_contactStiffnessParticleRigidBody = 100.0;
+	m_contactWarmStarting = 0.0;
+	m_updateNormals = true;
+	m_simulation = nullptr;
+	m_solverMethod = 0;
+	m_jacobiRelaxation = static_cast<Real>(1.5);
 
 	m_clothSimulationMethod = 2;
 	m_clothBendingMethod = 2;
@@ -83,6 +99,8 @@ SimulationModel::SimulationModel()
 	m_rod_twistingStiffness = static_cast<Real>(0.5);
 
 	m_groupsInitialized = false;
+	m_jacobiData.m_initialized = false;
+	m_femTetBatchData.m_initialized = false;
 
 	m_rigidBodyContactConstraints.reserve(10000);
 	m_particleRigidBodyContactConstraints.reserve(10000);
@@ -97,6 +115,18 @@ SimulationModel::~SimulationModel(void)
 	cleanup();
 }
 
+Simulation *SimulationModel::getSimulation()
+{
+	if (m_simulation != nullptr)
+		return m_simulation;
+	return Simulation::getCurrent();
+}
+
+TimeManager *SimulationModel::getTimeManager()
+{
+	return getSimulation()->getTimeManager();
+}
+
 void SimulationModel::init()
 {
 	initParameters();
@@ -105,6 +135,7 @@ void SimulationModel::init()
 void SimulationModel::cleanup()
 {
 	resetContacts();
+	clearContactImpulseCache();
 	for (unsigned int i = 0; i < m_rigidBodies.size(); i++)
 		delete m_rigidBodies[i];
 	m_rigidBodies.clear();
@@ -118,8 +149,12 @@ void SimulationModel::cleanup()
 		delete m_lineModels[i];
 	m_lineModels.clear();
 	for (unsigned int i = 0; i < m_constraints.size(); i++)
-		delete m_constraints[i];
+	{
+		if (!m_constraintArena.owns(m_constraints[i]))
+			delete m_constraints[i];
+	}
 	m_constraints.clear();
+	m_constraintArena.clear();
 	m_particles.release();
 	m_orientations.release();
 	m_groupsInitialized = false;
@@ -265,17 +300,41 @@ void SimulationModel::initParameters()
 	setGroup(CONTACT_STIFFNESS_PARTICLE_RB, "Simulation|Contact");
 	setDescription(CONTACT_STIFFNESS_PARTICLE_RB, "Stiffness coefficient for particle-rigid contact resolution.");
 	static_cast<NumericParameter<Real>*>(getParameter(CONTACT_STIFFNESS_PARTICLE_RB))->setMinValue(0.0);
+
+	CONTACT_WARM_STARTING = createNumericParameter<Real>("contactWarmStarting", "Contact warm starting", std::bind(&SimulationModel::getContactWarmStarting, this), std::bind(static_cast<void (SimulationModel::*)(const Real)>(&SimulationModel::setContactWarmStarting), this, std::placeholders::_1));
+	setGroup(CONTACT_WARM_STARTING, "Simulation|Contact");
+	setDescription(CONTACT_WARM_STARTING, "Factor for the accumulated impulses of the rigid-rigid contacts in the last step which are applied before the velocity solve (0 = no warm starting).");
+	static_cast<NumericParameter<Real>*>(getParameter(CONTACT_WARM_STARTING))->setMinValue(0.0);
+	static_cast<NumericParameter<Real>*>(getParameter(CONTACT_WARM_STARTING))->setMaxValue(1.0);
+
+	UPDATE_NORMALS = createBoolParameter("updateNormals", "Update normals", std::bind(&SimulationModel::getUpdateNormals, this), std::bind(static_cast<void (SimulationModel::*)(const bool)>(&SimulationModel::setUpdateNormals), this, std::placeholders::_1));
+	setGroup(UPDATE_NORMALS, "Simulation|General");
+	setDescription(UPDATE_NORMALS, "Update the normals of the rigid body meshes in each step. The normals are only required for rendering, so this can be disabled for headless simulations.");
+
+	SOLVER_METHOD = createEnumParameter("solverMethod", "Solver method", std::bind(&SimulationModel::getSolverMethod, this), std::bind(&SimulationModel::setSolverMethod, this, std::placeholders::_1));
+	setGroup(SOLVER_METHOD, "Simulation|Solver");
+	setDescription(SOLVER_METHOD, "Solver of the position constraints. Gauss-Seidel solves the independent constraint groups one after another. Jacobi solves all particle constraints in parallel and averages their corrections, which avoids a synchronization per constraint group.");
+	enumParam = static_cast<EnumParameter*>(getParameter(SOLVER_METHOD));
+	enumParam->addEnumValue("Gauss-Seidel", ENUM_SOLVER_GAUSS_SEIDEL);
+	enumParam->addEnumValue("Jacobi", ENUM_SOLVER_JACOBI);
+
+	JACOBI_RELAXATION = createNumericParameter<Real>("jacobiRelaxation", "Jacobi relaxation", std::bind(&SimulationModel::getJacobiRelaxation, this), std::bind(&SimulationModel::setJacobiRelaxation, this, std::placeholders::_1));
+	setGroup(JACOBI_RELAXATION, "Simulation|Solver");
+	setDescription(JACOBI_RELAXATION, "Relaxation factor of the Jacobi solver. The corrections of a particle are averaged and multiplied by this factor.");
+	static_cast<NumericParameter<Real>*>(getParameter(JACOBI_RELAXATION))->setMinValue(0.0);
+	static_cast<NumericParameter<Real>*>(getParameter(JACOBI_RELAXATION))->setMaxValue(2.0);
 }
 
 void SimulationModel::reset()
 {
 	resetContacts();
+	clearContactImpulseCache();
 
 	// rigid bodies
 	for (size_t i = 0; i < m_rigidBodies.size(); i++)
 	{
 		m_rigidBodies[i]->reset();
-		m_rigidBodies[i]->getGeometry().updateMeshTransformation(m_rigidBodies[i]->getPosition(), m_rigidBodies[i]->getRotationMatrix());
+		m_rigidBodies[i]->getGeometry().updateMeshTransformation(m_rigidBodies[i]->getPosition(), m_rigidBodies[i]->getRotationMatrix(), m_updateNormals);
 	}
 
 	// particles
@@ -367,7 +426,7 @@ void SimulationModel::updateConstraints()
 
 bool SimulationModel::addBallJoint(const unsigned int rbIndex1, const unsigned int rbIndex2, const Vector3r &pos)
 {
-	BallJoint *bj = new BallJoint();
+	BallJoint *bj = m_constraintArena.create<BallJoint>();
 	const bool res = bj->initConstraint(*this, rbIndex1, rbIndex2, pos);
 	if (res)
 	{
@@ -379,7 +438,7 @@ bool SimulationModel::addBallJoint(const unsigned int rbIndex1, const unsigned i
 
 bool SimulationModel::addBallOnLineJoint(const unsigned int rbIndex1, const unsigned int rbIndex2, const Vector3r &pos, const Vector3r &dir)
 {
-	BallOnLineJoint *bj = new BallOnLineJoint();
+	BallOnLineJoint *bj = m_constraintArena.create<BallOnLineJoint>();
 	const bool res = bj->initConstraint(*this, rbIndex1, rbIndex2, pos, dir);
 	if (res)
 	{
@@ -391,7 +450,7 @@ bool SimulationModel::addBallOnLineJoint(const unsigned int rbIndex1, const unsi
 
 bool SimulationModel::addHingeJoint(const unsigned int rbIndex1, const unsigned int rbIndex2, const Vector3r &pos, const Vector3r &axis)
 {
-	HingeJoint *hj = new HingeJoint();
+	HingeJoint *hj = m_constraintArena.create<HingeJoint>();
 	const bool res = hj->initConstraint(*this, rbIndex1, rbIndex2, pos, axis);
 	if (res)
 	{
@@ -403,7 +462,7 @@ bool SimulationModel::addHingeJoint(const unsigned int rbIndex1, const unsigned
 
 bool SimulationModel::addUniversalJoint(const unsigned int rbIndex1, const unsigned int rbIndex2, const Vector3r &pos, const Vector3r &axis1, const Vector3r &axis2)
 {
-	UniversalJoint *uj = new UniversalJoint();
+	UniversalJoint *uj = m_constraintArena.create<UniversalJoint>();
 	const bool res = uj->initConstraint(*this, rbIndex1, rbIndex2, pos, axis1, axis2);
 	if (res)
 	{
@@ -415,7 +474,7 @@ bool SimulationModel::addUniversalJoint(const unsigned int rbIndex1, const unsig
 
 bool SimulationModel::addSliderJoint(const unsigned int rbIndex1, const unsigned int rbIndex2, const Vector3r &axis)
 {
-	SliderJoint *joint = new SliderJoint();
+	SliderJoint *joint = m_constraintArena.create<SliderJoint>();
 	const bool res = joint->initConstraint(*this, rbIndex1, rbIndex2, axis);
 	if (res)
 	{
@@ -427,7 +486,7 @@ bool SimulationModel::addSliderJoint(const unsigned int rbIndex1, const unsigned
 
 bool SimulationModel::addTargetPositionMotorSliderJoint(const unsigned int rbIndex1, const unsigned int rbIndex2, const Vector3r &axis)
 {
-	TargetPositionMotorSliderJoint *joint = new TargetPositionMotorSliderJoint();
+	TargetPositionMotorSliderJoint *joint = m_constraintArena.create<TargetPositionMotorSliderJoint>();
 	const bool res = joint->initConstraint(*this, rbIndex1, rbIndex2, axis);
 	if (res)
 	{
@@ -439,7 +498,7 @@ bool SimulationModel::addTargetPositionMotorSliderJoint(const unsigned int rbInd
 
 bool SimulationModel::addTargetVelocityMotorSliderJoint(const unsigned int rbIndex1, const unsigned int rbIndex2, const Vector3r &axis)
 {
-	TargetVelocityMotorSliderJoint *joint = new TargetVelocityMotorSliderJoint();
+	TargetVelocityMotorSliderJoint *joint = m_constraintArena.create<TargetVelocityMotorSliderJoint>();
 	const bool res = joint->initConstraint(*this, rbIndex1, rbIndex2, axis);
 	if (res)
 	{
@@ -452,7 +511,7 @@ bool SimulationModel::addTargetVelocityMotorSliderJoint(const unsigned int rbInd
 
 bool SimulationModel::addTargetAngleMotorHingeJoint(const unsigned int rbIndex1, const unsigned int rbIndex2, const Vector3r &pos, const Vector3r &axis)
 {
-	TargetAngleMotorHingeJoint *hj = new TargetAngleMotorHingeJoint();
+	TargetAngleMotorHingeJoint *hj = m_constraintArena.create<TargetAngleMotorHingeJoint>();
 	const bool res = hj->initConstraint(*this, rbIndex1, rbIndex2, pos, axis);
 	if (res)
 	{
@@ -464,7 +523,7 @@ bool SimulationModel::addTargetAngleMotorHingeJoint(const unsigned int rbIndex1,
 
 bool SimulationModel::addTargetVelocityMotorHingeJoint(const unsigned int rbIndex1, const unsigned int rbIndex2, const Vector3r &pos, const Vector3r &axis)
 {
-	TargetVelocityMotorHingeJoint *hj = new TargetVelocityMotorHingeJoint();
+	TargetVelocityMotorHingeJoint *hj = m_constraintArena.create<TargetVelocityMotorHingeJoint>();
 	const bool res = hj->initConstraint(*this, rbIndex1, rbIndex2, pos, axis);
 	if (res)
 	{
@@ -476,7 +535,7 @@ bool SimulationModel::addTargetVelocityMotorHingeJoint(const unsigned int rbInde
 
 bool SimulationModel::addDamperJoint(const unsigned int rbIndex1, const unsigned int rbIndex2, const Vector3r &axis, const Real stiffness)
 {
-	DamperJoint *joint = new DamperJoint();
+	DamperJoint *joint = m_constraintArena.create<DamperJoint>();
 	const bool res = joint->initConstraint(*this, rbIndex1, rbIndex2, axis, stiffness);
 	if (res)
 	{
@@ -488,7 +547,7 @@ bool SimulationModel::addDamperJoint(const unsigned int rbIndex1, const unsigned
 
 bool SimulationModel::addRigidBodyParticleBallJoint(const unsigned int rbIndex, const unsigned int particleIndex)
 {
-	RigidBodyParticleBallJoint *bj = new RigidBodyParticleBallJoint();
+	RigidBodyParticleBallJoint *bj = m_constraintArena.create<RigidBodyParticleBallJoint>();
 	const bool res = bj->initConstraint(*this, rbIndex, particleIndex);
 	if (res)
 	{
@@ -500,7 +559,7 @@ bool SimulationModel::addRigidBodyParticleBallJoint(const unsigned int rbIndex,
 
 bool SimulationModel::addRigidBodySpring(const unsigned int rbIndex1, const unsigned int rbIndex2, const Vector3r &pos1, const Vector3r &pos2, const Real stiffness)
 {
-	RigidBodySpring *s = new RigidBodySpring();
+	RigidBodySpring *s = m_constraintArena.create<RigidBodySpring>();
 	const bool res = s->initConstraint(*this, rbIndex1, rbIndex2, pos1, pos2, stiffness);
 	if (res)
 	{
@@ -512,7 +571,7 @@ bool SimulationModel::addRigidBodySpring(const unsigned int rbIndex1, const unsi
 
 bool SimulationModel::addDistanceJoint(const unsigned int rbIndex1, const unsigned int rbIndex2, const Vector3r &pos1, const Vector3r &pos2)
 {
-	DistanceJoint *j = new DistanceJoint();
+	DistanceJoint *j = m_constraintArena.create<DistanceJoint>();
 	const bool res = j->initConstraint(*this, rbIndex1, rbIndex2, pos1, pos2);
 	if (res)
 	{
@@ -525,11 +584,12 @@ bool SimulationModel::addDistanceJoint(const unsigned int rbIndex1, const unsign
 bool SimulationModel::addRigidBodyContactConstraint(const unsigned int rbIndex1, const unsigned int rbIndex2, 
 	const Vector3r &cp1, const Vector3r &cp2, 
 	const Vector3r &normal, const Real dist,
-	const Real restitutionCoeff, const Real frictionCoeff)
+	const Real restitutionCoeff, const Real frictionCoeff,
+	const unsigned int featureIndex)
 {
 	m_rigidBodyContactConstraints.emplace_back(RigidBodyContactConstraint());
 	RigidBodyContactConstraint &cc = m_rigidBodyContactConstraints.back();
-	const bool res = cc.initConstraint(*this, rbIndex1, rbIndex2, cp1, cp2, normal, dist, restitutionCoeff, m_contactStiffnessRigidBody, frictionCoeff);
+	const bool res = cc.initConstraint(*this, rbIndex1, rbIndex2, cp1, cp2, normal, dist, restitutionCoeff, m_contactStiffnessRigidBody, frictionCoeff, featureIndex);
 	if (!res)
 		m_rigidBodyContactConstraints.pop_back();
 	return res;
@@ -564,7 +624,7 @@ bool SimulationModel::addParticleSolidContactConstraint(const unsigned int parti
 
 bool SimulationModel::addDistanceConstraint(const unsigned int particle1, const unsigned int particle2, const Real stiffness)
 {
-	DistanceConstraint *c = new DistanceConstraint();
+	DistanceConstraint *c = m_constraintArena.create<DistanceConstraint>();
 	const bool res = c->initConstraint(*this, particle1, particle2, stiffness);
 	if (res)
 	{
@@ -576,7 +636,7 @@ bool SimulationModel::addDistanceConstraint(const unsigned int particle1, const
 
 bool SimulationModel::addDistanceConstraint_XPBD(const unsigned int particle1, const unsigned int particle2, const Real stiffness)
 {
-	DistanceConstraint_XPBD* c = new DistanceConstraint_XPBD();
+	DistanceConstraint_XPBD* c = m_constraintArena.create<DistanceConstraint_XPBD>();
 	const bool res = c->initConstraint(*this, particle1, particle2, stiffness);
 	if (res)
 	{
@@ -589,7 +649,7 @@ bool SimulationModel::addDistanceConstraint_XPBD(const unsigned int particle1, c
 bool SimulationModel::addDihedralConstraint(const unsigned int particle1, const unsigned int particle2, 
 											const unsigned int particle3, const unsigned int particle4, const Real stiffness)
 {
-	DihedralConstraint *c = new DihedralConstraint();
+	DihedralConstraint *c = m_constraintArena.create<DihedralConstraint>();
 	const bool res = c->initConstraint(*this, particle1, particle2, particle3, particle4, stiffness);
 	if (res)
 	{
@@ -602,7 +662,7 @@ bool SimulationModel::addDihedralConstraint(const unsigned int particle1, const
 bool SimulationModel::addIsometricBendingConstraint(const unsigned int particle1, const unsigned int particle2,
 													const unsigned int particle3, const unsigned int particle4, const Real stiffness)
 {
-	IsometricBendingConstraint *c = new IsometricBendingConstraint();
+	IsometricBendingConstraint *c = m_constraintArena.create<IsometricBendingConstraint>();
 	const bool res = c->initConstraint(*this, particle1, particle2, particle3, particle4, stiffness);
 	if (res)
 	{
@@ -615,7 +675,7 @@ bool SimulationModel::addIsometricBendingConstraint(const unsigned int particle1
 bool SimulationModel::addIsometricBendingConstraint_XPBD(const unsigned int particle1, const unsigned int particle2,
 														const unsigned int particle3, const unsigned int particle4, const Real stiffness)
 {
-	IsometricBendingConstraint_XPBD* c = new IsometricBendingConstraint_XPBD();
+	IsometricBendingConstraint_XPBD* c = m_constraintArena.create<IsometricBendingConstraint_XPBD>();
 	const bool res = c->initConstraint(*this, particle1, particle2, particle3, particle4, stiffness);
 	if (res)
 	{
@@ -629,7 +689,7 @@ bool SimulationModel::addFEMTriangleConstraint(const unsigned int particle1, con
 	const unsigned int particle3, const Real xxStiffness, const Real yyStiffness, const Real xyStiffness,
 	const Real xyPoissonRatio, const Real yxPoissonRatio)
 {
-	FEMTriangleConstraint *c = new FEMTriangleConstraint();
+	FEMTriangleConstraint *c = m_constraintArena.create<FEMTriangleConstraint>();
 	const bool res = c->initConstraint(*this, particle1, particle2, particle3, xxStiffness, 
 		yyStiffness, xyStiffness, xyPoissonRatio, yxPoissonRatio);
 	if (res)
@@ -644,7 +704,7 @@ bool SimulationModel::addStrainTriangleConstraint(const unsigned int particle1,
 	const unsigned int particle3, const Real xxStiffness, const Real yyStiffness, const Real xyStiffness,
 	const bool normalizeStretch, const bool normalizeShear)
 {
-	StrainTriangleConstraint *c = new StrainTriangleConstraint();
+	StrainTriangleConstraint *c = m_constraintArena.create<StrainTriangleConstraint>();
 	const bool res = c->initConstraint(*this, particle1, particle2, particle3, xxStiffness, 
 		yyStiffness, xyStiffness, normalizeStretch, normalizeShear);
 	if (res)
@@ -658,7 +718,7 @@ bool SimulationModel::addStrainTriangleConstraint(const unsigned int particle1,
 bool SimulationModel::addVolumeConstraint(const unsigned int particle1, const unsigned int particle2,
 										const unsigned int particle3, const unsigned int particle4, const Real stiffness)
 {
-	VolumeConstraint *c = new VolumeConstraint();
+	VolumeConstraint *c = m_constraintArena.create<VolumeConstraint>();
 	const bool res = c->initConstraint(*this, particle1, particle2, particle3, particle4, stiffness);
 	if (res)
 	{
@@ -671,7 +731,7 @@ bool SimulationModel::addVolumeConstraint(const unsigned int particle1, const un
 bool SimulationModel::addVolumeConstraint_XPBD(const unsigned int particle1, const unsigned int particle2,
 	const unsigned int particle3, const unsigned int particle4, const Real stiffness)
 {
-	VolumeConstraint_XPBD* c = new VolumeConstraint_XPBD();
+	VolumeConstraint_XPBD* c = m_constraintArena.create<VolumeConstraint_XPBD>();
 	const bool res = c->initConstraint(*this, particle1, particle2, particle3, particle4, stiffness);
 	if (res)
 	{
@@ -685,7 +745,7 @@ bool SimulationModel::addFEMTetConstraint(const unsigned int particle1, const un
 										const unsigned int particle3, const unsigned int particle4, 
 										const Real stiffness, const Real poissonRatio)
 {
-	FEMTetConstraint *c = new FEMTetConstraint();
+	FEMTetConstraint *c = m_constraintArena.create<FEMTetConstraint>();
 	const bool res = c->initConstraint(*this, particle1, particle2, particle3, particle4, stiffness, poissonRatio);
 	if (res)
 	{
@@ -699,7 +759,7 @@ bool SimulationModel::addFEMTetConstraint_XPBD(const unsigned int particle1, con
 										const unsigned int particle3, const unsigned int particle4, 
 										const Real stiffness, const Real poissonRatio)
 {
-	XPBD_FEMTetConstraint *c = new XPBD_FEMTetConstraint();
+	XPBD_FEMTetConstraint *c = m_constraintArena.create<XPBD_FEMTetConstraint>();
 	const bool res = c->initConstraint(*this, particle1, particle2, particle3, particle4, stiffness, poissonRatio);
 	if (res)
 	{
@@ -714,7 +774,7 @@ bool SimulationModel::addStrainTetConstraint(const unsigned int particle1, const
 										const Real stretchStiffness, const Real shearStiffness, 
 										const bool normalizeStretch, const bool normalizeShear)
 {
-	StrainTetConstraint *c = new StrainTetConstraint();
+	StrainTetConstraint *c = m_constraintArena.create<StrainTetConstraint>();
 	const bool res = c->initConstraint(*this, particle1, particle2, particle3, particle4, stretchStiffness, shearStiffness, 
 		normalizeStretch, normalizeShear);
 	if (res)
@@ -727,7 +787,7 @@ bool SimulationModel::addStrainTetConstraint(const unsigned int particle1, const
 
 bool SimulationModel::addShapeMatchingConstraint(const unsigned int numberOfParticles, const unsigned int particleIndices[], const unsigned int numClusters[], const Real stiffness)
 {
-	ShapeMatchingConstraint *c = new ShapeMatchingConstraint(numberOfParticles);
+	ShapeMatchingConstraint *c = m_constraintArena.create<ShapeMatchingConstraint>(numberOfParticles);
 	const bool res = c->initConstraint(*this, particleIndices, numClusters, stiffness);
 	if (res)
 	{
@@ -741,7 +801,7 @@ bool SimulationModel::addStretchShearConstraint(const unsigned int particle1, co
 	const unsigned int quaternion1, const Real stretchingStiffness,
 	const Real shearingStiffness1, const Real shearingStiffness2)
 {
-	StretchShearConstraint *c = new StretchShearConstraint();
+	StretchShearConstraint *c = m_constraintArena.create<StretchShearConstraint>();
 	const bool res = c->initConstraint(*this, particle1, particle2, quaternion1, stretchingStiffness, shearingStiffness1, shearingStiffness2);
 	if (res)
 	{
@@ -755,7 +815,7 @@ bool SimulationModel::addBendTwistConstraint(const unsigned int quaternion1,
 	const unsigned int quaternion2, const Real twistingStiffness,
 	const Real bendingStiffness1, const Real bendingStiffness2)
 {
-	BendTwistConstraint *c = new BendTwistConstraint();
+	BendTwistConstraint *c = m_constraintArena.create<BendTwistConstraint>();
 	const bool res = c->initConstraint(*this, quaternion1, quaternion2, twistingStiffness, bendingStiffness1, bendingStiffness2);
 	if (res)
 	{
@@ -774,7 +834,7 @@ bool PBD::SimulationModel::addStretchBendingTwistingConstraint(
 	const Real youngsModulus,
 	const Real torsionModulus)
 {
-	StretchBendingTwistingConstraint *c = new StretchBendingTwistingConstraint();
+	StretchBendingTwistingConstraint *c = m_constraintArena.create<StretchBendingTwistingConstraint>();
 	const bool res = c->initConstraint(*this, rbIndex1, rbIndex2, pos,
 		averageRadius, averageSegmentLength, youngsModulus, torsionModulus);
 	if (res)
@@ -794,7 +854,7 @@ bool PBD::SimulationModel::addDirectPositionBasedSolverForStiffRodsConstraint(
 	const std::vector<Real> &torsionModuli
 	)
 {
-	DirectPositionBasedSolverForStiffRodsConstraint *c = new DirectPositionBasedSolverForStiffRodsConstraint();
+	DirectPositionBasedSolverForStiffRodsConstraint *c = m_constraintArena.create<DirectPositionBasedSolverForStiffRodsConstraint>();
 	const bool res = c->initConstraint(*this, jointSegmentIndices, jointPositions,
 		averageRadii, averageSegmentLengths, youngsModuli, torsionModuli);
 	if (res)
@@ -1090,7 +1150,127 @@ void SimulationModel::initConstraintGroups()
 	}
 	mapping.clear();
 
+	// Sort the constraints of each group by their type. The constraints of a group are
+	// independent, so the order does not matter and constraints of the same type
+	// can be solved in batches.
+	for (unsigned int j = 0; j < m_constraintGroups.size(); j++)
+	{
+		std::stable_sort(m_constraintGroups[j].begin(), m_constraintGroups[j].end(),
+			[&](const unsigned int a, const unsigned int b) { return m_constraints[a]->getTypeId() < m_constraints[b]->getTypeId(); });
+	}
+
 	m_groupsInitialized = true;
+	m_jacobiData.m_initialized = false;
+	m_femTetBatchData.m_initialized = false;
+}
+
+void SimulationModel::initJacobiData()
+{
+	const unsigned int numParticles = (unsigned int) m_particles.size();
+	JacobiData &jd = m_jacobiData;
+	if (jd.m_initialized && (jd.m_particleCorrectionStart.size() == numParticles + 1))
+		return;
+
+	// correction slots of the constraints
+	jd.m_constraints.clear();
+	jd.m_correctionStart.clear();
+	jd.m_correctionStart.push_back(0);
+	for (unsigned int i = 0; i < m_constraints.size(); i++)
+	{
+		if (m_constraints[i]->hasPositionCorrections())
+		{
+			jd.m_constraints.push_back(i);
+			jd.m_correctionStart.push_back(jd.m_correctionStart.back() + m_constraints[i]->numberOfBodies());
+		}
+	}
+	const unsigned int numCorrections = jd.m_correctionStart.back();
+	jd.m_corrections.resize(numCorrections);
+
+	// CSR map particle -> slots (counting sort)
+	jd.m_particleCorrectionStart.assign(numParticles + 1, 0);
+	for (unsigned int i = 0; i < jd.m_constraints.size(); i++)
+	{
+		const Constraint *constraint = m_constraints[jd.m_constraints[i]];
+		for (unsigned int k = 0; k < constraint->numberOfBodies(); k++)
+			jd.m_particleCorrectionStart[constraint->m_bodies[k] + 1]++;
+	}
+	for (unsigned int i = 0; i < numParticles; i++)
+		jd.m_particleCorrectionStart[i + 1] += jd.m_particleCorrectionStart[i];
+
+	jd.m_particleCorrections.resize(numCorrections);
+	std::vector<unsigned int> next(jd.m_particleCorrectionStart.begin(), jd.m_particleCorrectionStart.end() - 1);
+	for (unsigned int i = 0; i < jd.m_constraints.size(); i++)
+	{
+		const Constraint *constraint = m_constraints[jd.m_constraints[i]];
+		for (unsigned int k = 0; k < constraint->numberOfBodies(); k++)
+			jd.m_particleCorrections[next[constraint->m_bodies[k]]++] = jd.m_correctionStart[i] + k;
+	}
+
+	jd.m_initialized = true;
+}
+
+void SimulationModel::initFEMTetBatchData()
+{
+	FEMTetBatchData &bd = m_femTetBatchData;
+	if (bd.m_initialized)
+		return;
+
+	const unsigned int batchSize = PositionBasedDynamics::BatchSize;
+	const unsigned int blockSize = 10 * batchSize;
+	bd.m_restDataIndex.assign(m_constraints.size(), 0xffffffff);
+	bd.m_restData.clear();
+
+	// The runs of constraints of the same type in the groups are determined as in the solver.
+	// Only complete batches are solved by the batch solvers.
+	for (unsigned int group = 0; group < m_constraintGroups.size(); group++)
+	{
+		const ConstraintGroup &constraintGroup = m_constraintGroups[group];
+		const unsigned int groupSize = (unsigned int)constraintGroup.size();
+		unsigned int start = 0;
+		while (start < groupSize)
+		{
+			const int typeId = m_constraints[constraintGroup[start]]->getTypeId();
+			unsigned int end = start + 1;
+			while ((end < groupSize) && (m_constraints[constraintGroup[end]]->getTypeId() == typeId))
+				end++;
+
+			if ((typeId == FEMTetConstraint::TYPE_ID) || (typeId == XPBD_FEMTetConstraint::TYPE_ID))
+			{
+				const unsigned int numBatches = (end - start) / batchSize;
+				for (unsigned int b = 0; b < numBatches; b++)
+				{
+					const unsigned int block = (unsigned int)(bd.m_restData.size() / blockSize);
+					bd.m_restData.resize(bd.m_restData.size() + blockSize);
+					Real *restData = &bd.m_restData[block * blockSize];
+					for (unsigned int j = 0; j < batchSize; j++)
+					{
+						const unsigned int constraintIndex = constraintGroup[start + b * batchSize + j];
+						const Matrix3r *invRestMat;
+						Real volume;
+						if (typeId == FEMTetConstraint::TYPE_ID)
+						{
+							const FEMTetConstraint *c = static_cast<const FEMTetConstraint*>(m_constraints[constraintIndex]);
+							invRestMat = &c->m_invRestMat;
+							volume = c->m_volume;
+						}
+						else
+						{
+							const XPBD_FEMTetConstraint *c = static_cast<const XPBD_FEMTetConstraint*>(m_constraints[constraintIndex]);
+							invRestMat = &c->m_invRestMat;
+							volume = c->m_volume;
+						}
+						for (unsigned int k = 0; k < 9; k++)
+							restData[k * batchSize + j] = invRestMat->data()[k];
+						restData[9 * batchSize + j] = volume;
+						bd.m_restDataIndex[constraintIndex] = block * batchSize + j;
+					}
+				}
+			}
+			start = end;
+		}
+	}
+
+	bd.m_initialized = true;
 }
 
 void PBD::SimulationModel::setClothSimulationMethod(int val) 
@@ -1117,69 +1297,75 @@ void PBD::SimulationModel::setSolidSimulationMethod(int val)
 
 void SimulationModel::resetContacts()
 {
+	m_contactImpulseCache.clear();
+	if (m_contactWarmStarting > 0.0)
+	{
+		for (size_t i = 0; i < m_rigidBodyContactConstraints.size(); i++)
+		{
+			const RigidBodyContactConstraint &cc = m_rigidBodyContactConstraints[i];
+			if ((cc.m_featureIndex != RigidBodyContactConstraint::InvalidFeatureIndex) && (cc.m_sum_impulses > 0.0))
+				m_contactImpulseCache.push_back({ { cc.m_bodies[0], cc.m_bodies[1], cc.m_featureIndex }, cc.m_sum_impulses });
+		}
+		std::sort(m_contactImpulseCache.begin(), m_contactImpulseCache.end(), 
+			[](const std::pair<ContactKey, Real> &a, const std::pair<ContactKey, Real> &b) { return a.first < b.first; });
+	}
 	m_rigidBodyContactConstraints.clear();
 	m_particleRigidBodyContactConstraints.clear();
 	m_particleSolidContactConstraints.clear();
 }
 
+Real SimulationModel::getWarmStartImpulse(const unsigned int rbIndex1, const unsigned int rbIndex2, const unsigned int featureIndex) const
+{
+	if ((m_contactWarmStarting <= 0.0) || (featureIndex == RigidBodyContactConstraint::InvalidFeatureIndex))
+		return 0.0;
+	const ContactKey key = { rbIndex1, rbIndex2, featureIndex };
+	ContactImpulseCache::const_iterator it = std::lower_bound(m_contactImpulseCache.begin(), m_contactImpulseCache.end(), key, 
+		[](const std::pair<ContactKey, Real> &a, const ContactKey &k) { return a.first < k; });
+	if ((it == m_contactImpulseCache.end()) || !(it->first == key))
+		return 0.0;
+	return m_contactWarmStarting * it->second;
+}
+
 void SimulationModel::addClothConstraints(const TriangleModel* tm, const unsigned int clothMethod, 
 	const Real distanceStiffness, const Real xxStiffness, const Real yyStiffness, 
 	const Real xyStiffness,	const Real xyPoissonRatio, const Real yxPoissonRatio, 
 	const bool normalizeStretch, const bool normalizeShear)
 {
+	const unsigned int offset = tm->getIndexOffset();
+	const TriangleModel::ParticleMesh& mesh = tm->getParticleMesh();
+	const unsigned int nEdges = mesh.numEdges();
+	const Utilities::IndexedFaceMesh::Edge* edges = mesh.getEdges().data();
+	const unsigned int* tris = mesh.getFaces().data();
+	const unsigned int nFaces = mesh.numFaces();
 	if (clothMethod == 1)
 	{
-		const unsigned int offset = tm->getIndexOffset();
-		const unsigned int nEdges = tm->getParticleMesh().numEdges();
-		const Utilities::IndexedFaceMesh::Edge* edges = tm->getParticleMesh().getEdges().data();
-		for (unsigned int i = 0; i < nEdges; i++)
+		addConstraints<DistanceConstraint>(nEdges, [&](DistanceConstraint &c, const unsigned int i)
 		{
-			const unsigned int v1 = edges[i].m_vert[0] + offset;
-			const unsigned int v2 = edges[i].m_vert[1] + offset;
-
-			addDistanceConstraint(v1, v2, distanceStiffness);
-		}
+			return c.initConstraint(*this, edges[i].m_vert[0] + offset, edges[i].m_vert[1] + offset, distanceStiffness);
+		});
 	}
 	else if (clothMethod == 2)
 	{
-		const unsigned int offset = tm->getIndexOffset();
-		const TriangleModel::ParticleMesh& mesh = tm->getParticleMesh();
-		const unsigned int* tris = mesh.getFaces().data();
-		const unsigned int nFaces = mesh.numFaces();
-		for (unsigned int i = 0; i < nFaces; i++)
+		addConstraints<FEMTriangleConstraint>(nFaces, [&](FEMTriangleConstraint &c, const unsigned int i)
 		{
-			const unsigned int v1 = tris[3 * i] + offset;
-			const unsigned int v2 = tris[3 * i + 1] + offset;
-			const unsigned int v3 = tris[3 * i + 2] + offset;
-			addFEMTriangleConstraint(v1, v2, v3, xxStiffness, yyStiffness, xyStiffness, xyPoissonRatio, yxPoissonRatio);
-		}
+			return c.initConstraint(*this, tris[3 * i] + offset, tris[3 * i + 1] + offset, tris[3 * i + 2] + offset, 
+				xxStiffness, yyStiffness, xyStiffness, xyPoissonRatio, yxPoissonRatio);
+		});
 	}
 	else if (clothMethod == 3)
 	{
-		const unsigned int offset = tm->getIndexOffset();
-		const TriangleModel::ParticleMesh& mesh = tm->getParticleMesh();
-		const unsigned int* tris = mesh.getFaces().data();
-		const unsigned int nFaces = mesh.numFaces();
-		for (unsigned int i = 0; i < nFaces; i++)
+		addConstraints<StrainTriangleConstraint>(nFaces, [&](StrainTriangleConstraint &c, const unsigned int i)
 		{
-			const unsigned int v1 = tris[3 * i] + offset;
-			const unsigned int v2 = tris[3 * i + 1] + offset;
-			const unsigned int v3 = tris[3 * i + 2] + offset;
-			addStrainTriangleConstraint(v1, v2, v3, xxStiffness, yyStiffness, xyStiffness, normalizeStretch, normalizeShear);
-		}
+			return c.initConstraint(*this, tris[3 * i] + offset, tris[3 * i + 1] + offset, tris[3 * i + 2] + offset, 
+				xxStiffness, yyStiffness, xyStiffness, normalizeStretch, normalizeShear);
+		});
 	}
 	else if (clothMethod == 4)
 	{
-		const unsigned int offset = tm->getIndexOffset();
-		const unsigned int nEdges = tm->getParticleMesh().numEdges();
-		const Utilities::IndexedFaceMesh::Edge* edges = tm->getParticleMesh().getEdges().data();
-		for (unsigned int i = 0; i < nEdges; i++)
+		addConstraints<DistanceConstraint_XPBD>(nEdges, [&](DistanceConstraint_XPBD &c, const unsigned int i)
 		{
-			const unsigned int v1 = edges[i].m_vert[0] + offset;
-			const unsigned int v2 = edges[i].m_vert[1] + offset;
-
-			addDistanceConstraint_XPBD(v1, v2, distanceStiffness);
-		}
+			return c.initConstraint(*this, edges[i].m_vert[0] + offset, edges[i].m_vert[1] + offset, distanceStiffness);
+		});
 	}
 }
 
@@ -1193,6 +1379,10 @@ void SimulationModel::addBendingConstraints(const TriangleModel *tm, const unsig
 	unsigned int nEdges = mesh.numEdges();
 	const TriangleModel::ParticleMesh::Edge* edges = mesh.getEdges().data();
 	const unsigned int* tris = mesh.getFaces().data();
+
+	// collect the vertices of the bending elements
+	std::vector<std::array<unsigned int, 4>> elements;
+	elements.reserve(nEdges);
 	for (unsigned int i = 0; i < nEdges; i++)
 	{
 		const int tri1 = edges[i].m_face[0];
@@ -1221,22 +1411,35 @@ void SimulationModel::addBendingConstraints(const TriangleModel *tm, const unsig
 				}
 			}
 			if ((point1 != -1) && (point2 != -1))
-			{
-				const unsigned int vertex1 = point1 + offset;
-				const unsigned int vertex2 = point2 + offset;
-				const unsigned int vertex3 = edges[i].m_vert[0] + offset;
-				const unsigned int vertex4 = edges[i].m_vert[1] + offset;
-				if (bendingMethod == 1)
-					addDihedralConstraint(vertex1, vertex2, vertex3, vertex4, stiffness);
-				else if (bendingMethod == 2)
-					addIsometricBendingConstraint(vertex1, vertex2, vertex3, vertex4, stiffness);
-				else if (bendingMethod == 3)
-				{
-					addIsometricBendingConstraint_XPBD(vertex1, vertex2, vertex3, vertex4, stiffness);
-				}
-			}
+				elements.push_back({ point1 + offset, point2 + offset, edges[i].m_vert[0] + offset, edges[i].m_vert[1] + offset });
 		}
 	}
+
+	const unsigned int nElements = static_cast<unsigned int>(elements.size());
+	if (bendingMethod == 1)
+	{
+		addConstraints<DihedralConstraint>(nElements, [&](DihedralConstraint &c, const unsigned int i)
+		{
+			const std::array<unsigned int, 4> &v = elements[i];
+			return c.initConstraint(*this, v[0], v[1], v[2], v[3], stiffness);
+		});
+	}
+	else if (bendingMethod == 2)
+	{
+		addConstraints<IsometricBendingConstraint>(nElements, [&](IsometricBendingConstraint &c, const unsigned int i)
+		{
+			const std::array<unsigned int, 4> &v = elements[i];
+			return c.initConstraint(*this, v[0], v[1], v[2], v[3], stiffness);
+		});
+	}
+	else if (bendingMethod == 3)
+	{
+		addConstraints<IsometricBendingConstraint_XPBD>(nElements, [&](IsometricBendingConstraint_XPBD &c, const unsigned int i)
+		{
+			const std::array<unsigned int, 4> &v = elements[i];
+			return c.initConstraint(*this, v[0], v[1], v[2], v[3], stiffness);
+		});
+	}
 }
 
 void SimulationModel::addSolidConstraints(const TetModel* tm, const unsigned int solidMethod, const Real stiffness,
@@ -1247,71 +1450,46 @@ void SimulationModel::addSolidConstraints(const TetModel* tm, const unsigned int
 	const unsigned int* tets = tm->getParticleMesh().getTets().data();
 	const Utilities::IndexedTetMesh::VerticesTets& vTets = tm->getParticleMesh().getVertexTets();
 	const unsigned int offset = tm->getIndexOffset();
+	const unsigned int nEdges = tm->getParticleMesh().numEdges();
+	const Utilities::IndexedTetMesh::Edge* edges = tm->getParticleMesh().getEdges().data();
 	if (solidMethod == 1)
 	{
-		const unsigned int nEdges = tm->getParticleMesh().numEdges();
-		const Utilities::IndexedTetMesh::Edge* edges = tm->getParticleMesh().getEdges().data();
-		for (unsigned int i = 0; i < nEdges; i++)
+		addConstraints<DistanceConstraint>(nEdges, [&](DistanceConstraint &c, const unsigned int i)
 		{
-			const unsigned int v1 = edges[i].m_vert[0] + offset;
-			const unsigned int v2 = edges[i].m_vert[1] + offset;
-
-			addDistanceConstraint(v1, v2, stiffness);
-		}
-
-		for (unsigned int i = 0; i < nTets; i++)
+			return c.initConstraint(*this, edges[i].m_vert[0] + offset, edges[i].m_vert[1] + offset, stiffness);
+		});
+		addConstraints<VolumeConstraint>(nTets, [&](VolumeConstraint &c, const unsigned int i)
 		{
-			const unsigned int v1 = tets[4 * i] + offset;
-			const unsigned int v2 = tets[4 * i + 1] + offset;
-			const unsigned int v3 = tets[4 * i + 2] + offset;
-			const unsigned int v4 = tets[4 * i + 3] + offset;
-
-			addVolumeConstraint(v1, v2, v3, v4, volumeStiffness);
-		}
+			return c.initConstraint(*this, tets[4 * i] + offset, tets[4 * i + 1] + offset, tets[4 * i + 2] + offset, tets[4 * i + 3] + offset, volumeStiffness);
+		});
 	}
 	else if (solidMethod == 2)
 	{
-		const TetModel::ParticleMesh& mesh = tm->getParticleMesh();
-		for (unsigned int i = 0; i < nTets; i++)
+		addConstraints<FEMTetConstraint>(nTets, [&](FEMTetConstraint &c, const unsigned int i)
 		{
-			const unsigned int v1 = tets[4 * i] + offset;
-			const unsigned int v2 = tets[4 * i + 1] + offset;
-			const unsigned int v3 = tets[4 * i + 2] + offset;
-			const unsigned int v4 = tets[4 * i + 3] + offset;
-
-			addFEMTetConstraint(v1, v2, v3, v4, stiffness, poissonRatio);
-		}
+			return c.initConstraint(*this, tets[4 * i] + offset, tets[4 * i + 1] + offset, tets[4 * i + 2] + offset, tets[4 * i + 3] + offset, 
+				stiffness, poissonRatio);
+		});
 	}
 	else if (solidMethod == 3)
 	{
-		const TetModel::ParticleMesh& mesh = tm->getParticleMesh();
-		for (unsigned int i = 0; i < nTets; i++)
+		addConstraints<XPBD_FEMTetConstraint>(nTets, [&](XPBD_FEMTetConstraint &c, const unsigned int i)
 		{
-			const unsigned int v1 = tets[4 * i] + offset;
-			const unsigned int v2 = tets[4 * i + 1] + offset;
-			const unsigned int v3 = tets[4 * i + 2] + offset;
-			const unsigned int v4 = tets[4 * i + 3] + offset;
-
-			addFEMTetConstraint_XPBD(v1, v2, v3, v4, stiffness, poissonRatio);
-		}
+			return c.initConstraint(*this, tets[4 * i] + offset, tets[4 * i + 1] + offset, tets[4 * i + 2] + offset, tets[4 * i + 3] + offset, 
+				stiffness, poissonRatio);
+		});
 	}
 	else if (solidMethod == 4)
 	{
-		const TetModel::ParticleMesh& mesh = tm->getParticleMesh();
-		for (unsigned int i = 0; i < nTets; i++)
+		addConstraints<StrainTetConstraint>(nTets, [&](StrainTetConstraint &c, const unsigned int i)
 		{
-			const unsigned int v1 = tets[4 * i] + offset;
-			const unsigned int v2 = tets[4 * i + 1] + offset;
-			const unsigned int v3 = tets[4 * i + 2] + offset;
-			const unsigned int v4 = tets[4 * i + 3] + offset;
-
-			addStrainTetConstraint(v1, v2, v3, v4, stiffness, stiffness, normalizeStretch, normalizeStretch);
-		}
+			return c.initConstraint(*this, tets[4 * i] + offset, tets[4 * i + 1] + offset, tets[4 * i + 2] + offset, tets[4 * i + 3] + offset, 
+				stiffness, stiffness, normalizeStretch, normalizeStretch);
+		});
 	}
 	else if (solidMethod == 5)
 	{
-		const TetModel::ParticleMesh& mesh = tm->getParticleMesh();
-		for (unsigned int i = 0; i < nTets; i++)
+		addConstraints<ShapeMatchingConstraint>(nTets, [&](ShapeMatchingConstraint &c, const unsigned int i)
 		{
 			const unsigned int v[4] = { tets[4 * i] + offset,
 										tets[4 * i + 1] + offset,
@@ -1319,32 +1497,20 @@ void SimulationModel::addSolidConstraints(const TetModel* tm, const unsigned int
 										tets[4 * i + 3] + offset };
 			// Important: Divide position correction by the number of clusters 
 			// which contain the vertex.
-			const unsigned int nc[4] = { (unsigned int)vTets[v[0]-offset].size(), (unsigned int)vTets[v[1] - offset].size(), (unsigned int)vTets[v[2] - offset].size(), (unsigned int)vTets[v[3] - offset].size() };
-			addShapeMatchingConstraint(4, v, nc, stiffness);
-		}
+			const unsigned int nc[4] = { vTets.numNeighbors(v[0] - offset), vTets.numNeighbors(v[1] - offset), vTets.numNeighbors(v[2] - offset), vTets.numNeighbors(v[3] - offset) };
+			return c.initConstraint(*this, v, nc, stiffness);
+		}, 4u);
 	}
 	else if (solidMethod == 6)
 	{
-		const unsigned int offset = tm->getIndexOffset();
-		const unsigned int nEdges = tm->getParticleMesh().numEdges();
-		const Utilities::IndexedTetMesh::Edge* edges = tm->getParticleMesh().getEdges().data();
-		for (unsigned int i = 0; i < nEdges; i++)
+		addConstraints<DistanceConstraint_XPBD>(nEdges, [&](DistanceConstraint_XPBD &c, const unsigned int i)
 		{
-			const unsigned int v1 = edges[i].m_vert[0] + offset;
-			const unsigned int v2 = edges[i].m_vert[1] + offset;
-
-			addDistanceConstraint_XPBD(v1, v2, stiffness);
-		}
-
-		for (unsigned int i = 0; i < nTets; i++)
+			return c.initConstraint(*this, edges[i].m_vert[0] + offset, edges[i].m_vert[1] + offset, stiffness);
+		});
+		addConstraints<VolumeConstraint_XPBD>(nTets, [&](VolumeConstraint_XPBD &c, const unsigned int i)
 		{
-			const unsigned int v1 = tets[4 * i] + offset;
-			const unsigned int v2 = tets[4 * i + 1] + offset;
-			const unsigned int v3 = tets[4 * i + 2] + offset;
-			const unsigned int v4 = tets[4 * i + 3] + offset;
-
-			addVolumeConstraint_XPBD(v1, v2, v3, v4, volumeStiffness);
-		}
+			return c.initConstraint(*this, tets[4 * i] + offset, tets[4 * i + 1] + offset, tets[4 * i + 2] + offset, tets[4 * i + 3] + offset, volumeStiffness);
+		});
 	}
 }
 
@@ -8,11 +8,14 @@
 #include "TriangleModel.h"
 #include "TetModel.h"
 #include "LineModel.h"
+#include "ConstraintArena.h"
 #include "ParameterObject.h"
 
 namespace PBD 
 {	
 	class Constraint;
+	class Simulation;
+	class TimeManager;
 
 	class SimulationModel : public GenParam::ParameterObject
 	{
@@ -64,6 +67,14 @@ namespace PBD
 
 			static int CONTACT_STIFFNESS_RB;
 			static int CONTACT_STIFFNESS_PARTICLE_RB;
+			static int CONTACT_WARM_STARTING;
+
+			static int UPDATE_NORMALS;
+
+			static int SOLVER_METHOD;
+			static int ENUM_SOLVER_GAUSS_SEIDEL;
+			static int ENUM_SOLVER_JACOBI;
+			static int JACOBI_RELAXATION;
 
 			SimulationModel();
 			SimulationModel(const SimulationModel&) = delete;
@@ -84,6 +95,70 @@ namespace PBD
 			typedef std::vector<unsigned int> ConstraintGroup;
 			typedef std::vector<ConstraintGroup> ConstraintGroupVector;
 
+			/** Identifies a rigid body contact by the bodies and the contact feature
+			 * (vertex of the first body). 
+			 */
+			struct ContactKey
+			{
+				unsigned int m_body1;
+				unsigned int m_body2;
+				unsigned int m_feature;
+
+				bool operator==(const ContactKey &other) const 
+				{ 
+					return (m_body1 == other.m_body1) && (m_body2 == other.m_body2) && (m_feature == other.m_feature); 
+				}
+
+				bool operator<(const ContactKey &other) const
+				{
+					if (m_body1 != other.m_body1)
+						return m_body1 < other.m_body1;
+					if (m_body2 != other.m_body2)
+						return m_body2 < other.m_body2;
+					return m_feature < other.m_feature;
+				}
+			};
+
+			/** Impulses of the contacts of the last step sorted by their key. A sorted vector 
+			 * is used instead of a hash map since it keeps its memory when it is cleared.
+			 */
+			typedef std::vector<std::pair<ContactKey, Real>> ContactImpulseCache;
+
+			/** Data of the Jacobi solver. Each constraint which supports the Jacobi solver 
+			 * (see Constraint::hasPositionCorrections()) writes the corrections of its particles 
+			 * to its own slots. A CSR map from the particles to the slots is used to gather the 
+			 * corrections of each particle, so no atomic operations are required.
+			 */
+			struct JacobiData
+			{
+				/** Indices of the constraints which are solved by the Jacobi solver */
+				std::vector<unsigned int> m_constraints;
+				/** First correction slot of each Jacobi constraint (size: number of constraints + 1) */
+				std::vector<unsigned int> m_correctionStart;
+				/** Position corrections, one slot per particle of each Jacobi constraint */
+				std::vector<Vector3r> m_corrections;
+				/** The slots of particle i are m_particleCorrections[m_particleCorrectionStart[i]] 
+				 * to m_particleCorrections[m_particleCorrectionStart[i+1]-1]. */
+				std::vector<unsigned int> m_particleCorrectionStart;
+				std::vector<unsigned int> m_particleCorrections;
+				bool m_initialized;
+			};
+
+			/** Rest data of the FEM tet constraints in SoA layout for the batch solvers (see
+			 * FEMTetConstraint::solvePositionConstraints()). The runs of FEM tet constraints in
+			 * the constraint groups are solved in batches of PositionBasedDynamics::BatchSize
+			 * constraints. Each batch has a block with the entries of the inverse rest matrices
+			 * (column-major) followed by the rest volumes, each with one value per constraint.
+			 */
+			struct FEMTetBatchData
+			{
+				/** Index block * BatchSize + lane of each constraint in the blocks or 0xffffffff */
+				std::vector<unsigned int> m_restDataIndex;
+				/** Blocks of 10 * BatchSize values */
+				std::vector<Real> m_restData;
+				bool m_initialized;
+			};
+
 
 		protected:
 			RigidBodyVector m_rigidBodies;
@@ -93,10 +168,14 @@ namespace PBD
 			ParticleData m_particles;
 			OrientationData m_orientations;
 			ConstraintVector m_constraints;
+			/** storage of the constraints created by addConstraints() */
+			ConstraintArena m_constraintArena;
 			RigidBodyContactConstraintVector m_rigidBodyContactConstraints;
 			ParticleRigidBodyContactConstraintVector m_particleRigidBodyContactConstraints;
 			ParticleSolidContactConstraintVector m_particleSolidContactConstraints;
 			ConstraintGroupVector m_constraintGroups;
+			JacobiData m_jacobiData;
+			FEMTetBatchData m_femTetBatchData;
 
 			int m_clothSimulationMethod;
 			int m_clothBendingMethod;
@@ -126,6 +205,19 @@ namespace PBD
 
 			Real m_contactStiffnessRigidBody;
 			Real m_contactStiffnessParticleRigidBody;
+			/** Factor for the impulses of the last step which are used for warm starting. 0 disables warm starting. */
+			Real m_contactWarmStarting;
+			/** Accumulated impulses of the rigid body contacts of the last step */
+			ContactImpulseCache m_contactImpulseCache;
+			/** Update the normals of the rigid body meshes in each step. They are only required for rendering. */
+			bool m_updateNormals;
+			/** Solver of the position constraints: 0 = colored Gauss-Seidel, 1 = Jacobi */
+			int m_solverMethod;
+			/** Relaxation factor of the averaged Jacobi corrections */
+			Real m_jacobiRelaxation;
+
+			/** Simulation which performs the time steps of the model (see Simulation::setModel()) */
+			Simulation *m_simulation;
 
 			std::function<void()> m_clothSimMethodChanged;
 			std::function<void()> m_clothBendingMethodChanged;
@@ -148,7 +240,24 @@ namespace PBD
 			ConstraintGroupVector &getConstraintGroups();
 			bool m_groupsInitialized;
 
+			/** Return the simulation of the model. If no simulation was set, the current 
+			 * simulation of the calling thread is returned. The model, the time step and 
+			 * the constraints use this context instead of the global singletons, so that 
+			 * multiple simulations can be performed in parallel.
+			 */
+			Simulation *getSimulation();
+			void setSimulation(Simulation *simulation) { m_simulation = simulation; }
+			/** Return the time manager of the simulation of the model. */
+			TimeManager *getTimeManager();
+
+			/** Remove all contacts. If warm starting is enabled, the accumulated impulses 
+			 * of the rigid body contacts are cached for the next step.
+			 */
 			void resetContacts();
+			/** Discard the cached contact impulses, e.g. if the bodies were moved. */
+			void clearContactImpulseCache() { m_contactImpulseCache.clear(); }
+			/** Return the cached impulse of the last step times the warm starting factor or 0 if there is none. */
+			Real getWarmStartImpulse(const unsigned int rbIndex1, const unsigned int rbIndex2, const unsigned int featureIndex) const;
 
 			void addTriangleModel(
 				const unsigned int nPoints,
@@ -182,6 +291,14 @@ namespace PBD
 
 			void updateConstraints();
 			void initConstraintGroups();
+			/** Init the data of the Jacobi solver if the constraints have changed. 
+			 * The constraint groups must be initialized before. */
+			void initJacobiData();
+			JacobiData &getJacobiData() { return m_jacobiData; }
+			/** Init the rest data of the FEM tet batch solvers if the constraints have changed.
+			 * The constraint groups must be initialized before. */
+			void initFEMTetBatchData();
+			FEMTetBatchData &getFEMTetBatchData() { return m_femTetBatchData; }
 
 			bool addBallJoint(const unsigned int rbIndex1, const unsigned int rbIndex2, const Vector3r &pos);
 			bool addBallOnLineJoint(const unsigned int rbIndex1, const unsigned int rbIndex2, const Vector3r &pos, const Vector3r &dir);
@@ -199,7 +316,8 @@ namespace PBD
 			bool addRigidBodyContactConstraint(const unsigned int rbIndex1, const unsigned int rbIndex2, 
 					const Vector3r &cp1, const Vector3r &cp2,	
 					const Vector3r &normal, const Real dist, 
-					const Real restitutionCoeff, const Real frictionCoeff);
+					const Real restitutionCoeff, const Real frictionCoeff,
+					const unsigned int featureIndex = RigidBodyContactConstraint::InvalidFeatureIndex);
 			bool addParticleRigidBodyContactConstraint(const unsigned int particleIndex, const unsigned int rbIndex, 
 					const Vector3r &cp1, const Vector3r &cp2, 
 					const Vector3r &normal, const Real dist,
@@ -248,10 +366,57 @@ namespace PBD
 			bool addStretchBendingTwistingConstraint(const unsigned int rbIndex1, const unsigned int rbIndex2, const Vector3r &pos, const Real averageRadius, const Real averageSegmentLength, const Real youngsModulus, const Real torsionModulus);
 			bool addDirectPositionBasedSolverForStiffRodsConstraint(const std::vector<std::pair<unsigned int, unsigned int>> & jointSegmentIndices, const std::vector<Vector3r> &jointPositions, const std::vector<Real> &averageRadii, const std::vector<Real> &averageSegmentLengths, const std::vector<Real> &youngsModuli, const std::vector<Real> &torsionModuli);
 
+			/** Add numConstraints constraints of one type. The constraints are stored
+			 * in a single block of the constraint arena and initialized in parallel.
+			 * Constraints whose initialization fails are not added. The order of the 
+			 * added constraints is the order of their indices.
+			 *
+			 * @param numConstraints number of constraints
+			 * @param initFct bool(ConstraintType &c, const unsigned int i), initializes constraint i
+			 * @param args constructor arguments of the constraints
+			 * @return number of added constraints
+			 */
+			template<typename ConstraintType, typename InitFct, typename... Args>
+			unsigned int addConstraints(const unsigned int numConstraints, InitFct const& initFct, Args&&... args)
+			{
+				if (numConstraints == 0)
+					return 0;
+				ConstraintType *c = m_constraintArena.allocate<ConstraintType>(numConstraints, std::forward<Args>(args)...);
+				std::vector<unsigned char> valid(numConstraints);
+				const int n = static_cast<int>(numConstraints);
+				#pragma omp parallel if(n > MIN_PARALLEL_SIZE) default(shared)
+				{
+					#pragma omp for schedule(static)
+					for (int i = 0; i < n; i++)
+						valid[i] = initFct(c[i], static_cast<unsigned int>(i)) ? 1 : 0;
+				}
+
+				unsigned int numAdded = 0;
+				m_constraints.reserve(m_constraints.size() + numConstraints);
+				for (unsigned int i = 0; i < numConstraints; i++)
+				{
+					if (valid[i])
+					{
+						m_constraints.push_back(&c[i]);
+						numAdded++;
+					}
+				}
+				m_groupsInitialized = false;
+				return numAdded;
+			}
+
 			Real getContactStiffnessRigidBody() const { return m_contactStiffnessRigidBody; }
 			void setContactStiffnessRigidBody(Real val) { m_contactStiffnessRigidBody = val; }
 			Real getContactStiffnessParticleRigidBody() const { return m_contactStiffnessParticleRigidBody; }
 			void setContactStiffnessParticleRigidBody(Real val) { m_contactStiffnessParticleRigidBody = val; }
+			Real getContactWarmStarting() const { return m_contactWarmStarting; }
+			void setContactWarmStarting(Real val) { m_contactWarmStarting = val; }
+			bool getUpdateNormals() const { return m_updateNormals; }
+			void setUpdateNormals(bool val) { m_updateNormals = val; }
+			int getSolverMethod() const { return m_solverMethod; }
+			void setSolverMethod(const int val) { m_solverMethod = val; }
+			Real getJacobiRelaxation() const { return m_jacobiRelaxation; }
+			void setJacobiRelaxation(const Real val) { m_jacobiRelaxation = val; }
 		
 			void addClothConstraints(const TriangleModel* tm, const unsigned int clothMethod, 
 				const Real distanceStiffness, const Real xxStiffness, const Real yyStiffness,
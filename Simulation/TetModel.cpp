@@ -2,6 +2,7 @@
 #include "PositionBasedDynamics/PositionBasedDynamics.h"
 #include <iostream>
 #include "Utils/Logger.h"
+#include "TriangleMeshAABBTree.h"
 
 using namespace PBD;
 using namespace Utilities;
@@ -91,7 +92,7 @@ void TetModel::updateMeshNormals(const ParticleData &pd)
 	m_surfaceMesh.updateVertexNormals(pd);
 }
 
-void TetModel::attachVisMesh(const ParticleData &pd)
+void TetModel::attachVisMesh(const ParticleData &pd, const bool useBVH)
 {
 	const Real eps = static_cast<Real>(1.0e-6);
 
@@ -101,7 +102,21 @@ void TetModel::attachVisMesh(const ParticleData &pd)
 
  	const Vector3r *normals = m_surfaceMesh.getVertexNormals().data();
 
-	// for each point find nearest triangle (TODO: optimize)
+	// AABB tree over the surface triangles. The boxes are enlarged slightly so that the 
+	// distance to a box is never larger than the computed distance to one of its triangles.
+	TriangleMeshAABBTree tree;
+	if (useBVH && (nFaces > 0))
+	{
+		const Vector3r *vertices = &pd.getPosition0(m_indexOffset);
+		const unsigned int nVertices = m_particleMesh.numVertices();
+		AlignedBox3r box;
+		for (unsigned int i = 0; i < nVertices; i++)
+			box.extend(vertices[i]);
+		tree.init(vertices, nVertices, faces, nFaces, static_cast<Real>(1.0e-4) * box.diagonal().norm());
+		tree.construct();
+	}
+
+	// for each point find nearest triangles
 	const int nNearstT = 15;
 	m_attachments.resize(m_visVertices.size());
 
@@ -120,7 +135,10 @@ void TetModel::attachVisMesh(const ParticleData &pd)
 			}
 			Vector3r curBary[nNearstT];
 			Vector3r curInter[nNearstT];
-			for (unsigned int j = 0; j < nFaces; j++)
+
+			// The triangles are sorted by their distance and by their index for equal distances.
+			// Hence, the result does not depend on the order in which the triangles are tested.
+			auto testTriangle = [&](const unsigned int j)
 			{
 				const unsigned int indexA = faces[3 * j] + m_indexOffset;
 				const unsigned int indexB = faces[3 * j + 1] + m_indexOffset;
@@ -136,7 +154,7 @@ void TetModel::attachVisMesh(const ParticleData &pd)
 					Real len = (p - inter).norm();
 					for (int k = nNearstT - 1; k >= 0; k--) // update the best triangles
 					{
-						if (len < curDist[k])
+						if ((len < curDist[k]) || ((len == curDist[k]) && ((int)j < curT[k])))
 						{
 							if (k < nNearstT - 1)
 							{
@@ -152,6 +170,24 @@ void TetModel::attachVisMesh(const ParticleData &pd)
 						}
 					}
 				}
+			};
+
+			if (useBVH)
+			{
+				// Only the triangles which are closer than the farthest of the current 
+				// nearest triangles can change the result.
+				tree.traverse_nearest(p, [&]() { return curDist[nNearstT - 1]; },
+					[&](const unsigned int node_index)
+				{
+					const TriangleMeshAABBTree::Node &node = tree.node(node_index);
+					for (unsigned int l = node.begin; l < node.begin + node.n; l++)
+						testTriangle(tree.entity(l));
+				});
+			}
+			else
+			{
+				for (unsigned int j = 0; j < nFaces; j++)
+					testTriangle(j);
 			}
 			if (curT[0] == -1)
 			{
@@ -74,8 +74,14 @@ namespace PBD
 			/** Attach a visualization mesh to the surface of the body.
 			 * Important: The vertex normals have to be updated before 
 			 * calling this function by calling updateMeshNormals(). 
+			 *
+			 * @param pd particle data
+			 * @param useBVH if true, the nearest surface triangles of the vertices are determined
+			 * using an AABB tree. Otherwise all triangles are tested for each vertex. The
+			 * resulting attachments are the same.
 			 */
- 			void attachVisMesh(const ParticleData &pd);
+ 			void attachVisMesh(const ParticleData &pd, const bool useBVH = true);
+			const std::vector<Attachment> &getAttachments() const { return m_attachments; }
 
 			/** Update the visualization mesh of the body.
 			* Important: The vertex normals have to be updated before
@@ -1,8 +1,11 @@
 #include "TimeManager.h"
+#include <mutex>
 
 using namespace PBD;
 
-TimeManager* TimeManager::current = 0;
+thread_local TimeManager* TimeManager::current = 0;
+std::atomic<TimeManager*> TimeManager::processCurrent(nullptr);
+static std::mutex s_processCurrentMutex;
 
 TimeManager::TimeManager () 
 {
@@ -12,26 +15,48 @@ TimeManager::TimeManager ()
 
 TimeManager::~TimeManager () 
 {
-	current = 0;
+	if (current == this)
+		current = 0;
+	TimeManager *tm = this;
+	processCurrent.compare_exchange_strong(tm, nullptr);
 }
 
 TimeManager* TimeManager::getCurrent ()
 {
-	if (current == 0)
+	if (current != 0)
+		return current;
+	TimeManager *tm = processCurrent.load();
+	if (tm == 0)
 	{
-		current = new TimeManager ();
+		// only one time manager is created for all threads
+		std::lock_guard<std::mutex> lock(s_processCurrentMutex);
+		tm = processCurrent.load();
+		if (tm == 0)
+		{
+			tm = new TimeManager ();
+			processCurrent = tm;
+		}
 	}
-	return current;
+	return tm;
 }
 
 void TimeManager::setCurrent (TimeManager* tm)
 {
 	current = tm;
+	if (tm != 0)
+		processCurrent = tm;
+}
+
+TimeManager* TimeManager::bindToThread (TimeManager* tm)
+{
+	TimeManager *last = current;
+	current = tm;
+	return last;
 }
 
 bool TimeManager::hasCurrent()
 {
-	return (current != 0);
+	return (current != 0) || (processCurrent.load() != 0);
 }
 
 Real TimeManager::getTime()
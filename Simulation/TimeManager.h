@@ -2,24 +2,37 @@
 #define _TIMEMANAGER_H
 
 #include "Common/Common.h"
+#include <atomic>
 
 namespace PBD
 {
+	/** \brief Class to manage the simulation time and the time step size. 
+	* The current time manager is bound per thread. Threads without a bound time
+	* manager (e.g. OpenMP worker threads) use the one which was made current last
+	* in the process.
+	*/
 	class TimeManager
 	{
 	private:
 		Real time;
-		static TimeManager *current;
+		static thread_local TimeManager *current;
+		/** Time manager which was made current last in any thread */
+		static std::atomic<TimeManager*> processCurrent;
 		Real h;
 
 	public:
 		TimeManager ();
 		~TimeManager ();
 
-		// Singleton
+		/** Return the time manager of the calling thread or the one of the process if no
+		* time manager is bound to the thread. A time manager is only created if there
+		* is none in the process. */
 		static TimeManager* getCurrent ();
 		static void setCurrent (TimeManager* tm);
 		static bool hasCurrent();
+		/** Bind the time manager to the calling thread only, the one of the process is not
+		* changed. Return the time manager which was bound to the thread before (may be null). */
+		static TimeManager* bindToThread (TimeManager* tm);
 
 		Real getTime();
 		void setTime(Real t);
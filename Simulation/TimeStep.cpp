@@ -1,6 +1,7 @@
 #include "TimeStep.h"
 #include "TimeManager.h"
 #include "Simulation.h"
+#include <algorithm>
 
 
 using namespace PBD;
@@ -9,6 +10,8 @@ using namespace GenParam;
 
 TimeStep::TimeStep()
 {
+	m_collisionDetection = NULL;
+	m_contactBatchData.m_model = NULL;
 }
 
 TimeStep::~TimeStep(void)
@@ -32,7 +35,7 @@ void TimeStep::clearAccelerations(SimulationModel &model)
 	//////////////////////////////////////////////////////////////////////////
 
 	SimulationModel::RigidBodyVector &rb = model.getRigidBodies();
-	Simulation *sim = Simulation::getCurrent();
+	Simulation *sim = model.getSimulation();
 	const Vector3r grav(sim->getVecValue<Real>(Simulation::GRAVITATION));
 	for (size_t i = 0; i < rb.size(); i++)
 	{
@@ -68,8 +71,12 @@ void TimeStep::reset()
 void TimeStep::setCollisionDetection(SimulationModel &model, CollisionDetection *cd)
 {
 	m_collisionDetection = cd;
-	m_collisionDetection->setContactCallback(contactCallbackFunction, &model);
-	m_collisionDetection->setSolidContactCallback(solidContactCallbackFunction, &model);
+	// the single contact callbacks and the batch callback are exclusive,
+	// the single contacts are passed to the batch callback
+	m_collisionDetection->setContactCallback(NULL, NULL);
+	m_collisionDetection->setSolidContactCallback(NULL, NULL);
+	m_contactBatchData.m_model = &model;
+	m_collisionDetection->setContactBatchCallback(contactBatchCallbackFunction, &m_contactBatchData);
 }
 
 CollisionDetection *TimeStep::getCollisionDetection()
@@ -98,4 +105,95 @@ void TimeStep::solidContactCallbackFunction(const unsigned int contactType, cons
 	SimulationModel *model = (SimulationModel*)userData;
 	if (contactType == CollisionDetection::ParticleSolidContactType)
 		model->addParticleSolidContactConstraint(bodyIndex1, bodyIndex2, tetIndex, bary, cp1, cp2, normal, dist, restitutionCoeff, frictionCoeff);
-}
\ No newline at end of file
+}
+
+/** Remove the constraints with index >= first which could not be initialized. The order of the remaining constraints is kept. */
+template<class ConstraintVector>
+static void removeInvalidConstraints(ConstraintVector &constraints, const std::vector<char> &valid, const unsigned int first)
+{
+	unsigned int k = first;
+	for (unsigned int i = first; i < (unsigned int)constraints.size(); i++)
+	{
+		if (valid[i - first])
+		{
+			if (k != i)
+				constraints[k] = constraints[i];
+			k++;
+		}
+	}
+	constraints.resize(k);
+}
+
+void TimeStep::contactBatchCallbackFunction(const std::vector<std::vector<CollisionDetection::ContactData> > &contacts_mt, void *userData)
+{
+	ContactBatchData *data = (ContactBatchData*)userData;
+	SimulationModel *model = data->m_model;
+	SimulationModel::RigidBodyContactConstraintVector &rbContacts = model->getRigidBodyContactConstraints();
+	SimulationModel::ParticleRigidBodyContactConstraintVector &particleRbContacts = model->getParticleRigidBodyContactConstraints();
+	SimulationModel::ParticleSolidContactConstraintVector &particleSolidContacts = model->getParticleSolidContactConstraints();
+
+	// prefix sum of the contact counts of the threads
+	const unsigned int numThreads = (unsigned int)contacts_mt.size();
+	std::vector<unsigned int> &threadOffsets = data->m_threadOffsets;
+	threadOffsets.resize(numThreads + 1);
+	threadOffsets[0] = 0;
+	for (unsigned int t = 0; t < numThreads; t++)
+		threadOffsets[t + 1] = threadOffsets[t] + (unsigned int)contacts_mt[t].size();
+	const int numContacts = (int)threadOffsets[numThreads];
+	if (numContacts == 0)
+		return;
+
+	// determine the index of each contact in the constraint vector of its type
+	const unsigned int first[3] = { (unsigned int)rbContacts.size(), (unsigned int)particleRbContacts.size(), (unsigned int)particleSolidContacts.size() };
+	unsigned int size[3] = { first[0], first[1], first[2] };
+	std::vector<unsigned int> &constraintIndex = data->m_constraintIndex;
+	constraintIndex.resize(numContacts);
+	for (unsigned int t = 0; t < numThreads; t++)
+	{
+		for (unsigned int j = 0; j < contacts_mt[t].size(); j++)
+		{
+			const char type = contacts_mt[t][j].m_type;
+			if ((type >= 0) && (type <= 2))
+				constraintIndex[threadOffsets[t] + j] = size[(int)type]++;
+		}
+	}
+
+	// resize the constraint vectors once
+	rbContacts.resize(size[0]);
+	particleRbContacts.resize(size[1]);
+	particleSolidContacts.resize(size[2]);
+	std::vector<char> *valid = data->m_valid;
+	for (unsigned int i = 0; i < 3; i++)
+		valid[i].resize(size[i] - first[i]);
+
+	const Real stiffnessRb = model->getContactStiffnessRigidBody();
+	const Real stiffnessParticleRb = model->getContactStiffnessParticleRigidBody();
+
+	#pragma omp parallel if(numContacts > MIN_PARALLEL_SIZE) default(shared)
+	{
+		#pragma omp for schedule(static)
+		for (int i = 0; i < numContacts; i++)
+		{
+			const unsigned int t = (unsigned int)(std::upper_bound(threadOffsets.begin(), threadOffsets.end(), (unsigned int)i) - threadOffsets.begin()) - 1;
+			const CollisionDetection::ContactData &cd = contacts_mt[t][i - threadOffsets[t]];
+			const unsigned int index = constraintIndex[i];
+			if (cd.m_type == 0)
+				valid[0][index - first[0]] = rbContacts[index].initConstraint(*model, cd.m_index1, cd.m_index2, cd.m_cp1, cd.m_cp2, cd.m_normal, 
+					cd.m_dist, cd.m_restitution, stiffnessRb, cd.m_friction, cd.m_elementIndex1);
+			else if (cd.m_type == 1)
+				valid[1][index - first[1]] = particleRbContacts[index].initConstraint(*model, cd.m_index1, cd.m_index2, cd.m_cp1, cd.m_cp2, cd.m_normal, 
+					cd.m_dist, cd.m_restitution, stiffnessParticleRb, cd.m_friction);
+			else if (cd.m_type == 2)
+				valid[2][index - first[2]] = particleSolidContacts[index].initConstraint(*model, cd.m_index1, cd.m_index2, cd.m_elementIndex2, cd.m_bary2, 
+					cd.m_cp1, cd.m_cp2, cd.m_normal, cd.m_dist, cd.m_friction);
+		}
+	}
+
+	// remove contacts which could not be initialized
+	if (std::find(valid[0].begin(), valid[0].end(), 0) != valid[0].end())
+		removeInvalidConstraints(rbContacts, valid[0], first[0]);
+	if (std::find(valid[1].begin(), valid[1].end(), 0) != valid[1].end())
+		removeInvalidConstraints(particleRbContacts, valid[1], first[1]);
+	if (std::find(valid[2].begin(), valid[2].end(), 0) != valid[2].end())
+		removeInvalidConstraints(particleSolidContacts, valid[2], first[2]);
+}
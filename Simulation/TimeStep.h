@@ -13,7 +13,19 @@ namespace PBD
 	class TimeStep : public GenParam::ParameterObject
 	{
 	protected:
+		/** Model and buffers of the contact batch callback. The buffers are reused in 
+		 * each step, so no memory is allocated for the contacts in steady state.
+		 */
+		struct ContactBatchData
+		{
+			SimulationModel *m_model;
+			std::vector<unsigned int> m_threadOffsets;
+			std::vector<unsigned int> m_constraintIndex;
+			std::vector<char> m_valid[3];
+		};
+
 		CollisionDetection *m_collisionDetection;
+		ContactBatchData m_contactBatchData;
 
 		/** Clear accelerations and add gravitation.
 		*/
@@ -34,6 +46,11 @@ namespace PBD
 			const Vector3r &normal, const Real dist,
 			const Real restitutionCoeff, const Real frictionCoeff, void *userData);
 
+		/** Add the contact constraints of all contacts to the model. The constraint vectors 
+		 * are resized only once and the constraints are initialized in parallel.
+		 */
+		static void contactBatchCallbackFunction(const std::vector<std::vector<CollisionDetection::ContactData> > &contacts_mt, void *userData);
+
 	public:
 		TimeStep();
 		virtual ~TimeStep(void);
@@ -3,8 +3,10 @@
 #include "PositionBasedDynamics/PositionBasedRigidBodyDynamics.h"
 #include "PositionBasedDynamics/TimeIntegration.h"
 #include <iostream>
+#include <algorithm>
 #include "PositionBasedDynamics/PositionBasedDynamics.h"
 #include "Utils/Timing.h"
+#include "Utils/AllocationCounter.h"
 
 using namespace PBD;
 using namespace std;
@@ -18,6 +20,14 @@ int TimeStepController::MAX_ITERATIONS_V = -1;
 int TimeStepController::VELOCITY_UPDATE_METHOD = -1;
 int TimeStepController::ENUM_VUPDATE_FIRST_ORDER = -1;
 int TimeStepController::ENUM_VUPDATE_SECOND_ORDER = -1;
+int TimeStepController::SOLVER_ACCELERATION = -1;
+int TimeStepController::ENUM_ACCELERATION_NONE = -1;
+int TimeStepController::ENUM_ACCELERATION_SOR = -1;
+int TimeStepController::ENUM_ACCELERATION_CHEBYSHEV = -1;
+int TimeStepController::RELAXATION_OMEGA = -1;
+int TimeStepController::CHEBYSHEV_RHO = -1;
+int TimeStepController::RESIDUAL_TOLERANCE = -1;
+int TimeStepController::FUSED_SUB_STEPS = -1;
 
 
 TimeStepController::TimeStepController() 
@@ -28,6 +38,11 @@ TimeStepController::TimeStepController()
 	m_maxIterations = 1;
 	m_maxIterationsV = 5;
 	m_subSteps = 5;
+	m_solverAcceleration = 0;
+	m_relaxationOmega = static_cast<Real>(1.5);
+	m_chebyshevRho = static_cast<Real>(0.9);
+	m_residualTolerance = 0.0;
+	m_fusedSubSteps = false;
 	m_collisionDetection = NULL;	
 }
 
@@ -70,118 +85,91 @@ void TimeStepController::initParameters()
 	EnumParameter* enumParam = static_cast<EnumParameter*>(getParameter(VELOCITY_UPDATE_METHOD));
 	enumParam->addEnumValue("First Order Update", ENUM_VUPDATE_FIRST_ORDER);
 	enumParam->addEnumValue("Second Order Update", ENUM_VUPDATE_SECOND_ORDER);
+
+	SOLVER_ACCELERATION = createEnumParameter("solverAcceleration", "Solver acceleration", &m_solverAcceleration);
+	setGroup(SOLVER_ACCELERATION, "Simulation|PBD");
+	setDescription(SOLVER_ACCELERATION, "Acceleration of the position solver iterations (successive over-relaxation or Chebyshev semi-iterative method). Only the particle positions are accelerated, rigid bodies and the orientations of rods are not.");
+	enumParam = static_cast<EnumParameter*>(getParameter(SOLVER_ACCELERATION));
+	enumParam->addEnumValue("None", ENUM_ACCELERATION_NONE);
+	enumParam->addEnumValue("SOR", ENUM_ACCELERATION_SOR);
+	enumParam->addEnumValue("Chebyshev", ENUM_ACCELERATION_CHEBYSHEV);
+
+	RELAXATION_OMEGA = createNumericParameter("relaxationOmega", "Relaxation omega", &m_relaxationOmega);
+	setGroup(RELAXATION_OMEGA, "Simulation|PBD");
+	setDescription(RELAXATION_OMEGA, "Over-relaxation factor of the position corrections of an iteration (SOR).");
+	static_cast<NumericParameter<Real>*>(getParameter(RELAXATION_OMEGA))->setMinValue(0.0);
+	static_cast<NumericParameter<Real>*>(getParameter(RELAXATION_OMEGA))->setMaxValue(2.0);
+
+	CHEBYSHEV_RHO = createNumericParameter("chebyshevRho", "Chebyshev rho", &m_chebyshevRho);
+	setGroup(CHEBYSHEV_RHO, "Simulation|PBD");
+	setDescription(CHEBYSHEV_RHO, "Estimated spectral radius of the solver iteration for the Chebyshev method. Smaller values are more stable, larger ones converge faster.");
+	static_cast<NumericParameter<Real>*>(getParameter(CHEBYSHEV_RHO))->setMinValue(0.0);
+	static_cast<NumericParameter<Real>*>(getParameter(CHEBYSHEV_RHO))->setMaxValue(static_cast<Real>(0.9999));
+
+	RESIDUAL_TOLERANCE = createNumericParameter("residualTolerance", "Residual tolerance", &m_residualTolerance);
+	setGroup(RESIDUAL_TOLERANCE, "Simulation|PBD");
+	setDescription(RESIDUAL_TOLERANCE, "The position solver stops when the residual is reduced to this fraction of the residual of the first iteration (0 = always perform the max. iterations).");
+	static_cast<NumericParameter<Real>*>(getParameter(RESIDUAL_TOLERANCE))->setMinValue(0.0);
+
+	FUSED_SUB_STEPS = createBoolParameter("fusedSubSteps", "Fused sub steps", &m_fusedSubSteps);
+	setGroup(FUSED_SUB_STEPS, "Simulation|PBD");
+	setDescription(FUSED_SUB_STEPS, "Perform all sub steps in one parallel region and initialize the constraint groups only once per step. This reduces the overhead of many sub steps with few iterations. It is not used with a solver acceleration or a residual tolerance.");
 }
 
 void TimeStepController::step(SimulationModel &model)
 {
 	START_TIMING("simulation step");
-	TimeManager *tm = TimeManager::getCurrent ();
+	const size_t allocationsBefore = Utilities::AllocationCounter::getCount();
+	TimeManager *tm = model.getTimeManager();
 	const Real hOld = tm->getTimeStepSize();
+	m_residualHistory.clear();
  
 	//////////////////////////////////////////////////////////////////////////
 	// rigid body model
 	//////////////////////////////////////////////////////////////////////////
 	clearAccelerations(model);
 	SimulationModel::RigidBodyVector &rb = model.getRigidBodies();
-	ParticleData &pd = model.getParticles();
-	OrientationData &od = model.getOrientations();
 
 	const int numBodies = (int)rb.size();
 
 	Real h = hOld / (Real)m_subSteps;
 	tm->setTimeStepSize(h);
-	for (unsigned int step = 0; step < m_subSteps; step++)
+	if (m_fusedSubSteps && (m_solverAcceleration == 0) && (m_residualTolerance == 0.0))
 	{
-		#pragma omp parallel if(numBodies > MIN_PARALLEL_SIZE) default(shared)
-		{
-			#pragma omp for schedule(static) nowait
-			for (int i = 0; i < numBodies; i++)
-			{ 
-				rb[i]->getLastPosition() = rb[i]->getOldPosition();
-				rb[i]->getOldPosition() = rb[i]->getPosition();
-				TimeIntegration::semiImplicitEuler(h, rb[i]->getMass(), rb[i]->getPosition(), rb[i]->getVelocity(), rb[i]->getAcceleration());
-				rb[i]->getLastRotation() = rb[i]->getOldRotation();
-				rb[i]->getOldRotation() = rb[i]->getRotation();
-				TimeIntegration::semiImplicitEulerRotation(h, rb[i]->getMass(), rb[i]->getInertiaTensorW(), rb[i]->getInertiaTensorInverseW(), rb[i]->getRotation(), rb[i]->getAngularVelocity(), rb[i]->getTorque());
-				rb[i]->rotationUpdated();
-			}
-
-			//////////////////////////////////////////////////////////////////////////
-			// particle model
-			//////////////////////////////////////////////////////////////////////////
-			#pragma omp for schedule(static) 
-			for (int i = 0; i < (int) pd.size(); i++)
-			{
-				pd.getLastPosition(i) = pd.getOldPosition(i);
-				pd.getOldPosition(i) = pd.getPosition(i);
-				TimeIntegration::semiImplicitEuler(h, pd.getMass(i), pd.getPosition(i), pd.getVelocity(i), pd.getAcceleration(i));
-			}
-
-			//////////////////////////////////////////////////////////////////////////
-			// orientation model
-			//////////////////////////////////////////////////////////////////////////
-			#pragma omp for schedule(static) 
-			for (int i = 0; i < (int)od.size(); i++)
-			{
-				od.getLastQuaternion(i) = od.getOldQuaternion(i);
-				od.getOldQuaternion(i) = od.getQuaternion(i);
-				TimeIntegration::semiImplicitEulerRotation(h, od.getMass(i), od.getMass(i) * Matrix3r::Identity(), od.getInvMass(i) * Matrix3r::Identity(),od.getQuaternion(i), od.getVelocity(i), Vector3r(0,0,0));
-			}
-		}
-
-		START_TIMING("position constraints projection");
-		positionConstraintProjection(model);
+		START_TIMING("fused sub steps");
+		fusedSubSteps(model, h);
 		STOP_TIMING_AVG;
-
-		#pragma omp parallel if(numBodies > MIN_PARALLEL_SIZE) default(shared)
+	}
+	else
+	{
+		for (unsigned int step = 0; step < m_subSteps; step++)
 		{
-			// Update velocities	
-			#pragma omp for schedule(static) nowait
-			for (int i = 0; i < numBodies; i++)
+			#pragma omp parallel if(numBodies > MIN_PARALLEL_SIZE) default(shared)
 			{
-				if (m_velocityUpdateMethod == 0)
-				{
-					TimeIntegration::velocityUpdateFirstOrder(h, rb[i]->getMass(), rb[i]->getPosition(), rb[i]->getOldPosition(), rb[i]->getVelocity());
-					TimeIntegration::angularVelocityUpdateFirstOrder(h, rb[i]->getMass(), rb[i]->getRotation(), rb[i]->getOldRotation(), rb[i]->getAngularVelocity());
-				}
-				else
-				{
-					TimeIntegration::velocityUpdateSecondOrder(h, rb[i]->getMass(), rb[i]->getPosition(), rb[i]->getOldPosition(), rb[i]->getLastPosition(), rb[i]->getVelocity());
-					TimeIntegration::angularVelocityUpdateSecondOrder(h, rb[i]->getMass(), rb[i]->getRotation(), rb[i]->getOldRotation(), rb[i]->getLastRotation(), rb[i]->getAngularVelocity());
-				}
+				integrate(model, h);
 			}
 
-			// Update velocities	
-			#pragma omp for schedule(static) 
-			for (int i = 0; i < (int) pd.size(); i++)
-			{
-				if (m_velocityUpdateMethod == 0)
-					TimeIntegration::velocityUpdateFirstOrder(h, pd.getMass(i), pd.getPosition(i), pd.getOldPosition(i), pd.getVelocity(i));
-				else
-					TimeIntegration::velocityUpdateSecondOrder(h, pd.getMass(i), pd.getPosition(i), pd.getOldPosition(i), pd.getLastPosition(i), pd.getVelocity(i));
-			}
+			START_TIMING("position constraints projection");
+			positionConstraintProjection(model);
+			STOP_TIMING_AVG;
 
-			// Update velocites of orientations
-			#pragma omp for schedule(static) 
-			for (int i = 0; i < (int)od.size(); i++)
+			#pragma omp parallel if(numBodies > MIN_PARALLEL_SIZE) default(shared)
 			{
-				if (m_velocityUpdateMethod == 0)
-					TimeIntegration::angularVelocityUpdateFirstOrder(h, od.getMass(i), od.getQuaternion(i), od.getOldQuaternion(i), od.getVelocity(i));
-				else
-					TimeIntegration::angularVelocityUpdateSecondOrder(h, od.getMass(i), od.getQuaternion(i), od.getOldQuaternion(i), od.getLastQuaternion(i), od.getVelocity(i));
+				updateVelocities(model, h);
 			}
 		}
 	}
 	h = hOld;
 	tm->setTimeStepSize(hOld);
 
+	const bool updateNormals = model.getUpdateNormals();
 	#pragma omp parallel default(shared)
 	{
 		#pragma omp for schedule(static) nowait
 		for (int i = 0; i < numBodies; i++)
 		{
 			if (rb[i]->getMass() != 0.0)
-				rb[i]->getGeometry().updateMeshTransformation(rb[i]->getPosition(), rb[i]->getRotationMatrix());
+				rb[i]->getGeometry().updateMeshTransformation(rb[i]->getPosition(), rb[i]->getRotationMatrix(), updateNormals);
 		}
 	}
 
@@ -207,7 +195,7 @@ void TimeStepController::step(SimulationModel &model)
 			(constraints[i]->getTypeId() == TargetVelocityMotorSliderJoint::TYPE_ID))
 		{
 			MotorJoint *motor = (MotorJoint*)constraints[i];
-			const std::vector<Real> sequence = motor->getTargetSequence();
+			const std::vector<Real> &sequence = motor->getTargetSequence();
 			if (sequence.size() > 0)
 			{
 				Real time = tm->getTime();
@@ -237,6 +225,10 @@ void TimeStepController::step(SimulationModel &model)
 	
 	// compute new time	
 	tm->setTime (tm->getTime () + h);
+
+	// heap allocations of the step, should be zero in steady state
+	if (Utilities::AllocationCounter::isEnabled())
+		INCREASE_COUNTER("allocations per step", static_cast<double>(Utilities::AllocationCounter::getCount() - allocationsBefore));
 	STOP_TIMING_AVG;
 }
 
@@ -248,12 +240,186 @@ void TimeStepController::reset()
 	//m_maxIterationsV = 5;
 }
 
+void TimeStepController::integrate(SimulationModel &model, const Real h)
+{
+	SimulationModel::RigidBodyVector &rb = model.getRigidBodies();
+	ParticleData &pd = model.getParticles();
+	OrientationData &od = model.getOrientations();
+	const int numBodies = (int)rb.size();
+
+	#pragma omp for schedule(static) nowait
+	for (int i = 0; i < numBodies; i++)
+	{ 
+		rb[i]->getLastPosition() = rb[i]->getOldPosition();
+		rb[i]->getOldPosition() = rb[i]->getPosition();
+		TimeIntegration::semiImplicitEuler(h, rb[i]->getMass(), rb[i]->getPosition(), rb[i]->getVelocity(), rb[i]->getAcceleration());
+		rb[i]->getLastRotation() = rb[i]->getOldRotation();
+		rb[i]->getOldRotation() = rb[i]->getRotation();
+		TimeIntegration::semiImplicitEulerRotation(h, rb[i]->getMass(), rb[i]->getInertiaTensorW(), rb[i]->getInertiaTensorInverseW(), rb[i]->getRotation(), rb[i]->getAngularVelocity(), rb[i]->getTorque());
+		rb[i]->rotationUpdated();
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// particle model
+	//////////////////////////////////////////////////////////////////////////
+	#pragma omp for schedule(static) nowait
+	for (int i = 0; i < (int) pd.size(); i++)
+	{
+		pd.getLastPosition(i) = pd.getOldPosition(i);
+		pd.getOldPosition(i) = pd.getPosition(i);
+		TimeIntegration::semiImplicitEuler(h, pd.getMass(i), pd.getPosition(i), pd.getVelocity(i), pd.getAcceleration(i));
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// orientation model
+	//////////////////////////////////////////////////////////////////////////
+	#pragma omp for schedule(static) nowait
+	for (int i = 0; i < (int)od.size(); i++)
+	{
+		od.getLastQuaternion(i) = od.getOldQuaternion(i);
+		od.getOldQuaternion(i) = od.getQuaternion(i);
+		TimeIntegration::semiImplicitEulerRotation(h, od.getMass(i), od.getMass(i) * Matrix3r::Identity(), od.getInvMass(i) * Matrix3r::Identity(),od.getQuaternion(i), od.getVelocity(i), Vector3r(0,0,0));
+	}
+}
+
+void TimeStepController::updateVelocities(SimulationModel &model, const Real h)
+{
+	SimulationModel::RigidBodyVector &rb = model.getRigidBodies();
+	ParticleData &pd = model.getParticles();
+	OrientationData &od = model.getOrientations();
+	const int numBodies = (int)rb.size();
+
+	#pragma omp for schedule(static) nowait
+	for (int i = 0; i < numBodies; i++)
+	{
+		if (m_velocityUpdateMethod == 0)
+		{
+			TimeIntegration::velocityUpdateFirstOrder(h, rb[i]->getMass(), rb[i]->getPosition(), rb[i]->getOldPosition(), rb[i]->getVelocity());
+			TimeIntegration::angularVelocityUpdateFirstOrder(h, rb[i]->getMass(), rb[i]->getRotation(), rb[i]->getOldRotation(), rb[i]->getAngularVelocity());
+		}
+		else
+		{
+			TimeIntegration::velocityUpdateSecondOrder(h, rb[i]->getMass(), rb[i]->getPosition(), rb[i]->getOldPosition(), rb[i]->getLastPosition(), rb[i]->getVelocity());
+			TimeIntegration::angularVelocityUpdateSecondOrder(h, rb[i]->getMass(), rb[i]->getRotation(), rb[i]->getOldRotation(), rb[i]->getLastRotation(), rb[i]->getAngularVelocity());
+		}
+	}
+
+	#pragma omp for schedule(static) nowait
+	for (int i = 0; i < (int) pd.size(); i++)
+	{
+		if (m_velocityUpdateMethod == 0)
+			TimeIntegration::velocityUpdateFirstOrder(h, pd.getMass(i), pd.getPosition(i), pd.getOldPosition(i), pd.getVelocity(i));
+		else
+			TimeIntegration::velocityUpdateSecondOrder(h, pd.getMass(i), pd.getPosition(i), pd.getOldPosition(i), pd.getLastPosition(i), pd.getVelocity(i));
+	}
+
+	#pragma omp for schedule(static) nowait
+	for (int i = 0; i < (int)od.size(); i++)
+	{
+		if (m_velocityUpdateMethod == 0)
+			TimeIntegration::angularVelocityUpdateFirstOrder(h, od.getMass(i), od.getQuaternion(i), od.getOldQuaternion(i), od.getVelocity(i));
+		else
+			TimeIntegration::angularVelocityUpdateSecondOrder(h, od.getMass(i), od.getQuaternion(i), od.getOldQuaternion(i), od.getLastQuaternion(i), od.getVelocity(i));
+	}
+}
+
+void TimeStepController::fusedSubSteps(SimulationModel &model, const Real h)
+{
+	// the setup of the constraints is only done once per step
+	model.initConstraintGroups();
+	const bool jacobi = (model.getSolverMethod() == 1);
+	if (jacobi)
+		model.initJacobiData();
+	model.initFEMTetBatchData();
+
+	SimulationModel::ConstraintVector &constraints = model.getConstraints();
+	SimulationModel::ConstraintGroupVector &groups = model.getConstraintGroups();
+	SimulationModel::ParticleSolidContactConstraintVector &particleTetContacts = model.getParticleSolidContactConstraints();
+	const int numConstraints = (int)constraints.size();
+	const unsigned int maxIterations = m_maxIterations;
+	// a small model is solved by one thread since the barriers of the sub steps would dominate
+	const unsigned int numElements = std::max(std::max(model.getParticles().size(), static_cast<unsigned int>(model.getRigidBodies().size())),
+		static_cast<unsigned int>(numConstraints));
+
+	// All sub steps are performed in one parallel region. The loops of integrate() 
+	// and updateVelocities() have the same static schedule, so each body is updated 
+	// by the same thread in both and no barrier is required between the velocity 
+	// update of a sub step and the integration of the next one.
+	#pragma omp parallel if(numElements > MIN_PARALLEL_SIZE) default(shared)
+	{
+		for (unsigned int step = 0; step < m_subSteps; step++)
+		{
+			integrate(model, h);
+			#pragma omp barrier
+
+			#pragma omp for schedule(static) 
+			for (int i = 0; i < numConstraints; i++)
+				constraints[i]->initConstraintBeforeProjection(model);
+
+			for (unsigned int iter = 0; iter < maxIterations; iter++)
+			{
+				if (jacobi)
+					jacobiIteration(model, iter);
+
+				for (unsigned int group = 0; group < groups.size(); group++)
+				{
+					const int groupSize = (int)groups[group].size();
+					int start = 0;
+					while (start < groupSize)
+					{
+						const int typeId = constraints[groups[group][start]]->getTypeId();
+						int end = start + 1;
+						while ((end < groupSize) && (constraints[groups[group][end]]->getTypeId() == typeId))
+							end++;
+						const unsigned int *groupConstraints = &groups[group][start];
+						const int numGroupConstraints = end - start;
+						start = end;
+
+						// already solved by the Jacobi iteration
+						if (jacobi && constraints[groupConstraints[0]]->hasPositionCorrections())
+							continue;
+
+						const Constraint::BatchSolver batchSolver = constraints[groupConstraints[0]]->getBatchSolver();
+						if (batchSolver != nullptr)
+							batchSolver(model, groupConstraints, numGroupConstraints, iter);
+						else
+						{
+							#pragma omp for schedule(static) 
+							for (int i = 0; i < numGroupConstraints; i++)
+							{
+								const unsigned int constraintIndex = groupConstraints[i];
+								constraints[constraintIndex]->updateConstraint(model);
+								constraints[constraintIndex]->solvePositionConstraint(model, iter);
+							}
+						}
+					}
+				}
+
+				// the contacts are detected once per step and solved in each sub step
+				if (particleTetContacts.size() > 0)
+				{
+					#pragma omp single
+					for (unsigned int i = 0; i < particleTetContacts.size(); i++)
+						particleTetContacts[i].solvePositionConstraint(model, iter);
+				}
+			}
+
+			updateVelocities(model, h);
+		}
+	}
+	m_iterations = maxIterations;
+}
+
 void TimeStepController::positionConstraintProjection(SimulationModel &model)
 {
 	m_iterations = 0;
 
 	// init constraint groups if necessary
 	model.initConstraintGroups();
+	const bool jacobi = (model.getSolverMethod() == 1);
+	if (jacobi)
+		model.initJacobiData();
+	model.initFEMTetBatchData();
 
 	SimulationModel::RigidBodyVector &rb = model.getRigidBodies();
 	SimulationModel::ConstraintVector &constraints = model.getConstraints();
@@ -267,21 +433,77 @@ void TimeStepController::positionConstraintProjection(SimulationModel &model)
 		constraint->initConstraintBeforeProjection(model);
 	}
 
+	// the residual is only computed if it is required
+	const bool computeResidual = (m_solverAcceleration != 0) || (m_residualTolerance > 0.0);
+	if (computeResidual)
+	{
+		ParticleData &pd = model.getParticles();
+		m_iterationX.resize(pd.size());
+		for (unsigned int i = 0; i < pd.size(); i++)
+			m_iterationX[i] = pd.getPosition(i);
+		m_iterationXOld = m_iterationX;
+		m_iterationRbX.resize(rb.size());
+		for (unsigned int i = 0; i < rb.size(); i++)
+			m_iterationRbX[i] = rb[i]->getPosition();
+		m_residualHistory.reserve(m_subSteps * m_maxIterations);
+	}
+	Real omega = 1.0;
+	Real firstResidual = 0.0;
+
 	while (m_iterations < m_maxIterations)
 	{
+		if (jacobi)
+		{
+			const int numJacobiConstraints = (int)model.getJacobiData().m_constraints.size();
+			#pragma omp parallel if(numJacobiConstraints > MIN_PARALLEL_SIZE) default(shared)
+			{
+				jacobiIteration(model, m_iterations);
+			}
+		}
+
 		for (unsigned int group = 0; group < groups.size(); group++)
 		{
+			// the constraints of a group are sorted by their type,
+			// constraint types with a batch solver are solved in batches
 			const int groupSize = (int)groups[group].size();
-			#pragma omp parallel if(groupSize > MIN_PARALLEL_SIZE) default(shared)
+			int start = 0;
+			while (start < groupSize)
 			{
-				#pragma omp for schedule(static) 
-				for (int i = 0; i < groupSize; i++)
+				const int typeId = constraints[groups[group][start]]->getTypeId();
+				int end = start + 1;
+				while ((end < groupSize) && (constraints[groups[group][end]]->getTypeId() == typeId))
+					end++;
+				const unsigned int *groupConstraints = &groups[group][start];
+				const int numConstraints = end - start;
+
+				// already solved by the Jacobi iteration
+				if (jacobi && constraints[groupConstraints[0]]->hasPositionCorrections())
 				{
-					const unsigned int constraintIndex = groups[group][i];
+					start = end;
+					continue;
+				}
 
-					constraints[constraintIndex]->updateConstraint(model);
-					constraints[constraintIndex]->solvePositionConstraint(model, m_iterations);
+				const Constraint::BatchSolver batchSolver = constraints[groupConstraints[0]]->getBatchSolver();
+				if (batchSolver != nullptr)
+				{
+					#pragma omp parallel if(numConstraints > MIN_PARALLEL_SIZE) default(shared)
+					batchSolver(model, groupConstraints, numConstraints, m_iterations);
+				}
+				else
+				{
+					#pragma omp parallel if(numConstraints > MIN_PARALLEL_SIZE) default(shared)
+					{
+						#pragma omp for schedule(static) 
+						for (int i = 0; i < numConstraints; i++)
+						{
+							const unsigned int constraintIndex = groupConstraints[i];
+
+							constraints[constraintIndex]->updateConstraint(model);
+							constraints[constraintIndex]->solvePositionConstraint(model, m_iterations);
+						}
+					}
 				}
+				start = end;
 			}
 		}
 
@@ -290,8 +512,115 @@ void TimeStepController::positionConstraintProjection(SimulationModel &model)
 			particleTetContacts[i].solvePositionConstraint(model, m_iterations);
 		}
 
-		m_iterations++;
+		if (computeResidual)
+		{
+			if (m_solverAcceleration == 1)
+				omega = m_relaxationOmega;
+			else if (m_solverAcceleration == 2)
+			{
+				// Chebyshev weights, see Wang 2015, "A Chebyshev semi-iterative approach 
+				// for accelerating projective and position-based dynamics"
+				const Real rho2 = m_chebyshevRho * m_chebyshevRho;
+				if (m_iterations == 0)
+					omega = 1.0;
+				else if (m_iterations == 1)
+					omega = static_cast<Real>(2.0) / (static_cast<Real>(2.0) - rho2);
+				else
+					omega = static_cast<Real>(4.0) / (static_cast<Real>(4.0) - rho2 * omega);
+			}
+			const Real residual = accelerateIteration(model, omega);
+			m_residualHistory.push_back(residual);
+			if (m_iterations == 0)
+				firstResidual = residual;
+			m_iterations++;
+
+			// early exit
+			if ((m_residualTolerance > 0.0) && (residual <= m_residualTolerance * firstResidual))
+				break;
+		}
+		else
+			m_iterations++;
+	}
+}
+
+void TimeStepController::jacobiIteration(SimulationModel &model, const unsigned int iter)
+{
+	ParticleData &pd = model.getParticles();
+	SimulationModel::ConstraintVector &constraints = model.getConstraints();
+	SimulationModel::JacobiData &jd = model.getJacobiData();
+	const int numConstraints = (int)jd.m_constraints.size();
+	const int numParticles = (int)jd.m_particleCorrectionStart.size() - 1;
+	const Real relaxation = model.getJacobiRelaxation();
+
+	#pragma omp for schedule(static) 
+	for (int i = 0; i < numConstraints; i++)
+	{
+		Constraint *constraint = constraints[jd.m_constraints[i]];
+		Vector3r *corr = &jd.m_corrections[jd.m_correctionStart[i]];
+		constraint->updateConstraint(model);
+		if (!constraint->computePositionCorrections(model, iter, corr))
+		{
+			for (unsigned int k = 0; k < constraint->numberOfBodies(); k++)
+				corr[k].setZero();
+		}
+	}
+
+	// gather the corrections of each particle, the implicit barrier of the 
+	// loop above is the only synchronization of the iteration
+	#pragma omp for schedule(static) 
+	for (int i = 0; i < numParticles; i++)
+	{
+		const unsigned int start = jd.m_particleCorrectionStart[i];
+		const unsigned int end = jd.m_particleCorrectionStart[i + 1];
+		if ((start == end) || (pd.getInvMass(i) == 0.0))
+			continue;
+		Vector3r corr = Vector3r::Zero();
+		for (unsigned int j = start; j < end; j++)
+			corr += jd.m_corrections[jd.m_particleCorrections[j]];
+		pd.getPosition(i) += (relaxation / static_cast<Real>(end - start)) * corr;
+	}
+}
+
+Real TimeStepController::accelerateIteration(SimulationModel &model, const Real omega)
+{
+	ParticleData &pd = model.getParticles();
+	SimulationModel::RigidBodyVector &rb = model.getRigidBodies();
+	const int numParticles = (int)pd.size();
+	const int numRigidBodies = (int)rb.size();
+	const bool chebyshev = (m_solverAcceleration == 2);
+
+	Real residual2 = 0.0;
+	#pragma omp parallel if(numParticles + numRigidBodies > MIN_PARALLEL_SIZE) default(shared)
+	{
+		#pragma omp for schedule(static) reduction(+:residual2) nowait
+		for (int i = 0; i < numParticles; i++)
+		{
+			if (pd.getInvMass(i) == 0.0)
+				continue;
+			Vector3r &x = pd.getPosition(i);
+			const Vector3r corr = x - m_iterationX[i];
+			residual2 += corr.squaredNorm();
+			if (chebyshev)
+			{
+				// x_k+1 = omega (x_hat - x_k-1) + x_k-1
+				x = omega * (x - m_iterationXOld[i]) + m_iterationXOld[i];
+				m_iterationXOld[i] = m_iterationX[i];
+			}
+			else if (omega != 1.0)
+				x = m_iterationX[i] + omega * corr;
+			m_iterationX[i] = x;
+		}
+
+		// the rigid bodies are not accelerated but contribute to the residual
+		#pragma omp for schedule(static) reduction(+:residual2)
+		for (int i = 0; i < numRigidBodies; i++)
+		{
+			if (rb[i]->getMass() != 0.0)
+				residual2 += (rb[i]->getPosition() - m_iterationRbX[i]).squaredNorm();
+			m_iterationRbX[i] = rb[i]->getPosition();
+		}
 	}
+	return sqrt(residual2);
 }
 
 
@@ -323,6 +652,10 @@ void TimeStepController::velocityConstraintProjection(SimulationModel &model)
 		}
 	}
 
+	// warm starting with the impulses of the last step
+	for (unsigned int i = 0; i < rigidBodyContacts.size(); i++)
+		rigidBodyContacts[i].warmStart(model);
+
 	while (m_iterationsV < m_maxIterationsV)
 	{
 		for (unsigned int group = 0; group < groups.size(); group++)
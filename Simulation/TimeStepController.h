@@ -21,6 +21,15 @@ namespace PBD
 		static int ENUM_VUPDATE_FIRST_ORDER;
 		static int ENUM_VUPDATE_SECOND_ORDER;
 
+		static int SOLVER_ACCELERATION;
+		static int ENUM_ACCELERATION_NONE;
+		static int ENUM_ACCELERATION_SOR;
+		static int ENUM_ACCELERATION_CHEBYSHEV;
+		static int RELAXATION_OMEGA;
+		static int CHEBYSHEV_RHO;
+		static int RESIDUAL_TOLERANCE;
+		static int FUSED_SUB_STEPS;
+
 	protected:
 		int m_velocityUpdateMethod;
 		unsigned int m_iterations;
@@ -29,9 +38,62 @@ namespace PBD
 		unsigned int m_maxIterations;
 		unsigned int m_maxIterationsV;
 
+		/** Acceleration of the position solver: 0 = none, 1 = successive over-relaxation, 2 = Chebyshev.
+		 * Only the particle positions are extrapolated. The rigid bodies (positions and rotations)
+		 * and the quaternions of the rods are not accelerated, the rigid body positions only
+		 * contribute to the residual. So models which consist mainly of rigid bodies or rods
+		 * do not converge faster.
+		 */
+		int m_solverAcceleration;
+		/** Over-relaxation factor of the position corrections of an iteration */
+		Real m_relaxationOmega;
+		/** Estimated spectral radius of the iteration for the Chebyshev method */
+		Real m_chebyshevRho;
+		/** The position solver stops when the residual falls below this fraction of 
+		 * the residual of the first iteration (0 = always perform m_maxIterations).
+		 */
+		Real m_residualTolerance;
+		/** Residuals of the position solver iterations of all sub steps of the last step */
+		std::vector<Real> m_residualHistory;
+		/** Particle positions before the current iteration */
+		std::vector<Vector3r> m_iterationX;
+		/** Particle positions before the last iteration (Chebyshev) */
+		std::vector<Vector3r> m_iterationXOld;
+		/** Rigid body positions before the current iteration */
+		std::vector<Vector3r> m_iterationRbX;
+		/** Perform all sub steps in one parallel region (see fusedSubSteps()) */
+		bool m_fusedSubSteps;
+
 		virtual void initParameters();
 		
+		/** Time integration of the bodies. The loops are not synchronized, so this 
+		 * must be called in a parallel region followed by a barrier.
+		 */
+		void integrate(SimulationModel &model, const Real h);
+		/** Velocity update of the bodies. The loops are not synchronized, so this 
+		 * must be called in a parallel region followed by a barrier.
+		 */
+		void updateVelocities(SimulationModel &model, const Real h);
+		/** Perform all sub steps in a single parallel region: integration, position 
+		 * constraint projection and velocity update. The constraint groups are 
+		 * initialized only once per step and the contacts of the collision detection 
+		 * of the last step are used in all sub steps. This is efficient for many sub 
+		 * steps with few iterations (small step XPBD).
+		 */
+		void fusedSubSteps(SimulationModel &model, const Real h);
 		void positionConstraintProjection(SimulationModel &model);
+		/** Compute the residual of a position solver iteration, i.e. the norm of the
+		 * position corrections of the particles and rigid bodies, and apply the
+		 * over-relaxation or Chebyshev extrapolation to the particle positions
+		 * (see m_solverAcceleration).
+		 */
+		Real accelerateIteration(SimulationModel &model, const Real omega);
+		/** Perform a Jacobi iteration for all constraints which support it: the corrections
+		 * of all constraints are computed in parallel for the same positions and then the
+		 * relaxed average of the corrections of each particle is applied. The loops
+		 * must be called in a parallel region.
+		 */
+		void jacobiIteration(SimulationModel &model, const unsigned int iter);
 		void velocityConstraintProjection(SimulationModel &model);
 
 
@@ -41,6 +103,11 @@ namespace PBD
 
 		virtual void step(SimulationModel &model);
 		virtual void reset();
+
+		/** Residuals of the position solver iterations in the last step (one entry per iteration 
+		 * and sub step). The residuals are only computed if an acceleration or a residual tolerance is set.
+		 */
+		const std::vector<Real> &getResidualHistory() const { return m_residualHistory; }
 	};
 }
 
@@ -0,0 +1,54 @@
+#include "TriangleMeshAABBTree.h"
+
+using namespace PBD;
+
+
+TriangleMeshAABBTree::TriangleMeshAABBTree()
+	: super(0, 4)
+{
+}
+
+Vector3r const& TriangleMeshAABBTree::entity_position(unsigned int i) const
+{
+	return m_com[i];
+}
+
+void TriangleMeshAABBTree::compute_hull(unsigned int b, unsigned int n, AlignedBox3r& hull) const
+{
+	hull.setEmpty();
+	for (unsigned int i = b; i < b + n; i++)
+	{
+		const unsigned int face = m_lst[i];
+		hull.extend(m_vertices[m_indices[3 * face]]);
+		hull.extend(m_vertices[m_indices[3 * face + 1]]);
+		hull.extend(m_vertices[m_indices[3 * face + 2]]);
+	}
+	hull.min() -= m_tolerance * Vector3r::Ones();
+	hull.max() += m_tolerance * Vector3r::Ones();
+}
+
+void TriangleMeshAABBTree::compute_hull_from_children(unsigned int node_index, AlignedBox3r& hull) const
+{
+	Node const& nd = m_nodes[node_index];
+	hull = m_hulls[nd.children[0]].merged(m_hulls[nd.children[1]]);
+}
+
+void TriangleMeshAABBTree::init(const Vector3r *vertices, const unsigned int numVertices, const unsigned int *indices, const unsigned int numFaces, const Real tolerance)
+{
+	m_lst.resize(numFaces);
+	m_vertices = vertices;
+	m_numVertices = numVertices;
+	m_indices = indices;
+	m_numFaces = numFaces;
+	m_tolerance = tolerance;
+	m_com.resize(numFaces);
+	for (unsigned int i = 0; i < numFaces; i++)
+	{
+		m_com[i] = (m_vertices[m_indices[3 * i]] + m_vertices[m_indices[3 * i + 1]] + m_vertices[m_indices[3 * i + 2]]) / static_cast<Real>(3.0);
+	}
+}
+
+void TriangleMeshAABBTree::updateVertices(const Vector3r* vertices)
+{
+	m_vertices = vertices;
+}
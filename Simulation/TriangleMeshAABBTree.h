@@ -0,0 +1,95 @@
+#ifndef __TRIANGLEMESHAABBTREE_H__
+#define __TRIANGLEMESHAABBTREE_H__
+
+#include "Common/Common.h"
+#include "kdTree.h"
+
+namespace PBD
+{
+	/** Tree of axis aligned bounding boxes over the triangles of a mesh.
+	 * It is used for nearest triangle queries.
+	 */
+	class TriangleMeshAABBTree : public KDTree<AlignedBox3r>
+	{
+
+	public:
+
+		using super = KDTree<AlignedBox3r>;
+
+		TriangleMeshAABBTree();
+
+		/** Initialize the tree. construct() must be called afterwards.
+		 *
+		 * @param vertices vertex positions
+		 * @param numVertices number of vertices
+		 * @param indices three vertex indices per triangle
+		 * @param numFaces number of triangles
+		 * @param tolerance the boxes are enlarged by this value
+		 */
+		void init(const Vector3r *vertices, const unsigned int numVertices, const unsigned int *indices, const unsigned int numFaces, const Real tolerance);
+		Vector3r const& entity_position(unsigned int i) const final;
+		void compute_hull(unsigned int b, unsigned int n, AlignedBox3r& hull)
+			const final;
+		void compute_hull_from_children(unsigned int node_index, AlignedBox3r& hull)
+			const final;
+		void updateVertices(const Vector3r* vertices);
+
+		/** Visit the leaves of the tree which may contain a triangle within the distance
+		 * maxDist() of p. The closer child of a node is visited first and maxDist() is
+		 * evaluated again for each node, so the search region can shrink during the traversal.
+		 *
+		 * @param p query point
+		 * @param maxDist Real(), current search radius
+		 * @param cb void(unsigned int node_index), called for each visited leaf
+		 */
+		template <typename MaxDistance, typename Callback>
+		void traverse_nearest(const Vector3r &p, MaxDistance const& maxDist, Callback const& cb) const
+		{
+			if (m_nodes.empty())
+				return;
+
+			struct StackItem { unsigned int n; Real dist2; };
+			TraversalStack<StackItem, MaxStackSize> stack;
+			stack.push({ 0, m_hulls[0].squaredExteriorDistance(p) });
+			while (!stack.empty())
+			{
+				const StackItem item = stack.pop();
+				const Real d = maxDist();
+				if (item.dist2 > d * d)
+					continue;
+
+				Node const& nd = m_nodes[item.n];
+				if (nd.is_leaf())
+				{
+					cb(item.n);
+					continue;
+				}
+
+				const unsigned int c0 = static_cast<unsigned int>(nd.children[0]);
+				const unsigned int c1 = static_cast<unsigned int>(nd.children[1]);
+				const Real dist0 = m_hulls[c0].squaredExteriorDistance(p);
+				const Real dist1 = m_hulls[c1].squaredExteriorDistance(p);
+				if (dist0 <= dist1)
+				{
+					stack.push({ c1, dist1 });
+					stack.push({ c0, dist0 });
+				}
+				else
+				{
+					stack.push({ c0, dist0 });
+					stack.push({ c1, dist1 });
+				}
+			}
+		}
+
+	private:
+		const Vector3r *m_vertices;
+		unsigned int m_numVertices;
+		const unsigned int *m_indices;
+		unsigned int m_numFaces;
+		Real m_tolerance;
+		std::vector<Vector3r> m_com;
+	};
+}
+
+#endif
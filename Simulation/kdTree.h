@@ -15,6 +15,42 @@
 
 namespace PBD
 {
+	/** Stack for the traversal of the trees. The first N items are stored in a fixed size
+	 * array, further items are stored on the heap. So deep trees are traversed correctly
+	 * while no memory is allocated for trees of usual depth.
+	 */
+	template <typename T, unsigned int N>
+	class TraversalStack
+	{
+	public:
+		TraversalStack() : m_size(0) {}
+
+		bool empty() const { return m_size == 0; }
+
+		void push(const T &item)
+		{
+			if (m_size < N)
+				m_items[m_size] = item;
+			else
+				m_overflow.push_back(item);
+			m_size++;
+		}
+
+		T pop()
+		{
+			m_size--;
+			if (m_size < N)
+				return m_items[m_size];
+			const T item = m_overflow.back();
+			m_overflow.pop_back();
+			return item;
+		}
+
+	private:
+		T m_items[N];
+		std::vector<T> m_overflow;
+		unsigned int m_size;
+	};
 
 	template <typename HullType>
 	class KDTree
@@ -47,6 +83,13 @@ namespace PBD
 		};
 
 		struct QueueItem { unsigned int n, d; };
+		struct PacketItem { unsigned int n, d, mask; };
+
+		/** Number of items of the traversal stack which are stored without heap allocation.
+		 * Since the kd-tree splits at the median, the depth of the tree is usually at most
+		 * log2 of the number of primitives. Deeper trees are handled by TraversalStack.
+		 */
+		static const unsigned int MaxStackSize = 64;
 		using TraversalQueue = std::queue<QueueItem>;
 
 		KDTree(std::size_t n, unsigned int maxPrimitivesPerLeaf = 1)
@@ -55,12 +98,34 @@ namespace PBD
 		virtual ~KDTree() {}
 
 		Node const& node(unsigned int i) const { return m_nodes[i]; }
+		unsigned int numNodes() const { return static_cast<unsigned int>(m_nodes.size()); }
 		HullType const& hull(unsigned int i) const { return m_hulls[i]; }
 		unsigned int entity(unsigned int i) const { return m_lst[i]; }
 
 		void construct();
 		void traverse_depth_first(TraversalPredicate pred, TraversalCallback cb,
 			TraversalPriorityLess const& pless = nullptr) const;
+		/** Depth first traversal with the same visiting order as the std::function version. 
+		 * The functors are inlined and an explicit stack (TraversalStack) is used instead
+		 * of recursion. Lambdas which are passed directly bind to this overload.
+		 *
+		 * @param pred bool(unsigned int node_index, unsigned int depth), children are visited if it returns true
+		 * @param cb void(unsigned int node_index, unsigned int depth), called for each visited node
+		 */
+		template <typename Predicate, typename Callback>
+		void traverse_depth_first(Predicate const& pred, Callback const& cb) const;
+		/** Depth first traversal for a packet of up to 32 queries. Each node is visited once 
+		 * for all queries of the packet. The bits of the mask denote the queries which are 
+		 * still active.
+		 *
+		 * @param mask active queries at the root
+		 * @param pred unsigned int(unsigned int node_index, unsigned int depth, unsigned int mask),
+		 * returns the subset of the queries in mask for which the children have to be visited
+		 * @param cb void(unsigned int node_index, unsigned int depth, unsigned int mask), called for 
+		 * each visited node with the queries which reached the node
+		 */
+		template <typename PacketPredicate, typename PacketCallback>
+		void traverse_depth_first_packet(unsigned int mask, PacketPredicate const& pred, PacketCallback const& cb) const;
 		void traverse_breadth_first(TraversalPredicate const& pred, TraversalCallback const& cb, unsigned int start_node = 0, TraversalPriorityLess const& pless = nullptr, TraversalQueue& pending = TraversalQueue()) const;
 		void traverse_breadth_first_parallel(TraversalPredicate pred, TraversalCallback cb) const;
 		void update();
@@ -82,6 +147,15 @@ namespace PBD
 		{
 			compute_hull(b, n, hull);
 		}
+		/** Compute the hull of an inner node in update(). The hulls of the children are 
+		 * already up to date. The default implementation uses the primitives of the node.
+		 */
+		virtual void compute_hull_from_children(unsigned int node_index, HullType& hull) const
+		{
+			compute_hull_approx(m_nodes[node_index].begin, m_nodes[node_index].n, hull);
+		}
+
+		void init_levels();
 
 	protected:
 
@@ -90,6 +164,14 @@ namespace PBD
 		std::vector<Node> m_nodes;
 		std::vector<HullType> m_hulls;
 		unsigned int m_maxPrimitivesPerLeaf;
+
+		/** Indices of all leaf nodes */
+		std::vector<unsigned int> m_leafNodes;
+		/** Inner nodes sorted by their depth. The nodes of depth i are stored in
+		 * m_levelNodes[m_levelOffsets[i]] ... m_levelNodes[m_levelOffsets[i + 1] - 1].
+		 */
+		std::vector<unsigned int> m_levelNodes;
+		std::vector<unsigned int> m_levelOffsets;
 	};
 
 #include "kdTree.inl"
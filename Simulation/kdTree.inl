@@ -1,6 +1,7 @@
 
 #include "BoundingSphere.h"
 #include <cstring>
+#include <cassert>
 #include "omp.h"
 
 template<typename HullType> void
@@ -8,6 +9,9 @@ KDTree<HullType>::construct()
 {
 	m_nodes.clear();
 	m_hulls.clear();
+	m_leafNodes.clear();
+	m_levelNodes.clear();
+	m_levelOffsets.clear();
 	if (m_lst.empty()) return;
 
 	std::iota(m_lst.begin(), m_lst.end(), 0);
@@ -19,6 +23,40 @@ KDTree<HullType>::construct()
 
 	auto ni = add_node(0, static_cast<unsigned int>(m_lst.size()));
 	construct(ni, box, 0, static_cast<unsigned int>(m_lst.size()));
+	init_levels();
+}
+
+template<typename HullType> void
+KDTree<HullType>::init_levels()
+{
+	m_leafNodes.clear();
+	m_levelNodes.clear();
+	m_levelOffsets.clear();
+	if (m_nodes.empty())
+		return;
+
+	// breadth first traversal sorts the nodes by their depth
+	std::vector<unsigned int> current, next;
+	current.push_back(0);
+	while (!current.empty())
+	{
+		m_levelOffsets.push_back(static_cast<unsigned int>(m_levelNodes.size()));
+		next.clear();
+		for (auto node_index : current)
+		{
+			Node const& nd = m_nodes[node_index];
+			if (nd.is_leaf())
+				m_leafNodes.push_back(node_index);
+			else
+			{
+				m_levelNodes.push_back(node_index);
+				next.push_back(nd.children[0]);
+				next.push_back(nd.children[1]);
+			}
+		}
+		std::swap(current, next);
+	}
+	m_levelOffsets.push_back(static_cast<unsigned int>(m_levelNodes.size()));
 }
 
 template<typename HullType> void
@@ -105,6 +143,73 @@ KDTree<HullType>::traverse_depth_first(unsigned int node_index,
 }
 
 
+template<typename HullType> 
+template <typename Predicate, typename Callback> void
+KDTree<HullType>::traverse_depth_first(Predicate const& pred, Callback const& cb) const
+{
+	if (m_nodes.empty())
+		return;
+
+	if (!pred(0, 0))
+		return;
+
+	// The predicate of the root is already evaluated.
+	cb(0, 0);
+	if (m_nodes[0].is_leaf())
+		return;
+
+	TraversalStack<QueueItem, MaxStackSize> stack;
+	stack.push({ static_cast<unsigned int>(m_nodes[0].children[1]), 1 });
+	stack.push({ static_cast<unsigned int>(m_nodes[0].children[0]), 1 });
+	while (!stack.empty())
+	{
+		const QueueItem item = stack.pop();
+		Node const& nd = m_nodes[item.n];
+
+		cb(item.n, item.d);
+		if (!nd.is_leaf() && pred(item.n, item.d))
+		{
+			stack.push({ static_cast<unsigned int>(nd.children[1]), item.d + 1 });
+			stack.push({ static_cast<unsigned int>(nd.children[0]), item.d + 1 });
+		}
+	}
+}
+
+template<typename HullType> 
+template <typename PacketPredicate, typename PacketCallback> void
+KDTree<HullType>::traverse_depth_first_packet(unsigned int mask, PacketPredicate const& pred, PacketCallback const& cb) const
+{
+	if (m_nodes.empty())
+		return;
+
+	mask = pred(0, 0, mask);
+	if (mask == 0)
+		return;
+
+	cb(0, 0, mask);
+	if (m_nodes[0].is_leaf())
+		return;
+
+	TraversalStack<PacketItem, MaxStackSize> stack;
+	stack.push({ static_cast<unsigned int>(m_nodes[0].children[1]), 1, mask });
+	stack.push({ static_cast<unsigned int>(m_nodes[0].children[0]), 1, mask });
+	while (!stack.empty())
+	{
+		const PacketItem item = stack.pop();
+		Node const& nd = m_nodes[item.n];
+
+		cb(item.n, item.d, item.mask);
+		if (nd.is_leaf())
+			continue;
+		const unsigned int childMask = pred(item.n, item.d, item.mask);
+		if (childMask != 0)
+		{
+			stack.push({ static_cast<unsigned int>(nd.children[1]), item.d + 1, childMask });
+			stack.push({ static_cast<unsigned int>(nd.children[0]), item.d + 1, childMask });
+		}
+	}
+}
+
 template <typename HullType> void
 KDTree<HullType>::traverse_breadth_first(TraversalPredicate const& pred, 
 	TraversalCallback const& cb, unsigned int start_node, TraversalPriorityLess const& pless,
@@ -202,12 +307,38 @@ KDTree<HullType>::traverse_breadth_first(TraversalQueue& pending,
 template <typename HullType> void
 KDTree<HullType>::update()
 {
-	traverse_depth_first(
-		[&](unsigned int, unsigned int) { return true; },
-		[&](unsigned int node_index, unsigned int)
+	if (m_nodes.empty())
+		return;
+	if (m_leafNodes.empty())
+		init_levels();
+
+	// The leaves are refitted using their primitives. Then the inner nodes are 
+	// refitted bottom-up using the hulls of their children. All nodes of one 
+	// level are independent, so each level is processed in parallel.
+	const int numLeaves = static_cast<int>(m_leafNodes.size());
+	#pragma omp parallel if(numLeaves > MIN_PARALLEL_SIZE) default(shared)
 	{
-		auto const& nd = node(node_index);
-		compute_hull_approx(nd.begin, nd.n, m_hulls[node_index]);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < numLeaves; i++)
+		{
+			const unsigned int node_index = m_leafNodes[i];
+			Node const& nd = m_nodes[node_index];
+			compute_hull_approx(nd.begin, nd.n, m_hulls[node_index]);
+		}
+	}
+
+	for (int level = static_cast<int>(m_levelOffsets.size()) - 2; level >= 0; level--)
+	{
+		const int begin = static_cast<int>(m_levelOffsets[level]);
+		const int end = static_cast<int>(m_levelOffsets[level + 1]);
+		#pragma omp parallel if(end - begin > MIN_PARALLEL_SIZE) default(shared)
+		{
+			#pragma omp for schedule(static)
+			for (int i = begin; i < end; i++)
+			{
+				const unsigned int node_index = m_levelNodes[i];
+				compute_hull_from_children(node_index, m_hulls[node_index]);
+			}
+		}
 	}
-	);
 }
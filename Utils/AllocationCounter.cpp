@@ -0,0 +1,86 @@
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+#include <atomic>
+
+using namespace Utilities;
+
+#ifdef PBD_COUNT_ALLOCATIONS
+
+static std::atomic<std::size_t> allocationCount(0);
+
+static void *countedAlloc(std::size_t size)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	return std::malloc((size > 0) ? size : 1);
+}
+
+void *operator new(std::size_t size)
+{
+	void *p = countedAlloc(size);
+	if (p == nullptr)
+		throw std::bad_alloc();
+	return p;
+}
+
+void *operator new[](std::size_t size)
+{
+	void *p = countedAlloc(size);
+	if (p == nullptr)
+		throw std::bad_alloc();
+	return p;
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+	return countedAlloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+	return countedAlloc(size);
+}
+
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept
+{
+	std::free(p);
+}
+
+bool AllocationCounter::isEnabled()
+{
+	return true;
+}
+
+std::size_t AllocationCounter::getCount()
+{
+	return allocationCount.load(std::memory_order_relaxed);
+}
+
+#else
+
+bool AllocationCounter::isEnabled()
+{
+	return false;
+}
+
+std::size_t AllocationCounter::getCount()
+{
+	return 0;
+}
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef __ALLOCATIONCOUNTER_H__
+#define __ALLOCATIONCOUNTER_H__
+
+#include <cstddef>
+
+namespace Utilities
+{
+	/** \brief Counter of the heap allocations (calls of operator new) of the process. 
+	 * The global allocation operators are only replaced if the library is compiled 
+	 * with PBD_COUNT_ALLOCATIONS (CMake option USE_ALLOCATION_COUNTER). Otherwise 
+	 * the counter is always zero.
+	 */
+	class AllocationCounter
+	{
+	public:
+		/** Return true if the allocations are counted. */
+		static bool isEnabled();
+		/** Return the number of allocations since the start of the program. */
+		static std::size_t getCount();
+	};
+}
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef __CSRADJACENCY_H__
+#define __CSRADJACENCY_H__
+
+#include <vector>
+#include <array>
+#include "Common/Common.h"
+
+namespace Utilities
+{
+	/** Adjacency lists of a set of entities (e.g. the faces of each vertex) in compressed
+	 * sparse row format. The neighbors of entity i are stored contiguously in
+	 * m_indices[m_offsets[i]] ... m_indices[m_offsets[i+1]-1].
+	 */
+	class CSRAdjacency
+	{
+	protected:
+		std::vector<unsigned int> m_offsets;
+		std::vector<unsigned int> m_indices;
+
+	public:
+		void clear()
+		{
+			m_offsets.clear();
+			m_indices.clear();
+		}
+
+		/** Number of entities */
+		unsigned int size() const { return m_offsets.empty() ? 0u : static_cast<unsigned int>(m_offsets.size() - 1u); }
+		/** Total number of neighbors of all entities */
+		unsigned int numEntries() const { return static_cast<unsigned int>(m_indices.size()); }
+		unsigned int numNeighbors(const unsigned int i) const { return m_offsets[i + 1] - m_offsets[i]; }
+		const unsigned int *begin(const unsigned int i) const { return m_indices.data() + m_offsets[i]; }
+		const unsigned int *end(const unsigned int i) const { return m_indices.data() + m_offsets[i + 1]; }
+		const std::vector<unsigned int> &getOffsets() const { return m_offsets; }
+		const std::vector<unsigned int> &getIndices() const { return m_indices; }
+
+		/** Build the adjacency of the vertices to elements with a fixed number of vertices
+		 * (e.g. faces or tets). The elements of each vertex are sorted in ascending order.
+		 * An element occurs once for each of its corners with the vertex.
+		 *
+		 * @param numVertices number of vertices
+		 * @param indices vertex indices of the elements
+		 * @param numElements number of elements
+		 * @param verticesPerElement number of vertices per element
+		 */
+		void buildFromElements(const unsigned int numVertices, const unsigned int *indices, const unsigned int numElements, const unsigned int verticesPerElement)
+		{
+			// counting sort of the element corners by their vertex
+			m_offsets.assign(numVertices + 1, 0u);
+			const unsigned int numCorners = numElements * verticesPerElement;
+			for (unsigned int i = 0; i < numCorners; i++)
+				m_offsets[indices[i] + 1]++;
+			for (unsigned int i = 0; i < numVertices; i++)
+				m_offsets[i + 1] += m_offsets[i];
+
+			m_indices.resize(numCorners);
+			std::vector<unsigned int> pos(m_offsets.begin(), m_offsets.end() - 1);
+			for (unsigned int i = 0; i < numCorners; i++)
+				m_indices[pos[indices[i]]++] = i / verticesPerElement;
+		}
+
+		/** Find equal keys, e.g. the edges of all faces given by their sorted vertex indices.
+		 * The keys are grouped by their first vertex and the groups are searched in parallel.
+		 * The unique keys are numbered in the order of their first occurrence, so the result
+		 * is the same as for a sequential search.
+		 *
+		 * @param numVertices number of vertices
+		 * @param keys sorted vertex indices of each key
+		 * @param first index of the first key which is equal to key i
+		 * @param last for each first occurrence: index of the last key which is equal to it
+		 * @param uniqueIndex number of the unique key of key i
+		 * @return number of unique keys
+		 */
+		template<size_t N>
+		static unsigned int findUniqueKeys(const unsigned int numVertices, const std::vector<std::array<unsigned int, N>> &keys,
+			std::vector<unsigned int> &first, std::vector<unsigned int> &last, std::vector<unsigned int> &uniqueIndex)
+		{
+			const unsigned int numKeys = static_cast<unsigned int>(keys.size());
+			std::vector<unsigned int> firstVertex(numKeys);
+			for (unsigned int i = 0; i < numKeys; i++)
+				firstVertex[i] = keys[i][0];
+			CSRAdjacency groups;
+			groups.buildFromElements(numVertices, firstVertex.data(), numKeys, 1);
+
+			first.resize(numKeys);
+			last.resize(numKeys);
+			// equal keys are in the same group, each group is sorted in ascending order
+			const int nVertices = static_cast<int>(numVertices);
+			#pragma omp parallel if(nVertices > MIN_PARALLEL_SIZE) default(shared)
+			{
+				#pragma omp for schedule(static)
+				for (int v = 0; v < nVertices; v++)
+				{
+					for (const unsigned int *k = groups.begin(v); k != groups.end(v); k++)
+					{
+						first[*k] = *k;
+						for (const unsigned int *l = groups.begin(v); l != k; l++)
+						{
+							if ((first[*l] == *l) && (keys[*l] == keys[*k]))
+							{
+								first[*k] = *l;
+								break;
+							}
+						}
+						last[first[*k]] = *k;
+					}
+				}
+			}
+
+			uniqueIndex.resize(numKeys);
+			unsigned int numUnique = 0;
+			for (unsigned int i = 0; i < numKeys; i++)
+			{
+				if (first[i] == i)
+					uniqueIndex[i] = numUnique++;
+				else
+					uniqueIndex[i] = uniqueIndex[first[i]];
+			}
+			return numUnique;
+		}
+	};
+}
+
+#endif
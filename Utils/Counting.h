@@ -0,0 +1,95 @@
+#ifndef __Counting_H__
+#define __Counting_H__
+
+#include "Common/Common.h"
+#include <iostream>
+#include <unordered_map>
+#include <string>
+#include <atomic>
+#include "Logger.h"
+
+namespace Utilities
+{
+	#define INCREASE_COUNTER(counterName, increaseBy) \
+	{ \
+	static int counting_counterId = -1; \
+	Utilities::Counting::increaseCounter(counterName, increaseBy, counting_counterId); \
+	}
+
+	/** \brief Struct to store the sum of a counter and the number of calls in order to compute the average.
+	*/
+	struct AverageCount
+	{
+		double sum;
+		unsigned int numberOfCalls;
+		std::string name;
+	};
+
+	/** \brief Class for counters, e.g. the number of allocations per step.
+	* The counters are defined by INIT_TIMING and are thread local like the timers.
+	*/
+	class Counting
+	{
+	public:
+		static thread_local std::unordered_map<int, AverageCount> m_averageCounts;
+
+		static void reset()
+		{
+			m_averageCounts.clear();
+		}
+
+		/** Return a new id for a counter. */
+		static int getId()
+		{
+			static std::atomic<int> id(0);
+			return id++;
+		}
+
+		/** Add increaseBy to the counter with the given id. The id is determined in the
+		 * first call. The name is only copied when the counter is created, so counting
+		 * does not allocate memory afterwards.
+		 */
+		FORCE_INLINE static void increaseCounter(const char *name, const double increaseBy, int &id)
+		{
+			if (id == -1)
+				id = getId();
+			std::unordered_map<int, AverageCount>::iterator iter = m_averageCounts.find(id);
+			if (iter == m_averageCounts.end())
+			{
+				AverageCount ac;
+				ac.sum = increaseBy;
+				ac.numberOfCalls = 1;
+				ac.name = name;
+				m_averageCounts[id] = ac;
+			}
+			else
+			{
+				iter->second.sum += increaseBy;
+				iter->second.numberOfCalls++;
+			}
+		}
+
+		FORCE_INLINE static void printAverageCounts()
+		{
+			std::unordered_map<int, AverageCount>::iterator iter;
+			for (iter = Counting::m_averageCounts.begin(); iter != Counting::m_averageCounts.end(); iter++)
+			{
+				AverageCount &ac = iter->second;
+				const double avgCount = ac.sum / ac.numberOfCalls;
+				LOG_INFO << "Average " << ac.name.c_str() << " with " << ac.numberOfCalls << " calls: " << avgCount;
+			}
+		}
+
+		FORCE_INLINE static void printCounterSums()
+		{
+			std::unordered_map<int, AverageCount>::iterator iter;
+			for (iter = Counting::m_averageCounts.begin(); iter != Counting::m_averageCounts.end(); iter++)
+			{
+				AverageCount &ac = iter->second;
+				LOG_INFO << "Counter sum " << ac.name.c_str() << ": " << ac.sum;
+			}
+		}
+	};
+}
+
+#endif
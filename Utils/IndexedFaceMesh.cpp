@@ -1,4 +1,5 @@
 #include "IndexedFaceMesh.h"
+#include <algorithm>
 
 using namespace Utilities;
 
@@ -13,25 +14,8 @@ IndexedFaceMesh& IndexedFaceMesh::operator=(IndexedFaceMesh const& other)
 	m_uvs = other.m_uvs;
     m_normals          = other.m_normals;
     m_vertexNormals    = other.m_vertexNormals;
-
-    for (size_t i(0u); i < m_facesEdges.size(); ++i)
-    {
-        m_facesEdges[i].resize(m_verticesPerFace);
-#if defined(_MSC_VER)
-        std::copy(other.m_facesEdges[i].data(), other.m_facesEdges[i].data() + m_verticesPerFace,
-            stdext::unchecked_array_iterator<unsigned int*>(m_facesEdges[i].data()));
-#else
-        std::copy(other.m_facesEdges[i].data(), other.m_facesEdges[i].data() + m_verticesPerFace, m_facesEdges[i].data());
-#endif	    
-    }
-
-    m_verticesEdges.resize(other.m_verticesEdges.size());
-    for (size_t i(0u); i < m_verticesEdges.size(); ++i)
-        m_verticesEdges[i] = other.m_verticesEdges[i];
-
-    m_verticesFaces.resize(other.m_verticesFaces.size());
-    for (size_t i(0u); i < m_verticesFaces.size(); ++i)
-        m_verticesFaces[i] = other.m_verticesFaces[i];
+	m_verticesEdges = other.m_verticesEdges;
+	m_verticesFaces = other.m_verticesFaces;
 
     return *this;
 }
@@ -66,8 +50,6 @@ void IndexedFaceMesh::initMesh(const unsigned int nPoints, const unsigned int nE
 	m_facesEdges.reserve(nFaces);
 	m_uvIndices.reserve(nFaces);
 	m_uvs.reserve(nPoints);
-	m_verticesFaces.reserve(nPoints);
-	m_verticesEdges.reserve(nPoints);
 	m_normals.reserve(nFaces);
 	m_vertexNormals.reserve(nPoints);
 }
@@ -77,7 +59,6 @@ void IndexedFaceMesh::release()
 	m_indices.clear();
 	m_edges.clear();
 	m_facesEdges.clear();
-	m_facesEdges.clear();
 	m_uvIndices.clear();
 	m_uvs.clear();
 	m_verticesFaces.clear();
@@ -117,98 +98,51 @@ void IndexedFaceMesh::addUVIndex(const unsigned int index)
 	
 void IndexedFaceMesh::buildNeighbors()
 {
-	typedef std::vector<unsigned int> PEdges;
+	buildVertexFaces();
 
-	PEdges* pEdges = new PEdges[numVertices()];
+	// edges of the faces given by their sorted vertex indices
+	const unsigned int nFaces = numFaces();
+	const unsigned int nFaceEdges = nFaces * m_verticesPerFace;
+	std::vector<std::array<unsigned int, 2>> keys(nFaceEdges);
+	for (unsigned int i = 0; i < nFaces; i++)
+	{
+		for (unsigned int j = 0u; j < m_verticesPerFace; j++)
+		{
+			const unsigned int a = m_indices[m_verticesPerFace*i + j];
+			const unsigned int b = m_indices[m_verticesPerFace*i + (j + 1) % m_verticesPerFace];
+			keys[m_verticesPerFace*i + j] = { std::min(a, b), std::max(a, b) };
+		}
+	}
 
-	// build vertex-face structure
-	m_verticesFaces.clear(); // to delete old pointers
-	m_verticesFaces.resize(numVertices());
-	m_verticesEdges.clear(); // to delete old pointers
-	m_verticesEdges.resize(numVertices());
-	m_facesEdges.clear();
-	m_facesEdges.resize(numFaces());
+	// the edges are numbered in the order of their first occurrence
+	std::vector<unsigned int> first, last, edgeIndex;
+	const unsigned int nEdges = CSRAdjacency::findUniqueKeys(numVertices(), keys, first, last, edgeIndex);
 
-	m_edges.clear();
-
-	unsigned int *v = new unsigned int[m_verticesPerFace];
-	unsigned int *edges = new unsigned int[m_verticesPerFace*2];
-	for(unsigned int i=0; i < numFaces(); i++)
-	{		
-		m_facesEdges[i].resize(m_verticesPerFace);
-		for (unsigned int j=0u; j < m_verticesPerFace; j++)
-			v[j] = m_indices[m_verticesPerFace*i+j];
-			
-		for (unsigned int j=0u; j < m_verticesPerFace-1u; j++)
+	m_edges.resize(nEdges);
+	m_facesEdges.resize(nFaces);
+	for (unsigned int i = 0; i < nFaceEdges; i++)
+	{
+		const unsigned int face = i / m_verticesPerFace;
+		const unsigned int j = i % m_verticesPerFace;
+		m_facesEdges[face][j] = edgeIndex[i];
+		if (first[i] == i)
 		{
-			edges[2*j] = v[j];
-			edges[2*j+1] = v[j+1];
+			Edge &e = m_edges[edgeIndex[i]];
+			e.m_vert[0] = m_indices[i];
+			e.m_vert[1] = m_indices[m_verticesPerFace*face + (j + 1) % m_verticesPerFace];
+			e.m_face[0] = face;
+			e.m_face[1] = (last[i] != i) ? last[i] / m_verticesPerFace : 0xffffffff;
 		}
-		edges[2*(m_verticesPerFace-1)] = v[m_verticesPerFace-1];
-		edges[2*(m_verticesPerFace-1)+1] = v[0];
+	}
 
-		for(unsigned int j=0u; j < m_verticesPerFace; j++)
-		{
-			// add vertex-face connection
-			const unsigned int vIndex = m_indices[m_verticesPerFace*i+j];
-			bool found = false;
-			for(unsigned int k=0; k < m_verticesFaces[vIndex].size(); k++)
-			{
-				if (m_verticesFaces[vIndex][k] == i)
-				{
-					found = true;
-					break;
-				}
-			}
-			if (!found)
-			{
-				m_verticesFaces[vIndex].push_back(i);
-			}
-
-			// add edge information
-			const unsigned int a = edges[j*2+0];
-			const unsigned int b = edges[j*2+1];
-			unsigned int edge = 0xffffffff;
-			// find edge
-			for(unsigned int k=0; k < pEdges[a].size(); k++)
-			{
-				const Edge& e = m_edges[pEdges[a][k]];
-				if(((e.m_vert[0] == a) || (e.m_vert[0] == b)) &&
-					((e.m_vert[1] == a) || (e.m_vert[1] == b)))
-				{
-					edge = pEdges[a][k];
-					break;
-				}
-			}
-			if(edge == 0xffffffff)
-			{
-				// create new
-				Edge e;
-				e.m_vert[0] = a;
-				e.m_vert[1] = b;
-				e.m_face[0] = i;
-				e.m_face[1] = 0xffffffff;
-				m_edges.push_back(e);
-				edge = (unsigned int) m_edges.size() - 1u;
-
-				// add vertex-edge connection				
-				m_verticesEdges[a].push_back(edge);
-				m_verticesEdges[b].push_back(edge);
-			}
-			else
-			{
-				Edge& e = m_edges[edge];
-				e.m_face[1] = i;
-			}
-			// append to points
-			pEdges[a].push_back(edge);
-			pEdges[b].push_back(edge);
-			// append face
-			m_facesEdges[i][j] = edge;
-		}			
+	// vertex-edge connection
+	std::vector<unsigned int> edgeVertices(2 * nEdges);
+	for (unsigned int i = 0; i < nEdges; i++)
+	{
+		edgeVertices[2 * i] = m_edges[i].m_vert[0];
+		edgeVertices[2 * i + 1] = m_edges[i].m_vert[1];
 	}
-	delete [] v;
-	delete [] edges;
+	m_verticesEdges.buildFromElements(numVertices(), edgeVertices.data(), nEdges, 2);
 
 	// check for boundary
 	m_closed = true;
@@ -221,8 +155,11 @@ void IndexedFaceMesh::buildNeighbors()
 			break;
 		}
 	}
+}
 
-	delete [] pEdges;
+void IndexedFaceMesh::buildVertexFaces()
+{
+	m_verticesFaces.buildFromElements(numVertices(), m_indices.data(), numFaces(), m_verticesPerFace);
 }
 	
 void IndexedFaceMesh::copyUVs(const UVIndices& uvIndices, const UVs& uvs)
@@ -4,6 +4,7 @@
 #include <vector>
 #include <array>
 #include "Common/Common.h"
+#include "CSRAdjacency.h"
 #include <iterator>
 
 namespace Utilities
@@ -21,10 +22,10 @@ namespace Utilities
 		typedef std::vector<unsigned int> Faces;
 		typedef std::vector<Vector3r> FaceNormals;
 		typedef std::vector<Vector3r> VertexNormals;
-		typedef std::vector<std::vector<unsigned int>> FacesEdges;
+		typedef std::vector<std::array<unsigned int, 3>> FacesEdges;
 		typedef std::vector<Edge> Edges;
-		typedef std::vector<std::vector<unsigned int>> VerticesEdges;
-		typedef std::vector<std::vector<unsigned int>> VerticesFaces;
+		typedef CSRAdjacency VerticesEdges;
+		typedef CSRAdjacency VerticesFaces;
 		typedef std::vector<unsigned int> UVIndices;
 		typedef std::vector<Vector2r> UVs;
 
@@ -36,6 +37,7 @@ namespace Utilities
 		bool m_closed;
 		UVIndices m_uvIndices;
 		UVs m_uvs;
+		/** Faces of each vertex (one entry per face corner) */
 		VerticesFaces m_verticesFaces;
 		VerticesEdges m_verticesEdges;
 		const unsigned int m_verticesPerFace = 3u;
@@ -82,6 +84,11 @@ namespace Utilities
 		void copyUVs(const UVIndices& uvIndices, const UVs& uvs);
 
 		void buildNeighbors();
+		/** Build the vertex-face adjacency. This is done automatically by 
+		 * buildNeighbors() and updateVertexNormals() but must be called explicitly 
+		 * if the face indices are modified in place. 
+		 */
+		void buildVertexFaces();
 
 		template<class PositionData>
 		void updateNormals(const PositionData &pd, const unsigned int offset);
@@ -126,23 +133,23 @@ namespace Utilities
 	{
 		m_vertexNormals.resize(numVertices());
 
+		if ((m_verticesFaces.size() != numVertices()) || (m_verticesFaces.numEntries() != m_indices.size()))
+			buildVertexFaces();
 
-		for (unsigned int i = 0; i < numVertices(); i++)
+		// gather the normals of the adjacent faces for each vertex 
+		// (in the same order as the faces are stored)
+		const int nVertices = (int)numVertices();
+		#pragma omp parallel if(nVertices > MIN_PARALLEL_SIZE) default(shared)
 		{
-			m_vertexNormals[i].setZero();
-		}
-
-		for (unsigned int i = 0u; i < numFaces(); i++)
-		{
-			const Vector3r &n = m_normals[i];
-			m_vertexNormals[m_indices[m_verticesPerFace*i]] += n;
-			m_vertexNormals[m_indices[m_verticesPerFace*i + 1]] += n;
-			m_vertexNormals[m_indices[m_verticesPerFace*i + 2]] += n;
-		}
-
-		for (unsigned int i = 0; i < numVertices(); i++)
-		{
-			m_vertexNormals[i].normalize();
+			#pragma omp for schedule(static)  
+			for (int i = 0; i < nVertices; i++)
+			{
+				Vector3r &n = m_vertexNormals[i];
+				n.setZero();
+				for (const unsigned int *f = m_verticesFaces.begin(i); f != m_verticesFaces.end(i); f++)
+					n += m_normals[*f];
+				n.normalize();
+			}
 		}
 	}
 
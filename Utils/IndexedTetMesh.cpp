@@ -1,4 +1,5 @@
 #include "IndexedTetMesh.h"
+#include <algorithm>
 
 using namespace Utilities;
 
@@ -19,9 +20,6 @@ void IndexedTetMesh::initMesh(const unsigned int nPoints, const unsigned int nEd
 	m_edges.reserve(nEdges);
 	m_faces.reserve(nFaces);
 	m_tets.reserve(nTets);
-	m_verticesTets.reserve(nPoints);
-	m_verticesFaces.reserve(nPoints);
-	m_verticesEdges.reserve(nPoints);
 }
 
 void IndexedTetMesh::release()
@@ -54,129 +52,84 @@ void IndexedTetMesh::addTet(const int * const indices)
 
 void IndexedTetMesh::buildNeighbors()
 {
-	typedef std::vector<unsigned int> VertexEdges;
+	const unsigned int nTets = numTets();
+	m_verticesTets.buildFromElements(numVertices(), m_tetIndices.data(), nTets, 4);
 
-	m_verticesEdges.clear(); // to delete old pointers
-	m_verticesEdges.resize(numVertices());
+	// tet edge indices: {0,1, 0,2, 0,3, 1,2, 1,3, 2,3}
+	const unsigned int edges[12] = { 0, 1, 0, 2, 0, 3, 1, 2, 1, 3, 2, 3 };
 
-	m_verticesFaces.clear(); // to delete old pointers
-	m_verticesFaces.resize(numVertices());
+	// tet face indices: {0,1,2, 1,3,2, 3,0,2, 1,0,3} => clock wise
+	//const unsigned int faces[12] = { 0, 1, 2, 1, 3, 2, 3, 0, 2, 1, 0, 3 };
 
-	m_verticesTets.clear(); // to delete old pointers
-	m_verticesTets.resize(numVertices());
+	// tet face indices: {1,0,2, 3,1,2, 0,3,2, 0,1,3} => counter clock wise
+	const unsigned int faces[12] = { 1, 0, 2, 3, 1, 2, 0, 3, 2, 0, 1, 3 };
 
-	m_faces.clear();
-	m_edges.clear();
-	m_tets.resize(numTets());
-
-	for(unsigned int i=0; i < numTets(); i++)
-	{	
-		// tet edge indices: {0,1, 0,2, 0,3, 1,2, 1,3, 2,3}
-		const unsigned int edges[12] = {	m_tetIndices[4*i], m_tetIndices[4*i+1], 
-											m_tetIndices[4*i], m_tetIndices[4*i+2], 
-											m_tetIndices[4*i], m_tetIndices[4*i+3], 
-											m_tetIndices[4*i+1], m_tetIndices[4*i+2], 
-											m_tetIndices[4*i+1], m_tetIndices[4*i+3], 
-											m_tetIndices[4*i+2], m_tetIndices[4*i+3]};
-			
-		// tet face indices: {0,1,2, 1,3,2, 3,0,2, 1,0,3} => clock wise
-		/*const unsigned int faces[12] = {	m_tetIndices[4*i], m_tetIndices[4*i+1], m_tetIndices[4*i+2], 
-											m_tetIndices[4*i+1], m_tetIndices[4*i+3], m_tetIndices[4*i+2], 
-											m_tetIndices[4*i+3], m_tetIndices[4*i], m_tetIndices[4*i+2], 
-											m_tetIndices[4*i+1], m_tetIndices[4*i], m_tetIndices[4*i+3]};*/
-
-		// tet face indices: {1,0,2, 3,1,2, 0,3,2, 0,1,3} => counter clock wise
-		const unsigned int faces[12] = {	m_tetIndices[4*i+1], m_tetIndices[4*i], m_tetIndices[4*i+2], 
-											m_tetIndices[4*i+3], m_tetIndices[4*i+1], m_tetIndices[4*i+2], 
-											m_tetIndices[4*i], m_tetIndices[4*i+3], m_tetIndices[4*i+2], 
-											m_tetIndices[4*i], m_tetIndices[4*i+1], m_tetIndices[4*i+3]};
-
-		for(unsigned int j=0u; j < 4; j++)
+	// faces and edges of the tets given by their sorted vertex indices
+	std::vector<std::array<unsigned int, 3>> faceKeys(4 * nTets);
+	std::vector<std::array<unsigned int, 2>> edgeKeys(6 * nTets);
+	for (unsigned int i = 0; i < nTets; i++)
+	{
+		const unsigned int *t = &m_tetIndices[4 * i];
+		for (unsigned int j = 0u; j < 4; j++)
 		{
-			// add vertex-tet connection
-			const unsigned int vIndex = m_tetIndices[4*i+j];
-			m_verticesTets[vIndex].push_back(i);
+			std::array<unsigned int, 3> &key = faceKeys[4 * i + j];
+			key = { t[faces[3 * j]], t[faces[3 * j + 1]], t[faces[3 * j + 2]] };
+			std::sort(key.begin(), key.end());
 		}
-
-		for(unsigned int j=0u; j < 4; j++)
+		for (unsigned int j = 0u; j < 6; j++)
 		{
-			// add face information
-			const unsigned int a = faces[j*3+0];
-			const unsigned int b = faces[j*3+1];
-			const unsigned int c = faces[j*3+2];
-			unsigned int face = 0xffffffff;
-			// find face
-			for(unsigned int k=0; k < m_verticesFaces[a].size(); k++)
-			{
-				// Check if we already have this face in the list
-				const unsigned int& faceIndex = m_verticesFaces[a][k];
-				if(((m_faceIndices[3*faceIndex] == a) || (m_faceIndices[3*faceIndex] == b) || (m_faceIndices[3*faceIndex] == c)) &&
-					((m_faceIndices[3*faceIndex+1] == a) || (m_faceIndices[3*faceIndex+1] == b) || (m_faceIndices[3*faceIndex+1] == c)) &&
-					((m_faceIndices[3*faceIndex+2] == a) || (m_faceIndices[3*faceIndex+2] == b) || (m_faceIndices[3*faceIndex+2] == c)))
-				{
-					face = m_verticesFaces[a][k];
-					break;
-				}
-			}
-			if(face == 0xffffffff)
-			{
-				// create new
-				Face f;
-				m_faceIndices.push_back(a);
-				m_faceIndices.push_back(b);
-				m_faceIndices.push_back(c);
-				face = (unsigned int) m_faceIndices.size()/3 - 1u;
-				f.m_tets[0] = i;
-				f.m_tets[1] = 0xffffffff;
-				m_faces.push_back(f);
-
-				// add vertex-face connection				
-				m_verticesFaces[a].push_back(face);
-				m_verticesFaces[b].push_back(face);
-				m_verticesFaces[c].push_back(face);
-			}
-			else
-			{
-				Face &fd = m_faces[face];
-				fd.m_tets[1] = i;
-			}
-			// append face
-			m_tets[i].m_faces[j] = face;
+			const unsigned int a = t[edges[2 * j]];
+			const unsigned int b = t[edges[2 * j + 1]];
+			edgeKeys[6 * i + j] = { std::min(a, b), std::max(a, b) };
 		}
+	}
 
-		for(unsigned int j=0u; j < 6; j++)
+	// the faces and edges are numbered in the order of their first occurrence
+	std::vector<unsigned int> first, last, index;
+	const unsigned int nFaces = CSRAdjacency::findUniqueKeys(numVertices(), faceKeys, first, last, index);
+	faceKeys.clear();
+	faceKeys.shrink_to_fit();
+
+	m_tets.resize(nTets);
+	m_faces.resize(nFaces);
+	m_faceIndices.resize(3 * nFaces);
+	for (unsigned int i = 0; i < 4 * nTets; i++)
+	{
+		const unsigned int tet = i / 4;
+		const unsigned int j = i % 4;
+		m_tets[tet].m_faces[j] = index[i];
+		if (first[i] == i)
 		{
-			// add face information
-			const unsigned int a = edges[j*2+0];
-			const unsigned int b = edges[j*2+1];
-			unsigned int edge = 0xffffffff;
-			// find edge
-			for(unsigned int k=0; k < m_verticesEdges[a].size(); k++)
-			{
-				// Check if we already have this edge in the list
-				const Edge& e = m_edges[m_verticesEdges[a][k]];
-				if(((e.m_vert[0] == a) || (e.m_vert[0] == b)) &&
-					((e.m_vert[1] == a) || (e.m_vert[1] == b)))
-				{
-					edge = m_verticesEdges[a][k];
-					break;
-				}
-			}
-			if(edge == 0xffffffff)
-			{
-				// create new
-				Edge e;
-				e.m_vert[0] = a;
-				e.m_vert[1] = b;
-				m_edges.push_back(e);
-				edge = (unsigned int) m_edges.size() - 1u;					
-
-				// add vertex-edge connection				
-				m_verticesEdges[a].push_back(edge);
-				m_verticesEdges[b].push_back(edge);
-			}
-			// append edge
-			m_tets[i].m_edges[j] = edge;
+			const unsigned int face = index[i];
+			for (unsigned int k = 0u; k < 3; k++)
+				m_faceIndices[3 * face + k] = m_tetIndices[4 * tet + faces[3 * j + k]];
+			m_faces[face].m_tets[0] = tet;
+			m_faces[face].m_tets[1] = (last[i] != i) ? last[i] / 4 : 0xffffffff;
 		}
 	}
+	m_verticesFaces.buildFromElements(numVertices(), m_faceIndices.data(), nFaces, 3);
+
+	const unsigned int nEdges = CSRAdjacency::findUniqueKeys(numVertices(), edgeKeys, first, last, index);
+	m_edges.resize(nEdges);
+	for (unsigned int i = 0; i < 6 * nTets; i++)
+	{
+		const unsigned int tet = i / 6;
+		const unsigned int j = i % 6;
+		m_tets[tet].m_edges[j] = index[i];
+		if (first[i] == i)
+		{
+			Edge &e = m_edges[index[i]];
+			e.m_vert[0] = m_tetIndices[4 * tet + edges[2 * j]];
+			e.m_vert[1] = m_tetIndices[4 * tet + edges[2 * j + 1]];
+		}
+	}
+
+	// vertex-edge connection
+	std::vector<unsigned int> edgeVertices(2 * nEdges);
+	for (unsigned int i = 0; i < nEdges; i++)
+	{
+		edgeVertices[2 * i] = m_edges[i].m_vert[0];
+		edgeVertices[2 * i + 1] = m_edges[i].m_vert[1];
+	}
+	m_verticesEdges.buildFromElements(numVertices(), edgeVertices.data(), nEdges, 2);
 }
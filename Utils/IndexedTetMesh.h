@@ -4,6 +4,7 @@
 #include <vector>
 #include <array>
 #include "Common/Common.h"
+#include "CSRAdjacency.h"
 
 namespace Utilities
 {
@@ -35,9 +36,9 @@ namespace Utilities
 		typedef std::vector<Tet> TetData;
 		typedef std::vector<Face> FaceData;
 		typedef std::vector<Edge> Edges;
-		typedef std::vector<std::vector<unsigned int>> VerticesTets;
-		typedef std::vector<std::vector<unsigned int>> VerticesFaces;
-		typedef std::vector<std::vector<unsigned int>> VerticesEdges;
+		typedef CSRAdjacency VerticesTets;
+		typedef CSRAdjacency VerticesFaces;
+		typedef CSRAdjacency VerticesEdges;
 
 	protected:
 		unsigned int m_numPoints;
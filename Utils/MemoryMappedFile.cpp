@@ -0,0 +1,95 @@
+#include "MemoryMappedFile.h"
+#ifdef WIN32
+#define NOMINMAX
+#include "windows.h"
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace Utilities;
+
+MemoryMappedFile::MemoryMappedFile() :
+	m_data(nullptr),
+	m_size(0)
+#ifdef WIN32
+	, m_fileHandle(INVALID_HANDLE_VALUE)
+	, m_mappingHandle(nullptr)
+#else
+	, m_fileDescriptor(-1)
+#endif
+{
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+	close();
+}
+
+bool MemoryMappedFile::open(const std::string &fileName)
+{
+	close();
+#ifdef WIN32
+	m_fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(m_fileHandle, &size) || (size.QuadPart == 0))
+	{
+		close();
+		return false;
+	}
+	m_size = static_cast<std::size_t>(size.QuadPart);
+	m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_mappingHandle == nullptr)
+	{
+		close();
+		return false;
+	}
+	m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+	m_fileDescriptor = ::open(fileName.c_str(), O_RDONLY);
+	if (m_fileDescriptor < 0)
+		return false;
+	struct stat st;
+	if ((fstat(m_fileDescriptor, &st) != 0) || (st.st_size == 0))
+	{
+		close();
+		return false;
+	}
+	m_size = static_cast<std::size_t>(st.st_size);
+	void *data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, m_fileDescriptor, 0);
+	if (data != MAP_FAILED)
+		m_data = static_cast<const unsigned char*>(data);
+#endif
+	if (m_data == nullptr)
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+void MemoryMappedFile::close()
+{
+#ifdef WIN32
+	if (m_data != nullptr)
+		UnmapViewOfFile(m_data);
+	if (m_mappingHandle != nullptr)
+		CloseHandle(m_mappingHandle);
+	if (m_fileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(m_fileHandle);
+	m_mappingHandle = nullptr;
+	m_fileHandle = INVALID_HANDLE_VALUE;
+#else
+	if (m_data != nullptr)
+		munmap(const_cast<unsigned char*>(m_data), m_size);
+	if (m_fileDescriptor >= 0)
+		::close(m_fileDescriptor);
+	m_fileDescriptor = -1;
+#endif
+	m_data = nullptr;
+	m_size = 0;
+}
@@ -0,0 +1,41 @@
+#ifndef __MemoryMappedFile_h__
+#define __MemoryMappedFile_h__
+
+#include <string>
+#include <cstddef>
+
+namespace Utilities
+{
+	/** \brief Read-only memory mapping of a file.
+	 * The pages of the file are loaded lazily by the operating system
+	 * and shared by all processes which map the same file.
+	 */
+	class MemoryMappedFile
+	{
+	protected:
+		const unsigned char *m_data;
+		std::size_t m_size;
+#ifdef WIN32
+		void *m_fileHandle;
+		void *m_mappingHandle;
+#else
+		int m_fileDescriptor;
+#endif
+
+	public:
+		MemoryMappedFile();
+		MemoryMappedFile(const MemoryMappedFile&) = delete;
+		MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+		~MemoryMappedFile();
+
+		/** Map the file. Returns false if the file cannot be opened or mapped. */
+		bool open(const std::string &fileName);
+		void close();
+
+		bool isOpen() const { return m_data != nullptr; }
+		const unsigned char *data() const { return m_data; }
+		std::size_t size() const { return m_size; }
+	};
+}
+
+#endif
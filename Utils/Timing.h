@@ -2,10 +2,12 @@
 #define __Timing_H__
 
 #include <iostream>
-#include <stack>
+#include <vector>
 #include <unordered_map>
 #include "Logger.h"
+#include "Counting.h"
 #include <chrono>
+#include <atomic>
 
 #include <fstream>
 #include <sstream>
@@ -40,12 +42,14 @@ namespace Utilities
 	}
 
 	#define INIT_TIMING \
-		int Utilities::IDFactory::id = 0; \
-		std::unordered_map<int, Utilities::AverageTime> Utilities::Timing::m_averageTimes; \
-		std::stack<Utilities::TimingHelper> Utilities::Timing::m_timingStack; \
+		std::atomic<int> Utilities::IDFactory::id(0); \
+		thread_local std::unordered_map<int, Utilities::AverageTime> Utilities::Timing::m_averageTimes; \
+		thread_local std::vector<Utilities::TimingHelper> Utilities::Timing::m_timingStack; \
+		thread_local unsigned int Utilities::Timing::m_timingStackSize = 0; \
+		thread_local std::unordered_map<int, Utilities::AverageCount> Utilities::Counting::m_averageCounts; \
 		bool Utilities::Timing::m_dontPrintTimes = false; \
-		unsigned int Utilities::Timing::m_startCounter = 0; \
-		unsigned int Utilities::Timing::m_stopCounter = 0;
+		thread_local unsigned int Utilities::Timing::m_startCounter = 0; \
+		thread_local unsigned int Utilities::Timing::m_stopCounter = 0;
 		
 
 
@@ -71,50 +75,68 @@ namespace Utilities
 	class IDFactory
 	{
 	private:
-		/** Current id */
-		static int id;
+		/** Current id, ids are shared by all threads */
+		static std::atomic<int> id;
 
 	public:
 		static int getId() { return id++; }
 	};
 
 	/** \brief Class for time measurements.
+	* The entries of the timing stack are reused, so starting and stopping 
+	* a timer does not allocate memory in steady state.
+	* The timers are thread local, so simulations can be performed in parallel threads.
+	* The average times only contain the measurements of the calling thread.
 	*/
 	class Timing
 	{
 	public:
 		static bool m_dontPrintTimes;
-		static unsigned int m_startCounter;
-		static unsigned int m_stopCounter;
-		static std::stack<TimingHelper> m_timingStack;
-		static std::unordered_map<int, AverageTime> m_averageTimes;
+		static thread_local unsigned int m_startCounter;
+		static thread_local unsigned int m_stopCounter;
+		static thread_local std::vector<TimingHelper> m_timingStack;
+		/** Number of running timers in m_timingStack */
+		static thread_local unsigned int m_timingStackSize;
+		static thread_local std::unordered_map<int, AverageTime> m_averageTimes;
 
 		static void reset()
 		{
-			while (!m_timingStack.empty())
-				m_timingStack.pop();
+			m_timingStackSize = 0;
 			m_averageTimes.clear();
+			Counting::reset();
 			m_startCounter = 0;
 			m_stopCounter = 0;
 		}
 
-		FORCE_INLINE static void startTiming(const std::string& name = std::string(""))
+		FORCE_INLINE static TimingHelper &pushTimingHelper()
+		{
+			if (Timing::m_timingStackSize == Timing::m_timingStack.size())
+				Timing::m_timingStack.push_back(TimingHelper());
+			Timing::m_startCounter++;
+			return Timing::m_timingStack[Timing::m_timingStackSize++];
+		}
+
+		FORCE_INLINE static void startTiming(const char *name)
 		{
-			TimingHelper h;
+			TimingHelper &h = pushTimingHelper();
+			h.name = name;
 			h.start = std::chrono::high_resolution_clock::now();
+		}
+
+		FORCE_INLINE static void startTiming(const std::string& name = std::string(""))
+		{
+			TimingHelper &h = pushTimingHelper();
 			h.name = name;
-			Timing::m_timingStack.push(h);
-			Timing::m_startCounter++;
+			h.start = std::chrono::high_resolution_clock::now();
 		}
 
 		FORCE_INLINE static double stopTiming(bool print = true)
 		{
-			if (!Timing::m_timingStack.empty())
+			if (Timing::m_timingStackSize > 0)
 			{
 				Timing::m_stopCounter++;
 				std::chrono::time_point<std::chrono::high_resolution_clock> stop = std::chrono::high_resolution_clock::now();
-				TimingHelper h = Timing::m_timingStack.top();
-				Timing::m_timingStack.pop();
+				const TimingHelper &h = Timing::m_timingStack[--Timing::m_timingStackSize];
 				std::chrono::duration<double> elapsed_seconds = stop - h.start;
 				double t = elapsed_seconds.count() * 1000.0;
 
@@ -129,12 +151,11 @@ namespace Utilities
 		{
 			if (id == -1)
 				id = IDFactory::getId();
-			if (!Timing::m_timingStack.empty())
+			if (Timing::m_timingStackSize > 0)
 			{
 				Timing::m_stopCounter++;
 				std::chrono::time_point<std::chrono::high_resolution_clock> stop = std::chrono::high_resolution_clock::now();
-				TimingHelper h = Timing::m_timingStack.top();
-				Timing::m_timingStack.pop();
+				const TimingHelper &h = Timing::m_timingStack[--Timing::m_timingStackSize];
 
 				std::chrono::duration<double> elapsed_seconds = stop - h.start;
 				double t = elapsed_seconds.count() * 1000.0;
@@ -178,6 +199,7 @@ namespace Utilities
 				const double avgTime = at.totalTime / at.counter;
 				LOG_INFO << "Average time " << at.name.c_str() << " with " << at.counter << " calls: " << avgTime << " ms";
 			}
+			Counting::printAverageCounts();
 			if (Timing::m_startCounter != Timing::m_stopCounter)
 				LOG_INFO << "Problem: " << Timing::m_startCounter << " calls of startTiming and " << Timing::m_stopCounter << " calls of stopTiming. ";
 			LOG_INFO << "---------------------------------------------------------------------------\n";
@@ -35,6 +35,8 @@ void CollisionDetectionModule(py::module m_sub)
         .def("cleanup", &PBD::CollisionDetection::cleanup)
         .def("getTolerance", &PBD::CollisionDetection::getTolerance)
         .def("setTolerance", &PBD::CollisionDetection::setTolerance)
+        .def("getBroadPhaseMethod", &PBD::CollisionDetection::getBroadPhaseMethod)
+        .def("setBroadPhaseMethod", &PBD::CollisionDetection::setBroadPhaseMethod)
         .def("addRigidBodyContact", &PBD::CollisionDetection::addRigidBodyContact)
         .def("addParticleRigidBodyContact", &PBD::CollisionDetection::addParticleRigidBodyContact)
         .def("addParticleSolidContact", &PBD::CollisionDetection::addParticleSolidContact)
@@ -130,6 +132,23 @@ void CollisionDetectionModule(py::module m_sub)
     py::class_<PBD::CubicSDFCollisionDetection::Grid, std::shared_ptr<PBD::CubicSDFCollisionDetection::Grid>>(m_sub, "CubicSDFCollisionDetectionGridPtr")
         ;
 
+    py::class_<PBD::FloatCubicSDF, std::shared_ptr<PBD::FloatCubicSDF>>(m_sub, "FloatCubicSDF")
+        .def(py::init<>())
+        .def("init", &PBD::FloatCubicSDF::init, py::arg("grid"), py::arg("fieldId") = 0, py::arg("bandWidth") = FLT_MAX)
+        .def("save", &PBD::FloatCubicSDF::save)
+        .def("load", &PBD::FloatCubicSDF::load)
+        .def_static("convert", &PBD::FloatCubicSDF::convert, py::arg("gridFileName"), py::arg("fileName"), py::arg("bandWidth") = FLT_MAX, py::arg("fieldId") = 0)
+        .def_static("isFloatCubicSDFFile", &PBD::FloatCubicSDF::isFloatCubicSDFFile)
+        .def("isInitialized", &PBD::FloatCubicSDF::isInitialized)
+        .def("isMemoryMapped", &PBD::FloatCubicSDF::isMemoryMapped)
+        .def("numCells", &PBD::FloatCubicSDF::numCells)
+        .def("getBandWidth", &PBD::FloatCubicSDF::getBandWidth)
+        .def("interpolate", [](const PBD::FloatCubicSDF &sdf, const Vector3r &x)
+            {
+                return sdf.interpolate(x.template cast<float>());
+            })
+        ;
+
     py::class_<PBD::CubicSDFCollisionDetection, PBD::DistanceFieldCollisionDetection>(m_sub, "CubicSDFCollisionDetection")
         .def(py::init<>())
         .def("addCubicSDFCollisionObject", [](PBD::CubicSDFCollisionDetection& cd, const unsigned int bodyIndex, const unsigned int bodyType,
@@ -152,6 +171,16 @@ void CollisionDetectionModule(py::module m_sub)
             {
                 cd.addCubicSDFCollisionObject(bodyIndex, bodyType, &pd.getPosition(offset), numVertices, sdf, scale, testMesh, invertSDF);
             })
+        .def("addCubicSDFCollisionObject", [](PBD::CubicSDFCollisionDetection& cd, const unsigned int bodyIndex, const unsigned int bodyType,
+            const PBD::ParticleData& pd, const unsigned int offset, const unsigned int numVertices, PBD::FloatCubicSDFPtr sdf, const Vector3r& scale, const bool testMesh, const bool invertSDF)
+            {
+                cd.addCubicSDFCollisionObject(bodyIndex, bodyType, &pd.getPosition(offset), numVertices, sdf, scale, testMesh, invertSDF);
+            })
+        .def("addCubicSDFCollisionObject", [](PBD::CubicSDFCollisionDetection& cd, const unsigned int bodyIndex, const unsigned int bodyType,
+            const PBD::VertexData& pd, const unsigned int offset, const unsigned int numVertices, PBD::FloatCubicSDFPtr sdf, const Vector3r& scale, const bool testMesh, const bool invertSDF)
+            {
+                cd.addCubicSDFCollisionObject(bodyIndex, bodyType, &pd.getPosition(offset), numVertices, sdf, scale, testMesh, invertSDF);
+            })
         .def_static("generateSDF", [](const PBD::VertexData &vd, const Utilities::IndexedFaceMesh &mesh, const Eigen::Matrix<unsigned int, 3, 1> &resolution) -> PBD::CubicSDFCollisionDetection::GridPtr
             {
                 const std::vector<unsigned int>& faces = mesh.getFaces();
@@ -140,9 +140,13 @@ void ConstraintsModule(py::module m_sub)
         .def_readwrite("stiffness", &PBD::RigidBodyContactConstraint::m_stiffness)
         .def_readwrite("frictionCoeff", &PBD::RigidBodyContactConstraint::m_frictionCoeff)
         .def_readwrite("sum_impulses", &PBD::RigidBodyContactConstraint::m_sum_impulses)
+        .def_readwrite("featureIndex", &PBD::RigidBodyContactConstraint::m_featureIndex)
         .def_readwrite("constraintInfo", &PBD::RigidBodyContactConstraint::m_constraintInfo)
         .def("getTypeId", &PBD::RigidBodyContactConstraint::getTypeId)
-        .def("initConstraint", &PBD::RigidBodyContactConstraint::initConstraint)
+        .def("initConstraint", &PBD::RigidBodyContactConstraint::initConstraint,
+            py::arg("model"), py::arg("rbIndex1"), py::arg("rbIndex2"), py::arg("cp1"), py::arg("cp2"), py::arg("normal"), py::arg("dist"), 
+            py::arg("restitutionCoeff"), py::arg("stiffness"), py::arg("frictionCoeff"), py::arg("featureIndex") = PBD::RigidBodyContactConstraint::InvalidFeatureIndex)
+        .def("warmStart", &PBD::RigidBodyContactConstraint::warmStart)
         .def("solveVelocityConstraint", &PBD::RigidBodyContactConstraint::solveVelocityConstraint);
 
     py::class_<PBD::ParticleRigidBodyContactConstraint>(m_sub, "ParticleRigidBodyContactConstraint")
@@ -25,11 +25,13 @@ void ParticleDataModule(py::module m_sub)
         .def("release", &PBD::VertexData::release)
         .def("size", &PBD::VertexData::size)
         //.def("getVertices", &PBD::VertexData::getVertices, py::return_value_policy::reference);
-        .def("getVertices", [](PBD::VertexData& vd) -> py::memoryview {
-            void* base_ptr = const_cast<Real*>(&(vd.getVertices())[0][0]);
-            int num_vert = vd.size();
-            return py::memoryview::from_buffer((Real*)base_ptr, { num_vert, 3 }, { sizeof(Real) * 3, sizeof(Real) }, true);
-            });
+        .def("getVertices", [](py::object self) {
+            PBD::VertexData& vd = self.cast<PBD::VertexData&>();
+            return createVector3rArrayView(vd.getVertices(), self);
+            }, "Zero-copy NumPy view (n x 3) of the vertices. Writing to the array changes the vertices.")
+        .def("setVertices", [](PBD::VertexData& vd, const RealArray& x) {
+            copyArrayToVector3r(x, vd.getVertices(), "setVertices");
+            }, py::arg("x"));
 
     py::class_<PBD::ParticleData>(m_sub, "ParticleData")
         .def(py::init<>())
@@ -51,9 +53,34 @@ void ParticleDataModule(py::module m_sub)
         .def("release", &PBD::ParticleData::release)
         .def("size", &PBD::ParticleData::size)
         //.def("getVertices", &PBD::ParticleData::getVertices, py::return_value_policy::reference);
-        .def("getVertices", [](PBD::ParticleData &pd) -> py::memoryview {
-            void* base_ptr = const_cast<Real*>(&(pd.getVertices())[0][0]);
-            int num_vert = pd.getNumberOfParticles();
-            return py::memoryview::from_buffer((Real*)base_ptr, { num_vert, 3 }, { sizeof(Real) * 3, sizeof(Real) }, true);
-            });
+        .def("getVertices", [](py::object self) {
+            PBD::ParticleData& pd = self.cast<PBD::ParticleData&>();
+            return createVector3rArrayView(pd.getVertices(), self);
+            }, "Zero-copy NumPy view (n x 3) of the particle positions. Writing to the array changes the positions.")
+        .def("setVertices", [](PBD::ParticleData& pd, const RealArray& x) {
+            copyArrayToVector3r(x, pd.getVertices(), "setVertices");
+            }, py::arg("x"))
+        .def("getVelocities", [](py::object self) {
+            PBD::ParticleData& pd = self.cast<PBD::ParticleData&>();
+            return createVector3rArrayView(pd.getVelocities(), self);
+            }, "Zero-copy NumPy view (n x 3) of the particle velocities. Writing to the array changes the velocities.")
+        .def("setVelocities", [](PBD::ParticleData& pd, const RealArray& v) {
+            copyArrayToVector3r(v, pd.getVelocities(), "setVelocities");
+            }, py::arg("v"))
+        // the masses are read-only views since the inverse masses have to be updated by setMasses
+        .def("getMasses", [](py::object self) {
+            PBD::ParticleData& pd = self.cast<PBD::ParticleData&>();
+            return createRealArrayView(pd.getMasses().data(), { static_cast<py::ssize_t>(pd.getNumberOfParticles()) }, self, false);
+            }, "Zero-copy read-only NumPy view of the particle masses.")
+        .def("getInvMasses", [](py::object self) {
+            PBD::ParticleData& pd = self.cast<PBD::ParticleData&>();
+            return createRealArrayView(pd.getInvMasses().data(), { static_cast<py::ssize_t>(pd.getNumberOfParticles()) }, self, false);
+            }, "Zero-copy read-only NumPy view of the inverse particle masses.")
+        .def("setMasses", [](PBD::ParticleData& pd, const RealArray& masses) {
+            const unsigned int n = pd.getNumberOfParticles();
+            checkArrayShape(masses, n, 0, "setMasses");
+            const Real* m = masses.data();
+            for (unsigned int i = 0; i < n; i++)
+                pd.setMass(i, m[i]);
+            }, py::arg("masses"));
 }
\ No newline at end of file
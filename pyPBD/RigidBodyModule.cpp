@@ -27,10 +27,10 @@ void RigidBodyModule(py::module m_sub)
     py::class_<PBD::RigidBodyGeometry>(m_sub, "RigidBodyGeometry")
         .def(py::init<>())
         .def("getMesh", &PBD::RigidBodyGeometry::getMesh)
-        .def("getVertexData", (const PBD::VertexData & (PBD::RigidBodyGeometry::*)()const)(&PBD::RigidBodyGeometry::getVertexData))
-        .def("getVertexDataLocal", (const PBD::VertexData & (PBD::RigidBodyGeometry::*)()const)(&PBD::RigidBodyGeometry::getVertexDataLocal))
+        .def("getVertexData", (const PBD::VertexData & (PBD::RigidBodyGeometry::*)()const)(&PBD::RigidBodyGeometry::getVertexData), py::return_value_policy::reference_internal)
+        .def("getVertexDataLocal", (const PBD::VertexData & (PBD::RigidBodyGeometry::*)()const)(&PBD::RigidBodyGeometry::getVertexDataLocal), py::return_value_policy::reference_internal)
         .def("initMesh", &PBD::RigidBodyGeometry::initMesh)
-        .def("updateMeshTransformation", &PBD::RigidBodyGeometry::updateMeshTransformation)
+        .def("updateMeshTransformation", &PBD::RigidBodyGeometry::updateMeshTransformation, py::arg("x"), py::arg("R"), py::arg("updateNormals") = true)
         .def("updateMeshNormals", &PBD::RigidBodyGeometry::updateMeshNormals)
         ;
 
@@ -112,7 +112,7 @@ void RigidBodyModule(py::module m_sub)
         .def("setRestitutionCoeff", &PBD::RigidBody::setRestitutionCoeff)
         .def("getFrictionCoeff", &PBD::RigidBody::getFrictionCoeff)
         .def("setFrictionCoeff", &PBD::RigidBody::setFrictionCoeff)
-        .def("getGeometry", &PBD::RigidBody::getGeometry)
+        .def("getGeometry", &PBD::RigidBody::getGeometry, py::return_value_policy::reference_internal)
     ;
 
 }
\ No newline at end of file
@@ -44,6 +44,40 @@ PBD::CubicSDFCollisionDetection::GridPtr generateSDF(const std::vector<Vector3r>
     return sdf;
 }
 
+/** Copy the contact points, normals and impulses of rigid body or particle-rigid body contacts to NumPy arrays. */
+template<typename ContactConstraintVector>
+py::dict getContacts(const ContactConstraintVector& contacts)
+{
+    const py::ssize_t n = static_cast<py::ssize_t>(contacts.size());
+    py::array_t<unsigned int> bodies({ n, static_cast<py::ssize_t>(2) });
+    py::array_t<Real> points0({ n, static_cast<py::ssize_t>(3) });
+    py::array_t<Real> points1({ n, static_cast<py::ssize_t>(3) });
+    py::array_t<Real> normals({ n, static_cast<py::ssize_t>(3) });
+    py::array_t<Real> sumImpulses(n);
+    unsigned int* b = bodies.mutable_data();
+    Real* p0 = points0.mutable_data();
+    Real* p1 = points1.mutable_data();
+    Real* nd = normals.mutable_data();
+    Real* s = sumImpulses.mutable_data();
+    for (size_t i = 0; i < contacts.size(); i++)
+    {
+        b[2 * i] = contacts[i].m_bodies[0];
+        b[2 * i + 1] = contacts[i].m_bodies[1];
+        // constraint info: contact points (0, 1) and normal (2)
+        Vector3r::Map(&p0[3 * i]) = contacts[i].m_constraintInfo.col(0);
+        Vector3r::Map(&p1[3 * i]) = contacts[i].m_constraintInfo.col(1);
+        Vector3r::Map(&nd[3 * i]) = contacts[i].m_constraintInfo.col(2);
+        s[i] = contacts[i].m_sum_impulses;
+    }
+    py::dict d;
+    d["bodies"] = bodies;
+    d["points0"] = points0;
+    d["points1"] = points1;
+    d["normals"] = normals;
+    d["sumImpulses"] = sumImpulses;
+    return d;
+}
+
 void SimulationModelModule(py::module m_sub) 
 {
     py::class_<PBD::TriangleModel>(m_sub, "TriangleModel")
@@ -68,14 +102,14 @@ void SimulationModelModule(py::module m_sub)
         .def("setInitialScale", &PBD::TetModel::setInitialScale)
 
         .def("getSurfaceMesh", &PBD::TetModel::getSurfaceMesh)
-        .def("getVisVertices", &PBD::TetModel::getVisVertices)
+        .def("getVisVertices", &PBD::TetModel::getVisVertices, py::return_value_policy::reference_internal)
         .def("getVisMesh", &PBD::TetModel::getVisMesh)
         .def("getParticleMesh", (const PBD::TetModel::ParticleMesh & (PBD::TetModel::*)()const)(&PBD::TetModel::getParticleMesh))
         .def("cleanupModel", &PBD::TetModel::cleanupModel)
         .def("getIndexOffset", &PBD::TetModel::getIndexOffset)
         .def("initMesh", &PBD::TetModel::initMesh)
         .def("updateMeshNormals", &PBD::TetModel::updateMeshNormals)
-        .def("attachVisMesh", &PBD::TetModel::attachVisMesh)
+        .def("attachVisMesh", &PBD::TetModel::attachVisMesh, py::arg("pd"), py::arg("useBVH") = true)
         .def("updateVisMesh", &PBD::TetModel::updateVisMesh)
         .def("getRestitutionCoeff", &PBD::TetModel::getRestitutionCoeff)
         .def("setRestitutionCoeff", &PBD::TetModel::setRestitutionCoeff)
@@ -119,7 +153,7 @@ void SimulationModelModule(py::module m_sub)
                 return triModels[i];
             }, py::arg("points"), py::arg("indices"), py::arg("uvIndices") = PBD::TriangleModel::ParticleMesh::UVIndices(),
                 py::arg("uvs") = PBD::TriangleModel::ParticleMesh::UVs(), py::arg("testMesh") = false,
-                py::return_value_policy::reference)
+                py::return_value_policy::reference_internal)
         .def("addRegularTriangleModel", [](PBD::SimulationModel &model, 
             const int width, const int height,
             const Vector3r& translation,
@@ -143,7 +177,7 @@ void SimulationModelModule(py::module m_sub)
                 return triModels[i];
             }, py::arg("width"), py::arg("height"), py::arg("translation") = Vector3r::Zero(),
                 py::arg("rotation") = Matrix3r::Identity(), py::arg("scale") = Vector2r::Ones(), py::arg("testMesh") = false,
-                py::return_value_policy::reference)
+                py::return_value_policy::reference_internal)
         .def("addTetModel", [](
             PBD::SimulationModel& model,
             std::vector<Vector3r>& points,
@@ -202,7 +236,7 @@ void SimulationModelModule(py::module m_sub)
                 return tetModel;
             }, py::arg("points"), py::arg("indices"), py::arg("testMesh") = false,
                 py::arg("generateCollisionObject") = false, py::arg("resolution") = Eigen::Matrix<unsigned int, 3, 1>(30, 30, 30),
-                py::return_value_policy::reference)
+                py::return_value_policy::reference_internal)
         .def("addRegularTetModel", [](PBD::SimulationModel &model, 
             const int width, const int height, const int depth,
             const Vector3r& translation,
@@ -226,7 +260,7 @@ void SimulationModelModule(py::module m_sub)
                 return tetModels[i];
             }, py::arg("width"), py::arg("height"), py::arg("depth"), py::arg("translation") = Vector3r::Zero(),
                 py::arg("rotation") = Matrix3r::Identity(), py::arg("scale") = Vector3r::Ones(), py::arg("testMesh") = false, 
-                py::return_value_policy::reference)
+                py::return_value_policy::reference_internal)
         .def("addLineModel", [](
             PBD::SimulationModel& model,
             const unsigned int nPoints,
@@ -251,7 +285,9 @@ void SimulationModelModule(py::module m_sub)
         .def("addRigidBodySpring", &PBD::SimulationModel::addRigidBodySpring)
         .def("addDistanceJoint", &PBD::SimulationModel::addDistanceJoint)
         .def("addDamperJoint", &PBD::SimulationModel::addDamperJoint)
-        .def("addRigidBodyContactConstraint", &PBD::SimulationModel::addRigidBodyContactConstraint)
+        .def("addRigidBodyContactConstraint", &PBD::SimulationModel::addRigidBodyContactConstraint, 
+            py::arg("rbIndex1"), py::arg("rbIndex2"), py::arg("cp1"), py::arg("cp2"), py::arg("normal"), py::arg("dist"), 
+            py::arg("restitutionCoeff"), py::arg("frictionCoeff"), py::arg("featureIndex") = PBD::RigidBodyContactConstraint::InvalidFeatureIndex)
         .def("addParticleRigidBodyContactConstraint", &PBD::SimulationModel::addParticleRigidBodyContactConstraint)
         .def("addParticleSolidContactConstraint", &PBD::SimulationModel::addParticleSolidContactConstraint)
         .def("addDistanceConstraint", &PBD::SimulationModel::addDistanceConstraint)
@@ -281,17 +317,17 @@ void SimulationModelModule(py::module m_sub)
         .def("addStretchBendingTwistingConstraint", &PBD::SimulationModel::addStretchBendingTwistingConstraint)
         .def("addDirectPositionBasedSolverForStiffRodsConstraint", &PBD::SimulationModel::addDirectPositionBasedSolverForStiffRodsConstraint)
         
-        .def("getParticles", &PBD::SimulationModel::getParticles, py::return_value_policy::reference)
-        .def("getRigidBodies", &PBD::SimulationModel::getRigidBodies, py::return_value_policy::reference)
-        .def("getTriangleModels", &PBD::SimulationModel::getTriangleModels, py::return_value_policy::reference)
-        .def("getTetModels", &PBD::SimulationModel::getTetModels, py::return_value_policy::reference)
-        .def("getLineModels", &PBD::SimulationModel::getLineModels, py::return_value_policy::reference)
-        .def("getConstraints", &PBD::SimulationModel::getConstraints, py::return_value_policy::reference)
-        .def("getOrientations", &PBD::SimulationModel::getOrientations, py::return_value_policy::reference)
-        .def("getRigidBodyContactConstraints", &PBD::SimulationModel::getRigidBodyContactConstraints, py::return_value_policy::reference)
-        .def("getParticleRigidBodyContactConstraints", &PBD::SimulationModel::getParticleRigidBodyContactConstraints, py::return_value_policy::reference)
-        .def("getParticleSolidContactConstraints", &PBD::SimulationModel::getParticleSolidContactConstraints, py::return_value_policy::reference)
-        .def("getConstraintGroups", &PBD::SimulationModel::getConstraintGroups, py::return_value_policy::reference)
+        .def("getParticles", &PBD::SimulationModel::getParticles, py::return_value_policy::reference_internal)
+        .def("getRigidBodies", &PBD::SimulationModel::getRigidBodies, py::return_value_policy::reference_internal)
+        .def("getTriangleModels", &PBD::SimulationModel::getTriangleModels, py::return_value_policy::reference_internal)
+        .def("getTetModels", &PBD::SimulationModel::getTetModels, py::return_value_policy::reference_internal)
+        .def("getLineModels", &PBD::SimulationModel::getLineModels, py::return_value_policy::reference_internal)
+        .def("getConstraints", &PBD::SimulationModel::getConstraints, py::return_value_policy::reference_internal)
+        .def("getOrientations", &PBD::SimulationModel::getOrientations, py::return_value_policy::reference_internal)
+        .def("getRigidBodyContactConstraints", &PBD::SimulationModel::getRigidBodyContactConstraints, py::return_value_policy::reference_internal)
+        .def("getParticleRigidBodyContactConstraints", &PBD::SimulationModel::getParticleRigidBodyContactConstraints, py::return_value_policy::reference_internal)
+        .def("getParticleSolidContactConstraints", &PBD::SimulationModel::getParticleSolidContactConstraints, py::return_value_policy::reference_internal)
+        .def("getConstraintGroups", &PBD::SimulationModel::getConstraintGroups, py::return_value_policy::reference_internal)
         .def("resetContacts", &PBD::SimulationModel::resetContacts)
 
         .def("addClothConstraints", &PBD::SimulationModel::addClothConstraints)
@@ -302,6 +338,101 @@ void SimulationModelModule(py::module m_sub)
         .def("setContactStiffnessRigidBody", &PBD::SimulationModel::setContactStiffnessRigidBody)
         .def("getContactStiffnessParticleRigidBody", &PBD::SimulationModel::getContactStiffnessParticleRigidBody)
         .def("setContactStiffnessParticleRigidBody", &PBD::SimulationModel::setContactStiffnessParticleRigidBody)
+        .def("getContactWarmStarting", &PBD::SimulationModel::getContactWarmStarting)
+        .def("setContactWarmStarting", &PBD::SimulationModel::setContactWarmStarting)
+        .def("getUpdateNormals", &PBD::SimulationModel::getUpdateNormals)
+        .def("setUpdateNormals", &PBD::SimulationModel::setUpdateNormals)
+        .def_readwrite_static("SOLVER_METHOD", &PBD::SimulationModel::SOLVER_METHOD)
+        .def_readwrite_static("ENUM_SOLVER_GAUSS_SEIDEL", &PBD::SimulationModel::ENUM_SOLVER_GAUSS_SEIDEL)
+        .def_readwrite_static("ENUM_SOLVER_JACOBI", &PBD::SimulationModel::ENUM_SOLVER_JACOBI)
+        .def_readwrite_static("JACOBI_RELAXATION", &PBD::SimulationModel::JACOBI_RELAXATION)
+        .def("getSolverMethod", &PBD::SimulationModel::getSolverMethod)
+        .def("setSolverMethod", &PBD::SimulationModel::setSolverMethod)
+        .def("getJacobiRelaxation", &PBD::SimulationModel::getJacobiRelaxation)
+        .def("setJacobiRelaxation", &PBD::SimulationModel::setJacobiRelaxation)
+        .def("clearContactImpulseCache", &PBD::SimulationModel::clearContactImpulseCache)
+
+        // bulk access to the rigid bodies, the bodies are not stored contiguously, so the data is copied
+        .def("getRigidBodyTransforms", [](PBD::SimulationModel& model) {
+            PBD::SimulationModel::RigidBodyVector& rbs = model.getRigidBodies();
+            py::array_t<Real> a({ static_cast<py::ssize_t>(rbs.size()), static_cast<py::ssize_t>(7) });
+            copyRigidBodyTransforms(rbs, a.mutable_data());
+            return a;
+            }, "Return the transformations of all rigid bodies as (n x 7) array. Each row contains the position and the rotation quaternion (x, y, z, w).")
+        .def("setRigidBodyTransforms", [](PBD::SimulationModel& model, const RealArray& transforms) {
+            PBD::SimulationModel::RigidBodyVector& rbs = model.getRigidBodies();
+            checkArrayShape(transforms, rbs.size(), 7, "setRigidBodyTransforms");
+            const Real* data = transforms.data();
+            for (size_t i = 0; i < rbs.size(); i++)
+            {
+                PBD::RigidBody* rb = rbs[i];
+                Quaternionr q;
+                q.coeffs() = Vector4r::Map(&data[7 * i + 3]);
+                q.normalize();
+                rb->setPosition(Vector3r::Map(&data[7 * i]));
+                rb->setRotation(q);
+                // also update static bodies
+                rb->setRotationMatrix(q.matrix());
+                rb->updateInertiaW();
+                rb->updateInverseTransformation();
+                rb->getGeometry().updateMeshTransformation(rb->getPosition(), rb->getRotationMatrix(), model.getUpdateNormals());
+            }
+            }, py::arg("transforms"))
+        .def("getRigidBodyVelocities", [](PBD::SimulationModel& model) {
+            PBD::SimulationModel::RigidBodyVector& rbs = model.getRigidBodies();
+            py::array_t<Real> a({ static_cast<py::ssize_t>(rbs.size()), static_cast<py::ssize_t>(6) });
+            copyRigidBodyVelocities(rbs, a.mutable_data());
+            return a;
+            }, "Return the velocities of all rigid bodies as (n x 6) array. Each row contains the linear and the angular velocity.")
+        .def("setRigidBodyVelocities", [](PBD::SimulationModel& model, const RealArray& velocities) {
+            PBD::SimulationModel::RigidBodyVector& rbs = model.getRigidBodies();
+            checkArrayShape(velocities, rbs.size(), 6, "setRigidBodyVelocities");
+            const Real* data = velocities.data();
+            for (size_t i = 0; i < rbs.size(); i++)
+            {
+                rbs[i]->setVelocity(Vector3r::Map(&data[6 * i]));
+                rbs[i]->setAngularVelocity(Vector3r::Map(&data[6 * i + 3]));
+            }
+            }, py::arg("velocities"))
+
+        // contact lists of the last step as dictionaries of arrays
+        .def("getRigidBodyContacts", [](PBD::SimulationModel& model) {
+            return getContacts(model.getRigidBodyContactConstraints());
+            }, "Return the rigid body contacts as dictionary with the arrays bodies (n x 2), points0, points1, normals (n x 3) and sumImpulses (n).")
+        .def("getParticleRigidBodyContacts", [](PBD::SimulationModel& model) {
+            return getContacts(model.getParticleRigidBodyContactConstraints());
+            }, "Return the particle-rigid body contacts as dictionary with the arrays bodies (n x 2), points0, points1, normals (n x 3) and sumImpulses (n).")
+        .def("getParticleSolidContacts", [](PBD::SimulationModel& model) {
+            const PBD::SimulationModel::ParticleSolidContactConstraintVector& contacts = model.getParticleSolidContactConstraints();
+            const py::ssize_t n = static_cast<py::ssize_t>(contacts.size());
+            py::array_t<unsigned int> bodies({ n, static_cast<py::ssize_t>(2) });
+            py::array_t<unsigned int> tets(n);
+            py::array_t<Real> bary({ n, static_cast<py::ssize_t>(3) });
+            py::array_t<Real> normals({ n, static_cast<py::ssize_t>(3) });
+            py::array_t<Real> lambdas(n);
+            unsigned int* b = bodies.mutable_data();
+            unsigned int* t = tets.mutable_data();
+            Real* ba = bary.mutable_data();
+            Real* nd = normals.mutable_data();
+            Real* l = lambdas.mutable_data();
+            for (size_t i = 0; i < contacts.size(); i++)
+            {
+                const PBD::ParticleTetContactConstraint& c = contacts[i];
+                b[2 * i] = c.m_bodies[0];
+                b[2 * i + 1] = c.m_bodies[1];
+                t[i] = c.m_tetIndex;
+                Vector3r::Map(&ba[3 * i]) = c.m_bary;
+                Vector3r::Map(&nd[3 * i]) = c.m_constraintInfo.col(0);
+                l[i] = c.m_lambda;
+            }
+            py::dict d;
+            d["bodies"] = bodies;
+            d["tetIndices"] = tets;
+            d["bary"] = bary;
+            d["normals"] = normals;
+            d["lambdas"] = lambdas;
+            return d;
+            }, "Return the particle-solid contacts as dictionary with the arrays bodies (n x 2, particle and solid index), tetIndices (n), bary, normals (n x 3) and lambdas (n).")
 
         .def("addRigidBody", [](PBD::SimulationModel &model, const Real density, 
             const PBD::VertexData& vertices, 
@@ -332,7 +463,7 @@ void SimulationModelModule(py::module m_sub)
             }, py::arg("density"), py::arg("vertices"), py::arg("mesh"), py::arg("translation") = Vector3r::Zero(),
                 py::arg("rotation") = Matrix3r::Identity(), py::arg("scale") = Vector3r::Ones(), py::arg("testMesh") = false,
                 py::arg("sdf"),
-                py::return_value_policy::reference)
+                py::return_value_policy::reference_internal)
         .def("addRigidBody", [](PBD::SimulationModel &model, const Real density, 
             const PBD::VertexData& vertices, 
             const Utilities::IndexedFaceMesh& mesh, 
@@ -379,7 +510,7 @@ void SimulationModelModule(py::module m_sub)
             }, py::arg("density"), py::arg("vertices"), py::arg("mesh"), py::arg("translation") = Vector3r::Zero(),
                 py::arg("rotation") = Matrix3r::Identity(), py::arg("scale") = Vector3r::Ones(), py::arg("testMesh") = false,
                 py::arg("generateCollisionObject") = false, py::arg("resolution") = Eigen::Matrix<unsigned int, 3, 1>(30,30,30),
-                py::return_value_policy::reference)
+                py::return_value_policy::reference_internal)
         ;
 
 }
\ No newline at end of file
@@ -1,12 +1,147 @@
 #include "common.h"
 
 #include <Simulation/Simulation.h>
+#include <Simulation/BatchRunner.h>
 #include <Simulation/CubicSDFCollisionDetection.h>
+#include <Simulation/TimeManager.h>
 
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include <algorithm>
 
 namespace py = pybind11;
 
+/** Channel which is recorded by Simulation.advance after each step */
+struct RecordChannel
+{
+    enum Type { TIME, POSITIONS, VELOCITIES, RIGID_BODY_TRANSFORMS, RIGID_BODY_VELOCITIES };
+    Type type;
+    Real *data;
+    /** Number of values per step */
+    size_t size;
+};
+
+/** Return the type and the shape of the values of a record channel in one step. */
+static RecordChannel::Type getRecordChannelType(const std::string &name, PBD::SimulationModel &model, std::vector<py::ssize_t> &shape)
+{
+    const py::ssize_t numParticles = static_cast<py::ssize_t>(model.getParticles().size());
+    const py::ssize_t numBodies = static_cast<py::ssize_t>(model.getRigidBodies().size());
+    if (name == "time")
+    {
+        shape = {};
+        return RecordChannel::TIME;
+    }
+    else if (name == "positions")
+    {
+        shape = { numParticles, 3 };
+        return RecordChannel::POSITIONS;
+    }
+    else if (name == "velocities")
+    {
+        shape = { numParticles, 3 };
+        return RecordChannel::VELOCITIES;
+    }
+    else if (name == "rigidBodyTransforms")
+    {
+        shape = { numBodies, 7 };
+        return RecordChannel::RIGID_BODY_TRANSFORMS;
+    }
+    else if (name == "rigidBodyVelocities")
+    {
+        shape = { numBodies, 6 };
+        return RecordChannel::RIGID_BODY_VELOCITIES;
+    }
+    throw py::value_error("advance: unknown record channel '" + name + "'. Valid channels are time, positions, velocities, rigidBodyTransforms and rigidBodyVelocities.");
+}
+
+/** Perform numSteps simulation steps without holding the GIL. The channels given by record 
+ * are copied after each step. record is either a list of channel names (the buffers are allocated)
+ * or a dictionary which maps channel names to preallocated arrays of shape (numSteps, ...). 
+ * The buffers are returned as dictionary.
+ */
+static py::dict advance(PBD::Simulation &sim, const unsigned int numSteps, py::object record)
+{
+    PBD::SimulationModel *model = sim.getModel();
+    PBD::TimeStep *timeStep = sim.getTimeStep();
+    if ((model == nullptr) || (timeStep == nullptr) || (sim.getTimeManager() == nullptr))
+        throw py::value_error("advance: the simulation has no model, time step or time manager.");
+
+    // determine the buffers while holding the GIL
+    py::dict buffers;
+    std::vector<RecordChannel> channels;
+    if (!record.is_none())
+    {
+        const bool preallocated = py::isinstance<py::dict>(record);
+        for (py::handle item : record)
+        {
+            const std::string name = py::cast<std::string>(item);
+            std::vector<py::ssize_t> shape;
+            RecordChannel channel;
+            channel.type = getRecordChannelType(name, *model, shape);
+            shape.insert(shape.begin(), static_cast<py::ssize_t>(numSteps));
+
+            py::array_t<Real> buffer;
+            if (preallocated)
+            {
+                py::object obj = py::reinterpret_borrow<py::dict>(record)[item];
+                if (!py::array_t<Real, py::array::c_style>::check_(obj))
+                    throw py::value_error("advance: the buffer of channel '" + name + "' must be a C-contiguous array of type " + py::str(py::dtype::of<Real>()).cast<std::string>() + ".");
+                buffer = obj.cast<py::array_t<Real>>();
+                if (!buffer.writeable())
+                    throw py::value_error("advance: the buffer of channel '" + name + "' is read-only.");
+                if ((buffer.ndim() != static_cast<py::ssize_t>(shape.size())) || !std::equal(shape.begin(), shape.end(), buffer.shape()))
+                    throw py::value_error("advance: the buffer of channel '" + name + "' has a wrong shape.");
+            }
+            else
+                buffer = py::array_t<Real>(shape);
+            channel.data = buffer.mutable_data();
+            channel.size = static_cast<size_t>(buffer.size()) / std::max(numSteps, 1u);
+            channels.push_back(channel);
+            buffers[item] = buffer;
+        }
+    }
+
+    {
+        py::gil_scoped_release release;
+
+        // bind this simulation to the calling thread only, the binding of the thread is
+        // restored at the end of the block and the current simulation of the process is unchanged
+        PBD::Simulation::ThreadBinding binding(&sim);
+        PBD::TimeManager *tm = sim.getTimeManager();
+
+        for (unsigned int step = 0; step < numSteps; step++)
+        {
+            timeStep->step(*model);
+
+            for (size_t i = 0; i < channels.size(); i++)
+            {
+                Real *data = &channels[i].data[step * channels[i].size];
+                switch (channels[i].type)
+                {
+                case RecordChannel::TIME:
+                    *data = tm->getTime();
+                    break;
+                case RecordChannel::POSITIONS:
+                    memcpy(data, model->getParticles().getVertices().data(), sizeof(Real) * channels[i].size);
+                    break;
+                case RecordChannel::VELOCITIES:
+                    memcpy(data, model->getParticles().getVelocities().data(), sizeof(Real) * channels[i].size);
+                    break;
+                case RecordChannel::RIGID_BODY_TRANSFORMS:
+                    copyRigidBodyTransforms(model->getRigidBodies(), data);
+                    break;
+                case RecordChannel::RIGID_BODY_VELOCITIES:
+                    copyRigidBodyVelocities(model->getRigidBodies(), data);
+                    break;
+                }
+            }
+        }
+    }
+    return buffers;
+}
+
 void SimulationModule(py::module m_sub) {
     // ---------------------------------------
     // Class Simulation
@@ -30,5 +165,32 @@ void SimulationModule(py::module m_sub) {
                 PBD::CubicSDFCollisionDetection* cd = new PBD::CubicSDFCollisionDetection();
                 sim.getTimeStep()->setCollisionDetection(*sim.getModel(), cd);
             })
+        .def("makeCurrent", &PBD::Simulation::makeCurrent)
+        .def("getTimeManager", &PBD::Simulation::getTimeManager, py::return_value_policy::reference_internal)
+        .def("advance", &advance, py::arg("n_steps"), py::arg("record") = py::none(),
+            "Perform n_steps simulation steps without holding the GIL, so that independent simulations can run in parallel Python threads. "
+            "record is a list of channel names (time, positions, velocities, rigidBodyTransforms, rigidBodyVelocities) "
+            "or a dictionary which maps channel names to preallocated arrays of shape (n_steps, ...). "
+            "Returns a dictionary with the recorded channels.")
+        ;
+
+    // ---------------------------------------
+    // Class BatchRunner
+    // ---------------------------------------
+    py::class_<PBD::BatchRunner>(m_sub, "BatchRunner")
+        .def(py::init<const unsigned int>(), py::arg("num_threads") = 0)
+        .def("getNumThreads", &PBD::BatchRunner::getNumThreads)
+        .def("step", [](PBD::BatchRunner &runner, const std::vector<PBD::Simulation*> &simulations, const unsigned int numSteps)
+            {
+                for (size_t i = 0; i < simulations.size(); i++)
+                {
+                    if ((simulations[i] == nullptr) || (simulations[i]->getModel() == nullptr) || (simulations[i]->getTimeStep() == nullptr))
+                        throw py::value_error("BatchRunner.step: simulation " + std::to_string(i) + " has no model or time step.");
+                }
+                py::gil_scoped_release release;
+                runner.step(simulations, numSteps);
+            }, py::arg("simulations"), py::arg("n_steps"),
+            "Perform n_steps simulation steps of each simulation in the worker threads without holding the GIL. "
+            "The simulations must not share models.")
         ;
-}
\ No newline at end of file
+}
@@ -27,6 +27,19 @@ void TimeStepModule(py::module m_sub)
         .def_readwrite_static("VELOCITY_UPDATE_METHOD", &PBD::TimeStepController::VELOCITY_UPDATE_METHOD)
         .def_readwrite_static("ENUM_VUPDATE_FIRST_ORDER", &PBD::TimeStepController::ENUM_VUPDATE_FIRST_ORDER)
         .def_readwrite_static("ENUM_VUPDATE_SECOND_ORDER", &PBD::TimeStepController::ENUM_VUPDATE_SECOND_ORDER)
+        .def_readwrite_static("SOLVER_ACCELERATION", &PBD::TimeStepController::SOLVER_ACCELERATION)
+        .def_readwrite_static("ENUM_ACCELERATION_NONE", &PBD::TimeStepController::ENUM_ACCELERATION_NONE)
+        .def_readwrite_static("ENUM_ACCELERATION_SOR", &PBD::TimeStepController::ENUM_ACCELERATION_SOR)
+        .def_readwrite_static("ENUM_ACCELERATION_CHEBYSHEV", &PBD::TimeStepController::ENUM_ACCELERATION_CHEBYSHEV)
+        .def_readwrite_static("RELAXATION_OMEGA", &PBD::TimeStepController::RELAXATION_OMEGA)
+        .def_readwrite_static("CHEBYSHEV_RHO", &PBD::TimeStepController::CHEBYSHEV_RHO)
+        .def_readwrite_static("RESIDUAL_TOLERANCE", &PBD::TimeStepController::RESIDUAL_TOLERANCE)
+        .def_readwrite_static("FUSED_SUB_STEPS", &PBD::TimeStepController::FUSED_SUB_STEPS)
+        .def("getResidualHistory", [](const PBD::TimeStepController &tsc)
+            {
+                const std::vector<Real> &history = tsc.getResidualHistory();
+                return py::array_t<Real>(history.size(), history.data());
+            })
 
         .def(py::init<>());
 }
\ No newline at end of file
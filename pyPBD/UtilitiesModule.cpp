@@ -6,6 +6,7 @@
 #include <Utils/PLYLoader.h>
 #include <Utils/TetGenLoader.h>
 #include <Utils/Timing.h>
+#include <Utils/AllocationCounter.h>
 #include <Utils/Logger.h>
 
 namespace py = pybind11;
@@ -21,6 +22,17 @@ void UtilitiesModule(py::module m_sub)
     using UVIndices = Utilities::IndexedFaceMesh::UVIndices;
     using UVs = Utilities::IndexedFaceMesh::UVs;
 
+    py::class_<Utilities::CSRAdjacency>(m_sub, "CSRAdjacency")
+        .def(py::init<>())
+        .def("size", &Utilities::CSRAdjacency::size)
+        .def("numEntries", &Utilities::CSRAdjacency::numEntries)
+        .def("numNeighbors", &Utilities::CSRAdjacency::numNeighbors)
+        .def("getNeighbors", [](const Utilities::CSRAdjacency& adj, const unsigned int i) {
+            return std::vector<unsigned int>(adj.begin(i), adj.end(i));
+        })
+        .def("getOffsets", &Utilities::CSRAdjacency::getOffsets)
+        .def("getIndices", &Utilities::CSRAdjacency::getIndices);
+
     py::class_<Utilities::IndexedFaceMesh>(m_sub, "IndexedFaceMesh")
         .def(py::init<>())
         .def("release", &Utilities::IndexedFaceMesh::release)
@@ -55,8 +67,8 @@ void UtilitiesModule(py::module m_sub)
         .def("getFacesEdges", (const Utilities::IndexedFaceMesh::FacesEdges & (Utilities::IndexedFaceMesh::*)()const)(&Utilities::IndexedFaceMesh::getFacesEdges))
         .def("getUVIndices", (const UVIndices & (Utilities::IndexedFaceMesh::*)()const)(&Utilities::IndexedFaceMesh::getUVIndices))
         .def("getUVs", (const UVs & (Utilities::IndexedFaceMesh::*)()const)(&Utilities::IndexedFaceMesh::getUVs))
-        .def("getVertexFaces", (const Utilities::IndexedFaceMesh::VerticesFaces & (Utilities::IndexedFaceMesh::*)()const)(&Utilities::IndexedFaceMesh::getVertexFaces))
-        .def("getVertexEdges", (const Utilities::IndexedFaceMesh::VerticesEdges & (Utilities::IndexedFaceMesh::*)()const)(&Utilities::IndexedFaceMesh::getVertexEdges))
+        .def("getVertexFaces", (const Utilities::IndexedFaceMesh::VerticesFaces & (Utilities::IndexedFaceMesh::*)()const)(&Utilities::IndexedFaceMesh::getVertexFaces), py::return_value_policy::reference_internal)
+        .def("getVertexEdges", (const Utilities::IndexedFaceMesh::VerticesEdges & (Utilities::IndexedFaceMesh::*)()const)(&Utilities::IndexedFaceMesh::getVertexEdges), py::return_value_policy::reference_internal)
         .def("numVertices", &Utilities::IndexedFaceMesh::numVertices)
         .def("numFaces", &Utilities::IndexedFaceMesh::numFaces)
         .def("numEdges", &Utilities::IndexedFaceMesh::numEdges)
@@ -94,9 +106,9 @@ void UtilitiesModule(py::module m_sub)
         .def("getEdges", (const Utilities::IndexedTetMesh::Edges& (Utilities::IndexedTetMesh::*)()const)(&Utilities::IndexedTetMesh::getEdges))
         .def("getFaceData", (const Utilities::IndexedTetMesh::FaceData& (Utilities::IndexedTetMesh::*)()const)(&Utilities::IndexedTetMesh::getFaceData))
         .def("getTetData", (const Utilities::IndexedTetMesh::TetData& (Utilities::IndexedTetMesh::*)()const)(&Utilities::IndexedTetMesh::getTetData))
-        .def("getVertexTets", (const Utilities::IndexedTetMesh::VerticesTets& (Utilities::IndexedTetMesh::*)()const)(&Utilities::IndexedTetMesh::getVertexTets))
-        .def("getVertexFaces", (const Utilities::IndexedTetMesh::VerticesFaces & (Utilities::IndexedTetMesh::*)()const)(&Utilities::IndexedTetMesh::getVertexFaces))
-        .def("getVertexEdges", (const Utilities::IndexedTetMesh::VerticesEdges& (Utilities::IndexedTetMesh::*)()const)(&Utilities::IndexedTetMesh::getVertexEdges))
+        .def("getVertexTets", (const Utilities::IndexedTetMesh::VerticesTets& (Utilities::IndexedTetMesh::*)()const)(&Utilities::IndexedTetMesh::getVertexTets), py::return_value_policy::reference_internal)
+        .def("getVertexFaces", (const Utilities::IndexedTetMesh::VerticesFaces & (Utilities::IndexedTetMesh::*)()const)(&Utilities::IndexedTetMesh::getVertexFaces), py::return_value_policy::reference_internal)
+        .def("getVertexEdges", (const Utilities::IndexedTetMesh::VerticesEdges& (Utilities::IndexedTetMesh::*)()const)(&Utilities::IndexedTetMesh::getVertexEdges), py::return_value_policy::reference_internal)
         .def("numVertices", &Utilities::IndexedTetMesh::numVertices)
         .def("numFaces", &Utilities::IndexedTetMesh::numFaces)
         .def("numTets", &Utilities::IndexedTetMesh::numTets)
@@ -266,9 +278,10 @@ void UtilitiesModule(py::module m_sub)
         .def_readwrite_static("m_startCounter", &Utilities::Timing::m_startCounter)
         .def_readwrite_static("m_stopCounter", &Utilities::Timing::m_stopCounter)
         .def_readwrite_static("m_timingStack", &Utilities::Timing::m_timingStack)
+        .def_readwrite_static("m_timingStackSize", &Utilities::Timing::m_timingStackSize)
         .def_readwrite_static("m_averageTimes", &Utilities::Timing::m_averageTimes)
         .def_static("reset", &Utilities::Timing::reset)
-        .def_static("startTiming", &Utilities::Timing::startTiming)
+        .def_static("startTiming", static_cast<void (*)(const std::string&)>(&Utilities::Timing::startTiming))
         .def_static("stopTimingPrint", []()
             {
                 static int timing_timerId = -1;
@@ -287,4 +300,21 @@ void UtilitiesModule(py::module m_sub)
         .def_static("printAverageTimes", &Utilities::Timing::printAverageTimes)
         .def_static("printTimeSums", &Utilities::Timing::printTimeSums);
 
+    py::class_<Utilities::AverageCount>(m_sub, "AverageCount")
+        .def(py::init<>())
+        .def_readwrite("sum", &Utilities::AverageCount::sum)
+        .def_readwrite("numberOfCalls", &Utilities::AverageCount::numberOfCalls)
+        .def_readwrite("name", &Utilities::AverageCount::name);
+
+    py::class_<Utilities::Counting>(m_sub, "Counting")
+        .def(py::init<>())
+        .def_readwrite_static("m_averageCounts", &Utilities::Counting::m_averageCounts)
+        .def_static("reset", &Utilities::Counting::reset)
+        .def_static("printAverageCounts", &Utilities::Counting::printAverageCounts)
+        .def_static("printCounterSums", &Utilities::Counting::printCounterSums);
+
+    py::class_<Utilities::AllocationCounter>(m_sub, "AllocationCounter")
+        .def_static("isEnabled", &Utilities::AllocationCounter::isEnabled)
+        .def_static("getCount", &Utilities::AllocationCounter::getCount);
+
 }
@@ -5,6 +5,10 @@
 #include <pybind11/eigen.h>
 #include <pybind11/stl.h>
 #include <pybind11/stl_bind.h>
+#include <pybind11/numpy.h>
+
+#include <cstring>
+#include <string>
 
 #include "Common/Common.h"
 #include "Simulation/SimulationModel.h"
@@ -15,4 +19,72 @@ PYBIND11_MAKE_OPAQUE(std::vector<PBD::TetModel*>)
 PYBIND11_MAKE_OPAQUE(std::vector<PBD::Constraint*>)
 PYBIND11_MAKE_OPAQUE(std::vector<PBD::RigidBody*>)
 
+/** NumPy array of Real values which is converted from any numeric array. 
+ * Used for the bulk setters, so that float64 arrays can be passed to a float build and vice versa. 
+ */
+typedef pybind11::array_t<Real, pybind11::array::c_style | pybind11::array::forcecast> RealArray;
+
+/** Return a NumPy array which shares the memory of the given data (no copy). 
+ * The owner is the base object of the array, i.e. it is kept alive as long as the array exists. 
+ * Note that the array becomes invalid if the memory is reallocated, e.g. when particles are added.
+ */
+inline pybind11::array_t<Real> createRealArrayView(const Real *data, const std::vector<pybind11::ssize_t> &shape, pybind11::handle owner, const bool writeable = true)
+{
+    std::vector<pybind11::ssize_t> strides(shape.size(), static_cast<pybind11::ssize_t>(sizeof(Real)));
+    for (int i = static_cast<int>(shape.size()) - 2; i >= 0; i--)
+        strides[i] = strides[i + 1] * shape[i + 1];
+    pybind11::array_t<Real> a(shape, strides, data, owner);
+    if (!writeable)
+        pybind11::detail::array_proxy(a.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    return a;
+}
+
+/** Zero-copy NumPy view (n x 3) of a vector of Vector3r. */
+inline pybind11::array_t<Real> createVector3rArrayView(const std::vector<Vector3r> &v, pybind11::handle owner, const bool writeable = true)
+{
+    static_assert(sizeof(Vector3r) == 3 * sizeof(Real), "Vector3r must not be padded");
+    return createRealArrayView(v.empty() ? nullptr : v[0].data(), { static_cast<pybind11::ssize_t>(v.size()), 3 }, owner, writeable);
+}
+
+/** Check that the array has the shape (rows x cols) or (rows) if cols is zero. */
+inline void checkArrayShape(const RealArray &a, const size_t rows, const size_t cols, const char *name)
+{
+    const bool valid = (cols == 0) ?
+        ((a.ndim() == 1) && (static_cast<size_t>(a.shape(0)) == rows)) :
+        ((a.ndim() == 2) && (static_cast<size_t>(a.shape(0)) == rows) && (static_cast<size_t>(a.shape(1)) == cols));
+    if (!valid)
+    {
+        const std::string shape = (cols == 0) ? "(" + std::to_string(rows) + ",)" : "(" + std::to_string(rows) + ", " + std::to_string(cols) + ")";
+        throw pybind11::value_error(std::string(name) + ": expected an array with shape " + shape);
+    }
+}
+
+/** Copy an (n x 3) array to a vector of Vector3r with n elements (bulk setter). */
+inline void copyArrayToVector3r(const RealArray &a, std::vector<Vector3r> &v, const char *name)
+{
+    checkArrayShape(a, v.size(), 3, name);
+    if (!v.empty())
+        memcpy(v[0].data(), a.data(), sizeof(Real) * 3 * v.size());
+}
+
+/** Copy the transformations of the rigid bodies to an (n x 7) array. Each row contains the position and the rotation quaternion (x, y, z, w). */
+inline void copyRigidBodyTransforms(const PBD::SimulationModel::RigidBodyVector &rbs, Real *data)
+{
+    for (size_t i = 0; i < rbs.size(); i++)
+    {
+        Vector3r::Map(&data[7 * i]) = rbs[i]->getPosition();
+        Vector4r::Map(&data[7 * i + 3]) = rbs[i]->getRotation().coeffs();
+    }
+}
+
+/** Copy the velocities of the rigid bodies to an (n x 6) array. Each row contains the linear and the angular velocity. */
+inline void copyRigidBodyVelocities(const PBD::SimulationModel::RigidBodyVector &rbs, Real *data)
+{
+    for (size_t i = 0; i < rbs.size(); i++)
+    {
+        Vector3r::Map(&data[6 * i]) = rbs[i]->getVelocity();
+        Vector3r::Map(&data[6 * i + 3]) = rbs[i]->getAngularVelocity();
+    }
+}
+
 #endif //PBD_COMMON_H
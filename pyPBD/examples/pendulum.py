@@ -42,11 +42,13 @@ def render():
     
     # render distance constraints
     pd = model.getParticles()
+    # zero-copy view of the particle positions
+    x = pd.getVertices()
     glLineWidth(2.0)
     glColor3f(1.0, 1.0, 1.0)
     glBegin(GL_LINE_STRIP)
     for i in range(numParticles):
-        glVertex3fv(pd.getPosition(i))
+        glVertex3fv(x[i])
     glEnd()
     
     # render particles
@@ -54,7 +56,7 @@ def render():
     glColor3f(0.1, 0.7, 0.3)
     glBegin(GL_POINTS)
     for i in range(numParticles):
-        glVertex3fv(pd.getPosition(i))
+        glVertex3fv(x[i])
     glEnd()
 
     # render time